@@ -24,6 +24,16 @@
 
 #include "platform/Span.h"
 
+#include "platform/pixel_ops.h"
+
+#include "LVGLFlushDescriptor.h"
+#include "LVGLFrameSync.h"
+#include "LVGLFramePacer.h"
+
+#if MBED_CONF_RTOS_PRESENT
+#include "LVGLRenderPipeline.h"
+#endif
+
 class LVGLDisplayDriver
 {
 
@@ -32,6 +42,26 @@ public:
 	// Declare LittlevGL a friend class
 	friend class LittlevGL;
 
+#if MBED_CONF_RTOS_PRESENT
+	// Workers wait for the frame sync before flushing a frame's first strip
+	friend class LVGLRenderPipeline;
+#endif
+
+		/**
+		 * Pixel formats a display may accept natively
+		 *
+		 * lvgl renders every display at LV_COLOR_DEPTH. Displays with a
+		 * different native format get each rendered strip converted once,
+		 * when it is flushed, by the packing kernels in pixel_ops.
+		 */
+		typedef enum {
+			NATIVE_FORMAT_LV_COLOR = 0,		/** lv_color_t as rendered, no conversion */
+			NATIVE_FORMAT_RGB565,			/** 16 bits per pixel, low byte first */
+			NATIVE_FORMAT_RGB565_SWAPPED,	/** 16 bits per pixel, high byte first */
+			NATIVE_FORMAT_RGB332,			/** 8 bits per pixel */
+			NATIVE_FORMAT_MONO_VTILED,		/** 1 bit per pixel, 8 vertical pixels per byte, column by column */
+		} native_format_t;
+
 		/**
 		 * Constructor for LVGLDisplayDriver
 		 *
@@ -42,7 +72,17 @@ public:
 		 */
 		LVGLDisplayDriver(mbed::Span<lv_color_t> primary_display_buffer = mbed::Span<lv_color_t, 0>(),
 				mbed::Span<lv_color_t> secondary_display_buffer = mbed::Span<lv_color_t, 0>()) :
-				hor_res(LV_HOR_RES_MAX), ver_res(LV_VER_RES_MAX), lv_disp_obj(NULL) {
+				hor_res(LV_HOR_RES_MAX), ver_res(LV_VER_RES_MAX),
+				native_format(NATIVE_FORMAT_LV_COLOR), lv_disp_obj(NULL),
+				frame_sync(NULL), frame_start(false), sync_timeouts(0)
+#if LV_COLOR_DEPTH == 8
+				, palette_lut(NULL)
+#endif
+#if MBED_CONF_RTOS_PRESENT
+				, render_workers(MBED_CONF_MBED_LVGL_RENDER_WORKERS),
+				render_pipeline_depth(MBED_CONF_MBED_LVGL_RENDER_PIPELINE_DEPTH), pipeline(NULL)
+#endif
+				{
 
 			// If the user doesn't provide a display buffer to use, dynamically allocate one
 			if(primary_display_buffer.empty()) {
@@ -65,7 +105,16 @@ public:
 			initialize_display_buffers();
 		}
 
+		/**
+		 * @note A display driver must not be destroyed while it is registered with LittlevGL
+		 */
 		virtual ~LVGLDisplayDriver() {
+#if MBED_CONF_RTOS_PRESENT
+			delete pipeline;
+#endif
+#if LV_COLOR_DEPTH == 8
+			delete[] palette_lut;
+#endif
 			// Clean up our dynamically allocated display buffer
 			if(!user_provided_display_buffer) {
 				delete[] primary_display_buffer.data();
@@ -102,6 +151,161 @@ public:
 			*ver_res = this->ver_res;
 		}
 
+		/**
+		 * Synchronizes flushes with the panel's refresh
+		 *
+		 * The first strip of each frame is only flushed once the panel starts
+		 * a new refresh, and the display is refreshed at the panel's rate.
+		 *
+		 * @param[in] sync Frame sync source (eg: InterruptFrameSync on the TE pin), NULL to disable
+		 */
+		void set_frame_sync(LVGLFrameSync* sync) {
+			frame_sync = sync;
+		}
+
+		/**
+		 * Gets the frame sync source
+		 *
+		 * @retval frame sync source, NULL if flushes are not synchronized
+		 */
+		LVGLFrameSync* get_frame_sync(void) {
+			return frame_sync;
+		}
+
+		/**
+		 * Gets the display's adaptive frame pacer
+		 */
+		LVGLFramePacer& get_frame_pacer(void) {
+			return frame_pacer;
+		}
+
+		/**
+		 * Gets the number of frames flushed without a frame sync event (timed out)
+		 */
+		uint32_t get_sync_timeouts(void) const {
+			return sync_timeouts;
+		}
+
+		/**
+		 * Gets the display's native pixel format
+		 *
+		 * @retval native pixel format
+		 */
+		native_format_t get_native_format(void) const {
+			return native_format;
+		}
+
+		/**
+		 * Gets the size of an area of pixels in a native pixel format
+		 *
+		 * @param[in] format Native pixel format
+		 * @param[in] w Width of the area
+		 * @param[in] h Height of the area (a multiple of 8 for NATIVE_FORMAT_MONO_VTILED)
+		 *
+		 * @retval size in bytes
+		 */
+		static uint32_t get_native_size(native_format_t format, lv_coord_t w, lv_coord_t h) {
+			uint32_t px = (uint32_t) w * h;
+			switch(format) {
+				case NATIVE_FORMAT_RGB565:
+				case NATIVE_FORMAT_RGB565_SWAPPED:
+					return px * 2;
+				case NATIVE_FORMAT_RGB332:
+					return px;
+				case NATIVE_FORMAT_MONO_VTILED:
+					return px >> 3;
+				case NATIVE_FORMAT_LV_COLOR:
+				default:
+					return px * sizeof(lv_color_t);
+			}
+		}
+
+#if LV_COLOR_DEPTH == 8
+		/**
+		 * Sets the display's palette, making rendering indexed
+		 *
+		 * At LV_COLOR_DEPTH 8 each rendered pixel is one byte, so draw
+		 * buffers hold twice the lines of RGB565 ones in the same RAM. By
+		 * default the byte is an RGB332 color. Displays with an RGB565 native
+		 * format expand it through a 256-entry lookup table when flushing.
+		 * With a palette the byte is an index into it instead (see
+		 * palette_color()), so any 256 colors can be shown.
+		 *
+		 * @param[in] colors Colors of indices 0 to count - 1, NULL to go back to RGB332
+		 * @param[in] count Number of colors (at most 256), other indices keep their RGB332 color
+		 *
+		 * @retval false if the display's native format is not RGB565
+		 *
+		 * @note lvgl still blends pixels (anti-aliasing, opacity) as RGB332,
+		 * which mixes indices bit field by bit field. With a palette, disable
+		 * anti-aliasing and use opaque styles, or order the palette so mixed
+		 * indices make sense.
+		 */
+		bool set_palette(const lv_color32_t* colors, size_t count) {
+			if(native_format != NATIVE_FORMAT_RGB565 && native_format != NATIVE_FORMAT_RGB565_SWAPPED) {
+				return false;
+			}
+
+			MBED_ASSERT(count <= 256);
+			bool swap = (native_format == NATIVE_FORMAT_RGB565_SWAPPED);
+			if(palette_lut == NULL) {
+				palette_lut = new uint16_t[256];
+			}
+			mbed_lvgl_px_make_rgb565_lut(palette_lut, swap);
+
+			for(size_t i = 0; colors != NULL && i < count; i++) {
+				uint16_t v = (uint16_t)(((colors[i].ch.red & 0xF8) << 8) |
+						((colors[i].ch.green & 0xFC) << 3) | (colors[i].ch.blue >> 3));
+				uint8_t* entry = (uint8_t*) &palette_lut[i];
+				entry[0] = swap ? (v >> 8) : (v & 0xFF);
+				entry[1] = swap ? (v & 0xFF) : (v >> 8);
+			}
+			return true;
+		}
+
+		/**
+		 * Gets the color drawing a palette index (eg: for styles)
+		 */
+		static lv_color_t palette_color(uint8_t index) {
+			lv_color_t color;
+			color.full = index;
+			return color;
+		}
+#endif
+
+#if MBED_CONF_RTOS_PRESENT
+		/**
+		 * Sets the number of worker threads that prepare and flush
+		 * rendered strips while lvgl renders the next ones
+		 *
+		 * @param[in] workers Number of workers (0 to flush on the GUI thread)
+		 *
+		 * @note should be set before the display driver is registered with
+		 * LittlevGL. Each worker needs a draw buffer of its own, the extra
+		 * buffers are allocated by the pipeline unless a secondary display
+		 * buffer was provided. The driver's flush (and prepare) will then be
+		 * called from worker threads.
+		 */
+		void set_render_workers(size_t workers) {
+			render_workers = workers;
+		}
+
+		/**
+		 * Sets the number of draw buffers in the render pipeline's ring
+		 *
+		 * A deeper ring lets lvgl render several strips ahead of a slow
+		 * bus, absorbing bursty frames (eg: large scrolls) without stalling.
+		 *
+		 * @param[in] depth Number of draw buffers (0 for one per render worker plus one)
+		 *
+		 * @note should be set before the display driver is registered with
+		 * LittlevGL, only used when render workers are enabled
+		 */
+		void set_render_pipeline_depth(size_t depth) {
+			render_pipeline_depth = depth;
+		}
+#endif
+
 /* TODO - figure out why making LittlevGL a friend class does not
  * allow access to protected member functions...
  *
@@ -117,6 +321,37 @@ public:
 		 */
 		virtual void flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p) = 0;
 
+		/**
+		 * OPTIONAL: Flush the regions of a draw buffer listed in a flush descriptor
+		 *
+		 * With a full-frame buffer the descriptor lists only the areas that
+		 * were redrawn, along with the frame's stride, so drivers can transfer
+		 * them straight out of the frame. Full-frame buffers are not prepared
+		 * and must not be modified.
+		 *
+		 * The default implementation flushes the whole buffer with flush()
+		 *
+		 * @param[in] disp_drv lvgl display driver
+		 * @param[in] desc Flush descriptor
+		 */
+		virtual void flush_regions(lv_disp_drv_t * disp_drv, const LVGLFlushDescriptor& desc) {
+			flush(disp_drv, desc.get_buffer_area(), desc.get_buffer());
+		}
+
+		/**
+		 * OPTIONAL: Process a rendered strip before it is flushed (eg: color conversion)
+		 *
+		 * When render workers are enabled this runs on a worker thread,
+		 * concurrently with lvgl rendering other strips and with other
+		 * strips being prepared. It must only touch the given buffer.
+		 *
+		 * The default implementation converts the strip to the native
+		 * pixel format in place, flush then receives native pixels.
+		 */
+		virtual void prepare(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p) {
+			convert_in_place(area, color_p);
+		}
+
 		/**
 		 * Subclass returns true if it has a custom rounder function
 		 */
@@ -143,19 +378,79 @@ public:
 		 * number of flushed pixels */
 		virtual void monitor(lv_disp_drv_t * disp_drv, uint32_t time, uint32_t px) {
 #if MBED_CONF_MBED_LVGL_ENABLE_FLUSH_MONITORING
-			printf("%d px refreshed in %d ms\n", time, ms);
+			printf("%lu px refreshed in %lu ms\n", (unsigned long) px, (unsigned long) time);
 #endif
 		}
 
-#if USE_LV_GPU
+		/**
+		 * Subclass returns true if the display can scroll a band of rows in hardware
+		 */
+		virtual bool has_hw_scroll(void) {
+			return false;
+		}
+
+		/**
+		 * OPTIONAL: Defines the band of rows scrolled in hardware
+		 *
+		 * Rows outside of the band stay fixed. The scroll offset is reset, so
+		 * the whole display must be redrawn after the band is changed.
+		 *
+		 * @param[in] y1 First row of the band
+		 * @param[in] y2 Last row of the band, less than y1 to disable hardware scrolling
+		 */
+		virtual void set_scroll_region(lv_coord_t y1, lv_coord_t y2) { }
 
-		/** OPTIONAL: Blend two memories using opacity (GPU only)*/
+		/**
+		 * OPTIONAL: Moves the content of the scroll band in hardware
+		 *
+		 * Rows scrolled out of one end of the band come back in at the other
+		 * end and have to be redrawn. The display keeps mapping lvgl's rows
+		 * to the scrolled display memory in flush.
+		 *
+		 * @param[in] dy Number of rows to move the content by (positive moves it down)
+		 */
+		virtual void scroll(lv_coord_t dy) { }
+
+#if LV_USE_GPU
+
+		/**
+		 * OPTIONAL: Blend two memories using opacity (GPU only)
+		 *
+		 * The default implementation uses the SIMD software kernels in pixel_ops.
+		 * Drivers with a hardware accelerator (eg: DMA2D) should override this.
+		 */
 		virtual void gpu_blend(lv_disp_drv_t * disp_drv, lv_color_t * dest, const lv_color_t * src, uint32_t length,
-							 lv_opa_t opa) { }
+							 lv_opa_t opa) {
+			if(opa >= LV_OPA_MAX) {
+				gpu_copy(disp_drv, dest, src, length);
+			} else {
+				mbed_lvgl_px_blend(dest, src, length, opa);
+			}
+		}
 
-		/** OPTIONAL: Fill a memory with a color (GPU only)*/
+		/**
+		 * OPTIONAL: Fill an area of a memory with a color (GPU only)
+		 *
+		 * The default implementation uses the SIMD software kernels in pixel_ops.
+		 */
 		virtual void gpu_fill(lv_disp_drv_t * disp_drv, lv_color_t * dest_buf, lv_coord_t dest_width,
-							const lv_area_t * fill_area, lv_color_t color) { }
+							const lv_area_t * fill_area, lv_color_t color) {
+			uint32_t w = lv_area_get_width(fill_area);
+			lv_color_t* row = dest_buf + ((int32_t) dest_width * fill_area->y1) + fill_area->x1;
+			for(lv_coord_t y = fill_area->y1; y <= fill_area->y2; y++) {
+				mbed_lvgl_px_fill(row, w, color);
+				row += dest_width;
+			}
+		}
+
+		/**
+		 * OPTIONAL: Copy a memory (GPU only), used for fully opaque blends
+		 *
+		 * The default implementation uses the SIMD software kernels in pixel_ops.
+		 */
+		virtual void gpu_copy(lv_disp_drv_t * disp_drv, lv_color_t * dest, const lv_color_t * src, uint32_t length) {
+			mbed_lvgl_px_copy(dest, src, length);
+		}
 
 #endif
 
@@ -179,8 +474,125 @@ public:
 			return lv_disp_obj;
 		}
 
+#if MBED_CONF_RTOS_PRESENT
+		/**
+		 * Creates the render worker pool if render workers are enabled
+		 *
+		 * lvgl is switched to a single buffer, the secondary display
+		 * buffer (if any) becomes one of the pipeline's buffers instead
+		 */
+		void create_pipeline(void) {
+			if(render_workers == 0 || pipeline != NULL) {
+				return;
+			}
+			lv_disp_buf_init(&this->lv_buf, this->primary_display_buffer.data(),
+					NULL, this->primary_display_buffer.size());
+			pipeline = new LVGLRenderPipeline(*this,
+					this->secondary_display_buffer.empty() ? NULL : this->secondary_display_buffer.data(),
+					this->primary_display_buffer.size(), render_workers, render_pipeline_depth);
+		}
+
+		/**
+		 * Gets the render worker pool
+		 *
+		 * @retval pointer to the pipeline, NULL if strips are flushed on the GUI thread
+		 */
+		LVGLRenderPipeline* get_pipeline(void) {
+			return pipeline;
+		}
+#endif
+
 protected:
 
+		/**
+		 * Sets the display's native pixel format
+		 *
+		 * @param[in] format Native pixel format
+		 *
+		 * @note Called by display drivers in their constructor
+		 */
+		void set_native_format(native_format_t format) {
+			native_format = format;
+#if LV_COLOR_DEPTH == 8
+			// Build the default table now, strips may be expanded on several
+			// render workers. A palette set earlier is kept.
+			if(palette_lut == NULL) {
+				set_palette(NULL, 0);
+			}
+#endif
+		}
+
+		/**
+		 * Converts a rendered strip to the native pixel format, in place
+		 *
+		 * @param[in] area Area covered by the strip
+		 * @param[in,out] color_p Rendered strip, native pixels on return
+		 *
+		 * @retval true if the strip was converted, false if the native format
+		 * cannot be produced in place (NATIVE_FORMAT_MONO_VTILED and formats
+		 * larger than lv_color_t) or needs no conversion
+		 */
+		bool convert_in_place(const lv_area_t * area, lv_color_t * color_p) {
+			uint32_t px = lv_area_get_size(area);
+			switch(native_format) {
+				case NATIVE_FORMAT_RGB565:
+				case NATIVE_FORMAT_RGB565_SWAPPED:
+#if LV_COLOR_DEPTH >= 16
+					mbed_lvgl_px_to_rgb565((uint8_t*) color_p, color_p, px,
+							native_format == NATIVE_FORMAT_RGB565_SWAPPED);
+					return true;
+#else
+					return false;
+#endif
+				case NATIVE_FORMAT_RGB332:
+					mbed_lvgl_px_to_rgb332((uint8_t*) color_p, color_p, px);
+					return true;
+				default:
+					return false;
+			}
+		}
+
+#if LV_COLOR_DEPTH == 8
+		/**
+		 * Expands rendered pixels to RGB565 through the palette's lookup table
+		 *
+		 * @param[out] dest Destination, 2 bytes per pixel (must not overlap color_p)
+		 * @param[in] color_p Rendered pixels
+		 * @param[in] px Number of pixels
+		 *
+		 * @note Only for displays with an RGB565 native format, dest must be 2-byte aligned
+		 */
+		void expand_rgb565(uint8_t* dest, const lv_color_t* color_p, uint32_t px) {
+			MBED_ASSERT(palette_lut != NULL);
+			mbed_lvgl_px_lut_expand16((uint16_t*) dest, (const uint8_t*) color_p, px, palette_lut);
+		}
+#endif
+
+		/**
+		 * Marks the start of a frame, its first strip waits for the frame sync
+		 */
+		void start_frame(void) {
+			frame_start = (frame_sync != NULL);
+		}
+
+		/**
+		 * Returns true (once) if a strip is the first of its frame
+		 */
+		bool take_frame_start(void) {
+			bool first = frame_start;
+			frame_start = false;
+			return first;
+		}
+
+		/**
+		 * Waits for the panel to start a new refresh
+		 */
+		void wait_frame_sync(void) {
+			if(frame_sync != NULL && !frame_sync->wait(MBED_CONF_MBED_LVGL_FRAME_SYNC_TIMEOUT)) {
+				sync_timeouts++;
+			}
+		}
+
 		/**
 		 * Internal function to initialize the underlying LittlevGL
 		 * display buffer structure
@@ -201,6 +613,9 @@ protected:
 		lv_coord_t hor_res; /** Horizontal resolution */
 		lv_coord_t ver_res; /** Vertical resolution */
 
+		/** Pixel format the display accepts */
+		native_format_t native_format;
+
 private:
 
 		/** C struct for interfacing to LVGL */
@@ -212,6 +627,33 @@ private:
 		/** C struct for accessing LVGL display object */
 		lv_disp_t* lv_disp_obj;
 
+		/** Frame sync source, NULL if flushes are not synchronized */
+		LVGLFrameSync* frame_sync;
+
+		/** Set when a frame starts, until its first strip is flushed */
+		bool frame_start;
+
+		uint32_t sync_timeouts;
+
+		/** Adapts the refresh period to the cost of frames */
+		LVGLFramePacer frame_pacer;
+
+#if LV_COLOR_DEPTH == 8
+		/** Rendered pixel to RGB565 lookup table, NULL unless the native format is RGB565 */
+		uint16_t* palette_lut;
+#endif
+
+#if MBED_CONF_RTOS_PRESENT
+		/** Number of render workers to use when registered */
+		size_t render_workers;
+
+		/** Number of draw buffers in the render pipeline (0 for automatic) */
+		size_t render_pipeline_depth;
+
+		/** Worker pool, created when registered with render workers enabled */
+		LVGLRenderPipeline* pipeline;
+#endif
+
 };
 
 
@@ -0,0 +1,216 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_LVGLFLUSHDESCRIPTOR_H_
+#define MBED_LVGL_LVGLFLUSHDESCRIPTOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lv_color.h"
+#include "lv_area.h"
+#include "lv_hal_disp.h"
+
+#include "platform/mbed_assert.h"
+
+/** A run of pixel data that is contiguous in memory */
+typedef struct {
+	const uint8_t* data;	/** First byte of the run */
+	uint32_t len;			/** Length of the run in bytes */
+} LVGLFlushSegment;
+
+/**
+ * Describes what a flush has to transfer, and where it lives in memory
+ *
+ * lvgl hands flush a pointer and an area, which is enough for strips
+ * but not for full-frame buffers: with two screen-sized buffers lvgl
+ * renders straight into the frame and flushes the whole screen once per
+ * refresh, even if only a few small areas changed.
+ *
+ * A descriptor holds the draw buffer, the area it covers and its stride,
+ * along with the list of regions that actually need to be sent. Each
+ * region can be walked row by row or turned into a scatter-gather list
+ * of row segments, so a DMA-capable bus can transfer sub-areas directly
+ * out of the frame without copying them into a contiguous buffer first.
+ */
+class LVGLFlushDescriptor
+{
+	public:
+
+		/**
+		 * Instantiate a descriptor for a draw buffer
+		 *
+		 * @param[in] buffer Draw buffer
+		 * @param[in] buffer_area Area of the display covered by the buffer (copied)
+		 * @param[in] full_frame true if the buffer is a full-frame buffer
+		 */
+		LVGLFlushDescriptor(lv_color_t* buffer, const lv_area_t* buffer_area, bool full_frame) :
+				buffer(buffer), stride(lv_area_get_width(buffer_area) * sizeof(lv_color_t)),
+				region_count(0), full_frame(full_frame) {
+			lv_area_copy(&this->buffer_area, buffer_area);
+		}
+
+		/**
+		 * Adds a region to transfer
+		 *
+		 * @param[in] area Region, clipped to the buffer's area (copied)
+		 *
+		 * @retval false if the region list is full or the region is outside of the buffer
+		 */
+		bool add_region(const lv_area_t* area) {
+			if(region_count >= LV_INV_BUF_SIZE) {
+				return false;
+			}
+			if(!lv_area_intersect(&regions[region_count], area, &buffer_area)) {
+				return false;
+			}
+			region_count++;
+			return true;
+		}
+
+		/**
+		 * Gets the draw buffer
+		 */
+		lv_color_t* get_buffer(void) const {
+			return buffer;
+		}
+
+		/**
+		 * Gets the area of the display covered by the draw buffer
+		 */
+		const lv_area_t* get_buffer_area(void) const {
+			return &buffer_area;
+		}
+
+		/**
+		 * Gets the number of bytes from the start of one buffer row to the next
+		 */
+		uint32_t get_stride(void) const {
+			return stride;
+		}
+
+		/**
+		 * Returns true if the buffer is a full-frame buffer
+		 *
+		 * @note Full-frame buffers are lvgl's reference frame and must not be modified
+		 */
+		bool is_full_frame(void) const {
+			return full_frame;
+		}
+
+		/**
+		 * Gets the number of regions to transfer
+		 */
+		size_t get_region_count(void) const {
+			return region_count;
+		}
+
+		/**
+		 * Gets a region to transfer, in display coordinates
+		 *
+		 * @param[in] index Index of the region
+		 */
+		const lv_area_t* get_region(size_t index) const {
+			MBED_ASSERT(index < region_count);
+			return &regions[index];
+		}
+
+		/**
+		 * Gets the number of bytes in one row of a region
+		 *
+		 * @param[in] index Index of the region
+		 */
+		uint32_t get_row_bytes(size_t index) const {
+			return lv_area_get_width(get_region(index)) * sizeof(lv_color_t);
+		}
+
+		/**
+		 * Gets the first pixel of a row of a region
+		 *
+		 * @param[in] index Index of the region
+		 * @param[in] y Row, in display coordinates
+		 */
+		const uint8_t* get_row(size_t index, lv_coord_t y) const {
+			const lv_area_t* region = get_region(index);
+			return ((const uint8_t*) buffer) + (y - buffer_area.y1) * stride
+					+ (region->x1 - buffer_area.x1) * sizeof(lv_color_t);
+		}
+
+		/**
+		 * Returns true if a region's rows follow each other in memory
+		 *
+		 * @param[in] index Index of the region
+		 */
+		bool is_contiguous(size_t index) const {
+			const lv_area_t* region = get_region(index);
+			return (get_row_bytes(index) == stride) || (region->y1 == region->y2);
+		}
+
+		/**
+		 * Fills a scatter-gather list with the row segments of a region
+		 *
+		 * Contiguous regions are a single segment. Call repeatedly until
+		 * it returns 0 when the list is smaller than the region.
+		 *
+		 * @param[in] index Index of the region
+		 * @param[in,out] next_row Row to start from (display coordinates, start at the region's y1),
+		 * updated to the first row that was not added
+		 * @param[out] segments List of segments to fill
+		 * @param[in] max_segments Size of the list
+		 *
+		 * @retval number of segments added
+		 */
+		size_t get_segments(size_t index, lv_coord_t& next_row,
+				LVGLFlushSegment* segments, size_t max_segments) const {
+			const lv_area_t* region = get_region(index);
+			size_t count = 0;
+
+			if(next_row > region->y2 || max_segments == 0) {
+				return 0;
+			}
+
+			if(is_contiguous(index)) {
+				segments[0].data = get_row(index, next_row);
+				segments[0].len = (region->y2 - next_row + 1) * get_row_bytes(index);
+				next_row = region->y2 + 1;
+				return 1;
+			}
+
+			uint32_t row_bytes = get_row_bytes(index);
+			while(count < max_segments && next_row <= region->y2) {
+				segments[count].data = get_row(index, next_row);
+				segments[count].len = row_bytes;
+				count++;
+				next_row++;
+			}
+			return count;
+		}
+
+	protected:
+
+		lv_color_t* buffer;
+		lv_area_t buffer_area;
+		uint32_t stride;
+
+		lv_area_t regions[LV_INV_BUF_SIZE];
+		size_t region_count;
+
+		bool full_frame;
+
+};
+
+#endif /* MBED_LVGL_LVGLFLUSHDESCRIPTOR_H_ */
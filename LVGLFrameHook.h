@@ -0,0 +1,80 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_LVGLFRAMEHOOK_H_
+#define MBED_LVGL_LVGLFRAMEHOOK_H_
+
+#include <stddef.h>
+
+#include "lv_area.h"
+#include "lv_hal_disp.h"
+
+/**
+ * Hook into the refresh cycle of every display registered with LittlevGL
+ *
+ * LittlevGL calls before_refresh right before lvgl refreshes a display,
+ * from the display's own refresh task. At that point the display's
+ * invalid areas for the coming frame are final and may be changed.
+ * after_refresh is called once the frame was rendered and flushed (or
+ * handed to the render pipeline).
+ *
+ * on_invalidate is called for every area lvgl invalidates outside of a
+ * refresh, before it is rounded and merged with the other invalid areas.
+ *
+ * Hooks are registered with LittlevGL::add_frame_hook
+ */
+class LVGLFrameHook
+{
+	// Declare LittlevGL a friend class
+	friend class LittlevGL;
+
+	public:
+
+		LVGLFrameHook() : next_hook(NULL) { }
+
+		virtual ~LVGLFrameHook() { }
+
+		/**
+		 * Called before a display is refreshed
+		 *
+		 * @param[in] disp Display about to be refreshed
+		 */
+		virtual void before_refresh(lv_disp_t* disp) { }
+
+		/**
+		 * Called after a display was refreshed
+		 *
+		 * @param[in] disp Display that was refreshed
+		 */
+		virtual void after_refresh(lv_disp_t* disp) { }
+
+		/**
+		 * Called when an area of a display is invalidated
+		 *
+		 * @param[in] disp Display the area belongs to
+		 * @param[in] area Invalidated area, truncated to the screen
+		 */
+		virtual void on_invalidate(lv_disp_t* disp, const lv_area_t* area) { }
+
+	private:
+
+		/** Next registered hook */
+		LVGLFrameHook* next_hook;
+
+};
+
+#endif /* MBED_LVGL_LVGLFRAMEHOOK_H_ */
@@ -0,0 +1,187 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LVGLFramePacer.h"
+
+#include "lv_hal_tick.h"
+#include "lv_obj.h"
+
+/** Frames in a row over budget before the pacer steps in */
+#define PACING_ESCALATE_FRAMES		3
+
+/** Frames in a row well under budget before the pacer steps back */
+#define PACING_RELAX_FRAMES			30
+
+LVGLFramePacer::LVGLFramePacer() :
+		enabled(MBED_CONF_MBED_LVGL_ENABLE_ADAPTIVE_PACING), mode(PACING_NOMINAL),
+		nominal_period(LV_DISP_DEF_REFR_PERIOD), period(LV_DISP_DEF_REFR_PERIOD),
+		max_period(MBED_CONF_MBED_LVGL_PACING_MAX_PERIOD), applied_period(0),
+		avg_cost_x8(0), over_budget(0), under_budget(0), last_refresh(0),
+		refresh_interval(0), excluded_time(0), frames(0), dropped_frames(0), saved_antialiasing(false),
+		degrade_cb(NULL)
+{ }
+
+void LVGLFramePacer::set_enabled(bool enable)
+{
+	enabled = enable;
+	if(!enabled) {
+		// Back to the nominal period, effects are restored on the next frame
+		period = nominal_period;
+		over_budget = 0;
+		under_budget = 0;
+	}
+}
+
+void LVGLFramePacer::set_nominal_period(uint32_t period_ms)
+{
+	if(period_ms == 0 || period_ms == nominal_period) {
+		return;
+	}
+
+	// Keep the stretch factor
+	uint32_t factor = (period + nominal_period - 1) / nominal_period;
+	nominal_period = period_ms;
+	period = nominal_period * factor;
+	if(period > max_period) {
+		period = nominal_period;
+		while((period + nominal_period) <= max_period) {
+			period += nominal_period;
+		}
+	}
+}
+
+void LVGLFramePacer::before_refresh(lv_task_t* task)
+{
+	uint32_t now = lv_tick_get();
+	if(last_refresh != 0) {
+		refresh_interval = now - last_refresh;
+	}
+	last_refresh = now;
+
+	if(period != applied_period) {
+		lv_task_set_period(task, period);
+		applied_period = period;
+	}
+}
+
+void LVGLFramePacer::frame_done(lv_disp_t* disp, uint32_t cost_ms)
+{
+	frames++;
+
+	cost_ms = (cost_ms > excluded_time) ? (cost_ms - excluded_time) : 0;
+	excluded_time = 0;
+
+	// Frames that should have been shown since the last refresh
+	if(refresh_interval != 0) {
+		uint32_t due = (refresh_interval + (nominal_period / 2)) / nominal_period;
+		if(due > 1) {
+			dropped_frames += due - 1;
+		}
+	}
+
+	// Smooth out single slow frames (eg: a screen load)
+	if(avg_cost_x8 == 0) {
+		avg_cost_x8 = cost_ms * 8;
+	} else {
+		avg_cost_x8 = ((avg_cost_x8 * 7) / 8) + cost_ms;
+	}
+
+	if(!enabled) {
+		if(mode == PACING_DEGRADED) {
+			set_degraded(disp, false);
+		}
+		mode = PACING_NOMINAL;
+		return;
+	}
+
+	// Over budget above 90% of the period, well under below 50% of it
+	uint32_t budget_x8 = period * 8;
+	if((avg_cost_x8 * 10) > (budget_x8 * 9)) {
+		under_budget = 0;
+		if(++over_budget >= PACING_ESCALATE_FRAMES) {
+			over_budget = 0;
+			escalate(disp);
+		}
+	} else if((avg_cost_x8 * 2) < budget_x8 && mode != PACING_NOMINAL) {
+		over_budget = 0;
+		if(++under_budget >= PACING_RELAX_FRAMES) {
+			under_budget = 0;
+			relax(disp);
+		}
+	} else {
+		over_budget = 0;
+		under_budget = 0;
+	}
+}
+
+void LVGLFramePacer::escalate(lv_disp_t* disp)
+{
+	// Smallest multiple of the nominal period that fits the cost with some headroom
+	uint32_t needed = ((avg_cost_x8 * 5) / 32) + 1;
+	uint32_t stretched = ((needed + nominal_period - 1) / nominal_period) * nominal_period;
+	if(stretched <= period) {
+		stretched = period + nominal_period;
+	}
+
+	if(stretched > max_period) {
+		// Largest multiple of the nominal period allowed
+		stretched = (max_period / nominal_period) * nominal_period;
+	}
+
+	if(stretched > period) {
+		period = stretched;
+		mode = PACING_STRETCHED;
+	} else if(mode != PACING_DEGRADED) {
+		// Can't slow down any further
+		set_degraded(disp, true);
+		mode = PACING_DEGRADED;
+	}
+}
+
+void LVGLFramePacer::relax(lv_disp_t* disp)
+{
+	if(mode == PACING_DEGRADED) {
+		set_degraded(disp, false);
+		mode = (period > nominal_period) ? PACING_STRETCHED : PACING_NOMINAL;
+		return;
+	}
+
+	period -= nominal_period;
+	if(period <= nominal_period) {
+		period = nominal_period;
+		mode = PACING_NOMINAL;
+	}
+}
+
+void LVGLFramePacer::set_degraded(lv_disp_t* disp, bool degrade)
+{
+#if LV_ANTIALIAS
+	if(degrade) {
+		saved_antialiasing = disp->driver.antialiasing;
+		disp->driver.antialiasing = 0;
+	} else {
+		disp->driver.antialiasing = saved_antialiasing;
+	}
+#endif
+
+	if(degrade_cb) {
+		degrade_cb(disp, degrade);
+	}
+
+	// Redraw everything with the new settings
+	lv_obj_invalidate(lv_disp_get_scr_act(disp));
+}
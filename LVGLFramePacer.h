@@ -0,0 +1,215 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_LVGLFRAMEPACER_H_
+#define MBED_LVGL_LVGLFRAMEPACER_H_
+
+#include <stdint.h>
+
+#include "lv_hal_disp.h"
+#include "lv_disp.h"
+#include "lv_task.h"
+
+#include "platform/Callback.h"
+#include "platform/NonCopyable.h"
+
+/**
+ * Adapts a display's refresh rate to what it can sustain
+ *
+ * lvgl refreshes a display on a fixed period (LV_DISP_DEF_REFR_PERIOD, or
+ * the panel's period when synchronized to TE). When rendering and flushing
+ * a frame costs more than that, the task handler falls behind and
+ * animations stutter. The pacer measures the cost of every frame (from
+ * lvgl's monitor callback) and, once the average stays over budget:
+ * 1. stretches the refresh period to a multiple of the nominal period that
+ *    fits the cost, so lvgl's time-based animations skip intermediate
+ *    frames at a steady rate instead of lagging,
+ * 2. when the period can't be stretched further, degrades rendering:
+ *    antialiasing is turned off and the application's degrade callback
+ *    can drop expensive effects (eg: shadows).
+ * Once frames are cheap again the steps are undone in reverse order.
+ * Frames that were not shown at the nominal rate are counted as dropped.
+ */
+class LVGLFramePacer : private mbed::NonCopyable<LVGLFramePacer>
+{
+	public:
+
+		/** Pacing mode */
+		typedef enum {
+			PACING_NOMINAL,		/** Refreshing at the nominal period */
+			PACING_STRETCHED,	/** Refresh period stretched */
+			PACING_DEGRADED,	/** Period at its maximum and effects degraded */
+		} mode_t;
+
+		/** Called when effects must be degraded (true) or can be restored (false) */
+		typedef mbed::Callback<void(lv_disp_t* disp, bool degraded)> degrade_callback_t;
+
+		LVGLFramePacer();
+
+		/**
+		 * Enables adaptive pacing (defaults to MBED_CONF_MBED_LVGL_ENABLE_ADAPTIVE_PACING)
+		 *
+		 * @note When disabled the display is refreshed at the nominal period
+		 */
+		void set_enabled(bool enable);
+
+		bool is_enabled(void) const {
+			return enabled;
+		}
+
+		/**
+		 * Sets the callback called when effects are degraded or restored
+		 */
+		void set_degrade_callback(degrade_callback_t callback) {
+			degrade_cb = callback;
+		}
+
+		/**
+		 * Sets the longest refresh period the pacer may stretch to
+		 */
+		void set_max_period(uint32_t period_ms) {
+			max_period = period_ms;
+		}
+
+		/**
+		 * Gets the current pacing mode
+		 */
+		mode_t get_mode(void) const {
+			return mode;
+		}
+
+		/**
+		 * Gets the current refresh period
+		 */
+		uint32_t get_period(void) const {
+			return period;
+		}
+
+		/**
+		 * Gets the average cost of a frame (render and flush)
+		 */
+		uint32_t get_average_cost(void) const {
+			return (avg_cost_x8 + 4) / 8;
+		}
+
+		/**
+		 * Gets the number of frames rendered since the last reset
+		 */
+		uint32_t get_frames(void) const {
+			return frames;
+		}
+
+		/**
+		 * Gets the number of frames dropped (not shown at the nominal rate) since the last reset
+		 */
+		uint32_t get_dropped_frames(void) const {
+			return dropped_frames;
+		}
+
+		/**
+		 * Resets the frame counters
+		 */
+		void reset_stats(void) {
+			frames = 0;
+			dropped_frames = 0;
+		}
+
+		/**
+		 * Sets the period the display is meant to refresh at (eg: the panel's)
+		 */
+		void set_nominal_period(uint32_t period_ms);
+
+		/**
+		 * Called right before lvgl's refresh task runs, applies the period
+		 *
+		 * @param[in] task lvgl's refresh task of the display
+		 */
+		void before_refresh(lv_task_t* task);
+
+		/**
+		 * Forgets when the display was last refreshed (eg: after the GUI was parked)
+		 */
+		void restart(void) {
+			last_refresh = 0;
+			refresh_interval = 0;
+		}
+
+		/**
+		 * Excludes time spent idle (eg: waiting for the frame sync) from the frame's cost
+		 */
+		void exclude_time(uint32_t ms) {
+			excluded_time += ms;
+		}
+
+		/**
+		 * Called after a frame was rendered and flushed
+		 *
+		 * @param[in] disp Display the frame was rendered on
+		 * @param[in] cost_ms Time spent rendering and flushing the frame
+		 */
+		void frame_done(lv_disp_t* disp, uint32_t cost_ms);
+
+	protected:
+
+		/** Moves to a more (escalate) or less degraded state */
+		void escalate(lv_disp_t* disp);
+		void relax(lv_disp_t* disp);
+
+		/** Degrades or restores effects */
+		void set_degraded(lv_disp_t* disp, bool degrade);
+
+	protected:
+
+		bool enabled;
+
+		mode_t mode;
+
+		/** Period the display is meant to refresh at */
+		uint32_t nominal_period;
+
+		/** Current and longest refresh periods */
+		uint32_t period;
+		uint32_t max_period;
+
+		/** Period applied to lvgl's task */
+		uint32_t applied_period;
+
+		/** Moving average of the frame cost, in 1/8 ms */
+		uint32_t avg_cost_x8;
+
+		/** Consecutive frames over budget, and well under budget */
+		uint16_t over_budget;
+		uint16_t under_budget;
+
+		/** Time lvgl's refresh task last ran, and the interval since the run before */
+		uint32_t last_refresh;
+		uint32_t refresh_interval;
+
+		/** Idle time to take off the cost of the current frame */
+		uint32_t excluded_time;
+
+		uint32_t frames;
+		uint32_t dropped_frames;
+
+		/** Display's antialiasing setting before degrading */
+		bool saved_antialiasing;
+
+		degrade_callback_t degrade_cb;
+
+};
+
+#endif /* MBED_LVGL_LVGLFRAMEPACER_H_ */
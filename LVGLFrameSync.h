@@ -0,0 +1,55 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_LVGLFRAMESYNC_H_
+#define MBED_LVGL_LVGLFRAMESYNC_H_
+
+#include <stdint.h>
+
+/**
+ * Source of a panel's frame synchronization events (eg: the TE or VSync signal)
+ *
+ * A display driver given a frame sync source waits for the start of the
+ * panel's next refresh before flushing the first strip of each frame, so
+ * the write to display RAM runs behind the panel's scan instead of racing
+ * it. LittlevGL also paces the display's refresh to the panel's period.
+ */
+class LVGLFrameSync
+{
+	public:
+
+		virtual ~LVGLFrameSync() { }
+
+		/**
+		 * Blocks until the panel starts a new refresh
+		 *
+		 * @param[in] timeout_ms Maximum time to wait
+		 *
+		 * @retval false if no event came in time
+		 */
+		virtual bool wait(uint32_t timeout_ms) = 0;
+
+		/**
+		 * Gets the panel's refresh period
+		 *
+		 * @retval period in microseconds, 0 if not known yet
+		 */
+		virtual uint32_t get_period_us(void) = 0;
+
+};
+
+#endif /* MBED_LVGL_LVGLFRAMESYNC_H_ */
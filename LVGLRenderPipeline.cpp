@@ -0,0 +1,208 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LVGLRenderPipeline.h"
+
+#if MBED_CONF_RTOS_PRESENT
+
+#include "LVGLDisplayDriver.h"
+
+#include "platform/mbed_assert.h"
+#include "platform/Callback.h"
+#include "platform/ScopedLock.h"
+#include "platform/trace.h"
+#include "hal/us_ticker_api.h"
+
+LVGLRenderPipeline::LVGLRenderPipeline(LVGLDisplayDriver& driver, lv_color_t* extra_buffer,
+		uint32_t buffer_size, size_t workers, size_t depth) :
+		driver(driver), disp_drv(NULL), mutex(), cond(mutex),
+		job_head(0), job_count(0), free_count(0), owned_count(0),
+		buffer_count((depth != 0) ? depth : (workers + 1)), submit_seq(0), flush_seq(0),
+		stats_seq_base(0), stats_flush_base(0), max_in_flight(0), stalls(0), stall_time_us(0),
+		worker_count(workers), stopping(false)
+{
+	MBED_ASSERT(workers > 0);
+	MBED_ASSERT(buffer_count >= 2);
+
+	jobs = new job_t[buffer_count];
+	free_buffers = new lv_color_t*[buffer_count];
+	owned_buffers = new lv_color_t*[buffer_count];
+
+	// lvgl is rendering into the first buffer, everything else starts out free
+	if(extra_buffer != NULL) {
+		free_buffers[free_count++] = extra_buffer;
+	}
+	while(free_count < (buffer_count - 1)) {
+		lv_color_t* buf = new lv_color_t[buffer_size];
+		owned_buffers[owned_count++] = buf;
+		free_buffers[free_count++] = buf;
+	}
+
+	this->workers = new rtos::Thread*[worker_count];
+	for(size_t i = 0; i < worker_count; i++) {
+		this->workers[i] = new rtos::Thread(osPriorityNormal,
+				MBED_CONF_MBED_LVGL_RENDER_WORKER_STACK_SIZE, NULL, "lvgl_render");
+		this->workers[i]->start(mbed::callback(this, &LVGLRenderPipeline::work));
+	}
+}
+
+LVGLRenderPipeline::~LVGLRenderPipeline()
+{
+	sync();
+
+	mutex.lock();
+	stopping = true;
+	cond.notify_all();
+	mutex.unlock();
+
+	for(size_t i = 0; i < worker_count; i++) {
+		workers[i]->join();
+		delete workers[i];
+	}
+	delete[] workers;
+
+	for(size_t i = 0; i < owned_count; i++) {
+		delete[] owned_buffers[i];
+	}
+	delete[] owned_buffers;
+	delete[] free_buffers;
+	delete[] jobs;
+}
+
+lv_color_t* LVGLRenderPipeline::submit(lv_disp_drv_t* disp_drv, const lv_area_t* area, lv_color_t* color_p,
+		bool frame_start)
+{
+	mbed::ScopedLock<rtos::Mutex> lock(mutex);
+
+	this->disp_drv = disp_drv;
+
+	// There is always room, every job holds one of the buffers
+	MBED_ASSERT(job_count < buffer_count);
+	job_t* job = &jobs[(job_head + job_count) % buffer_count];
+	lv_area_copy(&job->area, area);
+	job->buffer = color_p;
+	job->seq = submit_seq++;
+	job->frame_start = frame_start;
+	job_count++;
+	cond.notify_all();
+	MBED_LVGL_TRACE_COUNTER("pipeline_queue", job_count);
+
+	size_t in_flight = submit_seq - flush_seq;
+	if(in_flight > max_in_flight) {
+		max_in_flight = in_flight;
+	}
+
+	// Wait for a buffer to render the next strip into
+	if(free_count == 0) {
+		uint64_t start = ticker_read_us(get_us_ticker_data());
+		while(free_count == 0) {
+			cond.wait();
+		}
+		stalls++;
+		stall_time_us += (uint32_t)(ticker_read_us(get_us_ticker_data()) - start);
+	}
+
+	return free_buffers[--free_count];
+}
+
+void LVGLRenderPipeline::get_stats(stats_t& stats)
+{
+	mbed::ScopedLock<rtos::Mutex> lock(mutex);
+	stats.submitted = submit_seq - stats_seq_base;
+	stats.flushed = flush_seq - stats_flush_base;
+	stats.queue_depth = submit_seq - flush_seq;
+	stats.max_queue_depth = max_in_flight;
+	stats.buffer_count = buffer_count;
+	stats.stalls = stalls;
+	stats.stall_time_us = stall_time_us;
+}
+
+void LVGLRenderPipeline::reset_stats(void)
+{
+	mbed::ScopedLock<rtos::Mutex> lock(mutex);
+	stats_seq_base = submit_seq;
+	stats_flush_base = flush_seq;
+	max_in_flight = submit_seq - flush_seq;
+	stalls = 0;
+	stall_time_us = 0;
+}
+
+void LVGLRenderPipeline::sync(void)
+{
+	mbed::ScopedLock<rtos::Mutex> lock(mutex);
+	while(flush_seq != submit_seq) {
+		cond.wait();
+	}
+}
+
+void LVGLRenderPipeline::work(void)
+{
+#if MBED_CONF_MBED_LVGL_ENABLE_TRACE
+	mbed_lvgl_trace_name_thread("render worker");
+#endif
+
+	mutex.lock();
+
+	while(true) {
+
+		while(job_count == 0 && !stopping) {
+			cond.wait();
+		}
+
+		if(job_count == 0) {
+			break;
+		}
+
+		job_t job = jobs[job_head];
+		job_head = (job_head + 1) % buffer_count;
+		job_count--;
+		mutex.unlock();
+
+		// Strips are prepared concurrently...
+		MBED_LVGL_TRACE_BEGIN("prepare");
+		driver.prepare(disp_drv, &job.area, job.buffer);
+		MBED_LVGL_TRACE_END("prepare");
+
+		// ...but flushed in the order they were rendered
+		mutex.lock();
+		while(job.seq != flush_seq) {
+			cond.wait();
+		}
+		mutex.unlock();
+
+		if(job.frame_start) {
+			MBED_LVGL_TRACE_BEGIN("frame_sync");
+			driver.wait_frame_sync();
+			MBED_LVGL_TRACE_END("frame_sync");
+		}
+
+		MBED_LVGL_TRACE_BEGIN_ARG("flush", lv_area_get_size(&job.area));
+		LVGLFlushDescriptor desc(job.buffer, &job.area, false);
+		desc.add_region(&job.area);
+		driver.flush_regions(disp_drv, desc);
+		MBED_LVGL_TRACE_END("flush");
+
+		mutex.lock();
+		flush_seq++;
+		free_buffers[free_count++] = job.buffer;
+		cond.notify_all();
+	}
+
+	mutex.unlock();
+}
+
+#endif /* MBED_CONF_RTOS_PRESENT */
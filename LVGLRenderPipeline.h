@@ -0,0 +1,172 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_LVGLRENDERPIPELINE_H_
+#define MBED_LVGL_LVGLRENDERPIPELINE_H_
+
+#if MBED_CONF_RTOS_PRESENT
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lv_color.h"
+#include "lv_area.h"
+#include "lv_hal_disp.h"
+
+#include "platform/NonCopyable.h"
+#include "rtos/Mutex.h"
+#include "rtos/ConditionVariable.h"
+#include "rtos/Thread.h"
+
+class LVGLDisplayDriver;
+
+/**
+ * Hands rendered strips off to a pool of worker threads
+ *
+ * lvgl's rasterizer keeps its drawing state in globals, so strips are
+ * still rasterized one at a time on the GUI thread. As soon as a strip
+ * is rendered it is handed to a worker along with its draw buffer and
+ * lvgl moves on to the next strip in another buffer. Workers run the
+ * driver's prepare stage (eg: color conversion) concurrently, then
+ * flush the strips to the display strictly in the order they were rendered.
+ *
+ * Draw buffers form a ring: lvgl renders into one while the others
+ * hold strips waiting to be prepared or flushed, so the renderer can run
+ * several strips ahead of a slow bus. When all buffers are in flight the
+ * GUI thread waits for the oldest strip to be flushed (backpressure).
+ * Queue depth and stall statistics are kept to help size the ring.
+ */
+class LVGLRenderPipeline : private mbed::NonCopyable<LVGLRenderPipeline>
+{
+	public:
+
+		/**
+		 * Instantiate an LVGLRenderPipeline
+		 *
+		 * @param[in] driver Display driver whose strips are prepared and flushed
+		 * @param[in] extra_buffer (optional) Another draw buffer provided by the driver, or NULL
+		 * @param[in] buffer_size Size of each draw buffer in pixels
+		 * @param[in] workers Number of worker threads
+		 * @param[in] depth (optional) Number of draw buffers in the ring, 0 for one per worker plus one for lvgl
+		 */
+		LVGLRenderPipeline(LVGLDisplayDriver& driver, lv_color_t* extra_buffer,
+				uint32_t buffer_size, size_t workers, size_t depth = 0);
+
+		/**
+		 * Waits for all pending strips to be flushed and stops the workers
+		 */
+		~LVGLRenderPipeline();
+
+		/**
+		 * Queues a rendered strip for preparation and flushing
+		 *
+		 * @param[in] disp_drv lvgl display driver of the strip
+		 * @param[in] area Area of the display covered by the strip (copied)
+		 * @param[in] color_p Draw buffer holding the strip
+		 * @param[in] frame_start (optional) true if the strip must wait for the frame sync before it is flushed
+		 *
+		 * @retval Draw buffer lvgl should render the next strip into
+		 *
+		 * @note Called from the GUI thread, blocks while no draw buffer is free
+		 */
+		lv_color_t* submit(lv_disp_drv_t* disp_drv, const lv_area_t* area, lv_color_t* color_p,
+				bool frame_start = false);
+
+		/**
+		 * Blocks until every queued strip has been flushed
+		 */
+		void sync(void);
+
+		/** Pipeline statistics */
+		typedef struct {
+			uint32_t submitted;		/** Strips submitted by lvgl */
+			uint32_t flushed;		/** Strips flushed to the display */
+			size_t queue_depth;		/** Strips currently waiting to be prepared or flushed */
+			size_t max_queue_depth;	/** High-water mark of queue_depth */
+			size_t buffer_count;	/** Number of draw buffers in the ring */
+			uint32_t stalls;		/** Number of times lvgl had to wait for a free buffer */
+			uint32_t stall_time_us;	/** Total time lvgl spent waiting for a free buffer */
+		} stats_t;
+
+		/**
+		 * Gets a snapshot of the pipeline statistics
+		 *
+		 * @param[out] stats Statistics
+		 */
+		void get_stats(stats_t& stats);
+
+		/**
+		 * Resets the pipeline statistics (counters and high-water marks)
+		 */
+		void reset_stats(void);
+
+	protected:
+
+		/** Rendered strip waiting for a worker */
+		typedef struct {
+			lv_area_t area;
+			lv_color_t* buffer;
+			uint32_t seq;
+			bool frame_start;
+		} job_t;
+
+		/** Worker thread body */
+		void work(void);
+
+	protected:
+
+		LVGLDisplayDriver& driver;
+		lv_disp_drv_t* disp_drv;
+
+		rtos::Mutex mutex;
+		rtos::ConditionVariable cond;
+
+		/** Strips waiting for a worker (ring) */
+		job_t* jobs;
+		size_t job_head;
+		size_t job_count;
+
+		/** Draw buffers not currently in use */
+		lv_color_t** free_buffers;
+		size_t free_count;
+
+		/** Draw buffers allocated by the pipeline */
+		lv_color_t** owned_buffers;
+		size_t owned_count;
+
+		size_t buffer_count;
+
+		/** Sequence number of the next strip to submit and to flush */
+		uint32_t submit_seq;
+		uint32_t flush_seq;
+
+		/** Statistics (counters are relative to the last reset) */
+		uint32_t stats_seq_base;
+		uint32_t stats_flush_base;
+		size_t max_in_flight;
+		uint32_t stalls;
+		uint32_t stall_time_us;
+
+		rtos::Thread** workers;
+		size_t worker_count;
+		bool stopping;
+
+};
+
+#endif /* MBED_CONF_RTOS_PRESENT */
+
+#endif /* MBED_LVGL_LVGLRENDERPIPELINE_H_ */
@@ -21,12 +21,52 @@
 #include "platform/mbed_debug.h"
 #include "platform/Callback.h"
 
+#include "lv_refr.h"
+
+#include "platform/trace.h"
+
+#if MBED_CONF_RTOS_PRESENT || MBED_CONF_MBED_LVGL_ENABLE_TASK_PROFILER
+#include "lv_gc.h"
+#include "lv_ll.h"
+#include "lv_indev.h"
+#endif
+
+#if MBED_CONF_RTOS_PRESENT
+
+#include "rtos/Kernel.h"
+
+/** Event flag set by wake() */
+#define IDLE_WAKE_FLAG		0x1
+#endif
+
+#if MBED_CONF_MBED_LVGL_ENABLE_RLE_DECODER
+#include "decoders/RLEImageDecoder.h"
+#endif
+
+lv_task_cb_t LittlevGL::refresh_task_cb = NULL;
+
 LittlevGL::LittlevGL() :
-		initialized(false), ticker()
+		initialized(false), ticking(false), ticker(), frame_hooks(NULL), refreshing(false)
+#if MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING
+		, render_mem_tag(MBED_LVGL_MEM_UNTAGGED), mem_telemetry(NULL), mem_telemetry_cb(NULL)
+#endif
+#if MBED_CONF_RTOS_PRESENT
+		, idle_parking(MBED_CONF_MBED_LVGL_ENABLE_IDLE_PARKING), idle_timeout(MBED_CONF_MBED_LVGL_IDLE_TIMEOUT),
+		idle_state(IDLE_ACTIVE), last_busy(0), idle_time(0), idle_count(0), system_task_count(0)
+#endif
+#if MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT && MBED_CONF_MBED_LVGL_ENABLE_PREFETCH
+		, asset_cache(NULL), prefetcher(NULL)
+#endif
 { }
 
 LittlevGL::~LittlevGL()
-{ }
+{
+#if MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT && MBED_CONF_MBED_LVGL_ENABLE_PREFETCH
+	mbed_lvgl_fs_wrapper_set_cache(NULL, NULL);
+	delete prefetcher;
+	delete asset_cache;
+#endif
+}
 
 LittlevGL& LittlevGL::get_instance(void) {
 	static LittlevGL* singleton;
@@ -38,8 +78,38 @@ LittlevGL& LittlevGL::get_instance(void) {
 
 void LittlevGL::init()
 {
+#if MBED_CONF_MBED_LVGL_ENABLE_TRACE
+	mbed_lvgl_trace_name_thread("gui");
+#endif
+
 	// Initialize LittlevGL
 	lv_init();
+
+#if MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING
+	render_mem_tag = mbed_lvgl_mem_register_tag("render");
+#endif
+
+#if MBED_CONF_RTOS_PRESENT
+	// Remember lvgl's own tasks, they don't keep the GUI from parking
+	lv_task_t* task = (lv_task_t*) lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll));
+	while(task != NULL && system_task_count < (sizeof(system_tasks) / sizeof(system_tasks[0]))) {
+		system_tasks[system_task_count++] = task;
+		task = (lv_task_t*) lv_ll_get_next(&LV_GC_ROOT(_lv_task_ll), task);
+	}
+#endif
+
+#if MBED_CONF_MBED_LVGL_ENABLE_TASK_PROFILER
+	lv_task_t* lvgl_task = (lv_task_t*) lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll));
+	for(; lvgl_task != NULL; lvgl_task = (lv_task_t*) lv_ll_get_next(&LV_GC_ROOT(_lv_task_ll), lvgl_task)) {
+		TaskProfiler::set_task_name(lvgl_task, "lvgl");
+	}
+#endif
+
+#if MBED_CONF_MBED_LVGL_ENABLE_RLE_DECODER
+	// Register the compressed image decoder
+	RLEImageDecoder::register_decoder();
+#endif
+
 	initialized = true;
 }
 
@@ -48,6 +118,11 @@ void LittlevGL::add_display_driver(LVGLDisplayDriver& driver) {
 	lv_disp_drv_t disp_drv;
 	lv_disp_drv_init(&disp_drv);
 
+#if MBED_CONF_RTOS_PRESENT
+	// Start the render workers (if enabled) before lvgl sees the buffers
+	driver.create_pipeline();
+#endif
+
 	// Set the resolution
 	driver.get_resolution(&disp_drv.hor_res, &disp_drv.ver_res);
 
@@ -60,24 +135,22 @@ void LittlevGL::add_display_driver(LVGLDisplayDriver& driver) {
 	// This class's flush implementation delegates to the correct display driver instance
 	disp_drv.flush_cb = &LittlevGL::flush;
 
-#if USE_LV_GPU
+#if LV_USE_GPU
 
 	disp_drv.gpu_blend_cb = &LittlevGL::gpu_blend;
 	disp_drv.gpu_fill_cb = &LittlevGL::gpu_fill;
 
 #endif
 
-	if(driver.has_rounder()) {
-		disp_drv.rounder_cb = &LittlevGL::round_lv_area;
-	}
+	// Always installed, frame hooks are told about invalidated areas from it
+	disp_drv.rounder_cb = &LittlevGL::round_lv_area;
 
 	if(driver.has_pix_write_func()) {
 		disp_drv.set_px_cb = &LittlevGL::set_pixel;
 	}
 
-#if MBED_CONF_MBED_LVGL_ENABLE_FLUSH_MONITORING
+	// Frame costs drive the adaptive frame pacer
 	disp_drv.monitor_cb = &LittlevGL::monitor;
-#endif
 
 	lv_disp_t * disp;
 	disp = lv_disp_drv_register(&disp_drv); /*Register the driver and save the created display objects*/
@@ -87,6 +160,14 @@ void LittlevGL::add_display_driver(LVGLDisplayDriver& driver) {
 
 	driver.set_lv_disp_obj(disp);
 
+	// Run the frame hooks right before each refresh of the display
+	refresh_task_cb = disp->refr_task->task_cb;
+	disp->refr_task->task_cb = &LittlevGL::refresh;
+
+#if MBED_CONF_MBED_LVGL_ENABLE_TASK_PROFILER
+	TaskProfiler::set_task_name(disp->refr_task, "refresh");
+#endif
+
 }
 
 void LittlevGL::set_default_display(LVGLDisplayDriver& driver) {
@@ -98,17 +179,237 @@ void LittlevGL::set_default_display(LVGLDisplayDriver& driver) {
 void LittlevGL::start(void)
 {
 	ticker.attach_us(mbed::callback(this, &LittlevGL::tick), 1000);
+	ticking = true;
 }
 
 void LittlevGL::stop(void)
 {
 	ticker.detach();
+	ticking = false;
 }
 
 void LittlevGL::update(void)
 {
+#if MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT && MBED_CONF_MBED_LVGL_ENABLE_PREFETCH
+	// Deliver prefetch completions on the GUI thread
+	if(prefetcher != NULL) {
+		prefetcher->dispatch();
+	}
+#endif
+
+#if MBED_CONF_MBED_LVGL_ENABLE_TASK_PROFILER
+	// Pick up tasks created since the last update
+	TaskProfiler::attach();
+#endif
+
+	MBED_LVGL_TRACE_BEGIN("lv_task_handler");
 	lv_task_handler();
+	MBED_LVGL_TRACE_END("lv_task_handler");
+
+#if MBED_CONF_RTOS_PRESENT
+	if(idle_parking) {
+		idle_step();
+	}
+#endif
+}
+
+#if MBED_CONF_RTOS_PRESENT
+void LittlevGL::set_idle_parking(bool enable, uint32_t timeout_ms)
+{
+	idle_parking = enable;
+	idle_timeout = timeout_ms;
+	last_busy = lv_tick_get();
+}
+
+void LittlevGL::wake(void)
+{
+	idle_flags.set(IDLE_WAKE_FLAG);
+}
+
+void LittlevGL::idle_step(void)
+{
+	uint32_t park_ms;
+	if(!is_idle(&park_ms)) {
+		last_busy = lv_tick_get();
+		return;
+	}
+
+	if(lv_tick_elaps(last_busy) < idle_timeout) {
+		return;
+	}
+
+	// Nothing to do: stop ticking until woken up or an application task is due
+	idle_state = IDLE_PARKED;
+	bool was_ticking = ticking;
+	if(was_ticking) {
+		stop();
+	}
+
+	uint64_t parked_at = rtos::Kernel::get_ms_count();
+	idle_flags.wait_any(IDLE_WAKE_FLAG, park_ms);
+	uint32_t parked = (uint32_t)(rtos::Kernel::get_ms_count() - parked_at);
+
+	// Catch lvgl's tick up with the time spent parked, an application
+	// driving the tick itself kept it running meanwhile
+	if(was_ticking) {
+		lv_tick_inc(parked);
+		start();
+	}
+
+	idle_state = IDLE_ACTIVE;
+	idle_time += parked;
+	idle_count++;
+	last_busy = lv_tick_get();
+
+	// The gap is not a frame drop
+	for(lv_disp_t* disp = lv_disp_get_next(NULL); disp != NULL; disp = lv_disp_get_next(disp)) {
+		LVGLDisplayDriver* driver = (LVGLDisplayDriver*)(disp->driver.user_data);
+		driver->get_frame_pacer().restart();
+	}
+}
+
+bool LittlevGL::is_idle(uint32_t* park_ms)
+{
+	// Areas waiting to be redrawn
+	for(lv_disp_t* disp = lv_disp_get_next(NULL); disp != NULL; disp = lv_disp_get_next(disp)) {
+		if(disp->inv_p != 0) {
+			return false;
+		}
+	}
+
+#if LV_USE_ANIMATION
+	if(lv_anim_count_running() != 0) {
+		return false;
+	}
+#endif
+
+	// Recent input on any display
+	if(lv_disp_get_inactive_time(NULL) < idle_timeout) {
+		return false;
+	}
+
+	// Application tasks bound the time the GUI can stay parked
+	*park_ms = osWaitForever;
+	lv_task_t* task = (lv_task_t*) lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll));
+	for(; task != NULL; task = (lv_task_t*) lv_ll_get_next(&LV_GC_ROOT(_lv_task_ll), task)) {
+#if MBED_CONF_MBED_LVGL_ENABLE_TASK_PROFILER
+		lv_task_cb_t task_cb = TaskProfiler::get_task_cb(task);
+#else
+		lv_task_cb_t task_cb = task->task_cb;
+#endif
+		if(task->prio == LV_TASK_PRIO_OFF || task_cb == &LittlevGL::refresh
+				|| task_cb == &lv_indev_read_task) {
+			continue;
+		}
+
+		bool system_task = false;
+		for(size_t i = 0; i < system_task_count; i++) {
+			system_task |= (system_tasks[i] == task);
+		}
+		if(system_task) {
+			continue;
+		}
+
+		uint32_t elapsed = lv_tick_elaps(task->last_run);
+		if(elapsed >= task->period) {
+			return false;
+		}
+		if((task->period - elapsed) < *park_ms) {
+			*park_ms = task->period - elapsed;
+		}
+	}
+
+	return true;
 }
+#endif
+
+void LittlevGL::add_frame_hook(LVGLFrameHook& hook)
+{
+	hook.next_hook = frame_hooks;
+	frame_hooks = &hook;
+}
+
+void LittlevGL::remove_frame_hook(LVGLFrameHook& hook)
+{
+	LVGLFrameHook** link = &frame_hooks;
+	while(*link != NULL) {
+		if(*link == &hook) {
+			*link = hook.next_hook;
+			hook.next_hook = NULL;
+			return;
+		}
+		link = &(*link)->next_hook;
+	}
+}
+
+void LittlevGL::refresh(lv_task_t* task)
+{
+	LittlevGL& instance = LittlevGL::get_instance();
+	lv_disp_t* disp = (lv_disp_t*) task->user_data;
+
+	for(LVGLFrameHook* hook = instance.frame_hooks; hook != NULL; hook = hook->next_hook) {
+		hook->before_refresh(disp);
+	}
+
+	LVGLDisplayDriver* driver = (LVGLDisplayDriver*)(disp->driver.user_data);
+	LVGLFramePacer& pacer = driver->get_frame_pacer();
+	LVGLFrameSync* sync = driver->get_frame_sync();
+	if(sync != NULL) {
+		// Refresh at (a multiple of) the panel's rate
+		pacer.set_nominal_period(sync->get_period_us() / 1000);
+	}
+	pacer.before_refresh(task);
+	driver->start_frame();
+
+	// Rendering runs from here to the first flush and between flushes
+	MBED_LVGL_TRACE_BEGIN("refresh");
+	MBED_LVGL_TRACE_BEGIN("render");
+	instance.refreshing = true;
+#if MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING
+	{
+		LVGLMemTag tag(instance.render_mem_tag);
+		refresh_task_cb(task);
+	}
+#else
+	refresh_task_cb(task);
+#endif
+	instance.refreshing = false;
+	MBED_LVGL_TRACE_END("render");
+	MBED_LVGL_TRACE_END("refresh");
+
+	for(LVGLFrameHook* hook = instance.frame_hooks; hook != NULL; hook = hook->next_hook) {
+		hook->after_refresh(disp);
+	}
+}
+
+#if MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING
+void LittlevGL::set_mem_telemetry(mem_telemetry_callback_t callback, uint32_t period_ms)
+{
+	mem_telemetry_cb = callback;
+
+	if(!callback) {
+		if(mem_telemetry != NULL) {
+			lv_task_del(mem_telemetry);
+			mem_telemetry = NULL;
+		}
+		return;
+	}
+
+	if(mem_telemetry == NULL) {
+		mem_telemetry = lv_task_create(&LittlevGL::mem_telemetry_task, period_ms, LV_TASK_PRIO_LOWEST, NULL);
+	} else {
+		lv_task_set_period(mem_telemetry, period_ms);
+	}
+}
+
+void LittlevGL::mem_telemetry_task(lv_task_t* task)
+{
+	LittlevGL& instance = LittlevGL::get_instance();
+	mbed_lvgl_mem_stats_t stats;
+	mbed_lvgl_mem_get_stats(&stats);
+	instance.mem_telemetry_cb(stats);
+}
+#endif
 
 #if MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM
 void LittlevGL::filesystem_ready(void)
@@ -121,6 +422,19 @@ void LittlevGL::filesystem_ready(void)
 		mbed_lvgl_fs_wrapper_default(&fs_drv);
 		fs_drv.letter = 'M';
 		lv_fs_drv_register(&fs_drv);
+
+#if MBED_CONF_RTOS_PRESENT && MBED_CONF_MBED_LVGL_ENABLE_PREFETCH
+		// Serve prefetched assets straight out of RAM
+		if(asset_cache == NULL) {
+			asset_cache = new AssetCache(MBED_CONF_MBED_LVGL_PREFETCH_CACHE_SIZE,
+					MBED_CONF_MBED_LVGL_PREFETCH_CACHE_ENTRIES);
+			prefetcher = new AssetPrefetcher(*asset_cache);
+			// Completions run from update(), which may be parked waiting for work
+			prefetcher->set_pending_callback(mbed::callback(this, &LittlevGL::wake));
+		}
+		mbed_lvgl_fs_wrapper_set_cache(&LittlevGL::asset_cache_acquire,
+				&LittlevGL::asset_cache_release);
+#endif
 	}
 	else
 	{
@@ -130,6 +444,40 @@ void LittlevGL::filesystem_ready(void)
 }
 #endif
 
+#if MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT && MBED_CONF_MBED_LVGL_ENABLE_PREFETCH
+void LittlevGL::prefetch(std::initializer_list<const char*> paths,
+		AssetPrefetcher::callback_t callback)
+{
+	if(prefetcher == NULL) {
+		debug("LittlevGL: assets cannot be prefetched before the filesystem is ready\n");
+		return;
+	}
+
+	for(const char* path : paths) {
+		prefetcher->prefetch(path, callback);
+	}
+}
+
+void LittlevGL::clear_prefetched(void)
+{
+	if(asset_cache != NULL) {
+		asset_cache->clear();
+	}
+}
+
+bool LittlevGL::asset_cache_acquire(const char* fn, const uint8_t** data, uint32_t* size)
+{
+	LittlevGL& instance = LittlevGL::get_instance();
+	return instance.asset_cache->acquire(fn, data, size);
+}
+
+void LittlevGL::asset_cache_release(const uint8_t* data)
+{
+	LittlevGL& instance = LittlevGL::get_instance();
+	instance.asset_cache->release(data);
+}
+#endif
+
 void LittlevGL::tick(void)
 {
 	lv_tick_inc(1);
@@ -141,29 +489,78 @@ void LittlevGL::flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color
 	LVGLDisplayDriver* driver = (LVGLDisplayDriver*)(disp_drv->user_data);
 	MBED_ASSERT(driver != NULL);
 
-	// Call the driver's flush function
-	driver->flush(disp_drv, area, color_p);
+	MBED_LVGL_TRACE_END("render");
+
+#if MBED_CONF_RTOS_PRESENT
+	LVGLRenderPipeline* pipeline = driver->get_pipeline();
+	if(pipeline != NULL) {
+		// Hand the strip to a worker and let lvgl render the next one into a free buffer
+		MBED_LVGL_TRACE_BEGIN("submit");
+		lv_color_t* next = pipeline->submit(disp_drv, area, color_p, driver->take_frame_start());
+		MBED_LVGL_TRACE_END("submit");
+		lv_disp_buf_t* buf = disp_drv->buffer;
+		buf->buf1 = next;
+		buf->buf_act = next;
+		lv_disp_flush_ready(disp_drv);
+		MBED_LVGL_TRACE_BEGIN("render");
+		return;
+	}
+#endif
+
+	// Start writing the frame right behind the panel's scan
+	if(driver->take_frame_start()) {
+		uint32_t wait_start = lv_tick_get();
+		MBED_LVGL_TRACE_BEGIN("frame_sync");
+		driver->wait_frame_sync();
+		MBED_LVGL_TRACE_END("frame_sync");
+		driver->get_frame_pacer().exclude_time(lv_tick_elaps(wait_start));
+	}
+
+	MBED_LVGL_TRACE_BEGIN_ARG("flush", lv_area_get_size(area));
+	lv_disp_t* disp = lv_refr_get_disp_refreshing();
+	if(disp != NULL && lv_disp_is_true_double_buf(disp)) {
+		// lvgl flushes full frames once per refresh, only send the areas that were redrawn
+		LVGLFlushDescriptor desc(color_p, area, true);
+		for(uint32_t i = 0; i < disp->inv_p; i++) {
+			if(disp->inv_area_joined[i] == 0) {
+				desc.add_region(&disp->inv_areas[i]);
+			}
+		}
+		driver->flush_regions(disp_drv, desc);
+	} else {
+		// Call the driver's prepare and flush functions
+		LVGLFlushDescriptor desc(color_p, area, false);
+		desc.add_region(area);
+		driver->prepare(disp_drv, area, color_p);
+		driver->flush_regions(disp_drv, desc);
+	}
+	MBED_LVGL_TRACE_END("flush");
 
 	// Tell lvgl flush is done
 	lv_disp_flush_ready(disp_drv);
+	MBED_LVGL_TRACE_BEGIN("render");
 }
 
-#if USE_LV_GPU
+#if LV_USE_GPU
 
-void LittlevGL::gpu_blend(lv_color_t* dest, const lv_color_t* src, uint32_t length, lv_opt_t opa)
+void LittlevGL::gpu_blend(lv_disp_drv_t * disp_drv, lv_color_t * dest, const lv_color_t * src, uint32_t length,
+		lv_opa_t opa)
 {
-	LittlevGL& instance = LittlevGL::get_instance();
-	if(instance._driver != NULL) {
-		instance._driver->gpu_blend(dest, src, length, opa);
-	}
+	// Retrieve the C++ display driver instance (stored in user_data)
+	LVGLDisplayDriver* driver = (LVGLDisplayDriver*)(disp_drv->user_data);
+	MBED_ASSERT(driver != NULL);
+
+	driver->gpu_blend(disp_drv, dest, src, length, opa);
 }
 
-void LittlevGL::gpu_fill(lv_color_t* dest, uint32_t length, lv_color_t color)
-{NoritakeLVGL
-	LittlevGL& instance = LittlevGL::get_instance();
-	if(instance._driver != NULL) {
-		instance._driver->gpu_fill(dest, length, color);
-	}
+void LittlevGL::gpu_fill(lv_disp_drv_t * disp_drv, lv_color_t * dest_buf, lv_coord_t dest_width,
+		const lv_area_t * fill_area, lv_color_t color)
+{
+	// Retrieve the C++ display driver instance (stored in user_data)
+	LVGLDisplayDriver* driver = (LVGLDisplayDriver*)(disp_drv->user_data);
+	MBED_ASSERT(driver != NULL);
+
+	driver->gpu_fill(disp_drv, dest_buf, dest_width, fill_area, color);
 }
 
 #endif
@@ -173,7 +570,18 @@ void LittlevGL::round_lv_area(lv_disp_drv_t* disp_drv, lv_area_t* area) {
 	LVGLDisplayDriver* driver = (LVGLDisplayDriver*)(disp_drv->user_data);
 	MBED_ASSERT(driver != NULL);
 
-	driver->round_lv_area(disp_drv, area);
+	// lvgl also rounds areas while refreshing, only report invalidations
+	LittlevGL& instance = LittlevGL::get_instance();
+	lv_disp_t* disp = driver->get_lv_disp_obj();
+	if(!instance.refreshing && disp != NULL) {
+		for(LVGLFrameHook* hook = instance.frame_hooks; hook != NULL; hook = hook->next_hook) {
+			hook->on_invalidate(disp, area);
+		}
+	}
+
+	if(driver->has_rounder()) {
+		driver->round_lv_area(disp_drv, area);
+	}
 
 }
 
@@ -188,11 +596,16 @@ void LittlevGL::set_pixel(lv_disp_drv_t* disp_drv, uint8_t* buf,
 }
 
 void LittlevGL::monitor(lv_disp_drv_t* disp_drv, uint32_t time, uint32_t px) {
-#if MBED_CONF_MBED_LVGL_ENABLE_FLUSH_MONITORING
 	// Retrieve the C++ display driver instance (stored in user_data)
 	LVGLDisplayDriver* driver = (LVGLDisplayDriver*)(disp_drv->user_data);
 	MBED_ASSERT(driver != NULL);
 
+	lv_disp_t* disp = driver->get_lv_disp_obj();
+	if(disp != NULL) {
+		driver->get_frame_pacer().frame_done(disp, time);
+	}
+
+#if MBED_CONF_MBED_LVGL_ENABLE_FLUSH_MONITORING
 	driver->monitor(disp_drv, time, px);
 #endif
 }
@@ -20,10 +20,24 @@
 #define LVGL_LITTLEVGL_H_
 
 #include <LVGLDisplayDriver.h>
+#include <LVGLFrameHook.h>
 
 #include "platform/NonCopyable.h"
 #include "drivers/Ticker.h"
 
+#if MBED_CONF_RTOS_PRESENT
+#include "rtos/EventFlags.h"
+#endif
+
+#if MBED_CONF_MBED_LVGL_ENABLE_TASK_PROFILER
+#include "platform/TaskProfiler.h"
+#endif
+
+#if MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING
+#include "platform/Callback.h"
+#include "platform/mem_accounting.h"
+#endif
+
 #include "lv_hal_disp.h"
 #include "lv_task.h"
 #include "lv_obj.h"
@@ -32,10 +46,27 @@
 #include "platform/filesystem_wrapper.h"
 #endif
 
+#if MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT && MBED_CONF_MBED_LVGL_ENABLE_PREFETCH
+#include <initializer_list>
+#include "platform/AssetCache.h"
+#include "platform/AssetPrefetcher.h"
+#endif
+
 class LittlevGL : private mbed::NonCopyable<LittlevGL>
 {
 	public:
 
+#if MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING
+		/** Called with a snapshot of lvgl's heap usage */
+		typedef mbed::Callback<void(const mbed_lvgl_mem_stats_t& stats)> mem_telemetry_callback_t;
+#endif
+
+		/** State of the idle state machine */
+		typedef enum {
+			IDLE_ACTIVE,	/** Ticking and refreshing */
+			IDLE_PARKED,	/** Ticker stopped, update() blocked until woken */
+		} idle_state_t;
+
 		virtual ~LittlevGL();
 
 		/**
@@ -87,9 +118,101 @@ class LittlevGL : private mbed::NonCopyable<LittlevGL>
 		/**
 		 * Updates the LitteVGL graphics system
 		 * @note This should be called by the application every 1 to 10ms
+		 * @note With idle parking enabled, this blocks while the GUI is idle
 		 */
 		void update(void);
 
+#if MBED_CONF_RTOS_PRESENT
+		/**
+		 * Enables parking the GUI when it is idle
+		 *
+		 * Once no display has invalid areas, no animation runs and there was
+		 * no input activity for the idle timeout, update() stops the tick
+		 * and blocks until wake() is called or an application lv_task is due.
+		 * lvgl's tick is then advanced by the time spent parked.
+		 *
+		 * @param[in] enable true to park the GUI when idle
+		 * @param[in] timeout_ms (optional) Idle time before parking
+		 *
+		 * @note Input devices are not polled while parked, their drivers
+		 * must call wake() (eg: from a touch interrupt)
+		 */
+		void set_idle_parking(bool enable, uint32_t timeout_ms = MBED_CONF_MBED_LVGL_IDLE_TIMEOUT);
+
+		/**
+		 * Wakes the GUI up if it is parked, eg: on input or when data shown changes
+		 *
+		 * @note Can be called from any thread or interrupt context
+		 */
+		void wake(void);
+
+		/**
+		 * Gets the state of the idle state machine
+		 */
+		idle_state_t get_idle_state(void) const {
+			return idle_state;
+		}
+
+		/**
+		 * Gets the total time spent parked
+		 */
+		uint64_t get_idle_time(void) const {
+			return idle_time;
+		}
+
+		/**
+		 * Gets the number of times the GUI was parked
+		 */
+		uint32_t get_idle_count(void) const {
+			return idle_count;
+		}
+#endif
+
+		/**
+		 * Registers a hook into the refresh cycle of every display
+		 *
+		 * @param[in] hook Hook to register, must stay alive until removed
+		 */
+		void add_frame_hook(LVGLFrameHook& hook);
+
+		/**
+		 * Unregisters a frame hook
+		 *
+		 * @param[in] hook Hook previously registered
+		 */
+		void remove_frame_hook(LVGLFrameHook& hook);
+
+#if MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING
+		/**
+		 * Gets a snapshot of lvgl's heap usage
+		 *
+		 * @param[out] stats Usage of the whole heap used by lvgl
+		 */
+		void get_mem_stats(mbed_lvgl_mem_stats_t& stats) {
+			mbed_lvgl_mem_get_stats(&stats);
+		}
+
+		/**
+		 * Gets a snapshot of lvgl's heap usage per tag (see LVGLMemTag)
+		 *
+		 * @param[out] stats Array receiving the usage of each tag
+		 * @param[in] max Size of the array
+		 *
+		 * @retval number of tags copied
+		 */
+		size_t get_mem_tag_stats(mbed_lvgl_mem_tag_stats_t* stats, size_t max) {
+			return mbed_lvgl_mem_get_tag_stats(stats, max);
+		}
+
+		/**
+		 * Reports lvgl's heap usage periodically
+		 *
+		 * @param[in] callback Called from update() with a snapshot, NULL to stop reporting
+		 * @param[in] period_ms Reporting period
+		 */
+		void set_mem_telemetry(mem_telemetry_callback_t callback, uint32_t period_ms);
+#endif
+
 #if MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM
 		/**
 		 * Tells littlevgl that a filesystem is ready to use
@@ -98,6 +221,26 @@ class LittlevGL : private mbed::NonCopyable<LittlevGL>
 		void filesystem_ready(void);
 #endif
 
+#if MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT && MBED_CONF_MBED_LVGL_ENABLE_PREFETCH
+		/**
+		 * Loads the given assets into RAM on a background thread so
+		 * later accesses through the 'M' filesystem driver (eg: lv_img_set_src)
+		 * do not stall the GUI thread on slow storage.
+		 *
+		 * @param[in] paths lvgl paths of the assets (eg: {"M:/img/a.bin", "M:/img/b.bin"})
+		 * @param[in] callback (optional) Called once per asset from update() when it is ready
+		 *
+		 * @note filesystem_ready() must be called first
+		 */
+		void prefetch(std::initializer_list<const char*> paths,
+				AssetPrefetcher::callback_t callback = NULL);
+
+		/**
+		 * Drops all prefetched assets that are not currently open
+		 */
+		void clear_prefetched(void);
+#endif
+
 	protected:
 
 		/**
@@ -105,6 +248,22 @@ class LittlevGL : private mbed::NonCopyable<LittlevGL>
 		 */
 		void tick(void);
 
+#if MBED_CONF_RTOS_PRESENT
+		/**
+		 * Parks the GUI if it is idle, returns once it is woken up
+		 */
+		void idle_step(void);
+
+		/**
+		 * Checks whether the GUI has anything to do
+		 *
+		 * @param[out] park_ms Longest time the GUI can be parked (application tasks), osWaitForever if unbounded
+		 *
+		 * @retval true if there is nothing to refresh or animate
+		 */
+		bool is_idle(uint32_t* park_ms);
+#endif
+
 	private:
 
 		/** Private constructor, as class is a singleton */
@@ -115,7 +274,7 @@ class LittlevGL : private mbed::NonCopyable<LittlevGL>
 		 */
 		static void flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
 
-#if USE_LV_GPU
+#if LV_USE_GPU
 
 		/*
 		 * @brief Internal function for bridging C/C++ to DisplayDriver instance
@@ -143,14 +302,84 @@ class LittlevGL : private mbed::NonCopyable<LittlevGL>
 		 * number of flushed pixels */
 		static void monitor(lv_disp_drv_t * disp_drv, uint32_t time, uint32_t px);
 
+		/*
+		 * @brief Runs the frame hooks before handing over to lvgl's display refresh task
+		 */
+		static void refresh(lv_task_t* task);
+
+#if MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING
+		/*
+		 * @brief lv_task reporting the heap usage
+		 */
+		static void mem_telemetry_task(lv_task_t* task);
+#endif
+
+#if MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT && MBED_CONF_MBED_LVGL_ENABLE_PREFETCH
+
+		/*
+		 * @brief Internal functions for bridging the C filesystem wrapper to the asset cache
+		 */
+		static bool asset_cache_acquire(const char* fn, const uint8_t** data, uint32_t* size);
+		static void asset_cache_release(const uint8_t* data);
+
+#endif
+
 	protected:
 
 		/** Initialized flag */
 		bool initialized;
 
+		/** Set while the ticker is started */
+		bool ticking;
+
 		/** Ticker for updating LittleVGL ticker */
 		mbed::Ticker ticker;
 
+		/** Registered frame hooks */
+		LVGLFrameHook* frame_hooks;
+
+		/** Set while lvgl refreshes a display */
+		bool refreshing;
+
+		/** lvgl's display refresh task function */
+		static lv_task_cb_t refresh_task_cb;
+
+#if MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING
+		/** Tag of allocations made while refreshing (eg: decoded images) */
+		uint8_t render_mem_tag;
+
+		lv_task_t* mem_telemetry;
+		mem_telemetry_callback_t mem_telemetry_cb;
+#endif
+
+#if MBED_CONF_RTOS_PRESENT
+		/** Idle state machine */
+		bool idle_parking;
+		uint32_t idle_timeout;
+		idle_state_t idle_state;
+
+		/** lvgl tick when the GUI was last seen busy */
+		uint32_t last_busy;
+
+		uint64_t idle_time;
+		uint32_t idle_count;
+
+		/** Set by wake() */
+		rtos::EventFlags idle_flags;
+
+		/** lvgl's own tasks (eg: animations), created by lv_init */
+		lv_task_t* system_tasks[4];
+		size_t system_task_count;
+#endif
+
+#if MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT && MBED_CONF_MBED_LVGL_ENABLE_PREFETCH
+		/** Prefetched assets, created once the filesystem is ready */
+		AssetCache* asset_cache;
+
+		/** Background asset loader */
+		AssetPrefetcher* prefetcher;
+#endif
+
 };
 
 
@@ -0,0 +1,347 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RLEImageDecoder.h"
+
+#include <string.h>
+
+#include "lv_img.h"
+#include "lv_fs.h"
+
+#include "platform/mbed_assert.h"
+
+#define RLE_HEADER_SIZE		16
+#define RLE_VERSION			1
+#define RLE_FLAG_CHROMA		0x01
+
+/** State of an open image */
+typedef struct {
+#if LV_USE_FILESYSTEM
+	lv_fs_file_t file;
+#endif
+	const uint8_t* mem;		/** Image data for variable sources (NULL for files) */
+	uint32_t mem_size;		/** Size of the image data (or file), rows must end within it */
+	uint16_t w;
+	uint16_t h;
+	uint32_t* rows;			/** Row table, h + 1 entries */
+	uint8_t* packed;		/** Compressed row scratch for file sources */
+	uint32_t packed_size;
+	lv_color_t* row;		/** Last decoded row */
+	int32_t row_y;			/** Index of the row held in row (-1 if none) */
+} rle_state_t;
+
+static inline uint16_t get_u16(const uint8_t* p)
+{
+	return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t* p)
+{
+	return ((uint32_t) p[0]) | ((uint32_t) p[1] << 8) |
+			((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+/** Validates a header and fills out lvgl's image header from it */
+static bool parse_header(const uint8_t* raw, lv_img_header_t* header)
+{
+	if(memcmp(raw, "LVRL", 4) != 0 || raw[4] != RLE_VERSION || raw[5] != LV_COLOR_DEPTH) {
+		return false;
+	}
+
+	header->always_zero = 0;
+	header->w = get_u16(&raw[6]);
+	header->h = get_u16(&raw[8]);
+	header->cf = (raw[10] & RLE_FLAG_CHROMA) ? LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED : LV_IMG_CF_TRUE_COLOR;
+	return true;
+}
+
+/** Returns the raw data of a variable source if it is an RLE image */
+static const uint8_t* get_variable_data(const void* src, uint32_t* size = NULL)
+{
+	const lv_img_dsc_t* img_dsc = (const lv_img_dsc_t*) src;
+	if(img_dsc->header.cf != LV_IMG_CF_RAW || img_dsc->data_size < RLE_HEADER_SIZE) {
+		return NULL;
+	}
+	if(size != NULL) {
+		*size = img_dsc->data_size;
+	}
+	return img_dsc->data;
+}
+
+/**
+ * Checks that the row table only points at data within the image:
+ * rows start after the table, never go backwards and end within the data
+ */
+static bool check_rows(const uint32_t* rows, uint16_t h, uint32_t data_size)
+{
+	uint32_t data_start = RLE_HEADER_SIZE + (uint32_t)(h + 1) * 4;
+	if(rows[0] < data_start || rows[h] > data_size) {
+		return false;
+	}
+	for(uint32_t i = 0; i < h; i++) {
+		if(rows[i + 1] < rows[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void RLEImageDecoder::register_decoder(void)
+{
+	lv_img_decoder_t* decoder = lv_img_decoder_create();
+	MBED_ASSERT(decoder != NULL);
+
+	lv_img_decoder_set_info_cb(decoder, &RLEImageDecoder::info);
+	lv_img_decoder_set_open_cb(decoder, &RLEImageDecoder::open);
+	lv_img_decoder_set_read_line_cb(decoder, &RLEImageDecoder::read_line);
+	lv_img_decoder_set_close_cb(decoder, &RLEImageDecoder::close);
+}
+
+bool RLEImageDecoder::decode_row(const uint8_t* src, uint32_t src_len, lv_color_t* dest, uint32_t w)
+{
+	const uint8_t* end = src + src_len;
+	lv_color_t* dest_end = dest + w;
+
+	while(src < end && dest < dest_end) {
+		uint8_t c = *src++;
+		uint32_t count = (c & 0x7F) + 1;
+		if(count > (uint32_t)(dest_end - dest)) {
+			return false;
+		}
+
+		if(c & 0x80) {
+			if((uint32_t)(end - src) < sizeof(lv_color_t)) {
+				return false;
+			}
+			lv_color_t color;
+			memcpy(&color, src, sizeof(lv_color_t));
+			src += sizeof(lv_color_t);
+			for(uint32_t i = 0; i < count; i++) {
+				*dest++ = color;
+			}
+		} else {
+			uint32_t bytes = count * sizeof(lv_color_t);
+			if((uint32_t)(end - src) < bytes) {
+				return false;
+			}
+			memcpy(dest, src, bytes);
+			src += bytes;
+			dest += count;
+		}
+	}
+
+	return (dest == dest_end);
+}
+
+lv_res_t RLEImageDecoder::info(lv_img_decoder_t* decoder, const void* src, lv_img_header_t* header)
+{
+	lv_img_src_t src_type = lv_img_src_get_type(src);
+
+	if(src_type == LV_IMG_SRC_VARIABLE) {
+		const uint8_t* data = get_variable_data(src);
+		if(data != NULL && parse_header(data, header)) {
+			return LV_RES_OK;
+		}
+	}
+#if LV_USE_FILESYSTEM
+	else if(src_type == LV_IMG_SRC_FILE) {
+		lv_fs_file_t file;
+		if(lv_fs_open(&file, (const char*) src, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+			return LV_RES_INV;
+		}
+
+		uint8_t raw[RLE_HEADER_SIZE];
+		uint32_t br = 0;
+		lv_fs_res_t res = lv_fs_read(&file, raw, sizeof(raw), &br);
+		lv_fs_close(&file);
+
+		if(res == LV_FS_RES_OK && br == sizeof(raw) && parse_header(raw, header)) {
+			return LV_RES_OK;
+		}
+	}
+#endif
+
+	return LV_RES_INV;
+}
+
+lv_res_t RLEImageDecoder::open(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc)
+{
+	rle_state_t* state = new rle_state_t;
+	memset(state, 0, sizeof(rle_state_t));
+	state->row_y = -1;
+
+	uint8_t raw[RLE_HEADER_SIZE];
+	uint32_t table_size;
+
+	if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
+		state->mem = get_variable_data(dsc->src, &state->mem_size);
+		if(state->mem == NULL) {
+			delete state;
+			return LV_RES_INV;
+		}
+		memcpy(raw, state->mem, RLE_HEADER_SIZE);
+	}
+#if LV_USE_FILESYSTEM
+	else if(dsc->src_type == LV_IMG_SRC_FILE) {
+		uint32_t br = 0;
+		if(lv_fs_open(&state->file, (const char*) dsc->src, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+			delete state;
+			return LV_RES_INV;
+		}
+		if(lv_fs_read(&state->file, raw, sizeof(raw), &br) != LV_FS_RES_OK || br != sizeof(raw)) {
+			lv_fs_close(&state->file);
+			delete state;
+			return LV_RES_INV;
+		}
+		// Drivers without a size callback: short reads of rows are caught instead
+		if(lv_fs_size(&state->file, &state->mem_size) != LV_FS_RES_OK) {
+			state->mem_size = UINT32_MAX;
+		}
+	}
+#endif
+	else {
+		delete state;
+		return LV_RES_INV;
+	}
+
+	dsc->user_data = state;
+
+	lv_img_header_t header;
+	if(!parse_header(raw, &header)) {
+		close(decoder, dsc);
+		return LV_RES_INV;
+	}
+	state->w = get_u16(&raw[6]);
+	state->h = get_u16(&raw[8]);
+
+	// Keep the row table resident so any row can be decoded directly
+	table_size = (uint32_t)(state->h + 1) * 4;
+	if(state->mem_size < RLE_HEADER_SIZE + table_size) {
+		close(decoder, dsc);
+		return LV_RES_INV;
+	}
+
+	uint8_t* table = new uint8_t[table_size];
+	bool table_ok = true;
+	if(state->mem != NULL) {
+		memcpy(table, state->mem + RLE_HEADER_SIZE, table_size);
+	}
+#if LV_USE_FILESYSTEM
+	else {
+		uint32_t br = 0;
+		table_ok = (lv_fs_read(&state->file, table, table_size, &br) == LV_FS_RES_OK && br == table_size);
+	}
+#endif
+
+	state->rows = new uint32_t[state->h + 1];
+	for(uint32_t i = 0; i <= state->h; i++) {
+		state->rows[i] = get_u32(&table[i * 4]);
+	}
+	delete[] table;
+
+	if(!table_ok || !check_rows(state->rows, state->h, state->mem_size)) {
+		close(decoder, dsc);
+		return LV_RES_INV;
+	}
+
+	// File sources need room for the largest compressed row
+	if(state->mem == NULL) {
+		for(uint32_t i = 0; i < state->h; i++) {
+			uint32_t len = state->rows[i + 1] - state->rows[i];
+			if(len > state->packed_size) {
+				state->packed_size = len;
+			}
+		}
+		state->packed = new uint8_t[state->packed_size];
+	}
+
+	state->row = new lv_color_t[state->w];
+
+	// Rows are decoded on demand by read_line
+	dsc->img_data = NULL;
+
+	return LV_RES_OK;
+}
+
+lv_res_t RLEImageDecoder::read_line(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc,
+		lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t* buf)
+{
+	rle_state_t* state = (rle_state_t*) dsc->user_data;
+	if(y < 0 || y >= state->h || x < 0 || x + len > state->w) {
+		return LV_RES_INV;
+	}
+
+	// lvgl usually reads the same row several times (once per masked segment)
+	if(state->row_y != y) {
+		uint32_t packed_len = state->rows[y + 1] - state->rows[y];
+		const uint8_t* packed;
+
+		if(state->mem != NULL) {
+			packed = state->mem + state->rows[y];
+		}
+#if LV_USE_FILESYSTEM
+		else {
+			uint32_t br = 0;
+			if(lv_fs_seek(&state->file, state->rows[y]) != LV_FS_RES_OK ||
+					lv_fs_read(&state->file, state->packed, packed_len, &br) != LV_FS_RES_OK ||
+					br != packed_len) {
+				return LV_RES_INV;
+			}
+			packed = state->packed;
+		}
+#else
+		else {
+			return LV_RES_INV;
+		}
+#endif
+
+		// Decode full rows straight into lvgl's buffer
+		if(x == 0 && len == state->w) {
+			state->row_y = -1;
+			return decode_row(packed, packed_len, (lv_color_t*) buf, state->w) ? LV_RES_OK : LV_RES_INV;
+		}
+
+		if(!decode_row(packed, packed_len, state->row, state->w)) {
+			state->row_y = -1;
+			return LV_RES_INV;
+		}
+		state->row_y = y;
+	}
+
+	memcpy(buf, &state->row[x], len * sizeof(lv_color_t));
+	return LV_RES_OK;
+}
+
+void RLEImageDecoder::close(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc)
+{
+	rle_state_t* state = (rle_state_t*) dsc->user_data;
+	if(state == NULL) {
+		return;
+	}
+
+#if LV_USE_FILESYSTEM
+	if(state->mem == NULL) {
+		lv_fs_close(&state->file);
+	}
+#endif
+
+	delete[] state->rows;
+	delete[] state->packed;
+	delete[] state->row;
+	delete state;
+	dsc->user_data = NULL;
+}
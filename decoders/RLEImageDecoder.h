@@ -0,0 +1,93 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_DECODERS_RLEIMAGEDECODER_H_
+#define MBED_LVGL_DECODERS_RLEIMAGEDECODER_H_
+
+#include <stdint.h>
+
+#include "lv_img_decoder.h"
+
+/**
+ * lvgl image decoder for row-compressed ("LVRL") images
+ *
+ * Each row is run-length encoded independently and indexed by a row
+ * table, so any row can be decoded straight into lvgl's draw buffer
+ * without ever holding the full image in RAM. Only the row table and
+ * one decoded row are kept while the image is open.
+ *
+ * Images may be stored in a file (eg: "M:/img/splash.rle") or in flash
+ * as an lv_img_dsc_t with cf = LV_IMG_CF_RAW whose data is the file contents.
+ * Use tools/rle_img_conv.py to convert images.
+ *
+ * File format (all fields little endian):
+ *
+ * Header (16 bytes)
+ *   char     magic[4]      "LVRL"
+ *   uint8_t  version       1
+ *   uint8_t  color_depth   must match LV_COLOR_DEPTH
+ *   uint16_t w
+ *   uint16_t h
+ *   uint8_t  flags         bit 0: chroma keyed (LV_COLOR_TRANSP is transparent)
+ *   uint8_t  reserved[5]
+ *
+ * Row table ((h + 1) * 4 bytes)
+ *   uint32_t offset        file offset of each row, the last entry marks the end of the data
+ *
+ * Rows are a sequence of packets, each starting with a control byte c:
+ *   c & 0x80: run, the next pixel is repeated (c & 0x7F) + 1 times
+ *   otherwise: literal, the next c + 1 pixels follow
+ * Pixels are stored as raw lv_color_t (sizeof(lv_color_t) bytes).
+ */
+class RLEImageDecoder
+{
+	public:
+
+		/**
+		 * Registers the decoder with lvgl
+		 *
+		 * @note Must be called after lv_init(), LittlevGL::init() does this
+		 * automatically if the decoder is enabled in the configuration
+		 */
+		static void register_decoder(void);
+
+		/**
+		 * Decodes a single compressed row
+		 *
+		 * @param[in] src Compressed row data
+		 * @param[in] src_len Length of the compressed row in bytes
+		 * @param[out] dest Decoded pixels
+		 * @param[in] w Number of pixels in the row
+		 *
+		 * @retval true if the row decoded to exactly w pixels
+		 */
+		static bool decode_row(const uint8_t* src, uint32_t src_len, lv_color_t* dest, uint32_t w);
+
+	protected:
+
+		/*
+		 * @brief lvgl image decoder interface
+		 */
+		static lv_res_t info(lv_img_decoder_t* decoder, const void* src, lv_img_header_t* header);
+		static lv_res_t open(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc);
+		static lv_res_t read_line(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc,
+				lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t* buf);
+		static void close(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc);
+
+};
+
+#endif /* MBED_LVGL_DECODERS_RLEIMAGEDECODER_H_ */
@@ -0,0 +1,246 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_DRIVERS_DISPLAYTRANSACTION_H_
+#define MBED_LVGL_DRIVERS_DISPLAYTRANSACTION_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform/mbed_assert.h"
+
+/**
+ * A chain of command and data steps sent to a display as one bus transaction
+ *
+ * Sending a window update as separate calls (column address, row address,
+ * RAM write, pixel data) costs a chip-select and D/C toggle and a wait for
+ * completion per call. A transaction lists the steps up front so an
+ * interface able to chain them (eg: a DMA descriptor list) can run them
+ * back-to-back under a single chip-select.
+ *
+ * Command parameters are small and copied into the transaction, pixel
+ * data is referenced and must stay valid until the transaction is executed.
+ * A data step may gather rows spaced out in memory (eg: a region of a
+ * full-frame buffer), like a 2D DMA transfer.
+ */
+class DisplayTransaction
+{
+	public:
+
+		/** Maximum number of steps in a transaction */
+		static const size_t MAX_STEPS = MBED_CONF_MBED_LVGL_TRANSACTION_MAX_STEPS;
+
+		/** Maximum number of parameter bytes copied into a step */
+		static const size_t MAX_INLINE_BYTES = 4;
+
+		typedef enum {
+			STEP_COMMAND,	/** Command byte, D/C low */
+			STEP_DATA,		/** Data bytes, D/C high */
+		} step_type_t;
+
+		/** One step of a transaction */
+		typedef struct {
+			step_type_t type;
+			const uint8_t* data;
+			uint32_t len;			/** Total number of bytes */
+			uint32_t row_len;		/** Bytes per row, len unless rows are spaced out */
+			uint32_t stride;		/** Bytes from the start of a row to the start of the next */
+			uint8_t inline_data[MAX_INLINE_BYTES];
+		} step_t;
+
+		DisplayTransaction() : step_count(0), data_bytes(0) { }
+
+		/**
+		 * Adds a command step
+		 *
+		 * @param[in] cmd Command byte
+		 *
+		 * @retval false if the transaction is full
+		 */
+		bool command(uint8_t cmd) {
+			step_t* step = next_step(STEP_COMMAND);
+			if(step == NULL) {
+				return false;
+			}
+			step->inline_data[0] = cmd;
+			step->data = step->inline_data;
+			step->len = 1;
+			step->row_len = step->stride = 1;
+			return true;
+		}
+
+		/**
+		 * Adds a data step, copying the (small) parameter bytes
+		 *
+		 * @param[in] params Parameter bytes
+		 * @param[in] len Number of bytes, at most MAX_INLINE_BYTES
+		 *
+		 * @retval false if the transaction is full
+		 */
+		bool params(const uint8_t* params, uint32_t len) {
+			MBED_ASSERT(len <= MAX_INLINE_BYTES);
+			step_t* step = next_step(STEP_DATA);
+			if(step == NULL) {
+				return false;
+			}
+			memcpy(step->inline_data, params, len);
+			step->data = step->inline_data;
+			step->len = step->row_len = step->stride = len;
+			data_bytes += len;
+			return true;
+		}
+
+		/**
+		 * Adds a data step referencing a buffer
+		 *
+		 * @param[in] data Data bytes, must stay valid until the transaction is executed
+		 * @param[in] len Number of bytes
+		 *
+		 * @retval false if the transaction is full
+		 */
+		bool data(const uint8_t* data, uint32_t len) {
+			step_t* step = next_step(STEP_DATA);
+			if(step == NULL) {
+				return false;
+			}
+			step->data = data;
+			step->len = step->row_len = step->stride = len;
+			data_bytes += len;
+			return true;
+		}
+
+		/**
+		 * Adds a data step gathering rows spaced out in memory
+		 *
+		 * @param[in] data First byte of the first row, rows must stay valid until the transaction is executed
+		 * @param[in] row_len Number of bytes in each row
+		 * @param[in] stride Number of bytes from the start of a row to the start of the next
+		 * @param[in] rows Number of rows
+		 *
+		 * @retval false if the transaction is full
+		 */
+		bool data_rows(const uint8_t* data, uint32_t row_len, uint32_t stride, uint32_t rows) {
+			step_t* step = next_step(STEP_DATA);
+			if(step == NULL) {
+				return false;
+			}
+			step->data = data;
+			step->len = row_len * rows;
+			step->row_len = row_len;
+			step->stride = stride;
+			data_bytes += step->len;
+			return true;
+		}
+
+		/**
+		 * Removes every step
+		 */
+		void clear(void) {
+			step_count = 0;
+			data_bytes = 0;
+		}
+
+		/**
+		 * Returns true if no more steps can be added
+		 */
+		bool is_full(void) const {
+			return step_count >= MAX_STEPS;
+		}
+
+		/**
+		 * Gets the number of steps
+		 */
+		size_t get_step_count(void) const {
+			return step_count;
+		}
+
+		/**
+		 * Gets a step
+		 *
+		 * @param[in] index Index of the step
+		 */
+		const step_t& get_step(size_t index) const {
+			MBED_ASSERT(index < step_count);
+			return steps[index];
+		}
+
+		/**
+		 * Gets the total number of data bytes (excluding commands)
+		 */
+		uint32_t get_data_bytes(void) const {
+			return data_bytes;
+		}
+
+		/**
+		 * Gets a row of a step
+		 *
+		 * @param[in] step Step of the transaction
+		 * @param[in] row Row of the step, from 0 to len / row_len - 1
+		 */
+		static const uint8_t* get_row(const step_t& step, uint32_t row) {
+			return step.data + row * step.stride;
+		}
+
+	protected:
+
+		step_t* next_step(step_type_t type) {
+			if(is_full()) {
+				return NULL;
+			}
+			step_t* step = &steps[step_count++];
+			step->type = type;
+			return step;
+		}
+
+	protected:
+
+		step_t steps[MAX_STEPS];
+		size_t step_count;
+		uint32_t data_bytes;
+
+};
+
+/**
+ * Interface of display buses able to execute a DisplayTransaction
+ * as a single chained transfer
+ *
+ * Implemented alongside uDisplay's DisplayInterface by buses that can
+ * chain transfers (eg: an SPI interface with a DMA descriptor list).
+ * Display drivers fall back to individual DisplayInterface calls when
+ * no batched interface is given.
+ */
+class BatchedDisplayInterface
+{
+	public:
+
+		virtual ~BatchedDisplayInterface() { }
+
+		/**
+		 * Executes every step of a transaction back-to-back, under a
+		 * single chip-select, toggling D/C between command and data steps.
+		 * The rows of a data step are sent one after the other.
+		 *
+		 * @param[in] transaction Transaction to execute
+		 *
+		 * @note Blocks until the transaction is complete
+		 */
+		virtual void execute(const DisplayTransaction& transaction) = 0;
+
+};
+
+#endif /* MBED_LVGL_DRIVERS_DISPLAYTRANSACTION_H_ */
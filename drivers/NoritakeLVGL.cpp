@@ -17,10 +17,18 @@
 
 #include "NoritakeLVGL.h"
 
+#include "platform/mbed_assert.h"
+
 NoritakeLVGL::NoritakeLVGL(DisplayInterface& interface, PinName reset,
-		uint32_t height, uint32_t width) : NoritakeVFD(interface, reset, height, width) {
+		uint32_t height, uint32_t width) : NoritakeVFD(interface, reset, height, width),
+		packed_strip(NULL) {
 
 	set_resolution(width, height);
+
+	// Replace the default display buffer, the base class still owns (and deletes) ours
+	delete[] primary_display_buffer.data();
+
+#if (LV_COLOR_DEPTH == 1)
 	// Allocate our own display buffer based on height and width
 	// Each pixel is one bit, so allocate (width*height)/8 bytes
 	unsigned int num_bytes = ((width*height) >> 3);
@@ -30,6 +38,17 @@ NoritakeLVGL::NoritakeLVGL(DisplayInterface& interface, PinName reset,
 
 	// Here we kind of lie and say the buffer is 8X bigger than it really is
 	primary_display_buffer = mbed::Span<lv_color_t>(disp_buf, num_bytes*8);
+#else
+	MBED_STATIC_ASSERT((STRIP_ROWS % 8) == 0, "noritake_strip_rows must be a multiple of 8");
+
+	// Render strips of 8-pixel rows at LV_COLOR_DEPTH and pack them to 1 bit in flush
+	lv_coord_t rows = ((lv_coord_t) height < STRIP_ROWS) ? (lv_coord_t) height : STRIP_ROWS;
+	lv_color_t* disp_buf = new lv_color_t[width * rows];
+	primary_display_buffer = mbed::Span<lv_color_t>(disp_buf, width * rows);
+
+	packed_strip = new uint8_t[get_native_size(NATIVE_FORMAT_MONO_VTILED, width, rows)];
+	set_native_format(NATIVE_FORMAT_MONO_VTILED);
+#endif
 
 	// Do not use the secondary display buffer
 	secondary_display_buffer = mbed::Span<lv_color_t, 0>();
@@ -40,14 +59,29 @@ NoritakeLVGL::NoritakeLVGL(DisplayInterface& interface, PinName reset,
 }
 
 NoritakeLVGL::~NoritakeLVGL() {
-	// Delete the dynamically-allocated display buffer
-	delete[] primary_display_buffer.data();
+	// The display buffer is deleted by LVGLDisplayDriver
+	delete[] packed_strip;
 }
 
 void NoritakeLVGL::flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p) {
 
-	draw_dot_unit_image(area->x1, area->y1, (area->x2 - area->x1)+1, (area->y2 - area->y1)+1, (unsigned char*) color_p);
+	lv_coord_t w = (area->x2 - area->x1) + 1;
+	lv_coord_t h = (area->y2 - area->y1) + 1;
+
+#if (LV_COLOR_DEPTH == 1)
+	draw_dot_unit_image(area->x1, area->y1, w, h, (unsigned char*) color_p);
+#else
+	mbed_lvgl_px_to_mono_vtiled(packed_strip, color_p, w, h);
+	draw_dot_unit_image(area->x1, area->y1, w, h, packed_strip);
+#endif
+}
+
+#if (LV_COLOR_DEPTH != 1)
+void NoritakeLVGL::round_lv_area(lv_disp_drv_t * disp_drv, lv_area_t * area) {
+	area->y1 &= ~0x7;
+	area->y2 |= 0x7;
 }
+#endif
 
 void NoritakeLVGL::set_pixel(lv_disp_drv_t * disp_drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
         lv_color_t color, lv_opa_t opa)
@@ -56,7 +90,7 @@ void NoritakeLVGL::set_pixel(lv_disp_drv_t * disp_drv, uint8_t * buf, lv_coord_t
 
 	// Start of display buffer + (x *4 + (y/8)) (selecting row and column in memory)
 	buf += ((x << 2) + (y >> 3));
-	if(lv_color_brightness(color) < 10) {
+	if(lv_color_brightness(color) < MBED_LVGL_MONO_THRESHOLD) {
 		(*buf) |= (0x80 >> (y % 8));	// Set the corresponding bit in the byte buffer
 	}
 	else {
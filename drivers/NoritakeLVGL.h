@@ -22,10 +22,6 @@
 #include "NoritakeVFD.h"
 #include <LVGLDisplayDriver.h>
 
-#if (LV_COLOR_DEPTH != 1)
-#warning LV_COLOR_DEPTH must be set to 1 for the NoritakeVFD monochrome display to work properly
-#endif
-
 class NoritakeLVGL : public LVGLDisplayDriver, public NoritakeVFD {
 	public:
 		/**
@@ -43,6 +39,24 @@ class NoritakeLVGL : public LVGLDisplayDriver, public NoritakeVFD {
 
 protected:
 
+#if (LV_COLOR_DEPTH != 1)
+		/**
+		 * Number of rows in the draw buffer when rendering at a color depth other than 1,
+		 * one 8-row band by default so the buffer grows with the depth as little as possible
+		 */
+		static const lv_coord_t STRIP_ROWS = MBED_CONF_MBED_LVGL_NORITAKE_STRIP_ROWS;
+
+		/**
+		 * Strips are packed into 8-pixel tall columns, so
+		 * areas are aligned to multiples of 8 rows
+		 */
+		virtual bool has_rounder(void) {
+			return true;
+		}
+
+		virtual void round_lv_area(lv_disp_drv_t * disp_drv, lv_area_t * area);
+#endif
+
 		/*
 		 * @brief Flush the content of the internal buffer to the specific area on the display
 		 * You can use DMA or any hardware acceleration to do this operation in the background but
@@ -54,13 +68,18 @@ protected:
 		 * Subclass returns true if it has a custom pixel write function
 		 */
 		virtual bool has_pix_write_func(void) {
-			return true;
+			return (LV_COLOR_DEPTH == 1);
 		}
 
 		/*Optional: Set a pixel in a buffer according to the requirements of the display*/
 		virtual void set_pixel(lv_disp_drv_t * disp_drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
 				lv_color_t color, lv_opa_t opa);
 
+protected:
+
+		/** Packed strip handed to the display when rendering at a color depth other than 1 */
+		uint8_t* packed_strip;
+
 };
 
 
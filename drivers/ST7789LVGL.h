@@ -11,6 +11,8 @@
 #include "ST7789.h"
 #include <LVGLDisplayDriver.h>
 
+#include "DisplayTransaction.h"
+
 class ST7789LVGL : public LVGLDisplayDriver, public ST7789Display {
 
 public:
@@ -28,7 +30,51 @@ public:
 			mbed::Span<lv_color_t> primary_display_buffer = mbed::Span<lv_color_t, 0>(),
 			mbed::Span<lv_color_t> secondary_display_buffer = mbed::Span<lv_color_t, 0>()) :
 				LVGLDisplayDriver(primary_display_buffer, secondary_display_buffer),
-				ST7789Display(interface, reset, backlight) { }
+				ST7789Display(interface, reset, backlight), batched(NULL),
+				convert_buffer(NULL), convert_used(0),
+				gram_x(0), gram_y(0), scroll_top(0), scroll_height(0), scroll_offset(0) {
+#if LV_COLOR_DEPTH != 16
+			// The panel is driven in RGB565, strips rendered at other depths are converted
+			set_native_format(NATIVE_FORMAT_RGB565_SWAPPED);
+
+			// Pixels converted while flushing, a draw buffer's worth so a flush is one transaction
+			convert_buffer = new uint16_t[this->primary_display_buffer.size()];
+#endif
+		}
+
+	virtual ~ST7789LVGL() {
+		delete[] convert_buffer;
+	}
+
+	/**
+	 * Sends each flush as chained transactions on a bus that supports them
+	 *
+	 * @param[in] bus Batched interface to the same bus as the display interface,
+	 * or NULL to go back to individual calls
+	 */
+	void set_batched_interface(BatchedDisplayInterface* bus) {
+		batched = bus;
+	}
+
+	/**
+	 * Sets where the display's top-left pixel is in display RAM
+	 *
+	 * The ST7789 has RAM for 240x320 pixels. Smaller panels (eg: 240x240)
+	 * only show part of it, which may not start at the origin depending on
+	 * the rotation (eg: rows 80 to 319 when rotated by 180 degrees).
+	 *
+	 * @param[in] x Column of display RAM shown in the panel's first column
+	 * @param[in] y Row of display RAM shown in the panel's first row
+	 *
+	 * @note Call again after changing the rotation, then redraw the display
+	 */
+	void set_gram_offset(lv_coord_t x, lv_coord_t y) {
+		gram_x = x;
+		gram_y = y;
+		if(scroll_height != 0) {
+			set_scroll_region(scroll_top, scroll_top + scroll_height - 1);
+		}
+	}
 
 protected:
 
@@ -40,20 +86,353 @@ protected:
 		 */
 		virtual void flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p) {
 
-			// Number of pixels * size of pixel data in bytes
-			uint32_t size_bytes = (area->x2-area->x1+1)*(area->y2-area->y1+1)*sizeof(lv_color_t);
+			// Size of a row in the panel's pixel format (converted in prepare)
+			lv_coord_t w = (area->x2-area->x1+1);
+			uint32_t row_bytes = get_native_size(get_native_format(), w, 1);
 
-			// This offset is needed in the current rotation
-			// Of the display because the ST7789 actually supports
-			// Displays up to 240X320. So we need to add 80 to get into
-			// The appropriate address space for the display in this rotation
-			static int32_t y_offset = -80;
+			// Rows in the hardware scroll band may wrap around in display RAM,
+			// each run of contiguous rows is a window of the same transaction
+			const uint8_t* data = (const uint8_t*) color_p;
+			convert_used = 0;
+			lv_coord_t y = area->y1;
+			while(y <= area->y2) {
+				lv_coord_t ram_y;
+				lv_coord_t rows = map_rows(y, area->y2, &ram_y);
 
-			this->set_column_address(area->x1, area->x2);
-			this->set_row_address(area->y1, area->y2);
-			this->start_ram_write();
-			this->write_data((uint8_t*) color_p, size_bytes);
+				start_window(area->x1, ram_y, area->x2, ram_y + rows - 1);
+#if LV_COLOR_DEPTH < 16
+				// RGB565 doesn't fit in place, convert while sending
+				uint16_t* converted = reserve_converted(rows * w);
+				convert_rgb565(converted, ((const lv_color_t*) color_p) + (y - area->y1) * w, rows * w);
+				send_data((const uint8_t*) converted, rows * row_bytes);
+#else
+				send_data(data, rows * row_bytes);
+#endif
+
+				data += rows * row_bytes;
+				y += rows;
+			}
+
+			end_transaction();
 		}
+
+		/**
+		 * Sends the redrawn regions of a full-frame buffer straight out of the frame
+		 */
+		virtual void flush_regions(lv_disp_drv_t * disp_drv, const LVGLFlushDescriptor& desc) {
+
+			// Strips were already prepared, flush them whole
+			if(!desc.is_full_frame()) {
+				LVGLDisplayDriver::flush_regions(disp_drv, desc);
+				return;
+			}
+
+			convert_used = 0;
+			for(size_t i = 0; i < desc.get_region_count(); i++) {
+				const lv_area_t* region = desc.get_region(i);
+
+				lv_coord_t y = region->y1;
+				while(y <= region->y2) {
+					lv_coord_t ram_y;
+					lv_coord_t rows = map_rows(y, region->y2, &ram_y);
+
+					start_window(region->x1, ram_y, region->x2, ram_y + rows - 1);
+
+#if LV_COLOR_DEPTH == 16
+					// Rows are sent directly from the frame
+					send_rows(desc.get_row(i, y), desc.get_row_bytes(i), desc.get_stride(), rows);
+#else
+					// The frame must not be modified, convert its rows next to each other and send them in one go
+					lv_coord_t w = lv_area_get_width(region);
+					uint16_t* converted = reserve_converted(rows * w);
+					for(lv_coord_t row = y; row < y + rows; row++) {
+						convert_rgb565(converted + (row - y) * w, (const lv_color_t*) desc.get_row(i, row), w);
+					}
+					send_data((const uint8_t*) converted, rows * w * 2);
+#endif
+
+					y += rows;
+				}
+			}
+
+			end_transaction();
+		}
+
+		/**
+		 * The ST7789 scrolls a band of display RAM rows in hardware
+		 */
+		virtual bool has_hw_scroll(void) {
+			return true;
+		}
+
+		/**
+		 * Defines the band of rows scrolled in hardware (VSCRDEF) and resets the scroll offset
+		 *
+		 * @note Hardware scrolling moves display RAM rows, the panel must be in an orientation
+		 * where they are the rows lvgl draws (ie: no row/column exchange in MADCTL)
+		 */
+		virtual void set_scroll_region(lv_coord_t y1, lv_coord_t y2) {
+			sync_pipeline();
+
+			if(y2 < y1) {
+				// A band covering all of display RAM with no offset is the same as no scrolling
+				y1 = 0;
+				y2 = ST7789_RAM_ROWS - 1;
+				scroll_height = 0;
+			} else {
+				scroll_height = y2 - y1 + 1;
+			}
+			scroll_top = y1;
+			scroll_offset = 0;
+
+			uint16_t tfa = (scroll_height != 0) ? (gram_y + y1) : 0;
+			uint16_t vsa = y2 - y1 + 1;
+			uint16_t bfa = ST7789_RAM_ROWS - tfa - vsa;
+			uint8_t vscrdef[6] = { (uint8_t)(tfa >> 8), (uint8_t) tfa,
+					(uint8_t)(vsa >> 8), (uint8_t) vsa,
+					(uint8_t)(bfa >> 8), (uint8_t) bfa };
+			this->write_command(ST7789_CMD_VSCRDEF);
+			this->write_data(vscrdef, sizeof(vscrdef));
+
+			write_scroll_start();
+		}
+
+		/**
+		 * Moves the content of the scroll band (VSCRSADD)
+		 */
+		virtual void scroll(lv_coord_t dy) {
+			if(scroll_height == 0) {
+				return;
+			}
+
+			sync_pipeline();
+
+			// Display row i of the band shows RAM row (top + offset + i), moving
+			// content down by dy means showing the RAM rows dy lines earlier
+			scroll_offset = (scroll_offset - (dy % scroll_height) + scroll_height) % scroll_height;
+
+			write_scroll_start();
+		}
+
+		/**
+		 * Maps lvgl rows to display RAM rows
+		 *
+		 * @param[in] y First row (lvgl coordinates)
+		 * @param[in] y2 Last row (lvgl coordinates)
+		 * @param[out] ram_y Display RAM row of y, relative to the panel's first row
+		 *
+		 * @retval number of rows from y that are contiguous in display RAM
+		 */
+		lv_coord_t map_rows(lv_coord_t y, lv_coord_t y2, lv_coord_t* ram_y) {
+			lv_coord_t scroll_bottom = scroll_top + scroll_height - 1;
+
+			if(scroll_height == 0 || y > scroll_bottom) {
+				*ram_y = y;
+				return y2 - y + 1;
+			}
+
+			if(y < scroll_top) {
+				// Fixed rows above the band
+				*ram_y = y;
+				return ((y2 < scroll_top) ? y2 : (scroll_top - 1)) - y + 1;
+			}
+
+			// Rows in the band, up to where they wrap around in display RAM
+			lv_coord_t line = (y - scroll_top + scroll_offset) % scroll_height;
+			lv_coord_t last = (y2 < scroll_bottom) ? y2 : scroll_bottom;
+			lv_coord_t rows = last - y + 1;
+			if(rows > scroll_height - line) {
+				rows = scroll_height - line;
+			}
+			*ram_y = scroll_top + line;
+			return rows;
+		}
+
+		/**
+		 * Sends the first display RAM row shown in the scroll band (VSCRSADD)
+		 */
+		void write_scroll_start(void) {
+			uint16_t vsp = (scroll_height != 0) ? (gram_y + scroll_top + scroll_offset) : 0;
+			uint8_t vscrsadd[2] = { (uint8_t)(vsp >> 8), (uint8_t) vsp };
+			this->write_command(ST7789_CMD_VSCRSADD);
+			this->write_data(vscrsadd, sizeof(vscrsadd));
+		}
+
+		/**
+		 * Waits for strips still queued for flushing with the previous row mapping
+		 */
+		void sync_pipeline(void) {
+#if MBED_CONF_RTOS_PRESENT
+			if(get_pipeline() != NULL) {
+				get_pipeline()->sync();
+			}
+#endif
+		}
+
+		/**
+		 * Reserves room for converted pixels in the conversion buffer
+		 *
+		 * Converted pixels are referenced by the transaction, they stay in
+		 * the buffer until the flush ends. Full-frame regions adding up to
+		 * more than the buffer flush what is queued first.
+		 *
+		 * @param[in] px Number of pixels, at most a draw buffer's worth
+		 */
+		uint16_t* reserve_converted(uint32_t px) {
+			uint32_t capacity = this->primary_display_buffer.size();
+			MBED_ASSERT(convert_buffer != NULL && px <= capacity);
+			if(convert_used + px > capacity) {
+				end_transaction();
+				convert_used = 0;
+			}
+			uint16_t* dest = convert_buffer + convert_used;
+			convert_used += px;
+			return dest;
+		}
+
+		/**
+		 * Converts pixels to the panel's RGB565 (high byte first)
+		 */
+		void convert_rgb565(uint16_t* dest, const lv_color_t* color_p, uint32_t px) {
+#if LV_COLOR_DEPTH == 8
+			expand_rgb565((uint8_t*) dest, color_p, px);
+#else
+			mbed_lvgl_px_to_rgb565((uint8_t*) dest, color_p, px, true);
+#endif
+		}
+
+		/**
+		 * Sets the window of display RAM to update and starts writing to it
+		 *
+		 * With a batched interface the commands are queued in the current
+		 * transaction, which is executed first if it has no room for them
+		 */
+		void start_window(lv_coord_t x1, lv_coord_t y1, lv_coord_t x2, lv_coord_t y2) {
+			x1 += gram_x;
+			x2 += gram_x;
+			y1 += gram_y;
+			y2 += gram_y;
+
+			if(batched == NULL) {
+				this->set_column_address(x1, x2);
+				this->set_row_address(y1, y2);
+				this->start_ram_write();
+				return;
+			}
+
+			uint8_t caset[4] = { (uint8_t)(x1 >> 8), (uint8_t) x1,
+					(uint8_t)(x2 >> 8), (uint8_t) x2 };
+			uint8_t raset[4] = { (uint8_t)(y1 >> 8), (uint8_t) y1,
+					(uint8_t)(y2 >> 8), (uint8_t) y2 };
+
+			// The window setup and at least one data step go together
+			if(DisplayTransaction::MAX_STEPS - transaction.get_step_count() < WINDOW_STEPS + 1) {
+				end_transaction();
+			}
+			transaction.command(ST7789_CMD_CASET);
+			transaction.params(caset, sizeof(caset));
+			transaction.command(ST7789_CMD_RASET);
+			transaction.params(raset, sizeof(raset));
+			transaction.command(ST7789_CMD_RAMWR);
+		}
+
+		/**
+		 * Sends pixel data to display RAM
+		 *
+		 * With a batched interface the data is queued in the current
+		 * transaction, which is executed first if it is full
+		 */
+		void send_data(const uint8_t* data, uint32_t len) {
+			if(batched == NULL) {
+				this->write_data((uint8_t*) data, len);
+				return;
+			}
+
+			if(transaction.is_full()) {
+				batched->execute(transaction);
+				transaction.clear();
+			}
+			if(transaction.get_step_count() == 0) {
+				// Resume the RAM write where the previous transaction stopped
+				transaction.command(ST7789_CMD_RAMWRC);
+			}
+			transaction.data(data, len);
+		}
+
+		/**
+		 * Sends rows of pixel data spaced out in memory to display RAM
+		 *
+		 * With a batched interface the rows are a single step of the current transaction
+		 */
+		void send_rows(const uint8_t* data, uint32_t row_len, uint32_t stride, lv_coord_t rows) {
+			if(row_len == stride || rows == 1) {
+				send_data(data, row_len * rows);
+				return;
+			}
+
+			if(batched == NULL) {
+				for(lv_coord_t row = 0; row < rows; row++) {
+					this->write_data((uint8_t*) data + row * stride, row_len);
+				}
+				return;
+			}
+
+			if(transaction.is_full()) {
+				batched->execute(transaction);
+				transaction.clear();
+			}
+			if(transaction.get_step_count() == 0) {
+				transaction.command(ST7789_CMD_RAMWRC);
+			}
+			transaction.data_rows(data, row_len, stride, rows);
+		}
+
+		/**
+		 * Executes the queued transaction, if any
+		 */
+		void end_transaction(void) {
+			if(batched != NULL && transaction.get_step_count() != 0) {
+				batched->execute(transaction);
+				transaction.clear();
+			}
+		}
+
+protected:
+
+		/** ST7789 commands used to build transactions */
+		static const uint8_t ST7789_CMD_CASET = 0x2A;
+		static const uint8_t ST7789_CMD_RASET = 0x2B;
+		static const uint8_t ST7789_CMD_RAMWR = 0x2C;
+		static const uint8_t ST7789_CMD_RAMWRC = 0x3C;
+		static const uint8_t ST7789_CMD_VSCRDEF = 0x33;
+		static const uint8_t ST7789_CMD_VSCRSADD = 0x37;
+
+		/** Steps queued by start_window() */
+		static const size_t WINDOW_STEPS = 5;
+
+		/** Rows of display RAM in the ST7789 */
+		static const lv_coord_t ST7789_RAM_ROWS = 320;
+
+		/** Chained bus, NULL to use individual DisplayInterface calls */
+		BatchedDisplayInterface* batched;
+
+		/** Transaction being built */
+		DisplayTransaction transaction;
+
+		/** Pixels converted to RGB565 for the flush in progress (LV_COLOR_DEPTH other than 16) */
+		uint16_t* convert_buffer;
+		uint32_t convert_used;
+
+		/** Display RAM address of the panel's top-left pixel */
+		lv_coord_t gram_x;
+		lv_coord_t gram_y;
+
+		/** Hardware scroll band (scroll_height is 0 when not scrolling) */
+		lv_coord_t scroll_top;
+		lv_coord_t scroll_height;
+
+		/** Rows the content of the band is scrolled by in display RAM */
+		lv_coord_t scroll_offset;
 };
 
 
@@ -0,0 +1,237 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NoritakeVFDEmulator.h"
+
+#if MBED_CONF_MBED_LVGL_ENABLE_EMULATORS
+
+#include <stdio.h>
+#include <string.h>
+
+#include "platform/mbed_assert.h"
+
+#define VFD_ESC		0x1B
+#define VFD_US		0x1F
+#define VFD_CLR		0x0C
+
+NoritakeVFDEmulator::NoritakeVFDEmulator(uint16_t width, uint16_t height) :
+		width(width), height(height), cmd_len(0), image_remaining(0),
+		cursor_x(0), cursor_y(0)
+{
+	MBED_ASSERT((height % 8) == 0);
+
+	fb = new uint8_t[(uint32_t) width * (height / 8)];
+	clear();
+
+	link.baud = 115200;
+	link.parallel_cycle_ns = 0;
+	link.busy_ns_per_byte = 10;
+
+	reset_stats();
+}
+
+NoritakeVFDEmulator::~NoritakeVFDEmulator()
+{
+	delete[] fb;
+}
+
+void NoritakeVFDEmulator::reset_stats(void)
+{
+	memset(&stats, 0, sizeof(stats));
+}
+
+void NoritakeVFDEmulator::write_command(uint8_t command)
+{
+	receive(command);
+}
+
+void NoritakeVFDEmulator::write_data(uint8_t* data, uint32_t length)
+{
+	for(uint32_t i = 0; i < length; i++) {
+		receive(data[i]);
+	}
+}
+
+bool NoritakeVFDEmulator::get_dot(uint16_t x, uint16_t y) const
+{
+	MBED_ASSERT(x < width && y < height);
+	return (fb[(uint32_t) x * (height / 8) + (y / 8)] & (0x80 >> (y % 8))) != 0;
+}
+
+bool NoritakeVFDEmulator::write_pbm(const char* path) const
+{
+	FILE* file = fopen(path, "wb");
+	if(file == NULL) {
+		return false;
+	}
+
+	fprintf(file, "P4\n%u %u\n", width, height);
+
+	// PBM rows are packed horizontally, MSB first
+	for(uint16_t y = 0; y < height; y++) {
+		uint8_t byte = 0;
+		for(uint16_t x = 0; x < width; x++) {
+			if(get_dot(x, y)) {
+				byte |= 0x80 >> (x % 8);
+			}
+			if((x % 8) == 7 || x == (width - 1)) {
+				fputc(byte, file);
+				byte = 0;
+			}
+		}
+	}
+
+	bool ok = (ferror(file) == 0);
+	fclose(file);
+	return ok;
+}
+
+void NoritakeVFDEmulator::receive(uint8_t byte)
+{
+	stats.bytes++;
+	if(link.baud != 0) {
+		// Start bit, 8 data bits, stop bit
+		stats.link_time_ns += 10000000000ull / link.baud;
+	} else {
+		stats.link_time_ns += link.parallel_cycle_ns;
+	}
+
+	if(image_remaining != 0) {
+		image_byte(byte);
+		return;
+	}
+
+	if(cmd_len == 0) {
+		if(byte == VFD_ESC || byte == VFD_US) {
+			cmd[cmd_len++] = byte;
+		} else if(byte == VFD_CLR) {
+			clear();
+		} else {
+			stats.other_bytes++;
+		}
+		return;
+	}
+
+	cmd[cmd_len++] = byte;
+	if(parse_command()) {
+		cmd_len = 0;
+	} else if(cmd_len == sizeof(cmd)) {
+		stats.other_bytes += cmd_len;
+		cmd_len = 0;
+	}
+}
+
+bool NoritakeVFDEmulator::parse_command(void)
+{
+	if(cmd[0] == VFD_ESC) {
+		if(cmd[1] == 0x40) {
+			// Initialize
+			clear();
+			cursor_x = 0;
+			cursor_y = 0;
+		} else {
+			stats.other_bytes += cmd_len;
+		}
+		return true;
+	}
+
+	// Unit separator commands
+	if(cmd[1] == 0x24) {
+		if(cmd_len < 6) {
+			return false;
+		}
+		cursor_x = cmd[2] | (cmd[3] << 8);
+		cursor_y = cmd[4] | (cmd[5] << 8);
+		return true;
+	}
+
+	if(cmd[1] != 0x28) {
+		stats.other_bytes += cmd_len;
+		return true;
+	}
+
+	if(cmd_len < 4) {
+		return false;
+	}
+
+	if(cmd[2] == 0x66 && cmd[3] == 0x11) {
+		// Real-time bit image at the cursor: 1F 28 66 11 xL xH yL yH g
+		if(cmd_len < 9) {
+			return false;
+		}
+		image_x = cursor_x;
+		image_y = cursor_y * 8;
+		image_w = cmd[4] | (cmd[5] << 8);
+		image_rows = cmd[6] | (cmd[7] << 8);
+	} else if(cmd[2] == 0x64 && cmd[3] == 0x21) {
+		// Dot unit image: 1F 28 64 21 xPL xPH yPL yPH xL xH yL yH g
+		if(cmd_len < 13) {
+			return false;
+		}
+		image_x = cmd[4] | (cmd[5] << 8);
+		image_y = cmd[6] | (cmd[7] << 8);
+		image_w = cmd[8] | (cmd[9] << 8);
+		image_rows = ((cmd[10] | (cmd[11] << 8)) + 7) / 8;
+	} else {
+		// Other extended commands (brightness, windows, fonts, ...) are not modelled
+		stats.other_bytes += cmd_len;
+		return true;
+	}
+
+	stats.images++;
+	image_index = 0;
+	image_remaining = (uint32_t) image_w * image_rows;
+	return true;
+}
+
+void NoritakeVFDEmulator::image_byte(uint8_t byte)
+{
+	stats.image_bytes++;
+	stats.busy_time_ns += link.busy_ns_per_byte;
+
+	uint16_t x = image_x + (image_index / image_rows);
+	uint16_t y = image_y + (image_index % image_rows) * 8;
+	image_index++;
+	image_remaining--;
+
+	if(x >= width || y >= height) {
+		stats.clipped_bytes++;
+		return;
+	}
+
+	for(uint8_t bit = 0; bit < 8 && (y + bit) < height; bit++) {
+		uint16_t dot_y = y + bit;
+		uint8_t* dst = &fb[(uint32_t) x * (height / 8) + (dot_y / 8)];
+		uint8_t mask = 0x80 >> (dot_y % 8);
+		bool lit = (byte & (0x80 >> bit)) != 0;
+		if(((*dst & mask) != 0) != lit) {
+			stats.dots_changed++;
+			if(lit) {
+				*dst |= mask;
+			} else {
+				*dst &= ~mask;
+			}
+		}
+	}
+}
+
+void NoritakeVFDEmulator::clear(void)
+{
+	memset(fb, 0, (uint32_t) width * (height / 8));
+}
+
+#endif /* MBED_CONF_MBED_LVGL_ENABLE_EMULATORS */
@@ -0,0 +1,165 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_EMULATORS_NORITAKEVFDEMULATOR_H_
+#define MBED_LVGL_EMULATORS_NORITAKEVFDEMULATOR_H_
+
+#if MBED_CONF_MBED_LVGL_ENABLE_EMULATORS
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "DisplayInterface.h"
+
+#include "platform/NonCopyable.h"
+
+/**
+ * Host-side emulator of a Noritake GU-series VFD module
+ *
+ * Stands in for the DisplayInterface of a NoritakeLVGL and decodes the
+ * byte stream into a 1-bit framebuffer. The graphic commands used by the
+ * driver are understood:
+ * - 1B 40: initialize (clears the display)
+ * - 0C: clear the display
+ * - 1F 24 xL xH yL yH: set the cursor (x in dots, y in 8-dot rows)
+ * - 1F 28 66 11 xL xH yL yH g d...: real-time bit image at the cursor
+ *   (x in dots, y in 8-dot rows)
+ * - 1F 28 64 21 xPL xPH yPL yPH xL xH yL yH g d...: dot unit image at a
+ *   position (all in dots)
+ * Image data is column by column, 8 vertical dots per byte, MSB on top.
+ * Other bytes are counted but do not change the framebuffer.
+ *
+ * Every byte is accounted for on a link model: 10 bit times per byte on
+ * an asynchronous serial link (8N1) or a fixed write cycle per byte on a
+ * parallel bus, plus the time the module is busy processing images.
+ */
+class NoritakeVFDEmulator : public DisplayInterface, private mbed::NonCopyable<NoritakeVFDEmulator>
+{
+	public:
+
+		/** Link model parameters */
+		typedef struct {
+			uint32_t baud;				/** Serial baud rate, 0 for a parallel bus */
+			uint32_t parallel_cycle_ns;	/** Write cycle per byte on a parallel bus */
+			uint32_t busy_ns_per_byte;	/** Module processing time per image data byte */
+		} link_config_t;
+
+		/** Link and module statistics */
+		typedef struct {
+			uint32_t bytes;				/** Bytes received */
+			uint32_t images;			/** Bit image commands */
+			uint32_t image_bytes;		/** Image data bytes */
+			uint32_t dots_changed;		/** Dots whose state changed */
+			uint32_t clipped_bytes;		/** Image bytes outside of the display (dropped) */
+			uint32_t other_bytes;		/** Bytes that are not part of a known command */
+			uint64_t link_time_ns;		/** Time spent transferring bytes */
+			uint64_t busy_time_ns;		/** Time the module spent processing images */
+		} stats_t;
+
+		/**
+		 * Instantiate a NoritakeVFDEmulator
+		 *
+		 * @param[in] width Width of the display in dots
+		 * @param[in] height Height of the display in dots (a multiple of 8)
+		 */
+		NoritakeVFDEmulator(uint16_t width = 128, uint16_t height = 32);
+
+		virtual ~NoritakeVFDEmulator();
+
+		/**
+		 * Sets the link model (defaults to 115200 baud serial, 10ns per image byte)
+		 */
+		void set_link_config(const link_config_t& config) {
+			link = config;
+		}
+
+		/*
+		 * @brief DisplayInterface implementation, the VFD has no command/data distinction
+		 */
+		virtual void write_command(uint8_t command);
+		virtual void write_data(uint8_t* data, uint32_t length);
+
+		/**
+		 * Gets the state of a dot
+		 */
+		bool get_dot(uint16_t x, uint16_t y) const;
+
+		/**
+		 * Writes the framebuffer to a binary PBM (P4) image, lit dots are black
+		 *
+		 * @retval false if the file could not be written
+		 */
+		bool write_pbm(const char* path) const;
+
+		/**
+		 * Gets the statistics accumulated since the last reset
+		 */
+		const stats_t& get_stats(void) const {
+			return stats;
+		}
+
+		/**
+		 * Resets the statistics (eg: at the start of each frame)
+		 */
+		void reset_stats(void);
+
+	protected:
+
+		/** Decodes one byte of the stream */
+		void receive(uint8_t byte);
+
+		/** Interprets the command collected so far, returns true once it is complete (or unknown) */
+		bool parse_command(void);
+
+		/** Stores one byte of image data */
+		void image_byte(uint8_t byte);
+
+		/** Clears the framebuffer */
+		void clear(void);
+
+	protected:
+
+		uint16_t width;
+		uint16_t height;
+
+		/** Framebuffer, column by column, 8 dots per byte, MSB on top */
+		uint8_t* fb;
+
+		/** Command being collected */
+		uint8_t cmd[16];
+		uint8_t cmd_len;
+
+		/** Image being received */
+		uint32_t image_remaining;
+		uint16_t image_x;
+		uint16_t image_y;
+		uint16_t image_w;
+		uint16_t image_rows;
+		uint32_t image_index;
+
+		/** Cursor (x in dots, y in 8-dot rows) */
+		uint16_t cursor_x;
+		uint16_t cursor_y;
+
+		link_config_t link;
+		stats_t stats;
+
+};
+
+#endif /* MBED_CONF_MBED_LVGL_ENABLE_EMULATORS */
+
+#endif /* MBED_LVGL_EMULATORS_NORITAKEVFDEMULATOR_H_ */
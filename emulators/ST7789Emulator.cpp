@@ -0,0 +1,471 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ST7789Emulator.h"
+
+#if MBED_CONF_MBED_LVGL_ENABLE_EMULATORS
+
+#include <stdio.h>
+#include <string.h>
+
+#include "platform/mbed_assert.h"
+
+/** ST7789 commands understood by the emulator */
+#define ST7789_SWRESET		0x01
+#define ST7789_CASET		0x2A
+#define ST7789_RASET		0x2B
+#define ST7789_RAMWR		0x2C
+#define ST7789_VSCRDEF		0x33
+#define ST7789_MADCTL		0x36
+#define ST7789_VSCRSADD		0x37
+#define ST7789_COLMOD		0x3A
+#define ST7789_RAMWRC		0x3C
+
+/** MADCTL bits */
+#define MADCTL_MY			0x80
+#define MADCTL_MX			0x40
+#define MADCTL_MV			0x20
+
+ST7789Emulator::ST7789Emulator(uint16_t panel_width, uint16_t panel_height,
+		uint16_t panel_x, uint16_t panel_y) :
+		panel_width(panel_width), panel_height(panel_height),
+		panel_x(panel_x), panel_y(panel_y), dc(false), in_cycle(false),
+		clock_ns(0), frame_period_ns(16666667), blanking_period_ns(600000), write_open(false)
+{
+	MBED_ASSERT(panel_x + panel_width <= GRAM_WIDTH);
+	MBED_ASSERT(panel_y + panel_height <= GRAM_HEIGHT);
+
+	gram = new uint16_t[GRAM_WIDTH * GRAM_HEIGHT];
+
+	bus.bitrate = 32000000;
+	bus.cs_overhead_ns = 200;
+	bus.dc_turnaround_ns = 20;
+	bus.idle_gap_ns = 2000;
+
+	reset();
+	reset_stats();
+}
+
+ST7789Emulator::~ST7789Emulator()
+{
+	delete[] gram;
+}
+
+void ST7789Emulator::reset(void)
+{
+	memset(gram, 0, GRAM_WIDTH * GRAM_HEIGHT * sizeof(uint16_t));
+
+	current_cmd = 0;
+	param_count = 0;
+	param_expected = 0;
+	ram_write = false;
+	pixel_half = false;
+	pixel_msb = 0;
+
+	xs = 0;
+	xe = GRAM_WIDTH - 1;
+	ys = 0;
+	ye = GRAM_HEIGHT - 1;
+	madctl = 0;
+	tfa = 0;
+	vsa = GRAM_HEIGHT;
+	bfa = 0;
+	vsp = 0;
+	col = 0;
+	row = 0;
+	counter_wrapped = false;
+	write_open = false;
+}
+
+void ST7789Emulator::reset_stats(void)
+{
+	memset(&stats, 0, sizeof(stats));
+}
+
+void ST7789Emulator::write_command(uint8_t command)
+{
+	begin_cycle();
+	set_dc(false);
+	clock_bytes(1);
+	this->command(command);
+	end_cycle();
+}
+
+void ST7789Emulator::write_data(uint8_t* data, uint32_t length)
+{
+	begin_cycle();
+	set_dc(true);
+	clock_bytes(length);
+	for(uint32_t i = 0; i < length; i++) {
+		this->data(data[i]);
+	}
+	end_cycle();
+}
+
+void ST7789Emulator::execute(const DisplayTransaction& transaction)
+{
+	begin_cycle();
+	for(size_t i = 0; i < transaction.get_step_count(); i++) {
+		const DisplayTransaction::step_t& step = transaction.get_step(i);
+		bool is_data = (step.type == DisplayTransaction::STEP_DATA);
+		set_dc(is_data);
+		clock_bytes(step.len);
+		for(uint32_t j = 0; j < step.len; j++) {
+			uint8_t byte = DisplayTransaction::get_row(step, j / step.row_len)[j % step.row_len];
+			if(is_data) {
+				data(byte);
+			} else {
+				command(byte);
+			}
+		}
+	}
+	end_cycle();
+}
+
+bool ST7789Emulator::wait(uint32_t timeout_ms)
+{
+	(void) timeout_ms;
+
+	// TE is raised as the panel's next frame starts with its blanking
+	end_ram_write();
+	clock_ns = ((clock_ns / frame_period_ns) + 1) * frame_period_ns;
+	return true;
+}
+
+uint32_t ST7789Emulator::get_period_us(void)
+{
+	return frame_period_ns / 1000;
+}
+
+uint16_t ST7789Emulator::get_gram_pixel(uint16_t x, uint16_t y) const
+{
+	MBED_ASSERT(x < GRAM_WIDTH && y < GRAM_HEIGHT);
+	return gram[(uint32_t) y * GRAM_WIDTH + x];
+}
+
+uint16_t ST7789Emulator::get_panel_pixel(uint16_t x, uint16_t y) const
+{
+	MBED_ASSERT(x < panel_width && y < panel_height);
+
+	// Scan line of the panel, remapped inside the vertical scroll area
+	uint16_t line = panel_y + y;
+	if(vsa != 0 && line >= tfa && line < (tfa + vsa)) {
+		uint16_t start = (vsp >= tfa && vsp < (tfa + vsa)) ? (vsp - tfa) : 0;
+		line = tfa + ((line - tfa) + start) % vsa;
+	}
+
+	return get_gram_pixel(panel_x + x, line);
+}
+
+bool ST7789Emulator::write_gram_ppm(const char* path) const
+{
+	return write_ppm(path, false);
+}
+
+bool ST7789Emulator::write_panel_ppm(const char* path) const
+{
+	return write_ppm(path, true);
+}
+
+bool ST7789Emulator::write_ppm(const char* path, bool panel) const
+{
+	FILE* file = fopen(path, "wb");
+	if(file == NULL) {
+		return false;
+	}
+
+	uint16_t w = panel ? panel_width : GRAM_WIDTH;
+	uint16_t h = panel ? panel_height : GRAM_HEIGHT;
+	fprintf(file, "P6\n%u %u\n255\n", w, h);
+
+	for(uint16_t y = 0; y < h; y++) {
+		for(uint16_t x = 0; x < w; x++) {
+			uint16_t px = panel ? get_panel_pixel(x, y) : get_gram_pixel(x, y);
+			uint8_t r = (px >> 11) & 0x1F;
+			uint8_t g = (px >> 5) & 0x3F;
+			uint8_t b = px & 0x1F;
+			uint8_t rgb[3] = {
+				(uint8_t)((r << 3) | (r >> 2)),
+				(uint8_t)((g << 2) | (g >> 4)),
+				(uint8_t)((b << 3) | (b >> 2)),
+			};
+			fwrite(rgb, 1, sizeof(rgb), file);
+		}
+	}
+
+	bool ok = (ferror(file) == 0);
+	fclose(file);
+	return ok;
+}
+
+void ST7789Emulator::begin_cycle(void)
+{
+	MBED_ASSERT(!in_cycle);
+	if(stats.cs_cycles != 0) {
+		stats.idle_time_ns += bus.idle_gap_ns;
+		clock_ns += bus.idle_gap_ns;
+	}
+	stats.cs_cycles++;
+	stats.bus_time_ns += bus.cs_overhead_ns;
+	clock_ns += bus.cs_overhead_ns;
+	in_cycle = true;
+}
+
+void ST7789Emulator::end_cycle(void)
+{
+	in_cycle = false;
+	if(write_open) {
+		write_end_ns = clock_ns;
+	}
+}
+
+void ST7789Emulator::set_dc(bool data)
+{
+	if(data != dc) {
+		dc = data;
+		stats.dc_toggles++;
+		stats.bus_time_ns += bus.dc_turnaround_ns;
+		clock_ns += bus.dc_turnaround_ns;
+	}
+}
+
+void ST7789Emulator::clock_bytes(uint32_t count)
+{
+	uint64_t ns = ((uint64_t) count * 8 * 1000000000ull) / bus.bitrate;
+	stats.bus_time_ns += ns;
+	clock_ns += ns;
+}
+
+void ST7789Emulator::end_ram_write(void)
+{
+	if(!write_open) {
+		return;
+	}
+	write_open = false;
+	stats.windows_written++;
+
+	// Rows the panel shows (vertical scrolling is not taken into account)
+	int32_t first = (int32_t) write_first_row - panel_y;
+	int32_t last = (int32_t) write_last_row - panel_y;
+	if(last < 0 || first >= panel_height) {
+		return;
+	}
+	if(first < 0) {
+		first = 0;
+	}
+	if(last >= panel_height) {
+		last = panel_height - 1;
+	}
+
+	// The rows are taken as written at a steady pace over the write, the
+	// panel shows a mix of old and new rows if, in a frame scanned during the
+	// write, the scan is behind the write at one end of the rows and ahead
+	// of it at the other
+	uint64_t rows = (uint64_t) write_last_row - write_first_row + 1;
+	uint64_t duration = write_end_ns - write_start_ns;
+	int64_t written_first = (int64_t)(write_start_ns + ((first + panel_y - write_first_row) * duration) / rows);
+	int64_t written_last = (int64_t)(write_start_ns + ((last + panel_y - write_first_row) * duration) / rows);
+
+	bool torn = false;
+	for(uint64_t frame = write_start_ns / frame_period_ns; frame <= write_end_ns / frame_period_ns; frame++) {
+		int64_t scanned_first = (int64_t)(frame * frame_period_ns + scan_time(first));
+		int64_t scanned_last = (int64_t)(frame * frame_period_ns + scan_time(last));
+		if((scanned_first < written_first) != (scanned_last < written_last)) {
+			torn = true;
+			break;
+		}
+	}
+
+	if(torn) {
+		stats.torn_writes++;
+	}
+}
+
+uint64_t ST7789Emulator::scan_time(uint16_t line) const
+{
+	return blanking_period_ns + ((uint64_t) line * (frame_period_ns - blanking_period_ns)) / panel_height;
+}
+
+void ST7789Emulator::command(uint8_t cmd)
+{
+	stats.commands++;
+
+	if(cmd != ST7789_RAMWRC) {
+		end_ram_write();
+	}
+
+	current_cmd = cmd;
+	param_count = 0;
+	ram_write = false;
+	pixel_half = false;
+
+	switch(cmd) {
+		case ST7789_SWRESET:
+			reset();
+			param_expected = 0;
+			break;
+		case ST7789_CASET:
+		case ST7789_RASET:
+			param_expected = 4;
+			break;
+		case ST7789_VSCRDEF:
+			param_expected = 6;
+			break;
+		case ST7789_VSCRSADD:
+			param_expected = 2;
+			break;
+		case ST7789_MADCTL:
+		case ST7789_COLMOD:
+			param_expected = 1;
+			break;
+		case ST7789_RAMWR:
+			// Writing starts over at the top-left of the window
+			col = xs;
+			row = ys;
+			counter_wrapped = false;
+			ram_write = true;
+			param_expected = 0;
+			write_open = true;
+			write_start_ns = clock_ns;
+			write_end_ns = clock_ns;
+			write_first_row = 0xFFFF;
+			write_last_row = 0;
+			break;
+		case ST7789_RAMWRC:
+			// Writing carries on at the address counter
+			ram_write = true;
+			param_expected = 0;
+			break;
+		default:
+			// Other commands (power, gamma, ...) don't affect the model
+			param_expected = 0;
+			break;
+	}
+}
+
+void ST7789Emulator::data(uint8_t byte)
+{
+	stats.data_bytes++;
+
+	if(ram_write) {
+		// RGB565, high byte first
+		if(!pixel_half) {
+			pixel_msb = byte;
+			pixel_half = true;
+		} else {
+			store_pixel(((uint16_t) pixel_msb << 8) | byte);
+			pixel_half = false;
+		}
+		return;
+	}
+
+	if(param_count < param_expected) {
+		params[param_count++] = byte;
+		if(param_count == param_expected) {
+			apply_params();
+		}
+	}
+}
+
+void ST7789Emulator::apply_params(void)
+{
+	switch(current_cmd) {
+		case ST7789_CASET:
+			xs = (params[0] << 8) | params[1];
+			xe = (params[2] << 8) | params[3];
+			break;
+		case ST7789_RASET:
+			ys = (params[0] << 8) | params[1];
+			ye = (params[2] << 8) | params[3];
+			break;
+		case ST7789_VSCRDEF:
+			tfa = (params[0] << 8) | params[1];
+			vsa = (params[2] << 8) | params[3];
+			bfa = (params[4] << 8) | params[5];
+			break;
+		case ST7789_VSCRSADD:
+			vsp = (params[0] << 8) | params[1];
+			break;
+		case ST7789_MADCTL:
+			madctl = params[0];
+			break;
+		default:
+			break;
+	}
+}
+
+void ST7789Emulator::store_pixel(uint16_t pixel)
+{
+	// Only count a wrap when a pixel goes past the end of the window, not when it is exactly filled
+	if(counter_wrapped) {
+		stats.window_wraps++;
+		counter_wrapped = false;
+	}
+
+	uint16_t x, y;
+	if(map_address(col, row, &x, &y)) {
+		gram[(uint32_t) y * GRAM_WIDTH + x] = pixel;
+		stats.pixels++;
+		if(write_open) {
+			if(y < write_first_row) {
+				write_first_row = y;
+			}
+			if(y > write_last_row) {
+				write_last_row = y;
+			}
+		}
+	} else {
+		stats.out_of_range++;
+	}
+
+	// The address counter wraps inside the window
+	if(col < xe) {
+		col++;
+		return;
+	}
+	col = xs;
+	if(row < ye) {
+		row++;
+		return;
+	}
+	row = ys;
+	counter_wrapped = true;
+}
+
+bool ST7789Emulator::map_address(uint16_t col, uint16_t row, uint16_t* x, uint16_t* y) const
+{
+	bool exchange = (madctl & MADCTL_MV) != 0;
+	uint16_t col_max = exchange ? (GRAM_HEIGHT - 1) : (GRAM_WIDTH - 1);
+	uint16_t row_max = exchange ? (GRAM_WIDTH - 1) : (GRAM_HEIGHT - 1);
+
+	if(col > col_max || row > row_max) {
+		return false;
+	}
+
+	if(madctl & MADCTL_MX) {
+		col = col_max - col;
+	}
+	if(madctl & MADCTL_MY) {
+		row = row_max - row;
+	}
+
+	*x = exchange ? row : col;
+	*y = exchange ? col : row;
+	return true;
+}
+
+#endif /* MBED_CONF_MBED_LVGL_ENABLE_EMULATORS */
@@ -0,0 +1,289 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_EMULATORS_ST7789EMULATOR_H_
+#define MBED_LVGL_EMULATORS_ST7789EMULATOR_H_
+
+#if MBED_CONF_MBED_LVGL_ENABLE_EMULATORS
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "DisplayInterface.h"
+#include "drivers/DisplayTransaction.h"
+#include "LVGLFrameSync.h"
+
+#include "platform/NonCopyable.h"
+
+/**
+ * Host-side emulator of an ST7789 display controller
+ *
+ * Stands in for the DisplayInterface of an ST7789LVGL (and for its
+ * BatchedDisplayInterface) and executes the command stream against a
+ * model of the controller:
+ * - 240x320 display RAM (GRAM) in RGB565 (COLMOD 0x55)
+ * - CASET/RASET windows, RAMWR/RAMWRC with the address counter wrapping
+ *   inside the window like the real controller
+ * - MADCTL row/column order and exchange (rotation)
+ * - VSCRDEF/VSCRSADD vertical scrolling, applied to what the panel shows
+ *
+ * Every transfer is also accounted for on a bus model: each call of the
+ * interface is one chip-select cycle with a fixed overhead, each byte
+ * costs 8 bit times at the configured bitrate and each D/C change inside
+ * a chained transaction costs a small turnaround. The idle gap between
+ * chip-select cycles models the software latency of starting a transfer.
+ *
+ * The panel's scan is modelled too: the emulator keeps a clock advanced by
+ * the bus model (and by advance() for time spent elsewhere) and, after a
+ * vertical blanking, the panel reads one line after the other over each
+ * frame period. A RAM write is
+ * counted as torn if the panel shows a frame with part of its rows old and
+ * part new, ie: the scan crossed the write. As a
+ * LVGLFrameSync it stands in for the TE signal, wait() skipping the clock
+ * to the start of the next frame.
+ *
+ * GRAM and the panel's view of it can be dumped to PPM images.
+ */
+class ST7789Emulator : public DisplayInterface, public BatchedDisplayInterface,
+		public LVGLFrameSync, private mbed::NonCopyable<ST7789Emulator>
+{
+	public:
+
+		/** Display RAM size */
+		static const uint16_t GRAM_WIDTH = 240;
+		static const uint16_t GRAM_HEIGHT = 320;
+
+		/** Bus model parameters */
+		typedef struct {
+			uint32_t bitrate;			/** Bus clock in bits per second */
+			uint32_t cs_overhead_ns;	/** Chip-select setup and hold per cycle */
+			uint32_t dc_turnaround_ns;	/** D/C change inside a chained transaction */
+			uint32_t idle_gap_ns;		/** Idle time between chip-select cycles */
+		} bus_config_t;
+
+		/** Bus and controller statistics */
+		typedef struct {
+			uint32_t cs_cycles;			/** Chip-select cycles (transactions) */
+			uint32_t dc_toggles;		/** D/C line changes */
+			uint32_t commands;			/** Command bytes */
+			uint32_t data_bytes;		/** Parameter and pixel bytes */
+			uint32_t pixels;			/** Pixels written to GRAM */
+			uint32_t window_wraps;		/** RAM writes that ran past the end of the window */
+			uint32_t out_of_range;		/** Pixels addressed outside of GRAM (dropped) */
+			uint64_t bus_time_ns;		/** Time the bus was busy */
+			uint64_t idle_time_ns;		/** Time between chip-select cycles */
+			uint32_t windows_written;	/** RAM writes (RAMWR and its RAMWRC continuations) */
+			uint32_t torn_writes;		/** RAM writes scanned by the panel while in progress */
+		} stats_t;
+
+		/**
+		 * Instantiate an ST7789Emulator
+		 *
+		 * @param[in] panel_width Width of the panel in pixels (at most 240)
+		 * @param[in] panel_height Height of the panel in pixels (at most 320)
+		 * @param[in] panel_x First GRAM column shown by the panel
+		 * @param[in] panel_y First GRAM row shown by the panel
+		 */
+		ST7789Emulator(uint16_t panel_width = GRAM_WIDTH, uint16_t panel_height = GRAM_HEIGHT,
+				uint16_t panel_x = 0, uint16_t panel_y = 0);
+
+		virtual ~ST7789Emulator();
+
+		/**
+		 * Sets the bus model (defaults to 32MHz SPI, 200ns CS overhead,
+		 * 20ns D/C turnaround and a 2us gap between transfers)
+		 */
+		void set_bus_config(const bus_config_t& config) {
+			bus = config;
+		}
+
+		/**
+		 * Sets the panel's frame timing (defaults to 60Hz, 600us of blanking)
+		 *
+		 * @param[in] period_ns Refresh period
+		 * @param[in] blanking_ns Vertical blanking at the start of each frame, TE is raised when it starts
+		 */
+		void set_frame_timing(uint32_t period_ns, uint32_t blanking_ns) {
+			frame_period_ns = period_ns;
+			blanking_period_ns = blanking_ns;
+		}
+
+		/**
+		 * Advances the clock by time spent away from the bus (eg: rendering)
+		 */
+		void advance(uint64_t ns) {
+			clock_ns += ns;
+		}
+
+		/**
+		 * Gets the emulator's clock, it is not affected by reset_stats()
+		 */
+		uint64_t get_clock_ns(void) const {
+			return clock_ns;
+		}
+
+		/**
+		 * Resets the controller (registers and GRAM) as SWRESET does
+		 */
+		void reset(void);
+
+		/*
+		 * @brief DisplayInterface implementation, one chip-select cycle per call
+		 */
+		virtual void write_command(uint8_t command);
+		virtual void write_data(uint8_t* data, uint32_t length);
+
+		/*
+		 * @brief BatchedDisplayInterface implementation, one chip-select cycle per transaction
+		 */
+		virtual void execute(const DisplayTransaction& transaction);
+
+		/*
+		 * @brief LVGLFrameSync implementation, the TE signal of the modelled panel
+		 */
+		virtual bool wait(uint32_t timeout_ms);
+		virtual uint32_t get_period_us(void);
+
+		/**
+		 * Gets a pixel of display RAM (RGB565)
+		 */
+		uint16_t get_gram_pixel(uint16_t x, uint16_t y) const;
+
+		/**
+		 * Gets a pixel as shown by the panel, after vertical scrolling (RGB565)
+		 *
+		 * @param[in] x Column of the panel
+		 * @param[in] y Row of the panel
+		 */
+		uint16_t get_panel_pixel(uint16_t x, uint16_t y) const;
+
+		/**
+		 * Writes display RAM to a binary PPM (P6) image
+		 *
+		 * @retval false if the file could not be written
+		 */
+		bool write_gram_ppm(const char* path) const;
+
+		/**
+		 * Writes what the panel shows to a binary PPM (P6) image
+		 *
+		 * @retval false if the file could not be written
+		 */
+		bool write_panel_ppm(const char* path) const;
+
+		/**
+		 * Gets the statistics accumulated since the last reset
+		 */
+		const stats_t& get_stats(void) const {
+			return stats;
+		}
+
+		/**
+		 * Resets the statistics (eg: at the start of each frame)
+		 */
+		void reset_stats(void);
+
+	protected:
+
+		/** Starts a chip-select cycle on the bus model */
+		void begin_cycle(void);
+
+		/** Ends a chip-select cycle on the bus model */
+		void end_cycle(void);
+
+		/** Sets the D/C line, counting changes */
+		void set_dc(bool data);
+
+		/** Accounts for bytes on the bus model */
+		void clock_bytes(uint32_t count);
+
+		/** Closes the RAM write in progress, checking it against the panel's scan */
+		void end_ram_write(void);
+
+		/** Gets when a panel line is scanned, from the start of a frame */
+		uint64_t scan_time(uint16_t line) const;
+
+		/** Decodes a command byte */
+		void command(uint8_t cmd);
+
+		/** Decodes a data byte (parameter or pixel) */
+		void data(uint8_t byte);
+
+		/** Executes the current command once all its parameters arrived */
+		void apply_params(void);
+
+		/** Stores a pixel at the address counter and advances it */
+		void store_pixel(uint16_t pixel);
+
+		/** Maps the address counter to a GRAM address through MADCTL */
+		bool map_address(uint16_t col, uint16_t row, uint16_t* x, uint16_t* y) const;
+
+		bool write_ppm(const char* path, bool panel) const;
+
+	protected:
+
+		uint16_t* gram;
+
+		uint16_t panel_width;
+		uint16_t panel_height;
+		uint16_t panel_x;
+		uint16_t panel_y;
+
+		/** Command being decoded, its parameters and how many it expects */
+		uint8_t current_cmd;
+		uint8_t params[8];
+		uint8_t param_count;
+		uint8_t param_expected;
+
+		/** Writing pixels to GRAM (after RAMWR/RAMWRC) */
+		bool ram_write;
+		uint8_t pixel_msb;
+		bool pixel_half;
+
+		/** Registers */
+		uint16_t xs, xe, ys, ye;
+		uint8_t madctl;
+		uint16_t tfa, vsa, bfa;
+		uint16_t vsp;
+
+		/** Address counter, and whether it went back to the window's top-left */
+		uint16_t col, row;
+		bool counter_wrapped;
+
+		/** Bus model */
+		bus_config_t bus;
+		bool dc;
+		bool in_cycle;
+		stats_t stats;
+
+		/** Scan model */
+		uint64_t clock_ns;
+		uint32_t frame_period_ns;
+		uint32_t blanking_period_ns;
+
+		/** RAM write in progress: when it started and ended, GRAM rows it touched */
+		bool write_open;
+		uint64_t write_start_ns;
+		uint64_t write_end_ns;
+		uint16_t write_first_row;
+		uint16_t write_last_row;
+
+};
+
+#endif /* MBED_CONF_MBED_LVGL_ENABLE_EMULATORS */
+
+#endif /* MBED_LVGL_EMULATORS_ST7789EMULATOR_H_ */
@@ -0,0 +1,271 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StreamFont.h"
+
+#if LV_USE_FILESYSTEM
+
+#include <string.h>
+
+#include "platform/mbed_debug.h"
+
+#define STREAM_FONT_HEADER_SIZE		32
+#define STREAM_FONT_RANGE_SIZE		12
+#define STREAM_FONT_GLYPH_SIZE		12
+#define STREAM_FONT_VERSION			1
+
+static inline uint16_t get_u16(const uint8_t* p)
+{
+	return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t* p)
+{
+	return ((uint32_t) p[0]) | ((uint32_t) p[1] << 8) |
+			((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+StreamFont::StreamFont(size_t cache_slots, uint32_t max_bitmap_size) :
+		is_open(false), bpp(0), glyph_table_offset(0),
+		ranges(NULL), range_count(0),
+		slots(new slot_t[cache_slots]()), slot_count(cache_slots),
+		bitmap_pool(new uint8_t[cache_slots * max_bitmap_size]),
+		max_bitmap_size(max_bitmap_size), last_slot(NULL),
+		use_counter(0), cache_hits(0), cache_misses(0)
+{
+	memset(&font, 0, sizeof(font));
+	memset(&file, 0, sizeof(file));
+
+	for(size_t i = 0; i < slot_count; i++) {
+		slots[i].bitmap = &bitmap_pool[i * max_bitmap_size];
+	}
+}
+
+StreamFont::~StreamFont()
+{
+	close();
+	delete[] slots;
+	delete[] bitmap_pool;
+}
+
+bool StreamFont::open(const char* path)
+{
+	close();
+
+	if(lv_fs_open(&file, path, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+		debug("StreamFont: cannot open %s\n", path);
+		return false;
+	}
+	is_open = true;
+
+	uint8_t header[STREAM_FONT_HEADER_SIZE];
+	if(!read(0, header, sizeof(header)) || memcmp(header, "LVSF", 4) != 0 ||
+			get_u16(&header[4]) != STREAM_FONT_VERSION) {
+		debug("StreamFont: %s is not a stream font\n", path);
+		close();
+		return false;
+	}
+
+	bpp = header[6];
+	range_count = get_u32(&header[12]);
+	glyph_table_offset = get_u32(&header[20]);
+
+	if(get_u32(&header[24]) > max_bitmap_size) {
+		debug("StreamFont: glyphs of %s exceed the configured max glyph size\n", path);
+		close();
+		return false;
+	}
+
+	// A truncated or corrupt file must not size the allocation below
+	uint64_t range_table_end = STREAM_FONT_HEADER_SIZE +
+			((uint64_t) range_count * STREAM_FONT_RANGE_SIZE);
+	if(!fits(range_table_end)) {
+		debug("StreamFont: range table of %s is larger than the file\n", path);
+		close();
+		return false;
+	}
+
+	// The range table is the only part of the font kept resident
+	ranges = new range_t[range_count];
+	for(uint32_t i = 0; i < range_count; i++) {
+		uint8_t entry[STREAM_FONT_RANGE_SIZE];
+		if(!read(STREAM_FONT_HEADER_SIZE + (i * STREAM_FONT_RANGE_SIZE), entry, sizeof(entry))) {
+			close();
+			return false;
+		}
+		ranges[i].first = get_u32(&entry[0]);
+		ranges[i].length = get_u16(&entry[4]);
+		ranges[i].glyph_id = get_u32(&entry[8]);
+	}
+
+	font.get_glyph_dsc = &StreamFont::get_glyph_dsc;
+	font.get_glyph_bitmap = &StreamFont::get_glyph_bitmap;
+	font.line_height = get_u16(&header[8]);
+	font.base_line = get_u16(&header[10]);
+	font.dsc = this;
+
+	return true;
+}
+
+void StreamFont::close(void)
+{
+	if(is_open) {
+		lv_fs_close(&file);
+		is_open = false;
+	}
+
+	delete[] ranges;
+	ranges = NULL;
+	range_count = 0;
+
+	for(size_t i = 0; i < slot_count; i++) {
+		slots[i].letter = 0;
+	}
+	last_slot = NULL;
+
+	font.get_glyph_dsc = NULL;
+	font.get_glyph_bitmap = NULL;
+}
+
+StreamFont::slot_t* StreamFont::get_slot(uint32_t letter)
+{
+	if(letter == 0 || !is_open) {
+		return NULL;
+	}
+
+	if(last_slot != NULL && last_slot->letter == letter) {
+		cache_hits++;
+		return last_slot;
+	}
+
+	slot_t* lru = &slots[0];
+	for(size_t i = 0; i < slot_count; i++) {
+		slot_t* slot = &slots[i];
+		if(slot->letter == letter) {
+			cache_hits++;
+			slot->last_use = ++use_counter;
+			last_slot = slot;
+			return slot;
+		}
+
+		// Free slots are always preferred over used ones
+		if(lru->letter != 0 && (slot->letter == 0 ||
+				(int32_t)(slot->last_use - lru->last_use) < 0)) {
+			lru = slot;
+		}
+	}
+
+	cache_misses++;
+
+	uint32_t glyph_id;
+	if(!find_glyph_id(letter, &glyph_id)) {
+		return NULL;
+	}
+
+	uint8_t entry[STREAM_FONT_GLYPH_SIZE];
+	if(!read(glyph_table_offset + (glyph_id * STREAM_FONT_GLYPH_SIZE), entry, sizeof(entry))) {
+		return NULL;
+	}
+
+	lv_font_glyph_dsc_t dsc;
+	dsc.adv_w = (get_u16(&entry[4]) + (1 << 3)) >> 4;
+	dsc.box_w = entry[6];
+	dsc.box_h = entry[7];
+	dsc.ofs_x = (int8_t) entry[8];
+	dsc.ofs_y = (int8_t) entry[9];
+	dsc.bpp = bpp;
+
+	uint32_t bitmap_size = ((uint32_t) dsc.box_w * dsc.box_h * bpp + 7) >> 3;
+	if(bitmap_size > max_bitmap_size || !read(get_u32(&entry[0]), lru->bitmap, bitmap_size)) {
+		lru->letter = 0;
+		return NULL;
+	}
+
+	lru->letter = letter;
+	lru->dsc = dsc;
+	lru->last_use = ++use_counter;
+	last_slot = lru;
+	return lru;
+}
+
+bool StreamFont::find_glyph_id(uint32_t letter, uint32_t* glyph_id)
+{
+	// Binary search the resident range table
+	uint32_t low = 0;
+	uint32_t high = range_count;
+	while(low < high) {
+		uint32_t mid = low + ((high - low) >> 1);
+		const range_t& range = ranges[mid];
+		if(letter < range.first) {
+			high = mid;
+		} else if(letter >= range.first + range.length) {
+			low = mid + 1;
+		} else {
+			*glyph_id = range.glyph_id + (letter - range.first);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool StreamFont::fits(uint64_t end)
+{
+	uint32_t size;
+	if(lv_fs_size(&file, &size) == LV_FS_RES_OK) {
+		return (end <= size);
+	}
+
+	// The driver cannot tell the size, the last byte must be readable then
+	uint8_t last;
+	return (end <= UINT32_MAX) && (end == 0 || read((uint32_t)(end - 1), &last, 1));
+}
+
+bool StreamFont::read(uint32_t pos, void* buf, uint32_t len)
+{
+	uint32_t br = 0;
+	if(lv_fs_seek(&file, pos) != LV_FS_RES_OK) {
+		return false;
+	}
+	if(lv_fs_read(&file, buf, len, &br) != LV_FS_RES_OK) {
+		return false;
+	}
+	return (br == len);
+}
+
+bool StreamFont::get_glyph_dsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc_out,
+		uint32_t letter, uint32_t letter_next)
+{
+	StreamFont* instance = (StreamFont*) font->dsc;
+	slot_t* slot = instance->get_slot(letter);
+	if(slot == NULL) {
+		return false;
+	}
+	*dsc_out = slot->dsc;
+	return true;
+}
+
+const uint8_t* StreamFont::get_glyph_bitmap(const lv_font_t* font, uint32_t letter)
+{
+	StreamFont* instance = (StreamFont*) font->dsc;
+	slot_t* slot = instance->get_slot(letter);
+	if(slot == NULL) {
+		return NULL;
+	}
+	return slot->bitmap;
+}
+
+#endif /* LV_USE_FILESYSTEM */
@@ -0,0 +1,191 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_FONTS_STREAMFONT_H_
+#define MBED_LVGL_FONTS_STREAMFONT_H_
+
+#if LV_USE_FILESYSTEM
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lv_font.h"
+#include "lv_fs.h"
+
+#include "platform/NonCopyable.h"
+
+/**
+ * Font backend that streams glyphs from a file on demand
+ *
+ * Only the codepoint range table is kept in RAM. Glyph descriptors and
+ * bitmaps are read from the file (eg: through the 'M' filesystem driver)
+ * when first needed and kept in a fixed number of cache slots, so very
+ * large fonts (CJK, icon sets) can be used with a few KB of RAM.
+ *
+ * Use tools/stream_font_conv.py to convert TTF/OTF or BDF fonts.
+ *
+ * File format (all fields little endian):
+ *
+ * Header (32 bytes)
+ *   char     magic[4]            "LVSF"
+ *   uint16_t version             1
+ *   uint8_t  bpp                 1, 2, 4 or 8
+ *   uint8_t  reserved
+ *   uint16_t line_height
+ *   uint16_t base_line
+ *   uint32_t range_count
+ *   uint32_t glyph_count
+ *   uint32_t glyph_table_offset  file offset of the glyph table
+ *   uint32_t max_bitmap_size     size in bytes of the largest glyph bitmap
+ *   uint32_t reserved
+ *
+ * Range table (range_count * 12 bytes, sorted by codepoint, follows the header)
+ *   uint32_t first               first codepoint of the range
+ *   uint16_t length              number of consecutive codepoints in the range
+ *   uint16_t reserved
+ *   uint32_t glyph_id            glyph table index of the first codepoint
+ *
+ * Glyph table (glyph_count * 12 bytes)
+ *   uint32_t bitmap_offset       file offset of the glyph's bitmap
+ *   uint16_t adv_w               advance width in 1/16 px
+ *   uint8_t  box_w
+ *   uint8_t  box_h
+ *   int8_t   ofs_x
+ *   int8_t   ofs_y
+ *   uint16_t reserved
+ *
+ * Bitmaps are packed the same way as lvgl's built-in fonts (bpp bits per
+ * pixel, rows are not padded).
+ */
+class StreamFont : private mbed::NonCopyable<StreamFont>
+{
+	public:
+
+		/**
+		 * Instantiate a StreamFont
+		 *
+		 * @param[in] cache_slots Number of glyphs kept in RAM at once
+		 * @param[in] max_bitmap_size Largest glyph bitmap (in bytes) the cache accepts
+		 */
+		StreamFont(size_t cache_slots = MBED_CONF_MBED_LVGL_STREAM_FONT_CACHE_SLOTS,
+				uint32_t max_bitmap_size = MBED_CONF_MBED_LVGL_STREAM_FONT_MAX_GLYPH_SIZE);
+
+		~StreamFont();
+
+		/**
+		 * Opens a font file and loads its range table
+		 *
+		 * @param[in] path lvgl path of the font file (eg: "M:/fonts/cjk_24.lvsf")
+		 *
+		 * @retval true if the font is ready to use
+		 *
+		 * @note The file is kept open until close() is called
+		 */
+		bool open(const char* path);
+
+		/**
+		 * Closes the font file and releases all RAM held by the font
+		 *
+		 * @note The font must not be in use by any object when closed
+		 */
+		void close(void);
+
+		/**
+		 * Gets the lvgl font handle, to be used in styles
+		 *
+		 * @retval pointer to lvgl font
+		 */
+		const lv_font_t* get_lv_font(void) const {
+			return &font;
+		}
+
+		/** Number of glyph lookups served from the cache */
+		uint32_t get_cache_hits(void) const {
+			return cache_hits;
+		}
+
+		/** Number of glyph lookups that had to read the file */
+		uint32_t get_cache_misses(void) const {
+			return cache_misses;
+		}
+
+	protected:
+
+		/** Resident codepoint range */
+		typedef struct {
+			uint32_t first;
+			uint16_t length;
+			uint32_t glyph_id;
+		} range_t;
+
+		/** Cached glyph */
+		typedef struct {
+			uint32_t letter;		/** Codepoint (0 if slot is free) */
+			lv_font_glyph_dsc_t dsc;
+			uint32_t last_use;
+			uint8_t* bitmap;		/** Points into the bitmap pool */
+		} slot_t;
+
+		/** Finds (or loads) the cache slot for a letter */
+		slot_t* get_slot(uint32_t letter);
+
+		/** Looks up the glyph id of a letter in the range table */
+		bool find_glyph_id(uint32_t letter, uint32_t* glyph_id);
+
+		/** Checks the font file is at least end bytes long */
+		bool fits(uint64_t end);
+
+		/** Reads len bytes at pos from the font file */
+		bool read(uint32_t pos, void* buf, uint32_t len);
+
+		/*
+		 * @brief Internal functions for bridging lvgl's font interface to this instance
+		 */
+		static bool get_glyph_dsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc_out,
+				uint32_t letter, uint32_t letter_next);
+		static const uint8_t* get_glyph_bitmap(const lv_font_t* font, uint32_t letter);
+
+	protected:
+
+		lv_font_t font;
+
+		lv_fs_file_t file;
+		bool is_open;
+
+		uint8_t bpp;
+		uint32_t glyph_table_offset;
+
+		range_t* ranges;
+		uint32_t range_count;
+
+		slot_t* slots;
+		size_t slot_count;
+		uint8_t* bitmap_pool;
+		uint32_t max_bitmap_size;
+
+		/** Last slot hit, lvgl asks for the descriptor and bitmap of a glyph back-to-back */
+		slot_t* last_slot;
+
+		uint32_t use_counter;
+		uint32_t cache_hits;
+		uint32_t cache_misses;
+
+};
+
+#endif /* LV_USE_FILESYSTEM */
+
+#endif /* MBED_LVGL_FONTS_STREAMFONT_H_ */
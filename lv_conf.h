@@ -83,6 +83,14 @@ typedef int16_t lv_coord_t;
 
 /* Automatically defrag. on free. Defrag. means joining the adjacent free cells. */
 #  define LV_MEM_AUTO_DEFRAG  1
+#elif MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING
+#  define LV_MEM_CUSTOM_INCLUDE "platform/mem_accounting.h"  /*Account allocations per tag (and trace them)*/
+#  define LV_MEM_CUSTOM_ALLOC   mbed_lvgl_mem_alloc
+#  define LV_MEM_CUSTOM_FREE    mbed_lvgl_mem_free
+#elif MBED_CONF_MBED_LVGL_ENABLE_TRACE
+#  define LV_MEM_CUSTOM_INCLUDE "platform/trace.h"  /*Record allocations in the trace*/
+#  define LV_MEM_CUSTOM_ALLOC   mbed_lvgl_trace_malloc
+#  define LV_MEM_CUSTOM_FREE    mbed_lvgl_trace_free
 #else       /*LV_MEM_CUSTOM*/
 #  define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
 #  define LV_MEM_CUSTOM_ALLOC   malloc       /*Wrapper to malloc*/
@@ -0,0 +1,181 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AssetCache.h"
+
+#if MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT
+
+#include <string.h>
+
+#include "platform/mbed_assert.h"
+#include "platform/ScopedLock.h"
+
+AssetCache::AssetCache(uint32_t max_bytes, size_t max_entries) :
+		entries(new entry_t[max_entries]()), max_entries(max_entries),
+		max_bytes(max_bytes), used_bytes(0), use_counter(0)
+{ }
+
+AssetCache::~AssetCache()
+{
+	for(size_t i = 0; i < max_entries; i++) {
+		if(entries[i].path != NULL) {
+			remove(&entries[i]);
+		}
+	}
+	delete[] entries;
+}
+
+bool AssetCache::contains(const char* path)
+{
+	mbed::ScopedLock<rtos::Mutex> lock(mutex);
+	return (find(path) != NULL);
+}
+
+bool AssetCache::reserve(uint32_t size)
+{
+	mbed::ScopedLock<rtos::Mutex> lock(mutex);
+	return make_room(size);
+}
+
+bool AssetCache::insert(const char* path, uint8_t* data, uint32_t size)
+{
+	mbed::ScopedLock<rtos::Mutex> lock(mutex);
+
+	// Already cached (eg: prefetched twice), keep the existing copy
+	if(find(path) != NULL) {
+		delete[] data;
+		return true;
+	}
+
+	if(!make_room(size)) {
+		delete[] data;
+		return false;
+	}
+
+	// make_room guarantees a free entry is available
+	for(size_t i = 0; i < max_entries; i++) {
+		entry_t* entry = &entries[i];
+		if(entry->path == NULL) {
+			entry->path = new char[strlen(path) + 1];
+			strcpy(entry->path, path);
+			entry->data = data;
+			entry->size = size;
+			entry->last_use = ++use_counter;
+			entry->pins = 0;
+			used_bytes += size;
+			return true;
+		}
+	}
+
+	delete[] data;
+	return false;
+}
+
+bool AssetCache::acquire(const char* path, const uint8_t** data, uint32_t* size)
+{
+	mbed::ScopedLock<rtos::Mutex> lock(mutex);
+
+	entry_t* entry = find(path);
+	if(entry == NULL) {
+		return false;
+	}
+
+	entry->pins++;
+	entry->last_use = ++use_counter;
+	*data = entry->data;
+	*size = entry->size;
+	return true;
+}
+
+void AssetCache::release(const uint8_t* data)
+{
+	mbed::ScopedLock<rtos::Mutex> lock(mutex);
+
+	for(size_t i = 0; i < max_entries; i++) {
+		entry_t* entry = &entries[i];
+		if(entry->path != NULL && entry->data == data) {
+			MBED_ASSERT(entry->pins > 0);
+			entry->pins--;
+			return;
+		}
+	}
+}
+
+void AssetCache::clear(void)
+{
+	mbed::ScopedLock<rtos::Mutex> lock(mutex);
+
+	for(size_t i = 0; i < max_entries; i++) {
+		if(entries[i].path != NULL && entries[i].pins == 0) {
+			remove(&entries[i]);
+		}
+	}
+}
+
+AssetCache::entry_t* AssetCache::find(const char* path)
+{
+	for(size_t i = 0; i < max_entries; i++) {
+		if(entries[i].path != NULL && strcmp(entries[i].path, path) == 0) {
+			return &entries[i];
+		}
+	}
+	return NULL;
+}
+
+bool AssetCache::make_room(uint32_t size)
+{
+	if(size > max_bytes) {
+		return false;
+	}
+
+	while(true) {
+
+		entry_t* lru = NULL;
+		bool have_free_entry = false;
+
+		for(size_t i = 0; i < max_entries; i++) {
+			entry_t* entry = &entries[i];
+			if(entry->path == NULL) {
+				have_free_entry = true;
+			} else if(entry->pins == 0 &&
+					(lru == NULL || (int32_t)(entry->last_use - lru->last_use) < 0)) {
+				lru = entry;
+			}
+		}
+
+		if(have_free_entry && (used_bytes + size) <= max_bytes) {
+			return true;
+		}
+
+		// Everything left is in use
+		if(lru == NULL) {
+			return false;
+		}
+
+		remove(lru);
+	}
+}
+
+void AssetCache::remove(entry_t* entry)
+{
+	used_bytes -= entry->size;
+	delete[] entry->path;
+	delete[] entry->data;
+	memset(entry, 0, sizeof(entry_t));
+}
+
+#endif /* MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT */
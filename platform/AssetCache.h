@@ -0,0 +1,151 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_PLATFORM_ASSETCACHE_H_
+#define MBED_LVGL_PLATFORM_ASSETCACHE_H_
+
+#if MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "platform/NonCopyable.h"
+#include "rtos/Mutex.h"
+
+/**
+ * Bounded, thread-safe cache of file contents held in RAM
+ *
+ * Entries are keyed by the path given to the filesystem wrapper
+ * (ie: without the lvgl drive letter). Entries that are currently
+ * open through the filesystem wrapper are pinned and will not be
+ * evicted. Unpinned entries are evicted least-recently-used first
+ * when room is needed for a new entry.
+ */
+class AssetCache : private mbed::NonCopyable<AssetCache>
+{
+	public:
+
+		/**
+		 * Instantiate an AssetCache
+		 *
+		 * @param[in] max_bytes Maximum number of bytes of file contents held by the cache
+		 * @param[in] max_entries Maximum number of files held by the cache
+		 */
+		AssetCache(uint32_t max_bytes, size_t max_entries);
+
+		~AssetCache();
+
+		/**
+		 * Checks if the given file is cached
+		 *
+		 * @param[in] path Path of the file
+		 *
+		 * @retval true if the file is cached
+		 */
+		bool contains(const char* path);
+
+		/**
+		 * Makes room for a new entry of the given size, evicting
+		 * least-recently-used unpinned entries if needed
+		 *
+		 * @param[in] size Size in bytes of the entry to make room for
+		 *
+		 * @retval true if there is now room for the entry
+		 */
+		bool reserve(uint32_t size);
+
+		/**
+		 * Inserts file contents into the cache
+		 *
+		 * @param[in] path Path of the file (copied)
+		 * @param[in] data Contents of the file, allocated with new[]. The cache takes ownership.
+		 * @param[in] size Size of the contents in bytes
+		 *
+		 * @retval true if the contents were inserted. On failure, data is deleted.
+		 */
+		bool insert(const char* path, uint8_t* data, uint32_t size);
+
+		/**
+		 * Looks up and pins a cached file
+		 *
+		 * @param[in] path Path of the file
+		 * @param[out] data Cached contents of the file
+		 * @param[out] size Size of the cached contents
+		 *
+		 * @retval true if the file is cached
+		 *
+		 * @note Every successful call must be balanced with a call to release
+		 */
+		bool acquire(const char* path, const uint8_t** data, uint32_t* size);
+
+		/**
+		 * Unpins a cached file previously acquired
+		 *
+		 * @param[in] data Cached contents returned by acquire
+		 */
+		void release(const uint8_t* data);
+
+		/**
+		 * Removes all unpinned entries from the cache
+		 */
+		void clear(void);
+
+		/**
+		 * Gets the number of bytes currently held by the cache
+		 */
+		uint32_t get_used_bytes(void) const {
+			return used_bytes;
+		}
+
+	protected:
+
+		/** Cache entry */
+		typedef struct {
+			char* path;			/** Path of the file (NULL if entry is free) */
+			uint8_t* data;		/** Contents of the file */
+			uint32_t size;		/** Size of the contents */
+			uint32_t last_use;	/** Value of use_counter when last used */
+			uint16_t pins;		/** Number of open handles to this entry */
+		} entry_t;
+
+		/** Find an entry by path, must be called with the mutex held */
+		entry_t* find(const char* path);
+
+		/** Evict LRU entries until size fits, must be called with the mutex held */
+		bool make_room(uint32_t size);
+
+		/** Free an entry, must be called with the mutex held */
+		void remove(entry_t* entry);
+
+	protected:
+
+		rtos::Mutex mutex;
+
+		entry_t* entries;
+		size_t max_entries;
+
+		uint32_t max_bytes;
+		uint32_t used_bytes;
+
+		/** Monotonic counter used to track least-recently-used entries */
+		uint32_t use_counter;
+
+};
+
+#endif /* MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT */
+
+#endif /* MBED_LVGL_PLATFORM_ASSETCACHE_H_ */
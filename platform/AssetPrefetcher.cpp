@@ -0,0 +1,137 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AssetPrefetcher.h"
+
+#if MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT
+
+#include <stdio.h>
+#include <string.h>
+#include <new>
+
+#include "platform/mbed_debug.h"
+
+AssetPrefetcher::AssetPrefetcher(AssetCache& cache) :
+		cache(cache),
+		worker(osPriorityBelowNormal, MBED_CONF_MBED_LVGL_PREFETCH_THREAD_STACK_SIZE, NULL, "lvgl_prefetch"),
+		worker_queue(MBED_CONF_MBED_LVGL_PREFETCH_QUEUE_DEPTH * QUEUED_REQUEST_SIZE),
+		gui_queue(MBED_CONF_MBED_LVGL_PREFETCH_QUEUE_DEPTH * QUEUED_REQUEST_SIZE),
+		cancelled(false)
+{
+	worker.start(mbed::callback(&worker_queue, &events::EventQueue::dispatch_forever));
+}
+
+AssetPrefetcher::~AssetPrefetcher()
+{
+	worker_queue.break_dispatch();
+	worker.join();
+
+	// The worker is gone, drain both queues on this thread so the requests
+	// still in them are freed instead of leaked
+	cancelled = true;
+	worker_queue.dispatch(0);
+	gui_queue.dispatch(0);
+}
+
+bool AssetPrefetcher::prefetch(const char* path, callback_t callback)
+{
+	request_t* request = new request_t;
+	request->path = new char[strlen(path) + 1];
+	strcpy(request->path, path);
+	request->callback = callback;
+	request->success = false;
+
+	if(worker_queue.call(this, &AssetPrefetcher::load, request) == 0) {
+		debug("AssetPrefetcher: queue full, dropping %s\n", path);
+		free_request(request);
+		return false;
+	}
+
+	return true;
+}
+
+void AssetPrefetcher::dispatch(void)
+{
+	gui_queue.dispatch(0);
+}
+
+const char* AssetPrefetcher::get_real_path(const char* path)
+{
+	path++; // Skip the drive letter
+	while(*path == ':' || *path == '/' || *path == '\\') {
+		path++;
+	}
+	return path;
+}
+
+void AssetPrefetcher::load(request_t* request)
+{
+	if(cancelled) {
+		free_request(request);
+		return;
+	}
+
+	const char* real_path = get_real_path(request->path);
+
+	if(cache.contains(real_path)) {
+		request->success = true;
+	} else {
+		FILE* f = fopen(real_path, "rb");
+		if(f != NULL) {
+			fseek(f, 0, SEEK_END);
+			long size = ftell(f);
+			fseek(f, 0, SEEK_SET);
+
+			// Check the budget before allocating anything
+			if(size > 0 && cache.reserve((uint32_t) size)) {
+				uint8_t* data = new (std::nothrow) uint8_t[size];
+				if(data != NULL) {
+					if(fread(data, 1, size, f) == (size_t) size) {
+						request->success = cache.insert(real_path, data, (uint32_t) size);
+					} else {
+						delete[] data;
+					}
+				}
+			}
+			fclose(f);
+		}
+	}
+
+	// Hand the result back to the GUI thread
+	if(gui_queue.call(this, &AssetPrefetcher::complete, request) == 0) {
+		debug("AssetPrefetcher: completion queue full, dropping %s\n", request->path);
+		free_request(request);
+	} else if(pending_callback) {
+		pending_callback();
+	}
+}
+
+void AssetPrefetcher::complete(request_t* request)
+{
+	if(request->callback && !cancelled) {
+		request->callback(request->path, request->success);
+	}
+	free_request(request);
+}
+
+void AssetPrefetcher::free_request(request_t* request)
+{
+	delete[] request->path;
+	delete request;
+}
+
+#endif /* MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT */
@@ -0,0 +1,142 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_PLATFORM_ASSETPREFETCHER_H_
+#define MBED_LVGL_PLATFORM_ASSETPREFETCHER_H_
+
+#if MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT
+
+#include "AssetCache.h"
+
+#include "platform/Callback.h"
+#include "platform/NonCopyable.h"
+#include "rtos/Thread.h"
+#include "events/EventQueue.h"
+
+/**
+ * Loads assets (images, fonts, ...) into an AssetCache on a
+ * background thread so the GUI thread does not stall on slow storage.
+ *
+ * Completion callbacks are deferred and only run when the GUI thread
+ * calls dispatch(), so they may safely use the lvgl API.
+ */
+class AssetPrefetcher : private mbed::NonCopyable<AssetPrefetcher>
+{
+	public:
+
+		/**
+		 * Completion callback
+		 *
+		 * @param[in] path Path of the prefetched asset (as given to prefetch)
+		 * @param[in] success true if the asset is now cached
+		 */
+		typedef mbed::Callback<void(const char* path, bool success)> callback_t;
+
+		/**
+		 * Instantiate an AssetPrefetcher
+		 *
+		 * @param[in] cache Cache to load assets into
+		 */
+		AssetPrefetcher(AssetCache& cache);
+
+		~AssetPrefetcher();
+
+		/**
+		 * Queues an asset to be loaded into the cache by the worker thread
+		 *
+		 * @param[in] path lvgl path of the asset (eg: "M:/img/a.bin"). Copied internally.
+		 * @param[in] callback (optional) Called from dispatch() once the asset is loaded
+		 *
+		 * @retval true if the request was queued
+		 */
+		bool prefetch(const char* path, callback_t callback = NULL);
+
+		/**
+		 * Runs any pending completion callbacks
+		 *
+		 * @note Must be called from the GUI thread
+		 */
+		void dispatch(void);
+
+		/**
+		 * Strips the lvgl drive letter and separators from a path, the
+		 * same way lvgl does before handing a path to a filesystem driver
+		 *
+		 * @param[in] path lvgl path (eg: "M:/img/a.bin")
+		 *
+		 * @retval path as seen by the filesystem wrapper (eg: "img/a.bin")
+		 */
+		static const char* get_real_path(const char* path);
+
+		/**
+		 * Sets a callback the worker thread calls each time it queues a
+		 * completion for dispatch(), eg: to wake up a parked GUI thread
+		 *
+		 * @param[in] callback Called from the worker thread, must not block
+		 *
+		 * @note Set it before prefetching
+		 */
+		void set_pending_callback(mbed::Callback<void()> callback) {
+			pending_callback = callback;
+		}
+
+	protected:
+
+		/** Pending prefetch request */
+		typedef struct {
+			char* path;
+			callback_t callback;
+			bool success;
+		} request_t;
+
+		/** Executed on the worker thread */
+		void load(request_t* request);
+
+		/** Executed on the GUI thread */
+		void complete(request_t* request);
+
+		/** Frees a request */
+		static void free_request(request_t* request);
+
+		/**
+		 * Bytes one request takes in either queue: the event, the bound
+		 * callback and the request pointer passed along to it
+		 */
+		static const size_t QUEUED_REQUEST_SIZE = EVENTS_EVENT_SIZE + sizeof(request_t*);
+
+	protected:
+
+		AssetCache& cache;
+
+		/** Worker thread and the queue it executes */
+		rtos::Thread worker;
+		events::EventQueue worker_queue;
+
+		/** Completion callbacks waiting for the GUI thread */
+		events::EventQueue gui_queue;
+
+		/** Called when a completion is queued on gui_queue */
+		mbed::Callback<void()> pending_callback;
+
+		/** Set on destruction, requests still queued are freed without being loaded or completed */
+		bool cancelled;
+
+};
+
+#endif /* MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM && MBED_CONF_RTOS_PRESENT */
+
+#endif /* MBED_LVGL_PLATFORM_ASSETPREFETCHER_H_ */
@@ -0,0 +1,70 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "InterruptFrameSync.h"
+
+#if DEVICE_INTERRUPTIN && MBED_CONF_RTOS_PRESENT
+
+#include "platform/Callback.h"
+#include "hal/us_ticker_api.h"
+
+/** Event flag set on each TE/VSync edge */
+#define FRAME_SYNC_FLAG		0x1
+
+/** Edges further apart than this are not used to measure the period (eg: TE was off) */
+#define FRAME_SYNC_MAX_PERIOD_US	100000
+
+InterruptFrameSync::InterruptFrameSync(PinName pin, bool rising_edge) :
+		te(pin), flags(), last_edge_us(0), period_us(0)
+{
+	if(rising_edge) {
+		te.rise(mbed::callback(this, &InterruptFrameSync::sync_irq));
+	} else {
+		te.fall(mbed::callback(this, &InterruptFrameSync::sync_irq));
+	}
+}
+
+InterruptFrameSync::~InterruptFrameSync()
+{
+	te.rise(NULL);
+	te.fall(NULL);
+}
+
+bool InterruptFrameSync::wait(uint32_t timeout_ms)
+{
+	// Only an edge that comes after the call counts
+	flags.clear(FRAME_SYNC_FLAG);
+	uint32_t result = flags.wait_any(FRAME_SYNC_FLAG, timeout_ms);
+	return (result & osFlagsError) == 0;
+}
+
+void InterruptFrameSync::sync_irq(void)
+{
+	// us_ticker_read() is the raw counter, not microseconds on every target
+	uint32_t now = (uint32_t) ticker_read_us(get_us_ticker_data());
+	uint32_t elapsed = now - last_edge_us;
+	last_edge_us = now;
+
+	if(elapsed < FRAME_SYNC_MAX_PERIOD_US) {
+		// Smooth out interrupt latency jitter
+		period_us = (period_us == 0) ? elapsed : ((period_us * 7) + elapsed) / 8;
+	}
+
+	flags.set(FRAME_SYNC_FLAG);
+}
+
+#endif /* DEVICE_INTERRUPTIN && MBED_CONF_RTOS_PRESENT */
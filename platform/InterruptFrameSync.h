@@ -0,0 +1,76 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_PLATFORM_INTERRUPTFRAMESYNC_H_
+#define MBED_LVGL_PLATFORM_INTERRUPTFRAMESYNC_H_
+
+#if DEVICE_INTERRUPTIN && MBED_CONF_RTOS_PRESENT
+
+#include "LVGLFrameSync.h"
+
+#include "drivers/InterruptIn.h"
+#include "platform/NonCopyable.h"
+#include "rtos/EventFlags.h"
+
+/**
+ * Frame sync source driven by a panel's TE (tearing effect) or VSync pin
+ *
+ * The panel's refresh period is measured from the time between edges.
+ */
+class InterruptFrameSync : public LVGLFrameSync, private mbed::NonCopyable<InterruptFrameSync>
+{
+	public:
+
+		/**
+		 * Instantiate an InterruptFrameSync
+		 *
+		 * @param[in] pin Pin connected to the panel's TE/VSync output
+		 * @param[in] rising_edge (optional) true if a refresh starts on the rising edge
+		 *
+		 * @note The panel's TE output must be enabled (TEON on the ST7789)
+		 */
+		InterruptFrameSync(PinName pin, bool rising_edge = true);
+
+		virtual ~InterruptFrameSync();
+
+		virtual bool wait(uint32_t timeout_ms);
+
+		virtual uint32_t get_period_us(void) {
+			return period_us;
+		}
+
+	protected:
+
+		/** TE/VSync interrupt handler */
+		void sync_irq(void);
+
+	protected:
+
+		mbed::InterruptIn te;
+		rtos::EventFlags flags;
+
+		/** Time of the last edge */
+		volatile uint32_t last_edge_us;
+
+		/** Measured refresh period (smoothed) */
+		volatile uint32_t period_us;
+
+};
+
+#endif /* DEVICE_INTERRUPTIN && MBED_CONF_RTOS_PRESENT */
+
+#endif /* MBED_LVGL_PLATFORM_INTERRUPTFRAMESYNC_H_ */
@@ -0,0 +1,235 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "InvalidationProfiler.h"
+
+#if MBED_CONF_MBED_LVGL_ENABLE_INVALIDATION_PROFILER
+
+#include <stdio.h>
+#include <string.h>
+
+InvalidationProfiler::InvalidationProfiler(LVGLDisplayDriver& driver, uint8_t cell_size) :
+		driver(driver), entry_count(0), unattributed_pixels(0),
+		cell_size(cell_size), frames(0)
+{
+	lv_coord_t hor_res, ver_res;
+	driver.get_resolution(&hor_res, &ver_res);
+	cols = (hor_res + cell_size - 1) / cell_size;
+	rows = (ver_res + cell_size - 1) / cell_size;
+	heatmap = new uint16_t[(uint32_t) cols * rows];
+	memset(heatmap, 0, (uint32_t) cols * rows * sizeof(uint16_t));
+}
+
+InvalidationProfiler::~InvalidationProfiler()
+{
+	delete[] heatmap;
+}
+
+void InvalidationProfiler::reset(void)
+{
+	entry_count = 0;
+	unattributed_pixels = 0;
+	frames = 0;
+	memset(heatmap, 0, (uint32_t) cols * rows * sizeof(uint16_t));
+}
+
+void InvalidationProfiler::on_invalidate(lv_disp_t* disp, const lv_area_t* area)
+{
+	if(disp != driver.get_lv_disp_obj()) {
+		return;
+	}
+
+	// Objects on the top and system layers are drawn over the screen
+	lv_obj_t* owner = NULL;
+	lv_obj_t* layers[2] = { lv_disp_get_layer_sys(disp), lv_disp_get_layer_top(disp) };
+	for(size_t i = 0; i < 2 && owner == NULL; i++) {
+		lv_obj_t* child = lv_obj_get_child(layers[i], NULL);
+		for(; child != NULL && owner == NULL; child = lv_obj_get_child(layers[i], child)) {
+			owner = find_owner(child, area);
+		}
+	}
+	if(owner == NULL) {
+		owner = find_owner(lv_disp_get_scr_act(disp), area);
+	}
+	if(owner == NULL) {
+		// eg: the screen itself being invalidated while loading another one
+		owner = lv_disp_get_scr_act(disp);
+	}
+
+	uint32_t pixels = lv_area_get_size(area);
+	entry_t* entry = find_entry(owner);
+	if(entry == NULL) {
+		unattributed_pixels += pixels;
+		return;
+	}
+
+	entry->invalidations++;
+	entry->pixels += pixels;
+}
+
+void InvalidationProfiler::before_refresh(lv_disp_t* disp)
+{
+	if(disp != driver.get_lv_disp_obj() || disp->inv_p == 0) {
+		return;
+	}
+
+	frames++;
+	for(uint32_t i = 0; i < disp->inv_p; i++) {
+		if(disp->inv_area_joined[i]) {
+			continue;
+		}
+
+		const lv_area_t* area = &disp->inv_areas[i];
+		for(lv_coord_t row = area->y1 / cell_size; row <= area->y2 / cell_size && row < rows; row++) {
+			for(lv_coord_t col = area->x1 / cell_size; col <= area->x2 / cell_size && col < cols; col++) {
+				uint16_t* cell = &heatmap[(uint32_t) row * cols + col];
+				if(*cell != UINT16_MAX) {
+					(*cell)++;
+				}
+			}
+		}
+	}
+}
+
+size_t InvalidationProfiler::get_entries(entry_t* out, size_t max)
+{
+	// Selection of the largest entries, the table is small
+	bool taken[MBED_CONF_MBED_LVGL_INVALIDATION_PROFILER_SLOTS] = { false };
+	size_t count = 0;
+	for(; count < max && count < entry_count; count++) {
+		size_t best = entry_count;
+		for(size_t i = 0; i < entry_count; i++) {
+			if(!taken[i] && (best == entry_count || entries[i].pixels > entries[best].pixels)) {
+				best = i;
+			}
+		}
+		taken[best] = true;
+		out[count] = entries[best];
+	}
+	return count;
+}
+
+void InvalidationProfiler::print_report(size_t count)
+{
+	entry_t top[MBED_CONF_MBED_LVGL_INVALIDATION_PROFILER_SLOTS];
+	if(count > MBED_CONF_MBED_LVGL_INVALIDATION_PROFILER_SLOTS) {
+		count = MBED_CONF_MBED_LVGL_INVALIDATION_PROFILER_SLOTS;
+	}
+	count = get_entries(top, count);
+
+	printf("Redraws over %lu frames, by smallest enclosing object:\n", (unsigned long) frames);
+	for(size_t i = 0; i < count; i++) {
+		printf("  %p %-12s %8lu areas %10llu px\n", (void*) top[i].obj, top[i].type,
+				(unsigned long) top[i].invalidations, (unsigned long long) top[i].pixels);
+	}
+	if(unattributed_pixels != 0) {
+		printf("  (untracked objects)          %10llu px\n", (unsigned long long) unattributed_pixels);
+	}
+}
+
+uint16_t InvalidationProfiler::get_heat(lv_coord_t x, lv_coord_t y) const
+{
+	return heatmap[(uint32_t)(y / cell_size) * cols + (x / cell_size)];
+}
+
+bool InvalidationProfiler::write_heatmap_ppm(const char* path) const
+{
+	FILE* file = fopen(path, "wb");
+	if(file == NULL) {
+		return false;
+	}
+
+	lv_coord_t hor_res, ver_res;
+	driver.get_resolution(&hor_res, &ver_res);
+	fprintf(file, "P6\n%d %d\n255\n", hor_res, ver_res);
+
+	uint16_t max = 1;
+	for(uint32_t i = 0; i < (uint32_t) cols * rows; i++) {
+		if(heatmap[i] > max) {
+			max = heatmap[i];
+		}
+	}
+
+	for(lv_coord_t y = 0; y < ver_res; y++) {
+		for(lv_coord_t x = 0; x < hor_res; x++) {
+			// "Hot" color ramp: black, red, yellow, white
+			uint32_t level = ((uint32_t) get_heat(x, y) * 765) / max;
+			uint8_t rgb[3] = {
+				(uint8_t)((level > 255) ? 255 : level),
+				(uint8_t)((level > 510) ? 255 : ((level > 255) ? (level - 255) : 0)),
+				(uint8_t)((level > 510) ? (level - 510) : 0),
+			};
+			fwrite(rgb, 1, sizeof(rgb), file);
+		}
+	}
+
+	bool ok = (ferror(file) == 0);
+	fclose(file);
+	return ok;
+}
+
+lv_obj_t* InvalidationProfiler::find_owner(lv_obj_t* obj, const lv_area_t* area)
+{
+	if(lv_obj_get_hidden(obj)) {
+		return NULL;
+	}
+
+	lv_area_t coords;
+	lv_obj_get_coords(obj, &coords);
+	coords.x1 -= obj->ext_draw_pad;
+	coords.y1 -= obj->ext_draw_pad;
+	coords.x2 += obj->ext_draw_pad;
+	coords.y2 += obj->ext_draw_pad;
+	if(!lv_area_is_in(area, &coords)) {
+		return NULL;
+	}
+
+	// Children are returned front to back
+	for(lv_obj_t* child = lv_obj_get_child(obj, NULL); child != NULL; child = lv_obj_get_child(obj, child)) {
+		lv_obj_t* owner = find_owner(child, area);
+		if(owner != NULL) {
+			return owner;
+		}
+	}
+
+	return obj;
+}
+
+InvalidationProfiler::entry_t* InvalidationProfiler::find_entry(lv_obj_t* obj)
+{
+	for(size_t i = 0; i < entry_count; i++) {
+		if(entries[i].obj == obj) {
+			return &entries[i];
+		}
+	}
+
+	if(entry_count == MBED_CONF_MBED_LVGL_INVALIDATION_PROFILER_SLOTS) {
+		return NULL;
+	}
+
+	lv_obj_type_t type;
+	lv_obj_get_type(obj, &type);
+
+	entry_t* entry = &entries[entry_count++];
+	entry->obj = obj;
+	entry->type = type.type[0];
+	entry->invalidations = 0;
+	entry->pixels = 0;
+	return entry;
+}
+
+#endif /* MBED_CONF_MBED_LVGL_ENABLE_INVALIDATION_PROFILER */
@@ -0,0 +1,160 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_PLATFORM_INVALIDATIONPROFILER_H_
+#define MBED_LVGL_PLATFORM_INVALIDATIONPROFILER_H_
+
+#if MBED_CONF_MBED_LVGL_ENABLE_INVALIDATION_PROFILER
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lv_obj.h"
+
+#include "LVGLDisplayDriver.h"
+#include "LVGLFrameHook.h"
+
+#include "platform/NonCopyable.h"
+
+/**
+ * Finds the objects that make a display redraw the most
+ *
+ * lvgl doesn't tell which object invalidated an area, so attribution is
+ * geometric: every area invalidated goes to the smallest visible object
+ * that encloses it (with its extra draw padding). That is usually the
+ * object that was invalidated, but:
+ * - a child covering all of its parent is blamed for the parent's redraws
+ * - an area spanning several objects goes to their common container
+ * (Wrapping lv_obj_invalidate at link time would miss the calls lvgl makes
+ * from within lv_obj.c, eg: when an object moves.) Invalidations and
+ * pixels are accumulated per object.
+ *
+ * The areas actually redrawn in each frame (after lvgl merged them) are
+ * accumulated into a heatmap of cells over the screen, which can be
+ * written to a PPM image on the host.
+ *
+ * @note Objects are identified by their address, an object created where
+ * a deleted one was is counted as the same object
+ */
+class InvalidationProfiler : public LVGLFrameHook, private mbed::NonCopyable<InvalidationProfiler>
+{
+	public:
+
+		/** Redraw accounting of an object */
+		typedef struct {
+			lv_obj_t* obj;			/** Object (may have been deleted) */
+			const char* type;		/** Type of the object (eg: "lv_label") */
+			uint32_t invalidations;	/** Areas invalidated */
+			uint64_t pixels;		/** Pixels invalidated */
+		} entry_t;
+
+		/**
+		 * Instantiate an InvalidationProfiler
+		 *
+		 * @param[in] driver Display driver to profile
+		 * @param[in] cell_size (optional) Size of the heatmap cells in pixels
+		 *
+		 * @note Register it with LittlevGL::add_frame_hook
+		 */
+		InvalidationProfiler(LVGLDisplayDriver& driver,
+				uint8_t cell_size = MBED_CONF_MBED_LVGL_HEATMAP_CELL_SIZE);
+
+		~InvalidationProfiler();
+
+		/**
+		 * Copies the accounting of the worst offenders, most pixels first
+		 *
+		 * @param[out] entries Array receiving the accounting
+		 * @param[in] max Size of the array
+		 *
+		 * @retval number of entries copied
+		 */
+		size_t get_entries(entry_t* entries, size_t max);
+
+		/**
+		 * Prints the worst offenders
+		 *
+		 * @param[in] count Number of objects to print
+		 */
+		void print_report(size_t count = 10);
+
+		/**
+		 * Pixels invalidated by objects that didn't fit in the table
+		 */
+		uint64_t get_unattributed_pixels(void) const {
+			return unattributed_pixels;
+		}
+
+		/**
+		 * Number of frames accumulated into the heatmap
+		 */
+		uint32_t get_frames(void) const {
+			return frames;
+		}
+
+		/**
+		 * Gets how many frames redrew a pixel
+		 */
+		uint16_t get_heat(lv_coord_t x, lv_coord_t y) const;
+
+		/**
+		 * Writes the heatmap to a binary PPM (P6) image the size of the display,
+		 * from black (never redrawn) through red and yellow to white (redrawn the most)
+		 *
+		 * @retval false if the file could not be written
+		 */
+		bool write_heatmap_ppm(const char* path) const;
+
+		/**
+		 * Clears the accounting and the heatmap
+		 */
+		void reset(void);
+
+		/*
+		 * @brief Frame hook implementation
+		 */
+		virtual void before_refresh(lv_disp_t* disp);
+		virtual void on_invalidate(lv_disp_t* disp, const lv_area_t* area);
+
+	protected:
+
+		/** Finds the smallest visible object under obj enclosing an area */
+		static lv_obj_t* find_owner(lv_obj_t* obj, const lv_area_t* area);
+
+		/** Finds the accounting of an object, claiming a free entry if needed */
+		entry_t* find_entry(lv_obj_t* obj);
+
+	protected:
+
+		LVGLDisplayDriver& driver;
+
+		entry_t entries[MBED_CONF_MBED_LVGL_INVALIDATION_PROFILER_SLOTS];
+		size_t entry_count;
+		uint64_t unattributed_pixels;
+
+		/** Heatmap, one saturating counter per cell */
+		uint16_t* heatmap;
+		uint8_t cell_size;
+		lv_coord_t cols;
+		lv_coord_t rows;
+		uint32_t frames;
+
+};
+
+#endif /* MBED_CONF_MBED_LVGL_ENABLE_INVALIDATION_PROFILER */
+
+#endif /* MBED_LVGL_PLATFORM_INVALIDATIONPROFILER_H_ */
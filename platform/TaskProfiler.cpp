@@ -0,0 +1,244 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TaskProfiler.h"
+
+#if MBED_CONF_MBED_LVGL_ENABLE_TASK_PROFILER
+
+#include <string.h>
+
+#include "lv_gc.h"
+#include "lv_ll.h"
+#include "lv_hal_tick.h"
+#include "lv_indev.h"
+
+#include "platform/mbed_assert.h"
+
+#if DEVICE_USTICKER
+#include "cmsis.h"
+#include "hal/us_ticker_api.h"
+#if defined(__CORTEX_M) && (__CORTEX_M >= 3)
+#define TASK_PROFILER_DWT	1
+#endif
+#else
+#include <time.h>
+#define TASK_PROFILER_CLOCK_GETTIME	1
+#endif
+
+TaskProfiler::slot_t TaskProfiler::slots[MBED_CONF_MBED_LVGL_TASK_PROFILER_SLOTS];
+size_t TaskProfiler::slot_count = 0;
+uint32_t TaskProfiler::untracked = 0;
+
+void TaskProfiler::attach(void)
+{
+#if TASK_PROFILER_DWT
+	// Start the cycle counter
+	if((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0) {
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CYCCNT = 0;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+#endif
+
+	for(size_t i = 0; i < slot_count; i++) {
+		slots[i].entry.alive = false;
+	}
+
+	// Known tasks first, new ones may only take the slots of deleted tasks
+	lv_task_t* task = (lv_task_t*) lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll));
+	for(; task != NULL; task = (lv_task_t*) lv_ll_get_next(&LV_GC_ROOT(_lv_task_ll), task)) {
+		slot_t* slot = find(task, false);
+		if(slot != NULL) {
+			slot->entry.alive = true;
+			slot->entry.period = task->period;
+		}
+	}
+
+	task = (lv_task_t*) lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll));
+	for(; task != NULL; task = (lv_task_t*) lv_ll_get_next(&LV_GC_ROOT(_lv_task_ll), task)) {
+		if(task->task_cb == &TaskProfiler::trampoline) {
+			continue;
+		}
+
+		slot_t* slot = find(task, true);
+		if(slot == NULL) {
+			continue;
+		}
+
+		slot->entry.alive = true;
+		slot->entry.period = task->period;
+		if(slot->wrapped) {
+			// A new task reusing the memory of a deleted one
+			const char* name = slot->entry.name;
+			memset(slot, 0, sizeof(*slot));
+			slot->entry.task = task;
+			slot->entry.alive = true;
+			slot->entry.period = task->period;
+			slot->entry.name = name;
+		}
+
+		slot->entry.task_cb = task->task_cb;
+		slot->wrapped = true;
+		if(slot->entry.name == NULL && task->task_cb == &lv_indev_read_task) {
+			slot->entry.name = "indev";
+		}
+		task->task_cb = &TaskProfiler::trampoline;
+	}
+}
+
+void TaskProfiler::set_task_name(lv_task_t* task, const char* name)
+{
+	slot_t* slot = find(task, true);
+	if(slot != NULL) {
+		slot->entry.name = name;
+	}
+}
+
+lv_task_cb_t TaskProfiler::get_task_cb(lv_task_t* task)
+{
+	if(task->task_cb != &TaskProfiler::trampoline) {
+		return task->task_cb;
+	}
+	slot_t* slot = find(task, false);
+	return (slot != NULL) ? slot->entry.task_cb : NULL;
+}
+
+size_t TaskProfiler::snapshot(entry_t* entries, size_t max)
+{
+	uint32_t scale = ticks_per_us();
+	size_t count = 0;
+	for(size_t i = 0; i < slot_count && count < max; i++) {
+		if(!slots[i].wrapped) {
+			continue;
+		}
+		entries[count] = slots[i].entry;
+		entries[count].total_us = slots[i].total_ticks / scale;
+		entries[count].max_us = slots[i].max_ticks / scale;
+		count++;
+	}
+	return count;
+}
+
+void TaskProfiler::reset(void)
+{
+	size_t kept = 0;
+	for(size_t i = 0; i < slot_count; i++) {
+		slot_t slot = slots[i];
+		if(!slot.entry.alive && slot.wrapped) {
+			continue;
+		}
+		slot.entry.calls = 0;
+		slot.entry.late_runs = 0;
+		slot.entry.overruns = 0;
+		slot.total_ticks = 0;
+		slot.max_ticks = 0;
+		slots[kept++] = slot;
+	}
+	slot_count = kept;
+	untracked = 0;
+}
+
+void TaskProfiler::trampoline(lv_task_t* task)
+{
+	slot_t* slot = find(task, false);
+	MBED_ASSERT(slot != NULL);
+
+	// lvgl sets last_run before calling the task, so keep the previous start
+	uint32_t start_ms = lv_tick_get();
+	if(slot->entry.calls != 0) {
+		uint32_t interval = start_ms - slot->last_start_ms;
+		uint32_t period = task->period;
+		if(interval > (period + (period / 2)) && (interval - period) > 1) {
+			slot->entry.late_runs++;
+		}
+	}
+	slot->last_start_ms = start_ms;
+
+	lv_task_cb_t task_cb = slot->entry.task_cb;
+	uint32_t start = now();
+	task_cb(task);
+	uint32_t ticks = now() - start;
+
+	// The task may have deleted itself
+	slot->entry.calls++;
+	slot->total_ticks += ticks;
+	if(ticks > slot->max_ticks) {
+		slot->max_ticks = ticks;
+	}
+	if((ticks / ticks_per_us()) > (slot->entry.period * 1000)) {
+		slot->entry.overruns++;
+	}
+}
+
+TaskProfiler::slot_t* TaskProfiler::find(lv_task_t* task, bool create)
+{
+	for(size_t i = 0; i < slot_count; i++) {
+		if(slots[i].entry.task == task) {
+			return &slots[i];
+		}
+	}
+
+	if(!create) {
+		return NULL;
+	}
+
+	// Take a free slot, once the table is full the slot of a deleted task
+	slot_t* slot = NULL;
+	if(slot_count < MBED_CONF_MBED_LVGL_TASK_PROFILER_SLOTS) {
+		slot = &slots[slot_count++];
+	} else {
+		for(size_t i = 0; i < slot_count && slot == NULL; i++) {
+			if(!slots[i].entry.alive && slots[i].wrapped) {
+				slot = &slots[i];
+			}
+		}
+		if(slot == NULL) {
+			untracked++;
+			return NULL;
+		}
+	}
+
+	memset(slot, 0, sizeof(*slot));
+	slot->entry.task = task;
+	return slot;
+}
+
+uint32_t TaskProfiler::now(void)
+{
+#if TASK_PROFILER_DWT
+	return DWT->CYCCNT;
+#elif TASK_PROFILER_CLOCK_GETTIME
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)(((uint64_t) ts.tv_sec * 1000000000ull) + ts.tv_nsec);
+#else
+	return (uint32_t) ticker_read_us(get_us_ticker_data());
+#endif
+}
+
+uint32_t TaskProfiler::ticks_per_us(void)
+{
+#if TASK_PROFILER_DWT
+	return SystemCoreClock / 1000000;
+#elif TASK_PROFILER_CLOCK_GETTIME
+	return 1000;
+#else
+	return 1;
+#endif
+}
+
+#endif /* MBED_CONF_MBED_LVGL_ENABLE_TASK_PROFILER */
@@ -0,0 +1,134 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_PLATFORM_TASKPROFILER_H_
+#define MBED_LVGL_PLATFORM_TASKPROFILER_H_
+
+#if MBED_CONF_MBED_LVGL_ENABLE_TASK_PROFILER
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lv_task.h"
+
+/**
+ * Measures the CPU time used by each lvgl task
+ *
+ * attach() replaces the callback of every task it doesn't know yet with a
+ * trampoline that times the original callback. LittlevGL::update() calls
+ * it before running lvgl's task handler, so tasks created by the
+ * application are picked up as well. Durations are measured with the DWT
+ * cycle counter on Cortex-M3 and above, the microsecond ticker on other
+ * targets and clock_gettime() on the host.
+ *
+ * Per task the profiler keeps the number of calls, the total and longest
+ * duration and two kinds of deadline misses:
+ * - late runs: the task started more than half a period late (eg: another
+ *   task or the application held up lv_task_handler())
+ * - overruns: the task ran for longer than its own period
+ *
+ * @note Not thread safe, call from the thread that runs lvgl
+ */
+class TaskProfiler
+{
+	public:
+
+		/** Statistics of a task */
+		typedef struct {
+			lv_task_t* task;		/** Task (may have been deleted, see alive) */
+			lv_task_cb_t task_cb;	/** Original callback of the task */
+			const char* name;		/** Name given with set_task_name(), or NULL */
+			bool alive;				/** false once the task was deleted */
+			uint32_t period;		/** Period of the task (ms) */
+			uint32_t calls;			/** Number of runs */
+			uint64_t total_us;		/** Total time spent in the task */
+			uint32_t max_us;		/** Longest run */
+			uint32_t late_runs;		/** Runs started more than half a period late */
+			uint32_t overruns;		/** Runs longer than the task's period */
+		} entry_t;
+
+		/**
+		 * Starts profiling the tasks that aren't profiled yet
+		 */
+		static void attach(void);
+
+		/**
+		 * Names a task in the profiler's statistics
+		 *
+		 * @param[in] task Task to name
+		 * @param[in] name Name of the task, must stay valid
+		 */
+		static void set_task_name(lv_task_t* task, const char* name);
+
+		/**
+		 * Gets the original callback of a task (unwrapping the profiler's trampoline)
+		 */
+		static lv_task_cb_t get_task_cb(lv_task_t* task);
+
+		/**
+		 * Copies the statistics of the profiled tasks
+		 *
+		 * @param[out] entries Array receiving the statistics
+		 * @param[in] max Size of the array
+		 *
+		 * @retval number of entries copied
+		 */
+		static size_t snapshot(entry_t* entries, size_t max);
+
+		/**
+		 * Clears the statistics, deleted tasks are forgotten
+		 */
+		static void reset(void);
+
+		/**
+		 * Gets the number of tasks that could not be profiled (the table is full)
+		 */
+		static uint32_t get_untracked(void) {
+			return untracked;
+		}
+
+	protected:
+
+		typedef struct {
+			entry_t entry;
+			bool wrapped;
+			uint32_t last_start_ms;
+			uint64_t total_ticks;
+			uint32_t max_ticks;
+		} slot_t;
+
+		/** Runs and times a task's original callback */
+		static void trampoline(lv_task_t* task);
+
+		/** Finds the slot of a task, optionally claiming a free one */
+		static slot_t* find(lv_task_t* task, bool create);
+
+		/** Reads the timer, and its ticks per microsecond */
+		static uint32_t now(void);
+		static uint32_t ticks_per_us(void);
+
+	protected:
+
+		static slot_t slots[MBED_CONF_MBED_LVGL_TASK_PROFILER_SLOTS];
+		static size_t slot_count;
+		static uint32_t untracked;
+
+};
+
+#endif /* MBED_CONF_MBED_LVGL_ENABLE_TASK_PROFILER */
+
+#endif /* MBED_LVGL_PLATFORM_TASKPROFILER_H_ */
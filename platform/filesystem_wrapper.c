@@ -18,40 +18,66 @@
 #if MBED_CONF_FILESYSTEM_PRESENT && LV_USE_FILESYSTEM
 
 #include "filesystem_wrapper.h"
+#include "trace.h"
 #include "platform/mbed_retarget.h"
 #include <stdio.h>
+#include <string.h>
 
-typedef FILE* file_ptr_t;
+typedef lv_fs_wrapper_file_t* file_ptr_t;
+
+/** Optional in-memory cache hooks (see mbed_lvgl_fs_wrapper_set_cache) */
+static lv_fs_wrapper_cache_acquire_t cache_acquire = NULL;
+static lv_fs_wrapper_cache_release_t cache_release = NULL;
 
 void mbed_lvgl_fs_wrapper_default(lv_fs_drv_t* fs_drv)
 {
 	// Set up the defaults for mbed-lvgl filesystem wrapper driver struct
-	fs_drv->file_size	= sizeof(file_ptr_t);
+	fs_drv->file_size	= sizeof(lv_fs_wrapper_file_t);
 	fs_drv->letter		= 'A';
 	fs_drv->open_cb 		= lv_fs_wrapper_open;
 	fs_drv->close_cb		= lv_fs_wrapper_close;
 	fs_drv->read_cb 		= lv_fs_wrapper_read;
 	fs_drv->seek_cb 		= lv_fs_wrapper_seek;
 	fs_drv->tell_cb 		= lv_fs_wrapper_tell;
+	fs_drv->size_cb 		= lv_fs_wrapper_size;
+}
+
+void mbed_lvgl_fs_wrapper_set_cache(lv_fs_wrapper_cache_acquire_t acquire,
+		lv_fs_wrapper_cache_release_t release)
+{
+	cache_acquire = acquire;
+	cache_release = release;
 }
 
 lv_fs_res_t lv_fs_wrapper_open(lv_fs_drv_t* fs_drv, void* file_p, const char* fn, lv_fs_mode_t mode)
 {
+	file_ptr_t fp = file_p;         /*Just avoid the confusing castings*/
+	fp->file = NULL;
+	fp->mem = NULL;
+	fp->mem_size = 0;
+	fp->mem_pos = 0;
+
+	// Read-only files may be served straight out of the cache
+	if(mode == LV_FS_MODE_RD && cache_acquire != NULL) {
+		if(cache_acquire(fn, &fp->mem, &fp->mem_size)) {
+			return LV_FS_RES_OK;
+		}
+	}
+
 	const char * flags = "";
 
 	if(mode == LV_FS_MODE_WR) flags = "wb";
 	else if(mode == LV_FS_MODE_RD) flags = "rb";
 	else if(mode == (LV_FS_MODE_WR | LV_FS_MODE_RD)) flags = "a+";
 
-	file_ptr_t f = fopen(fn, flags);
+	FILE* f = fopen(fn, flags);
 	if((long int)f <= 0) return LV_FS_RES_UNKNOWN;
 	else {
 	  fseek(f, 0, SEEK_SET);
 
 	  /* 'file_p' is pointer to a file descriptor and
 		* we need to store our file descriptor here*/
-	  file_ptr_t *fp = file_p;         /*Just avoid the confusing castings*/
-	  *fp = f;
+	  fp->file = f;
 	}
 
 	return LV_FS_RES_OK;
@@ -59,29 +85,73 @@ lv_fs_res_t lv_fs_wrapper_open(lv_fs_drv_t* fs_drv, void* file_p, const char* fn
 
 lv_fs_res_t lv_fs_wrapper_close(lv_fs_drv_t* fs_drv, void* file_p)
 {
-	file_ptr_t *fp = file_p;         /*Just avoid the confusing castings*/
-	fclose(*fp);
+	file_ptr_t fp = file_p;         /*Just avoid the confusing castings*/
+	if(fp->mem != NULL) {
+		if(cache_release != NULL) {
+			cache_release(fp->mem);
+		}
+		fp->mem = NULL;
+		return LV_FS_RES_OK;
+	}
+	fclose(fp->file);
 	return LV_FS_RES_OK;
 }
 
 lv_fs_res_t lv_fs_wrapper_read(lv_fs_drv_t* fs_drv, void* file_p, void* buf, uint32_t btr, uint32_t* br)
 {
-	file_ptr_t *fp = file_p;         /*Just avoid the confusing castings*/
-	*br = fread(buf, 1, btr, *fp);
+	file_ptr_t fp = file_p;         /*Just avoid the confusing castings*/
+	if(fp->mem != NULL) {
+		uint32_t remaining = fp->mem_size - fp->mem_pos;
+		*br = (btr < remaining) ? btr : remaining;
+		memcpy(buf, fp->mem + fp->mem_pos, *br);
+		fp->mem_pos += *br;
+		return LV_FS_RES_OK;
+	}
+	MBED_LVGL_TRACE_BEGIN_ARG("fs_read", btr);
+	*br = fread(buf, 1, btr, fp->file);
+	MBED_LVGL_TRACE_END("fs_read");
 	return LV_FS_RES_OK;
 }
 
 lv_fs_res_t lv_fs_wrapper_seek(lv_fs_drv_t* fs_drv, void* file_p, uint32_t pos)
 {
-	file_ptr_t *fp = file_p;         /*Just avoid the confusing castings*/
-	fseek(*fp, pos, SEEK_SET);
+	file_ptr_t fp = file_p;         /*Just avoid the confusing castings*/
+	if(fp->mem != NULL) {
+		fp->mem_pos = (pos < fp->mem_size) ? pos : fp->mem_size;
+		return LV_FS_RES_OK;
+	}
+	fseek(fp->file, pos, SEEK_SET);
 	return LV_FS_RES_OK;
 }
 
 lv_fs_res_t lv_fs_wrapper_tell(lv_fs_drv_t* fs_drv, void* file_p, uint32_t* pos_p)
 {
-	file_ptr_t *fp = file_p;         /*Just avoid the confusing castings*/
-	*pos_p = ftell(*fp);
+	file_ptr_t fp = file_p;         /*Just avoid the confusing castings*/
+	if(fp->mem != NULL) {
+		*pos_p = fp->mem_pos;
+		return LV_FS_RES_OK;
+	}
+	*pos_p = ftell(fp->file);
+	return LV_FS_RES_OK;
+}
+
+lv_fs_res_t lv_fs_wrapper_size(lv_fs_drv_t* fs_drv, void* file_p, uint32_t* size_p)
+{
+	file_ptr_t fp = file_p;         /*Just avoid the confusing castings*/
+	if(fp->mem != NULL) {
+		*size_p = fp->mem_size;
+		return LV_FS_RES_OK;
+	}
+	long pos = ftell(fp->file);
+	if(pos < 0 || fseek(fp->file, 0, SEEK_END) != 0) {
+		return LV_FS_RES_UNKNOWN;
+	}
+	long size = ftell(fp->file);
+	fseek(fp->file, pos, SEEK_SET);
+	if(size < 0) {
+		return LV_FS_RES_UNKNOWN;
+	}
+	*size_p = (uint32_t) size;
 	return LV_FS_RES_OK;
 }
 
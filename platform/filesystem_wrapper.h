@@ -33,15 +33,54 @@ extern "C" {
 
 #include "lv_fs.h"
 
+#include <stdbool.h>
+#include <stdio.h>
+
+/**
+ * File handle used by the wrapper driver
+ *
+ * A file is either backed by Mbed's retargeted stdio or, if its
+ * contents have been prefetched into RAM, served directly from memory
+ */
+typedef struct {
+	FILE* file;				/** Retargeted stdio file (NULL if served from memory) */
+	const uint8_t* mem;		/** Cached file contents (NULL if read from stdio) */
+	uint32_t mem_size;		/** Size of the cached file contents */
+	uint32_t mem_pos;		/** Read pointer into the cached file contents */
+} lv_fs_wrapper_file_t;
+
+/**
+ * Cache lookup hook
+ * @param fn name of the file (as given to the driver, without drive letter)
+ * @param data pointer to store the cached contents
+ * @param size pointer to store the size of the cached contents
+ * @return true if the file is cached, the contents stay valid until released
+ */
+typedef bool (*lv_fs_wrapper_cache_acquire_t)(const char* fn, const uint8_t** data, uint32_t* size);
+
+/**
+ * Cache release hook, called when a file served from memory is closed
+ * @param data cached contents previously returned by the acquire hook
+ */
+typedef void (*lv_fs_wrapper_cache_release_t)(const uint8_t* data);
+
 /**
  * Sets up the default mbed fileystem wrapper structure for lvgl
  * @param[in/out] driver driver instance to configure to defaults
  */
 void mbed_lvgl_fs_wrapper_default(lv_fs_drv_t* fs_drv);
 
+/**
+ * Installs hooks that allow files to be served from an in-memory cache
+ * @param acquire hook used to look up a file when it is opened (NULL to disable)
+ * @param release hook used to release a cached file when it is closed
+ */
+void mbed_lvgl_fs_wrapper_set_cache(lv_fs_wrapper_cache_acquire_t acquire,
+		lv_fs_wrapper_cache_release_t release);
+
 /**
  * Open a file using mbed's retargeted filesystem
- * @param file_p pointer to a FILE* variable
+ * @param file_p pointer to a lv_fs_wrapper_file_t variable
  * @param fn name of the file.
  * @param mode element of 'fs_mode_t' enum or its 'OR' connection (e.g. FS_MODE_WR | FS_MODE_RD)
  * @return LV_FS_RES_OK: no error, the file is opened
@@ -51,7 +90,7 @@ lv_fs_res_t lv_fs_wrapper_open(lv_fs_drv_t* fs_drv, void* file_p, const char* fn
 
 /**
  * Close an opened file
- * @param file_p pointer to a FILE* variable. (opened with lv_ufs_open)
+ * @param file_p pointer to a lv_fs_wrapper_file_t variable. (opened with lv_ufs_open)
  * @return LV_FS_RES_OK: no error, the file is read
  *         any error from lv__fs_res_t enum
  */
@@ -59,7 +98,7 @@ lv_fs_res_t lv_fs_wrapper_close(lv_fs_drv_t* fs_drv, void* file_p);
 
 /**
  * Read data from an opened file
- * @param file_p pointer to a FILE variable.
+ * @param file_p pointer to a lv_fs_wrapper_file_t variable.
  * @param buf pointer to a memory block where to store the read data
  * @param btr number of Bytes To Read
  * @param br the real number of read bytes (Byte Read)
@@ -70,7 +109,7 @@ lv_fs_res_t lv_fs_wrapper_read(lv_fs_drv_t* fs_drv, void* file_p, void* buf, uin
 
 /**
  * Set the read write pointer. Also expand the file size if necessary.
- * @param file_p pointer to a FILE* variable. (opened with lv_ufs_open )
+ * @param file_p pointer to a lv_fs_wrapper_file_t variable. (opened with lv_ufs_open )
  * @param pos the new position of read write pointer
  * @return LV_FS_RES_OK: no error, the file is read
  *         any error from lv__fs_res_t enum
@@ -79,13 +118,22 @@ lv_fs_res_t lv_fs_wrapper_seek(lv_fs_drv_t* fs_drv, void* file_p, uint32_t pos);
 
 /**
  * Give the position of the read write pointer
- * @param file_p pointer to a FILE* variable.
+ * @param file_p pointer to a lv_fs_wrapper_file_t variable.
  * @param pos_p pointer to to store the result
  * @return LV_FS_RES_OK: no error, the file is read
  *         any error from lv__fs_res_t enum
  */
 lv_fs_res_t lv_fs_wrapper_tell(lv_fs_drv_t* fs_drv, void* file_p, uint32_t* pos_p);
 
+/**
+ * Give the size of an opened file
+ * @param file_p pointer to a lv_fs_wrapper_file_t variable.
+ * @param size_p pointer to store the size
+ * @return LV_FS_RES_OK: no error, the size is stored
+ *         any error from lv__fs_res_t enum
+ */
+lv_fs_res_t lv_fs_wrapper_size(lv_fs_drv_t* fs_drv, void* file_p, uint32_t* size_p);
+
 #ifdef __cplusplus
 }
 #endif
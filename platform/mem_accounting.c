@@ -0,0 +1,175 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mem_accounting.h"
+
+#if MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trace.h"
+
+#if defined(__MBED__)
+#include "platform/mbed_assert.h"
+#include "platform/mbed_critical.h"
+#define MEM_LOCK()		core_util_critical_section_enter()
+#define MEM_UNLOCK()	core_util_critical_section_exit()
+#else
+#include <assert.h>
+#define MBED_ASSERT(expr)	assert(expr)
+#define MEM_LOCK()
+#define MEM_UNLOCK()
+#endif
+
+#define MEM_TAGS		MBED_CONF_MBED_LVGL_MEM_TAGS
+
+/** Marks blocks allocated by the wrapper */
+#define MEM_MAGIC		0xA11C
+
+/** Header in front of every block, keeps the block 8-byte aligned */
+typedef struct {
+	uint32_t size;
+	uint16_t magic;
+	uint8_t tag;
+	uint8_t reserved;
+} mem_header_t;
+
+static mbed_lvgl_mem_stats_t totals;
+static mbed_lvgl_mem_tag_stats_t tags[MEM_TAGS] = { { "untagged", 0, 0, 0, 0 } };
+static size_t tag_count = 1;
+static uint8_t current_tag = MBED_LVGL_MEM_UNTAGGED;
+
+void* mbed_lvgl_mem_alloc(size_t size)
+{
+	MBED_LVGL_TRACE_INSTANT("malloc", (uint32_t) size);
+
+	mem_header_t* header = (mem_header_t*) malloc(sizeof(mem_header_t) + size);
+
+	MEM_LOCK();
+	if(header == NULL) {
+		totals.failures++;
+		MEM_UNLOCK();
+		return NULL;
+	}
+
+	header->size = size;
+	header->magic = MEM_MAGIC;
+	header->tag = current_tag;
+
+	totals.allocs++;
+	totals.live_blocks++;
+	totals.live_bytes += size;
+	if(totals.live_bytes > totals.peak_bytes) {
+		totals.peak_bytes = totals.live_bytes;
+	}
+
+	mbed_lvgl_mem_tag_stats_t* tag = &tags[header->tag];
+	tag->allocs++;
+	tag->live_blocks++;
+	tag->live_bytes += size;
+	if(tag->live_bytes > tag->peak_bytes) {
+		tag->peak_bytes = tag->live_bytes;
+	}
+	MEM_UNLOCK();
+
+	return header + 1;
+}
+
+void mbed_lvgl_mem_free(void* ptr)
+{
+	if(ptr == NULL) {
+		return;
+	}
+
+	MBED_LVGL_TRACE_INSTANT("free", 0);
+
+	mem_header_t* header = ((mem_header_t*) ptr) - 1;
+	MBED_ASSERT(header->magic == MEM_MAGIC);
+
+	MEM_LOCK();
+	totals.frees++;
+	totals.live_blocks--;
+	totals.live_bytes -= header->size;
+
+	// Charged to the tag it was allocated under
+	mbed_lvgl_mem_tag_stats_t* tag = &tags[header->tag];
+	tag->live_blocks--;
+	tag->live_bytes -= header->size;
+	MEM_UNLOCK();
+
+	header->magic = 0;
+	free(header);
+}
+
+uint8_t mbed_lvgl_mem_register_tag(const char* name)
+{
+	for(size_t i = 0; i < tag_count; i++) {
+		if(strcmp(tags[i].name, name) == 0) {
+			return (uint8_t) i;
+		}
+	}
+
+	if(tag_count == MEM_TAGS) {
+		return MBED_LVGL_MEM_UNTAGGED;
+	}
+
+	MEM_LOCK();
+	memset(&tags[tag_count], 0, sizeof(tags[tag_count]));
+	tags[tag_count].name = name;
+	tag_count++;
+	MEM_UNLOCK();
+
+	return (uint8_t)(tag_count - 1);
+}
+
+uint8_t mbed_lvgl_mem_set_tag(uint8_t tag)
+{
+	MBED_ASSERT(tag < tag_count);
+	uint8_t previous = current_tag;
+	current_tag = tag;
+	return previous;
+}
+
+void mbed_lvgl_mem_get_stats(mbed_lvgl_mem_stats_t* stats)
+{
+	MEM_LOCK();
+	*stats = totals;
+	MEM_UNLOCK();
+}
+
+size_t mbed_lvgl_mem_get_tag_stats(mbed_lvgl_mem_tag_stats_t* stats, size_t max)
+{
+	MEM_LOCK();
+	size_t count = (tag_count < max) ? tag_count : max;
+	memcpy(stats, tags, count * sizeof(*stats));
+	MEM_UNLOCK();
+	return count;
+}
+
+void mbed_lvgl_mem_reset_peaks(void)
+{
+	MEM_LOCK();
+	totals.peak_bytes = totals.live_bytes;
+	for(size_t i = 0; i < tag_count; i++) {
+		tags[i].peak_bytes = tags[i].live_bytes;
+	}
+	MEM_UNLOCK();
+}
+
+#endif /* MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING */
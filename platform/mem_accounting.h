@@ -0,0 +1,136 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* This header provides lvgl's allocation wrappers (LV_MEM_CUSTOM_ALLOC and
+ * LV_MEM_CUSTOM_FREE) with accounting. lvgl's own lv_mem_monitor only
+ * knows about its built-in pool, with LV_MEM_CUSTOM the heap used by
+ * lvgl is otherwise invisible.
+ *
+ * Every allocation is charged to the current tag (eg: the screen being
+ * built), live and peak usage are kept per tag and in total. Deleting a
+ * screen should bring its tag's live usage back to where it was before
+ * it was built, anything left is a leak.
+ */
+#ifndef MBED_LVGL_MEM_ACCOUNTING_H_
+#define MBED_LVGL_MEM_ACCOUNTING_H_
+
+#if MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Tag of allocations made outside of any tag
+ *
+ * Typed so LVGLMemTag(MBED_LVGL_MEM_UNTAGGED) picks the tag constructor,
+ * a plain 0 is also a null name
+ */
+#define MBED_LVGL_MEM_UNTAGGED		((uint8_t) 0)
+
+/** Usage of the whole heap used by lvgl */
+typedef struct {
+	uint32_t live_bytes;	/** Bytes currently allocated */
+	uint32_t peak_bytes;	/** Most bytes allocated at once since the last peak reset */
+	uint32_t live_blocks;	/** Blocks currently allocated */
+	uint32_t allocs;		/** Allocations */
+	uint32_t frees;			/** Frees */
+	uint32_t failures;		/** Allocations that failed */
+} mbed_lvgl_mem_stats_t;
+
+/** Usage charged to a tag */
+typedef struct {
+	const char* name;		/** Name of the tag */
+	uint32_t live_bytes;	/** Bytes currently allocated */
+	uint32_t peak_bytes;	/** Most bytes allocated at once since the last peak reset */
+	uint32_t live_blocks;	/** Blocks currently allocated */
+	uint32_t allocs;		/** Allocations */
+} mbed_lvgl_mem_tag_stats_t;
+
+/**
+ * Allocation wrappers for lvgl (see lv_conf.h)
+ */
+void* mbed_lvgl_mem_alloc(size_t size);
+void mbed_lvgl_mem_free(void* ptr);
+
+/**
+ * Register a tag
+ * @param name name of the tag, must stay valid
+ * @return tag, the existing one if the name is already registered, MBED_LVGL_MEM_UNTAGGED if the table is full
+ */
+uint8_t mbed_lvgl_mem_register_tag(const char* name);
+
+/**
+ * Charge the following allocations to a tag
+ * @param tag tag returned by mbed_lvgl_mem_register_tag
+ * @return previous tag
+ */
+uint8_t mbed_lvgl_mem_set_tag(uint8_t tag);
+
+/**
+ * Get the usage of the whole heap used by lvgl
+ * @param stats pointer to store the usage
+ */
+void mbed_lvgl_mem_get_stats(mbed_lvgl_mem_stats_t* stats);
+
+/**
+ * Get the usage of each tag
+ * @param stats array receiving the usage of each tag, starting with untagged allocations
+ * @param max size of the array
+ * @return number of tags copied
+ */
+size_t mbed_lvgl_mem_get_tag_stats(mbed_lvgl_mem_tag_stats_t* stats, size_t max);
+
+/**
+ * Start measuring peaks over from the current usage
+ */
+void mbed_lvgl_mem_reset_peaks(void);
+
+#ifdef __cplusplus
+}
+
+/**
+ * Charges the allocations made during its lifetime to a tag
+ *
+ * eg: { LVGLMemTag tag("settings"); build_settings_screen(); }
+ */
+class LVGLMemTag
+{
+	public:
+
+		LVGLMemTag(const char* name) :
+				previous(mbed_lvgl_mem_set_tag(mbed_lvgl_mem_register_tag(name))) { }
+
+		LVGLMemTag(uint8_t tag) : previous(mbed_lvgl_mem_set_tag(tag)) { }
+
+		~LVGLMemTag() {
+			mbed_lvgl_mem_set_tag(previous);
+		}
+
+	private:
+
+		uint8_t previous;
+
+};
+#endif
+
+#endif /* MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING */
+
+#endif /* MBED_LVGL_MEM_ACCOUNTING_H_ */
@@ -0,0 +1,325 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pixel_ops.h"
+
+#include <string.h>
+
+#if defined(__ARM_FEATURE_MVE)
+#include <arm_mve.h>
+#define PX_OPS_ARM_VECTOR 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PX_OPS_ARM_VECTOR 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define PX_OPS_AVX2 1
+#define PX_OPS_SSE2 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define PX_OPS_SSE2 1
+#endif
+
+/* Vector kernels work on the plain RGB565 layout (red in the top bits) */
+#define PX_OPS_RGB565 ((LV_COLOR_DEPTH == 16) && (LV_COLOR_16_SWAP == 0))
+
+void mbed_lvgl_px_fill(lv_color_t* dest, uint32_t len, lv_color_t color)
+{
+#if LV_COLOR_DEPTH == 16
+	uint16_t* d = (uint16_t*) dest;
+	uint16_t c = color.full;
+#if PX_OPS_ARM_VECTOR
+	uint16x8_t vc = vdupq_n_u16(c);
+	for(; len >= 8; len -= 8, d += 8) {
+		vst1q_u16(d, vc);
+	}
+#elif PX_OPS_AVX2
+	__m256i vc = _mm256_set1_epi16((short) c);
+	for(; len >= 16; len -= 16, d += 16) {
+		_mm256_storeu_si256((__m256i*) d, vc);
+	}
+#elif PX_OPS_SSE2
+	__m128i vc = _mm_set1_epi16((short) c);
+	for(; len >= 8; len -= 8, d += 8) {
+		_mm_storeu_si128((__m128i*) d, vc);
+	}
+#endif
+	while(len--) {
+		*d++ = c;
+	}
+#elif LV_COLOR_DEPTH == 32
+	uint32_t* d = (uint32_t*) dest;
+	uint32_t c = color.full;
+#if PX_OPS_ARM_VECTOR
+	uint32x4_t vc = vdupq_n_u32(c);
+	for(; len >= 4; len -= 4, d += 4) {
+		vst1q_u32(d, vc);
+	}
+#elif PX_OPS_AVX2
+	__m256i vc = _mm256_set1_epi32((int) c);
+	for(; len >= 8; len -= 8, d += 8) {
+		_mm256_storeu_si256((__m256i*) d, vc);
+	}
+#elif PX_OPS_SSE2
+	__m128i vc = _mm_set1_epi32((int) c);
+	for(; len >= 4; len -= 4, d += 4) {
+		_mm_storeu_si128((__m128i*) d, vc);
+	}
+#endif
+	while(len--) {
+		*d++ = c;
+	}
+#else
+	// 1 and 8 bit colors are a single byte
+	memset(dest, color.full, len);
+#endif
+}
+
+void mbed_lvgl_px_copy(lv_color_t* dest, const lv_color_t* src, uint32_t len)
+{
+	// The C library's memcpy is already vectorized on every supported toolchain
+	memcpy(dest, src, len * sizeof(lv_color_t));
+}
+
+void mbed_lvgl_px_blend(lv_color_t* dest, const lv_color_t* src, uint32_t len, lv_opa_t opa)
+{
+#if PX_OPS_RGB565
+	uint16_t* d = (uint16_t*) dest;
+	const uint16_t* s = (const uint16_t*) src;
+#if PX_OPS_ARM_VECTOR
+	uint16x8_t mix = vdupq_n_u16(opa);
+	uint16x8_t inv = vdupq_n_u16(255 - opa);
+	uint16x8_t mask5 = vdupq_n_u16(0x1F);
+	uint16x8_t mask6 = vdupq_n_u16(0x3F);
+	for(; len >= 8; len -= 8, d += 8, s += 8) {
+		uint16x8_t vs = vld1q_u16(s);
+		uint16x8_t vd = vld1q_u16(d);
+		uint16x8_t r = vshrq_n_u16(vaddq_u16(vmulq_u16(vshrq_n_u16(vs, 11), mix),
+				vmulq_u16(vshrq_n_u16(vd, 11), inv)), 8);
+		uint16x8_t g = vshrq_n_u16(vaddq_u16(vmulq_u16(vandq_u16(vshrq_n_u16(vs, 5), mask6), mix),
+				vmulq_u16(vandq_u16(vshrq_n_u16(vd, 5), mask6), inv)), 8);
+		uint16x8_t b = vshrq_n_u16(vaddq_u16(vmulq_u16(vandq_u16(vs, mask5), mix),
+				vmulq_u16(vandq_u16(vd, mask5), inv)), 8);
+		vst1q_u16(d, vorrq_u16(vorrq_u16(vshlq_n_u16(r, 11), vshlq_n_u16(g, 5)), b));
+	}
+#elif PX_OPS_AVX2
+	__m256i mix = _mm256_set1_epi16(opa);
+	__m256i inv = _mm256_set1_epi16(255 - opa);
+	__m256i mask5 = _mm256_set1_epi16(0x1F);
+	__m256i mask6 = _mm256_set1_epi16(0x3F);
+	for(; len >= 16; len -= 16, d += 16, s += 16) {
+		__m256i vs = _mm256_loadu_si256((const __m256i*) s);
+		__m256i vd = _mm256_loadu_si256((const __m256i*) d);
+		__m256i r = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(vs, 11), mix),
+				_mm256_mullo_epi16(_mm256_srli_epi16(vd, 11), inv)), 8);
+		__m256i g = _mm256_srli_epi16(_mm256_add_epi16(
+				_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(vs, 5), mask6), mix),
+				_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(vd, 5), mask6), inv)), 8);
+		__m256i b = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_and_si256(vs, mask5), mix),
+				_mm256_mullo_epi16(_mm256_and_si256(vd, mask5), inv)), 8);
+		_mm256_storeu_si256((__m256i*) d,
+				_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(r, 11), _mm256_slli_epi16(g, 5)), b));
+	}
+#elif PX_OPS_SSE2
+	__m128i mix = _mm_set1_epi16(opa);
+	__m128i inv = _mm_set1_epi16(255 - opa);
+	__m128i mask5 = _mm_set1_epi16(0x1F);
+	__m128i mask6 = _mm_set1_epi16(0x3F);
+	for(; len >= 8; len -= 8, d += 8, s += 8) {
+		__m128i vs = _mm_loadu_si128((const __m128i*) s);
+		__m128i vd = _mm_loadu_si128((const __m128i*) d);
+		__m128i r = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_srli_epi16(vs, 11), mix),
+				_mm_mullo_epi16(_mm_srli_epi16(vd, 11), inv)), 8);
+		__m128i g = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(vs, 5), mask6), mix),
+				_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(vd, 5), mask6), inv)), 8);
+		__m128i b = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(vs, mask5), mix),
+				_mm_mullo_epi16(_mm_and_si128(vd, mask5), inv)), 8);
+		_mm_storeu_si128((__m128i*) d, _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 11), _mm_slli_epi16(g, 5)), b));
+	}
+#endif
+	dest = (lv_color_t*) d;
+	src = (const lv_color_t*) s;
+#elif LV_COLOR_DEPTH == 32
+#if PX_OPS_SSE2
+	__m128i mix = _mm_set1_epi16(opa);
+	__m128i inv = _mm_set1_epi16(255 - opa);
+	__m128i zero = _mm_setzero_si128();
+	__m128i alpha = _mm_set1_epi32((int) 0xFF000000);
+	for(; len >= 4; len -= 4, dest += 4, src += 4) {
+		__m128i vs = _mm_loadu_si128((const __m128i*) src);
+		__m128i vd = _mm_loadu_si128((const __m128i*) dest);
+		__m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(vs, zero), mix),
+				_mm_mullo_epi16(_mm_unpacklo_epi8(vd, zero), inv)), 8);
+		__m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(vs, zero), mix),
+				_mm_mullo_epi16(_mm_unpackhi_epi8(vd, zero), inv)), 8);
+		_mm_storeu_si128((__m128i*) dest, _mm_or_si128(_mm_packus_epi16(lo, hi), alpha));
+	}
+#elif PX_OPS_ARM_VECTOR && defined(__ARM_NEON)
+	uint8x8_t mix = vdup_n_u8(opa);
+	uint8x8_t inv = vdup_n_u8(255 - opa);
+	for(; len >= 8; len -= 8, dest += 8, src += 8) {
+		uint8x8x4_t vs = vld4_u8((const uint8_t*) src);
+		uint8x8x4_t vd = vld4_u8((const uint8_t*) dest);
+		for(int ch = 0; ch < 3; ch++) {
+			vd.val[ch] = vshrn_n_u16(vmlal_u8(vmull_u8(vs.val[ch], mix), vd.val[ch], inv), 8);
+		}
+		vd.val[3] = vdup_n_u8(0xFF);
+		vst4_u8((uint8_t*) dest, vd);
+	}
+#endif
+#endif
+
+	// Remaining pixels (and all other color formats)
+	while(len--) {
+		*dest = lv_color_mix(*src, *dest, opa);
+		dest++;
+		src++;
+	}
+}
+
+/** Splits a color into 8 bit channels */
+static inline void px_to_rgb888(lv_color_t c, uint8_t* r, uint8_t* g, uint8_t* b)
+{
+#if LV_COLOR_DEPTH == 32
+	*r = c.ch.red;
+	*g = c.ch.green;
+	*b = c.ch.blue;
+#else
+	uint32_t c32 = lv_color_to32(c);
+	*r = (c32 >> 16) & 0xFF;
+	*g = (c32 >> 8) & 0xFF;
+	*b = c32 & 0xFF;
+#endif
+}
+
+void mbed_lvgl_px_to_rgb565(uint8_t* dest, const lv_color_t* src, uint32_t len, bool swap)
+{
+#if LV_COLOR_DEPTH == 16
+	// Already RGB565, at most the byte order differs
+	bool need_swap = (swap != (LV_COLOR_16_SWAP != 0));
+	const uint16_t* s = (const uint16_t*) src;
+	uint16_t* d = (uint16_t*) dest;
+	if(!need_swap) {
+		if((void*) d != (const void*) s) {
+			memcpy(d, s, len * 2);
+		}
+		return;
+	}
+	while(len--) {
+		uint16_t v = *s++;
+		*d++ = (uint16_t)((v << 8) | (v >> 8));
+	}
+#else
+	// Each destination pixel is no larger than its source, so converting forwards works in place
+	while(len--) {
+		uint8_t r, g, b;
+		px_to_rgb888(*src++, &r, &g, &b);
+		uint16_t v = (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+		if(swap) {
+			*dest++ = v >> 8;
+			*dest++ = v & 0xFF;
+		} else {
+			*dest++ = v & 0xFF;
+			*dest++ = v >> 8;
+		}
+	}
+#endif
+}
+
+void mbed_lvgl_px_to_rgb332(uint8_t* dest, const lv_color_t* src, uint32_t len)
+{
+#if LV_COLOR_DEPTH == 8
+	if((void*) dest != (const void*) src) {
+		memcpy(dest, src, len);
+	}
+#else
+	while(len--) {
+		uint8_t r, g, b;
+		px_to_rgb888(*src++, &r, &g, &b);
+		*dest++ = (uint8_t)((r & 0xE0) | ((g & 0xE0) >> 3) | (b >> 6));
+	}
+#endif
+}
+
+void mbed_lvgl_px_lut_expand16(uint16_t* dest, const uint8_t* src, uint32_t len, const uint16_t* lut)
+{
+#if defined(__ARM_FEATURE_MVE)
+	// Helium gathers 8 halfwords per instruction
+	for(; len >= 8; len -= 8, src += 8, dest += 8) {
+		uint16x8_t index = vldrbq_u16(src);
+		vst1q_u16(dest, vldrhq_gather_shifted_offset_u16(lut, index));
+	}
+#endif
+
+	/* Other instruction sets have no 16-bit gather (or a slow one), the
+	 * lookups are unrolled instead, reading 4 indices per load */
+	for(; len >= 4; len -= 4, src += 4, dest += 4) {
+		uint32_t indices;
+		memcpy(&indices, src, 4);
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+		dest[0] = lut[indices >> 24];
+		dest[1] = lut[(indices >> 16) & 0xFF];
+		dest[2] = lut[(indices >> 8) & 0xFF];
+		dest[3] = lut[indices & 0xFF];
+#else
+		dest[0] = lut[indices & 0xFF];
+		dest[1] = lut[(indices >> 8) & 0xFF];
+		dest[2] = lut[(indices >> 16) & 0xFF];
+		dest[3] = lut[indices >> 24];
+#endif
+	}
+
+	while(len--) {
+		*dest++ = lut[*src++];
+	}
+}
+
+#if LV_COLOR_DEPTH == 8
+void mbed_lvgl_px_make_rgb565_lut(uint16_t* lut, bool swap)
+{
+	for(uint32_t i = 0; i < 256; i++) {
+		lv_color_t c;
+		c.full = (uint8_t) i;
+		mbed_lvgl_px_to_rgb565((uint8_t*) &lut[i], &c, 1, swap);
+	}
+}
+#endif
+
+void mbed_lvgl_px_to_mono_vtiled(uint8_t* dest, const lv_color_t* src, lv_coord_t w, lv_coord_t h)
+{
+	lv_coord_t byte_rows = h >> 3;
+
+	for(lv_coord_t r = 0; r < byte_rows; r++) {
+		const lv_color_t* band = src + ((int32_t) r * 8 * w);
+		uint8_t* out = dest + r;
+
+		// Gather 8 vertically adjacent pixels of each column into one byte
+		for(lv_coord_t x = 0; x < w; x++) {
+			uint8_t bits = 0;
+			const lv_color_t* px = band + x;
+			for(int k = 0; k < 8; k++) {
+				bits <<= 1;
+				if(lv_color_brightness(*px) < MBED_LVGL_MONO_THRESHOLD) {
+					bits |= 1;
+				}
+				px += w;
+			}
+			*out = bits;
+			out += byte_rows;
+		}
+	}
+}
@@ -0,0 +1,121 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* This header provides pixel kernels (fill, copy, blend) used
+ * as the default "GPU" implementation of display drivers, and packing
+ * kernels that convert rendered lv_color_t pixels to a panel's native format.
+ *
+ * The kernels are vectorized with NEON or Helium (MVE) on Arm targets
+ * and SSE2 or AVX2 on hosts, falling back to plain C elsewhere. The
+ * results are bit-exact with lvgl's own lv_color_mix.
+ */
+#ifndef MBED_LVGL_PIXEL_OPS_H_
+#define MBED_LVGL_PIXEL_OPS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lv_color.h"
+#include "lv_area.h"
+
+/**
+ * Pixels darker than this (lv_color_brightness) set their bit on
+ * monochrome displays, for the packing kernel and drivers' set_pixel alike
+ */
+#ifndef MBED_LVGL_MONO_THRESHOLD
+#define MBED_LVGL_MONO_THRESHOLD 128
+#endif
+
+/**
+ * Fill a run of pixels with a color
+ * @param dest pointer to the first pixel
+ * @param len number of pixels to fill
+ * @param color color to fill with
+ */
+void mbed_lvgl_px_fill(lv_color_t* dest, uint32_t len, lv_color_t color);
+
+/**
+ * Copy a run of pixels
+ * @param dest destination pixels
+ * @param src source pixels (must not overlap dest)
+ * @param len number of pixels to copy
+ */
+void mbed_lvgl_px_copy(lv_color_t* dest, const lv_color_t* src, uint32_t len);
+
+/**
+ * Blend a run of pixels onto another: dest = mix(src, dest, opa)
+ * @param dest destination pixels (also the background)
+ * @param src foreground pixels
+ * @param len number of pixels to blend
+ * @param opa opacity of src
+ */
+void mbed_lvgl_px_blend(lv_color_t* dest, const lv_color_t* src, uint32_t len, lv_opa_t opa);
+
+/**
+ * Convert pixels to RGB565
+ * @param dest destination, 2 bytes per pixel (may be the same memory as src if LV_COLOR_DEPTH >= 16)
+ * @param src rendered pixels
+ * @param len number of pixels to convert
+ * @param swap true to store the high byte first (panel wire order on little endian MCUs)
+ */
+void mbed_lvgl_px_to_rgb565(uint8_t* dest, const lv_color_t* src, uint32_t len, bool swap);
+
+/**
+ * Expand 8-bit pixels (palette indices) through a lookup table
+ * @param dest destination, 2 bytes per pixel (must not overlap src)
+ * @param src 8-bit pixels (lv_color_t.full at LV_COLOR_DEPTH 8)
+ * @param len number of pixels to expand
+ * @param lut 256 entries, each in the destination's memory layout
+ */
+void mbed_lvgl_px_lut_expand16(uint16_t* dest, const uint8_t* src, uint32_t len, const uint16_t* lut);
+
+#if LV_COLOR_DEPTH == 8
+/**
+ * Build the lookup table expanding 8-bit pixels to RGB565
+ * @param lut 256 entries, entry i is pixel i (RGB332) as mbed_lvgl_px_to_rgb565 converts it
+ * @param swap true to store the high byte first
+ */
+void mbed_lvgl_px_make_rgb565_lut(uint16_t* lut, bool swap);
+#endif
+
+/**
+ * Convert pixels to RGB332
+ * @param dest destination, 1 byte per pixel (may be the same memory as src)
+ * @param src rendered pixels
+ * @param len number of pixels to convert
+ */
+void mbed_lvgl_px_to_rgb332(uint8_t* dest, const lv_color_t* src, uint32_t len);
+
+/**
+ * Convert pixels to 1 bit per pixel, 8 vertical pixels per byte (MSB on top),
+ * stored column by column. Dark pixels (brightness below MBED_LVGL_MONO_THRESHOLD) set their bit.
+ * @param dest destination, w * (h / 8) bytes (must not overlap src)
+ * @param src rendered pixels, w * h row-major
+ * @param w width of the area in pixels
+ * @param h height of the area in pixels, must be a multiple of 8
+ */
+void mbed_lvgl_px_to_mono_vtiled(uint8_t* dest, const lv_color_t* src, lv_coord_t w, lv_coord_t h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MBED_LVGL_PIXEL_OPS_H_ */
@@ -0,0 +1,256 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "trace.h"
+
+#if MBED_CONF_MBED_LVGL_ENABLE_TRACE
+
+#include <stdlib.h>
+
+#if defined(__MBED__)
+#include "platform/mbed_critical.h"
+#if DEVICE_USTICKER
+#include "hal/us_ticker_api.h"
+#endif
+#if MBED_CONF_RTOS_PRESENT
+#include "cmsis_os2.h"
+#endif
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#define TRACE_BUFFER_EVENTS		MBED_CONF_MBED_LVGL_TRACE_BUFFER_EVENTS
+
+/** Maximum number of named threads */
+#define TRACE_MAX_THREADS		8
+
+typedef struct {
+	const char* name;
+	uint32_t ts_us;
+	uint32_t tid;
+	uint32_t value;
+	char phase;
+} trace_event_t;
+
+typedef struct {
+	uint32_t tid;
+	const char* name;
+} trace_thread_t;
+
+/** Spans a thread has open while events are written */
+typedef struct {
+	uint32_t tid;
+	uint32_t depth;
+} trace_depth_t;
+
+static trace_event_t events[TRACE_BUFFER_EVENTS];
+
+/** Total number of events recorded, the ring holds the last TRACE_BUFFER_EVENTS */
+static volatile uint32_t event_count = 0;
+
+static volatile bool recording = true;
+
+static trace_thread_t threads[TRACE_MAX_THREADS];
+static size_t thread_count = 0;
+
+static trace_depth_t depths[TRACE_MAX_THREADS * 2];
+
+static uint32_t trace_timestamp(void)
+{
+#if defined(__MBED__)
+#if DEVICE_USTICKER
+	return (uint32_t) ticker_read_us(get_us_ticker_data());
+#else
+	return 0;
+#endif
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)(((uint64_t) ts.tv_sec * 1000000u) + (ts.tv_nsec / 1000));
+#endif
+}
+
+static uint32_t trace_thread_id(void)
+{
+#if defined(__MBED__)
+#if MBED_CONF_RTOS_PRESENT
+	if(core_util_is_isr_active()) {
+		return 0;
+	}
+	return (uint32_t) osThreadGetId();
+#else
+	return core_util_is_isr_active() ? 0 : 1;
+#endif
+#else
+	return (uint32_t)(uintptr_t) pthread_self();
+#endif
+}
+
+static uint32_t trace_claim_slot(void)
+{
+#if defined(__MBED__)
+	return core_util_atomic_incr_u32((uint32_t*) &event_count, 1) - 1;
+#else
+	return __atomic_fetch_add(&event_count, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+void mbed_lvgl_trace_event(const char* name, char phase, uint32_t value)
+{
+	if(!recording) {
+		return;
+	}
+
+	trace_event_t* event = &events[trace_claim_slot() % TRACE_BUFFER_EVENTS];
+	event->name = name;
+	event->ts_us = trace_timestamp();
+	event->tid = trace_thread_id();
+	event->value = value;
+	event->phase = phase;
+}
+
+void mbed_lvgl_trace_enable(bool enable)
+{
+	recording = enable;
+}
+
+void mbed_lvgl_trace_clear(void)
+{
+	event_count = 0;
+}
+
+void mbed_lvgl_trace_name_thread(const char* name)
+{
+	uint32_t tid = trace_thread_id();
+	for(size_t i = 0; i < thread_count; i++) {
+		if(threads[i].tid == tid) {
+			threads[i].name = name;
+			return;
+		}
+	}
+	if(thread_count < TRACE_MAX_THREADS) {
+		threads[thread_count].tid = tid;
+		threads[thread_count].name = name;
+		thread_count++;
+	}
+}
+
+size_t mbed_lvgl_trace_write(FILE* stream)
+{
+	bool was_recording = recording;
+	recording = false;
+
+	uint32_t count = event_count;
+	uint32_t first = (count > TRACE_BUFFER_EVENTS) ? (count - TRACE_BUFFER_EVENTS) : 0;
+
+	fprintf(stream, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	bool separator = false;
+	for(size_t i = 0; i < thread_count; i++) {
+		fprintf(stream, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,\"args\":{\"name\":\"%s\"}}",
+				separator ? ",\n" : "", (unsigned long) threads[i].tid, threads[i].name);
+		separator = true;
+	}
+
+	size_t depth_count = 0;
+	size_t written = 0;
+
+	// Timestamps are 32-bit microseconds, unwrap them relative to the oldest event
+	uint64_t ts = 0;
+	uint32_t last_ts = (count != first) ? events[first % TRACE_BUFFER_EVENTS].ts_us : 0;
+	for(uint32_t i = first; i < count; i++) {
+		const trace_event_t* event = &events[i % TRACE_BUFFER_EVENTS];
+		int32_t delta = (int32_t)(event->ts_us - last_ts);
+		if(delta > 0 || (uint64_t)(-(int64_t) delta) <= ts) {
+			ts += delta;
+		}
+		last_ts = event->ts_us;
+
+		// Drop the ends of spans whose beginning was overwritten
+		if(event->phase == 'B' || event->phase == 'E') {
+			trace_depth_t* depth = NULL;
+			for(size_t j = 0; j < depth_count && depth == NULL; j++) {
+				if(depths[j].tid == event->tid) {
+					depth = &depths[j];
+				}
+			}
+			if(depth == NULL && depth_count < (sizeof(depths) / sizeof(depths[0]))) {
+				depth = &depths[depth_count++];
+				depth->tid = event->tid;
+				depth->depth = 0;
+			}
+			if(depth != NULL) {
+				if(event->phase == 'B') {
+					depth->depth++;
+				} else if(depth->depth == 0) {
+					continue;
+				} else {
+					depth->depth--;
+				}
+			}
+		}
+
+		fprintf(stream, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu,\"pid\":1,\"tid\":%lu",
+				separator ? ",\n" : "", event->name, event->phase,
+				(unsigned long long) ts, (unsigned long) event->tid);
+		if(event->phase == 'C' || event->value != 0) {
+			fprintf(stream, ",\"args\":{\"value\":%lu}", (unsigned long) event->value);
+		}
+		if(event->phase == 'i') {
+			fprintf(stream, ",\"s\":\"t\"");
+		}
+		fprintf(stream, "}");
+		separator = true;
+		written++;
+	}
+
+	fprintf(stream, "\n]}\n");
+
+	recording = was_recording;
+	return written;
+}
+
+bool mbed_lvgl_trace_save(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if(file == NULL) {
+		return false;
+	}
+
+	mbed_lvgl_trace_write(file);
+
+	bool ok = (ferror(file) == 0);
+	fclose(file);
+	return ok;
+}
+
+void* mbed_lvgl_trace_malloc(size_t size)
+{
+	mbed_lvgl_trace_event("malloc", 'i', (uint32_t) size);
+	return malloc(size);
+}
+
+void mbed_lvgl_trace_free(void* ptr)
+{
+	if(ptr != NULL) {
+		mbed_lvgl_trace_event("free", 'i', 0);
+	}
+	free(ptr);
+}
+
+#endif /* MBED_CONF_MBED_LVGL_ENABLE_TRACE */
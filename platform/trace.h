@@ -0,0 +1,108 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* This header provides a lightweight tracing facility for the rendering
+ * pipeline. Events are recorded into a RAM ring buffer without locking
+ * (so they can be recorded from any thread, the render workers or an
+ * interrupt) and exported as Chrome trace JSON, which can be opened
+ * in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Tracing is compiled out entirely unless enable_trace is set in the
+ * configuration, the MBED_LVGL_TRACE_* macros then expand to nothing.
+ */
+#ifndef MBED_LVGL_TRACE_H_
+#define MBED_LVGL_TRACE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#if MBED_CONF_MBED_LVGL_ENABLE_TRACE
+
+#define MBED_LVGL_TRACE_BEGIN(name)				mbed_lvgl_trace_event((name), 'B', 0)
+#define MBED_LVGL_TRACE_BEGIN_ARG(name, value)	mbed_lvgl_trace_event((name), 'B', (value))
+#define MBED_LVGL_TRACE_END(name)				mbed_lvgl_trace_event((name), 'E', 0)
+#define MBED_LVGL_TRACE_INSTANT(name, value)	mbed_lvgl_trace_event((name), 'i', (value))
+#define MBED_LVGL_TRACE_COUNTER(name, value)	mbed_lvgl_trace_event((name), 'C', (value))
+
+/**
+ * Record an event
+ * @param name name of the event, must be a string literal (only the pointer is stored)
+ * @param phase Chrome trace phase: 'B' begin, 'E' end, 'i' instant, 'C' counter
+ * @param value argument of the event (counter value, size, ...), omitted when 0 except for counters
+ */
+void mbed_lvgl_trace_event(const char* name, char phase, uint32_t value);
+
+/**
+ * Pause or resume recording (recording starts enabled)
+ * @param enable true to record events
+ */
+void mbed_lvgl_trace_enable(bool enable);
+
+/**
+ * Drop all recorded events
+ */
+void mbed_lvgl_trace_clear(void);
+
+/**
+ * Name the calling thread in exported traces
+ * @param name name of the thread, must stay valid
+ */
+void mbed_lvgl_trace_name_thread(const char* name);
+
+/**
+ * Write the recorded events as Chrome trace JSON
+ * @param stream stream to write to (eg: stdout on target, a file on the host)
+ * @return number of events written
+ * @note recording is paused while the events are written
+ * @note once the ring has wrapped, ends of spans whose beginning was overwritten are dropped
+ */
+size_t mbed_lvgl_trace_write(FILE* stream);
+
+/**
+ * Write the recorded events to a Chrome trace JSON file
+ * @param path path of the file
+ * @return false if the file could not be written
+ */
+bool mbed_lvgl_trace_save(const char* path);
+
+/**
+ * lvgl allocation wrappers (LV_MEM_CUSTOM_ALLOC/FREE), recording each call
+ */
+void* mbed_lvgl_trace_malloc(size_t size);
+void mbed_lvgl_trace_free(void* ptr);
+
+#else
+
+#define MBED_LVGL_TRACE_BEGIN(name)
+#define MBED_LVGL_TRACE_BEGIN_ARG(name, value)
+#define MBED_LVGL_TRACE_END(name)
+#define MBED_LVGL_TRACE_INSTANT(name, value)
+#define MBED_LVGL_TRACE_COUNTER(name, value)
+
+#endif /* MBED_CONF_MBED_LVGL_ENABLE_TRACE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MBED_LVGL_TRACE_H_ */
@@ -0,0 +1,236 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Indexed (LV_COLOR_DEPTH 8) versus RGB565 (LV_COLOR_DEPTH 16) rendering
+ *
+ * Built once per depth. A 480x320 dashboard (gradient background, panels,
+ * labels) is redrawn through LittlevGL into a draw buffer of the same
+ * size in bytes at both depths, so the 8-bit build renders twice the
+ * lines per strip. The driver models an RGB565 SPI panel:
+ *  - at depth 16 strips are converted to RGB565 in place (prepare)
+ *  - at depth 8 strips are expanded through the palette's lookup table
+ *    into a bus buffer when flushed
+ * The table gives the host time per frame (rendering and conversion),
+ * the conversion time alone, and the frame time with the bus modelled
+ * (flushing inline, no render workers): a fixed cost per flush (--flush-us, setting the window and starting
+ * the write) plus the pixels at --bus-mbps. Both depths send the same
+ * number of bytes, the 8-bit build in half the flushes.
+ *
+ * At depth 8 the expanded pixels are checked against mbed_lvgl_px_to_rgb565
+ * with the default table, and against the palette's colors with one set.
+ *
+ * Usage: bench_indexed_flush [--quick] [--flush-us <us>] [--bus-mbps <mbps>]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "host_test.h"
+
+#include "LittlevGL.h"
+#include "lv_label.h"
+#include "lv_refr.h"
+#include "platform/pixel_ops.h"
+
+static const lv_coord_t HOR_RES = LV_HOR_RES_MAX;
+static const lv_coord_t VER_RES = LV_VER_RES_MAX;
+
+/** 32 lines of RGB565, the draw buffer takes the same RAM at both depths */
+static const uint32_t DRAW_BUFFER_BYTES = (uint32_t) LV_HOR_RES_MAX * 32 * 2;
+static const uint32_t DRAW_BUFFER_PX = DRAW_BUFFER_BYTES / sizeof(lv_color_t);
+
+static lv_color_t draw_buffer[DRAW_BUFFER_PX];
+
+/** An RGB565 panel behind a modelled bus */
+class BenchDriver : public LVGLDisplayDriver
+{
+	public:
+
+		BenchDriver() : LVGLDisplayDriver(mbed::Span<lv_color_t>(draw_buffer, DRAW_BUFFER_PX)),
+				convert_ns(0), flushes(0), bytes(0), mismatches(0), verify(false) {
+			set_native_format(NATIVE_FORMAT_RGB565_SWAPPED);
+#if LV_COLOR_DEPTH == 8
+			bus.resize(DRAW_BUFFER_PX);
+			palette_px = 0;
+#endif
+		}
+
+		virtual void prepare(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p) {
+			uint64_t start = host_time_ns();
+			LVGLDisplayDriver::prepare(disp_drv, area, color_p);
+			convert_ns += host_time_ns() - start;
+		}
+
+		virtual void flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p) {
+			uint32_t px = lv_area_get_size(area);
+#if LV_COLOR_DEPTH == 8
+			uint64_t start = host_time_ns();
+			expand_rgb565((uint8_t*) bus.data(), color_p, px);
+			convert_ns += host_time_ns() - start;
+
+			if(verify) {
+				for(uint32_t i = 0; i < px; i++) {
+					mismatches += (bus[i] != expected(color_p[i]));
+					palette_px += (color_p[i].full < palette.size());
+				}
+			}
+#endif
+			flushes++;
+			bytes += px * 2;
+		}
+
+#if LV_COLOR_DEPTH == 8
+		/** What an 8-bit pixel should be sent as */
+		uint16_t expected(lv_color_t c) {
+			if(c.full < palette.size()) {
+				uint16_t v = (uint16_t)(((palette[c.full].ch.red & 0xF8) << 8) |
+						((palette[c.full].ch.green & 0xFC) << 3) | (palette[c.full].ch.blue >> 3));
+				return (uint16_t)((v >> 8) | (v << 8));
+			}
+			uint16_t v;
+			mbed_lvgl_px_to_rgb565((uint8_t*) &v, &c, 1, true);
+			return v;
+		}
+
+		std::vector<lv_color32_t> palette;
+		uint32_t palette_px;
+
+		/** Expanded pixels, as sent over the bus */
+		std::vector<uint16_t> bus;
+#endif
+
+		uint64_t convert_ns;
+		uint32_t flushes;
+		uint64_t bytes;
+		uint32_t mismatches;
+		bool verify;
+};
+
+static void build_dashboard(void)
+{
+	static lv_style_t screen_style;
+	static lv_style_t panel_styles[4];
+	static const uint32_t panel_colors[] = { 0x204080, 0x208040, 0x802020, 0x606060 };
+
+	lv_style_copy(&screen_style, &lv_style_pretty_color);
+	lv_obj_set_style(lv_scr_act(), &screen_style);
+
+	for(int i = 0; i < 8; i++) {
+		lv_style_t* style = &panel_styles[i % 4];
+		lv_style_copy(style, &lv_style_plain_color);
+		style->body.main_color = lv_color_hex(panel_colors[i % 4]);
+		style->body.grad_color = style->body.main_color;
+		style->body.border.width = 2;
+		style->body.border.color = LV_COLOR_WHITE;
+
+		lv_obj_t* panel = lv_obj_create(lv_scr_act(), NULL);
+		lv_obj_set_style(panel, style);
+		lv_obj_set_size(panel, HOR_RES / 4 - 12, VER_RES / 2 - 12);
+		lv_obj_set_pos(panel, (i % 4) * (HOR_RES / 4) + 6, (i / 4) * (VER_RES / 2) + 6);
+
+		char text[32];
+		snprintf(text, sizeof(text), "Sensor %d\n%d.%d V", i + 1, 3 + i % 2, (i * 37) % 10);
+		lv_obj_t* label = lv_label_create(panel, NULL);
+		lv_label_set_text(label, text);
+		lv_obj_set_pos(label, 8, 8);
+	}
+}
+
+static void redraw_frame(void)
+{
+	lv_obj_invalidate(lv_scr_act());
+	lv_refr_now(NULL);
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = host_bench_quick(argc, argv);
+	int frames = quick ? 10 : 300;
+	double flush_us = 20;
+	double bus_mbps = 40;
+	for(int i = 1; i < argc - 1; i++) {
+		if(strcmp(argv[i], "--flush-us") == 0) {
+			flush_us = atof(argv[i + 1]);
+		} else if(strcmp(argv[i], "--bus-mbps") == 0) {
+			bus_mbps = atof(argv[i + 1]);
+		}
+	}
+
+	LittlevGL& lvgl = LittlevGL::get_instance();
+	lvgl.init();
+	BenchDriver driver;
+	lvgl.add_display_driver(driver);
+	lvgl.set_default_display(driver);
+	build_dashboard();
+
+#if LV_COLOR_DEPTH == 8
+	// Expansion through the default (RGB332) table, then through a palette
+	driver.verify = true;
+	redraw_frame();
+	HOST_CHECK_EQUAL(0, driver.mismatches);
+
+	for(uint32_t i = 0; i < 16; i++) {
+		lv_color32_t c;
+		c.ch.red = (uint8_t)(i * 16);
+		c.ch.green = (uint8_t)(255 - i * 16);
+		c.ch.blue = (uint8_t)(i * 8);
+		c.ch.alpha = 0xFF;
+		driver.palette.push_back(c);
+	}
+	HOST_CHECK(driver.set_palette(driver.palette.data(), driver.palette.size()));
+
+	// A status bar drawn with a palette index
+	static lv_style_t bar_style;
+	lv_style_copy(&bar_style, &lv_style_plain_color);
+	bar_style.body.main_color = LVGLDisplayDriver::palette_color(5);
+	bar_style.body.grad_color = bar_style.body.main_color;
+	lv_obj_t* bar = lv_obj_create(lv_scr_act(), NULL);
+	lv_obj_set_style(bar, &bar_style);
+	lv_obj_set_size(bar, HOR_RES, 4);
+
+	redraw_frame();
+	HOST_CHECK_EQUAL(0, driver.mismatches);
+	HOST_CHECK(driver.palette_px >= (uint32_t) HOR_RES * 4);
+	lv_obj_del(bar);
+	driver.verify = false;
+#endif
+
+	redraw_frame();
+	driver.convert_ns = 0;
+	driver.flushes = 0;
+	driver.bytes = 0;
+
+	uint64_t start = host_time_ns();
+	for(int i = 0; i < frames; i++) {
+		redraw_frame();
+	}
+	double host_us = (host_time_ns() - start) / 1e3 / frames;
+	double flushes = (double) driver.flushes / frames;
+	double bus_us = flushes * flush_us + (double) driver.bytes / frames * 8 / bus_mbps;
+
+	printf("%dx%d at LV_COLOR_DEPTH %d, %u B draw buffer (%u lines), %d frames\n",
+			HOR_RES, VER_RES, LV_COLOR_DEPTH, (unsigned) DRAW_BUFFER_BYTES,
+			(unsigned)(DRAW_BUFFER_PX / HOR_RES), frames);
+	printf("%8s %14s %14s %16s\n", "flushes", "host (us)", "convert (us)", "modelled (us)");
+	printf("%8.1f %14.1f %14.1f %16.1f\n", flushes, host_us, driver.convert_ns / 1e3 / frames, host_us + bus_us);
+
+	return host_test_result();
+}
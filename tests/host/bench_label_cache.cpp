@@ -0,0 +1,339 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * LabelCache on a 40-label dashboard
+ *
+ * 20 caption labels and 20 value labels on a gradient screen, refreshed
+ * through a strip buffer the way a display driver would be. Two frame
+ * types are timed with and without the cache:
+ *  - redraw: the whole screen is invalidated and no text changes (what an
+ *    animation behind the labels, or a screen reload, costs)
+ *  - update: 5 values change, only their areas are redrawn
+ * The cached frames are compared with the uncached ones, and a text with
+ * the same key as the cached one must not be served from the cache.
+ * Recolored labels and labels with a selection must look the same with
+ * and without the cache.
+ *
+ * Usage: bench_label_cache [--quick]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "host_test.h"
+
+#include "lv_obj.h"
+#include "lv_label.h"
+#include "lv_hal_disp.h"
+#include "lv_refr.h"
+#include "widgets/LabelCache.h"
+
+static const lv_coord_t HOR_RES = LV_HOR_RES_MAX;
+static const lv_coord_t VER_RES = LV_VER_RES_MAX;
+static const uint32_t STRIP_PX = LV_HOR_RES_MAX * 32;
+static const int LABEL_PAIRS = 20;
+static const int UPDATED_PER_FRAME = 5;
+
+/** The coverage is quantized by the mask's RGB565 brightness, then blended again */
+static const int MAX_CHANNEL_DIFF = 12;
+
+static lv_color_t framebuffer[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+static lv_color_t strip[STRIP_PX];
+
+static void flush(lv_disp_drv_t* drv, const lv_area_t* area, lv_color_t* color_p)
+{
+	for(lv_coord_t y = area->y1; y <= area->y2; y++) {
+		lv_coord_t w = lv_area_get_width(area);
+		memcpy(&framebuffer[y * HOR_RES + area->x1], color_p, w * sizeof(lv_color_t));
+		color_p += w;
+	}
+	lv_disp_flush_ready(drv);
+}
+
+struct Dashboard {
+	lv_obj_t* captions[LABEL_PAIRS];
+	lv_obj_t* values[LABEL_PAIRS];
+	uint32_t frame;
+};
+
+static void init_display(void)
+{
+	static lv_disp_buf_t disp_buf;
+	static lv_style_t screen_style;
+
+	lv_init();
+	lv_disp_buf_init(&disp_buf, strip, NULL, STRIP_PX);
+	lv_disp_drv_t drv;
+	lv_disp_drv_init(&drv);
+	drv.buffer = &disp_buf;
+	drv.flush_cb = flush;
+	lv_disp_drv_register(&drv);
+
+	lv_style_copy(&screen_style, &lv_style_pretty_color);
+	lv_obj_set_style(lv_scr_act(), &screen_style);
+}
+
+static void set_value(Dashboard& dash, int i)
+{
+	char text[16];
+	snprintf(text, sizeof(text), "%5u.%u", (unsigned)((dash.frame * 37 + i * 101) % 10000),
+			(unsigned)(dash.frame % 10));
+	lv_label_set_text(dash.values[i], text);
+}
+
+static void build_dashboard(Dashboard& dash)
+{
+	static const char* names[] = {
+		"Coolant temp", "Oil pressure", "Battery", "Fuel level", "Intake air",
+		"Boost", "RPM", "Speed", "Odometer", "Trip",
+	};
+
+	dash.frame = 0;
+	for(int i = 0; i < LABEL_PAIRS; i++) {
+		lv_coord_t x = (i % 2) * (HOR_RES / 2) + 8;
+		lv_coord_t y = (i / 2) * (VER_RES / 10) + 8;
+
+		char caption[32];
+		snprintf(caption, sizeof(caption), "%s %c", names[i % 10], 'A' + i / 10);
+		dash.captions[i] = lv_label_create(lv_scr_act(), NULL);
+		lv_label_set_text(dash.captions[i], caption);
+		lv_obj_set_pos(dash.captions[i], x, y);
+
+		dash.values[i] = lv_label_create(lv_scr_act(), NULL);
+		lv_obj_set_pos(dash.values[i], x + 140, y);
+		set_value(dash, i);
+	}
+}
+
+static void redraw_frame(Dashboard& dash)
+{
+	(void) dash;
+	lv_obj_invalidate(lv_scr_act());
+	lv_refr_now(NULL);
+}
+
+static void update_frame(Dashboard& dash)
+{
+	dash.frame++;
+	for(int i = 0; i < UPDATED_PER_FRAME; i++) {
+		set_value(dash, (dash.frame * UPDATED_PER_FRAME + i) % LABEL_PAIRS);
+	}
+	lv_refr_now(NULL);
+}
+
+static double time_frames(void (*frame)(Dashboard&), Dashboard& dash, int count)
+{
+	uint64_t start = host_time_ns();
+	for(int i = 0; i < count; i++) {
+		frame(dash);
+	}
+	return (host_time_ns() - start) / 1e3 / count;
+}
+
+/** Largest difference of a color channel, scaled to 8 bits */
+static int max_channel_diff(const lv_color_t* a, const lv_color_t* b, size_t count)
+{
+	int max_diff = 0;
+	for(size_t i = 0; i < count; i++) {
+		lv_color32_t ca, cb;
+		ca.full = lv_color_to32(a[i]);
+		cb.full = lv_color_to32(b[i]);
+		int d[] = { ca.ch.red - cb.ch.red, ca.ch.green - cb.ch.green, ca.ch.blue - cb.ch.blue };
+		for(int c = 0; c < 3; c++) {
+			int v = d[c] < 0 ? -d[c] : d[c];
+			if(v > max_diff) max_diff = v;
+		}
+	}
+	return max_diff;
+}
+
+static uint32_t fnv1a(const char* text)
+{
+	uint32_t hash = 2166136261u;
+	for(const char* c = text; *c != '\0'; c++) {
+		hash = (hash ^ (uint8_t) *c) * 16777619u;
+	}
+	return hash;
+}
+
+/** Two texts of the same length whose hashes collide, so the cache keys do too */
+static bool find_colliding_texts(std::string& a, std::string& b)
+{
+	std::map<uint32_t, std::string> seen;
+	char text[16];
+	for(uint32_t i = 0; i < 4000000; i++) {
+		snprintf(text, sizeof(text), "%08x", i * 2654435761u);
+		std::pair<std::map<uint32_t, std::string>::iterator, bool> res =
+				seen.insert(std::make_pair(fnv1a(text), std::string(text)));
+		if(!res.second) {
+			a = res.first->second;
+			b = text;
+			return true;
+		}
+	}
+	return false;
+}
+
+static void test_colliding_text_is_rendered(void)
+{
+	std::string a, b;
+	HOST_CHECK(find_colliding_texts(a, b));
+
+	init_display();
+	lv_obj_t* label = lv_label_create(lv_scr_act(), NULL);
+	lv_label_set_text(label, a.c_str());
+
+	LabelCache cache(64 * 1024);
+	cache.attach(label);
+	lv_refr_now(NULL);
+	HOST_CHECK_EQUAL(1, cache.get_misses());
+
+	lv_label_set_text(label, b.c_str());
+	lv_refr_now(NULL);
+	HOST_CHECK_EQUAL(2, cache.get_misses());
+	HOST_CHECK_EQUAL(0, cache.get_hits());
+
+	std::vector<lv_color_t> cached(framebuffer, framebuffer + HOR_RES * VER_RES);
+	cache.detach(label);
+	lv_obj_invalidate(label);
+	lv_refr_now(NULL);
+	HOST_CHECK(max_channel_diff(cached.data(), framebuffer, HOR_RES * VER_RES) <= MAX_CHANNEL_DIFF);
+
+	lv_obj_del(label);
+}
+
+/** Draws the label with and without the cache, both frames must be the same */
+static void check_drawn_as_uncached(lv_obj_t* label)
+{
+	LabelCache cache(64 * 1024);
+	cache.attach(label);
+	lv_obj_invalidate(lv_scr_act());
+	lv_refr_now(NULL);
+	std::vector<lv_color_t> cached(framebuffer, framebuffer + HOR_RES * VER_RES);
+	HOST_CHECK_EQUAL(0, cache.get_misses() + cache.get_hits());
+
+	cache.detach(label);
+	lv_obj_invalidate(lv_scr_act());
+	lv_refr_now(NULL);
+	HOST_CHECK_EQUAL(0, max_channel_diff(cached.data(), framebuffer, HOR_RES * VER_RES));
+}
+
+/** Number of pixels of the label's area of the given color */
+static unsigned count_color(lv_obj_t* label, lv_color_t color)
+{
+	unsigned count = 0;
+	for(lv_coord_t y = label->coords.y1; y <= label->coords.y2; y++) {
+		for(lv_coord_t x = label->coords.x1; x <= label->coords.x2; x++) {
+			if(framebuffer[y * HOR_RES + x].full == color.full) {
+				count++;
+			}
+		}
+	}
+	return count;
+}
+
+static void test_recolored_label_keeps_its_colors(void)
+{
+	init_display();
+	lv_obj_t* label = lv_label_create(lv_scr_act(), NULL);
+	lv_label_set_recolor(label, true);
+	lv_label_set_text(label, "Status: #ff0000 FAULT# #00ff00 OK#");
+	lv_obj_set_pos(label, 10, 10);
+
+	check_drawn_as_uncached(label);
+	HOST_CHECK(count_color(label, LV_COLOR_RED) > 0);
+	HOST_CHECK(count_color(label, LV_COLOR_LIME) > 0);
+
+	lv_obj_del(label);
+}
+
+static void test_selected_label_keeps_its_selection(void)
+{
+	init_display();
+	lv_obj_t* label = lv_label_create(lv_scr_act(), NULL);
+	lv_label_set_text(label, "Selected text");
+	lv_label_set_text_sel_start(label, 0);
+	lv_label_set_text_sel_end(label, 8);
+	lv_obj_set_pos(label, 10, 10);
+
+	check_drawn_as_uncached(label);
+	HOST_CHECK(count_color(label, lv_obj_get_style(label)->text.sel_color) > 0);
+
+	lv_obj_del(label);
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = host_bench_quick(argc, argv);
+	int frames = quick ? 20 : 500;
+
+	HOST_TEST_RUN(test_colliding_text_is_rendered);
+	HOST_TEST_RUN(test_recolored_label_keeps_its_colors);
+	HOST_TEST_RUN(test_selected_label_keeps_its_selection);
+
+	printf("LabelCache: %d labels on a %dx%d screen, %u px strips, %d frames each\n",
+			LABEL_PAIRS * 2, HOR_RES, VER_RES, (unsigned) STRIP_PX, frames);
+	printf("%-8s %14s %14s %8s %8s %10s\n", "frame", "uncached (us)", "cached (us)", "hits", "misses",
+			"cache (B)");
+
+	// Uncached reference frames
+	init_display();
+	Dashboard dash;
+	build_dashboard(dash);
+	lv_refr_now(NULL);
+	double redraw_uncached = time_frames(redraw_frame, dash, frames);
+	std::vector<lv_color_t> reference(framebuffer, framebuffer + HOR_RES * VER_RES);
+	double update_uncached = time_frames(update_frame, dash, frames);
+
+	init_display();
+	build_dashboard(dash);
+	// Sized for every label: with a smaller budget a full redraw evicts
+	// least-recently-used bitmaps in drawing order and nothing ever hits
+	LabelCache cache(64 * 1024);
+	for(int i = 0; i < LABEL_PAIRS; i++) {
+		cache.attach(dash.captions[i]);
+		cache.attach(dash.values[i]);
+	}
+	lv_refr_now(NULL);
+
+	uint32_t hits = cache.get_hits();
+	uint32_t misses = cache.get_misses();
+	double redraw_cached = time_frames(redraw_frame, dash, frames);
+	printf("%-8s %14.1f %14.1f %8u %8u %10u\n", "redraw", redraw_uncached, redraw_cached,
+			(unsigned)(cache.get_hits() - hits), (unsigned)(cache.get_misses() - misses),
+			(unsigned) cache.get_used_bytes());
+
+	int diff = max_channel_diff(reference.data(), framebuffer, HOR_RES * VER_RES);
+	printf("largest channel difference to the uncached frame: %d\n", diff);
+	HOST_CHECK(diff <= MAX_CHANNEL_DIFF);
+	HOST_CHECK_EQUAL(0, cache.get_misses() - misses);
+
+	hits = cache.get_hits();
+	misses = cache.get_misses();
+	double update_cached = time_frames(update_frame, dash, frames);
+	printf("%-8s %14.1f %14.1f %8u %8u %10u\n", "update", update_uncached, update_cached,
+			(unsigned)(cache.get_hits() - hits), (unsigned)(cache.get_misses() - misses),
+			(unsigned) cache.get_used_bytes());
+
+	return host_test_result();
+}
@@ -0,0 +1,185 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * pixel_ops throughput against the scalar references
+ *
+ * Runs of 16 pixels (a glyph or widget edge) and 480 pixels (a display
+ * row) are processed repeatedly, in megapixels per second. The references
+ * are built with the same flags, so the compiler may auto-vectorize them:
+ * the ratio is what the hand-written kernels add over that. Results are
+ * checked against the references before timing.
+ *
+ * Usage: bench_pixel_ops [--quick]
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "host_test.h"
+#include "pixel_ops_reference.h"
+
+#include "platform/pixel_ops.h"
+
+static const uint32_t TOTAL_PX = 1u << 16;
+
+struct Buffers {
+	std::vector<lv_color_t> src;
+	std::vector<lv_color_t> dest;
+	std::vector<uint8_t> bytes;
+	std::vector<uint16_t> lut;
+
+	Buffers() : src(TOTAL_PX), dest(TOTAL_PX), bytes(TOTAL_PX * 2), lut(256) {
+		ref_random_pixels(src.data(), TOTAL_PX, 1);
+		ref_random_pixels(dest.data(), TOTAL_PX, 2);
+		for(uint32_t i = 0; i < TOTAL_PX; i++) {
+			bytes[i] = (uint8_t)(i * 37);
+		}
+		for(uint32_t i = 0; i < 256; i++) {
+			lut[i] = (uint16_t)(i * 0x0101u ^ 0x5A5Au);
+		}
+	}
+};
+
+typedef void (*kernel_t)(Buffers& b, uint32_t offset, uint32_t len);
+
+static void fill_kernel(Buffers& b, uint32_t offset, uint32_t len)
+{
+	mbed_lvgl_px_fill(&b.dest[offset], len, LV_COLOR_ORANGE);
+}
+
+static void fill_reference(Buffers& b, uint32_t offset, uint32_t len)
+{
+	ref_fill(&b.dest[offset], len, LV_COLOR_ORANGE);
+}
+
+static void blend_kernel(Buffers& b, uint32_t offset, uint32_t len)
+{
+	mbed_lvgl_px_blend(&b.dest[offset], &b.src[offset], len, LV_OPA_60);
+}
+
+static void blend_reference(Buffers& b, uint32_t offset, uint32_t len)
+{
+	ref_blend(&b.dest[offset], &b.src[offset], len, LV_OPA_60);
+}
+
+static void rgb565_kernel(Buffers& b, uint32_t offset, uint32_t len)
+{
+	mbed_lvgl_px_to_rgb565(&b.bytes[offset * 2], &b.src[offset], len, true);
+}
+
+static void rgb565_reference(Buffers& b, uint32_t offset, uint32_t len)
+{
+	uint8_t* d = &b.bytes[offset * 2];
+	for(uint32_t i = 0; i < len; i++) {
+		uint16_t v = ref_rgb565(b.src[offset + i]);
+		*d++ = v >> 8;
+		*d++ = v & 0xFF;
+	}
+}
+
+static void lut_kernel(Buffers& b, uint32_t offset, uint32_t len)
+{
+	mbed_lvgl_px_lut_expand16((uint16_t*) &b.dest[0] + offset, &b.bytes[offset], len, b.lut.data());
+}
+
+static void lut_reference(Buffers& b, uint32_t offset, uint32_t len)
+{
+	uint16_t* d = (uint16_t*) &b.dest[0] + offset;
+	for(uint32_t i = 0; i < len; i++) {
+		d[i] = b.lut[b.bytes[offset + i]];
+	}
+}
+
+/** Megapixels per second processing runs of len pixels over the buffers */
+static double rate(kernel_t kernel, Buffers& b, uint32_t len, int passes)
+{
+	uint64_t start = host_time_ns();
+	for(int pass = 0; pass < passes; pass++) {
+		for(uint32_t offset = 0; offset + len <= TOTAL_PX; offset += len) {
+			kernel(b, offset, len);
+		}
+	}
+	uint64_t elapsed_ns = host_time_ns() - start;
+	return (double)(TOTAL_PX / len) * len * passes / (elapsed_ns / 1e3);
+}
+
+static bool operator==(const lv_color_t& a, const lv_color_t& b)
+{
+	return a.full == b.full;
+}
+
+/** Whether the kernel and reference produce the same buffers */
+static bool matches(kernel_t kernel, kernel_t reference, uint32_t len)
+{
+	Buffers a, b;
+	for(uint32_t offset = 0; offset + len <= TOTAL_PX; offset += len) {
+		kernel(a, offset, len);
+		reference(b, offset, len);
+	}
+	return a.dest == b.dest && a.bytes == b.bytes;
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = host_bench_quick(argc, argv);
+	int passes = quick ? 5 : 500;
+
+#if defined(__AVX2__)
+	const char* isa = "AVX2";
+#elif defined(__SSE2__)
+	const char* isa = "SSE2";
+#elif defined(__ARM_NEON)
+	const char* isa = "NEON";
+#else
+	const char* isa = "C";
+#endif
+
+	struct {
+		const char* name;
+		kernel_t kernel;
+		kernel_t reference;
+	} ops[] = {
+		{ "fill", fill_kernel, fill_reference },
+		{ "blend", blend_kernel, blend_reference },
+		{ "rgb565", rgb565_kernel, rgb565_reference },
+		{ "lut", lut_kernel, lut_reference },
+	};
+	const uint32_t lens[] = { 16, 480 };
+
+	printf("pixel_ops at LV_COLOR_DEPTH %d, %s kernels, Mpx/s\n", LV_COLOR_DEPTH, isa);
+	printf("%-8s %5s %10s %10s %8s\n", "kernel", "run", "reference", "kernel", "ratio");
+
+	Buffers b;
+	int errors = 0;
+	for(size_t o = 0; o < sizeof(ops) / sizeof(ops[0]); o++) {
+		for(size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+			if(!matches(ops[o].kernel, ops[o].reference, lens[l])) {
+				printf("%-8s %5u does not match the reference\n", ops[o].name, (unsigned) lens[l]);
+				errors++;
+				continue;
+			}
+			double ref = rate(ops[o].reference, b, lens[l], passes);
+			double opt = rate(ops[o].kernel, b, lens[l], passes);
+			printf("%-8s %5u %10.0f %10.0f %7.2fx\n", ops[o].name, (unsigned) lens[l], ref, opt, opt / ref);
+		}
+	}
+
+	return errors == 0 ? 0 : 1;
+}
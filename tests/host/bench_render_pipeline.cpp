@@ -0,0 +1,197 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * LVGLRenderPipeline throughput versus the number of render workers
+ *
+ * Drives the pipeline the way LittlevGL's flush callback does: the main
+ * thread (lvgl) renders 480x32 strips of a 480x320 frame with the blend
+ * kernels (a number of translucent layers) and submits each one, workers prepare them (RGB565 conversion,
+ * plus optional extra passes modelling heavier processing like dithering)
+ * and flush them in order over a modelled bus, which sleeps for the time
+ * the strip's bytes take at the given bit rate (the CPU is free meanwhile,
+ * as with DMA). Each configuration is compared with flushing inline on the
+ * rendering thread (0 workers).
+ *
+ * Rasterization itself stays on one thread (lvgl v6 keeps its drawing
+ * state in globals), so workers only take preparation and bus time off it.
+ * Preparation only scales with more workers than cores can run if the
+ * host has them: the core count is printed with the results.
+ *
+ * Usage: bench_render_pipeline [--quick]
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "host_test.h"
+
+#include "LVGLDisplayDriver.h"
+#include "platform/pixel_ops.h"
+
+static const lv_coord_t HOR_RES = 480;
+static const lv_coord_t VER_RES = 320;
+static const lv_coord_t STRIP_H = 32;
+static const uint32_t STRIP_PX = (uint32_t) HOR_RES * STRIP_H;
+
+/** Converts strips to RGB565 and flushes them over a modelled bus */
+class BenchDriver : public LVGLDisplayDriver
+{
+	public:
+
+		BenchDriver(lv_color_t* buffer, double bus_mbps, int prepare_passes) :
+				LVGLDisplayDriver(mbed::Span<lv_color_t>(buffer, STRIP_PX)),
+				bus_mbps(bus_mbps), prepare_passes(prepare_passes),
+				next_y(0), flushes(0), order_errors(0) {
+			set_native_format(NATIVE_FORMAT_RGB565_SWAPPED);
+		}
+
+		virtual void prepare(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p) {
+			uint32_t px = lv_area_get_size(area);
+			for(int i = 0; i < prepare_passes; i++) {
+				mbed_lvgl_px_blend(color_p, color_p, px, LV_OPA_50);
+			}
+			LVGLDisplayDriver::prepare(disp_drv, area, color_p);
+		}
+
+		virtual void flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p) {
+			uint32_t bytes = get_native_size(NATIVE_FORMAT_RGB565_SWAPPED,
+					lv_area_get_width(area), lv_area_get_height(area));
+			std::chrono::steady_clock::time_point done = std::chrono::steady_clock::now() +
+					std::chrono::nanoseconds((int64_t)(bytes * 8 * 1000 / bus_mbps));
+
+			// Strips must reach the display in the order they were rendered
+			if(area->y1 != next_y) {
+				order_errors++;
+			}
+			next_y = (area->y2 + 1) % VER_RES;
+			flushes++;
+
+			std::this_thread::sleep_until(done);
+		}
+
+		double bus_mbps;
+		int prepare_passes;
+		lv_coord_t next_y;
+		uint32_t flushes;
+		uint32_t order_errors;
+};
+
+typedef struct {
+	const char* name;
+	double bus_mbps;
+	int render_passes;
+	int prepare_passes;
+} scenario_t;
+
+/** What lvgl does for a strip: a background then a few translucent layers */
+static void render_strip(lv_color_t* buf, const std::vector<lv_color_t>& layer, int strip, int passes)
+{
+	mbed_lvgl_px_fill(buf, STRIP_PX, LV_COLOR_MAKE(0x20, 0x40, (uint8_t)(strip * 16)));
+	for(int i = 0; i < passes; i++) {
+		mbed_lvgl_px_blend(buf, layer.data(), STRIP_PX, LV_OPA_30);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = host_bench_quick(argc, argv);
+	int frames = quick ? 4 : 60;
+	const int strips = VER_RES / STRIP_H;
+
+	std::vector<lv_color_t> layer(STRIP_PX);
+	for(uint32_t i = 0; i < STRIP_PX; i++) {
+		layer[i] = LV_COLOR_MAKE((uint8_t) i, (uint8_t)(i >> 3), (uint8_t)(i >> 6));
+	}
+
+	lv_disp_drv_t disp_drv;
+	lv_disp_drv_init(&disp_drv);
+
+	const scenario_t scenarios[] = {
+		{ "SPI at 40 MHz, 4 layers, conversion (bus bound)", 40, 4, 0 },
+		{ "16-bit 8080 at 20 MHz, 32 layers, conversion (render and bus balanced)", 320, 32, 0 },
+		{ "16-bit 8080 at 20 MHz, 4 layers, conversion + 16 passes (prepare bound)", 320, 4, 16 },
+	};
+	const size_t worker_counts[] = { 0, 1, 2, 4, 8 };
+
+	printf("LVGLRenderPipeline: %dx%d frames in %d strips of %d lines, %d frames, %u host cores\n",
+			HOR_RES, VER_RES, strips, STRIP_H, frames, std::thread::hardware_concurrency());
+
+	int errors = 0;
+	for(size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+		const scenario_t& scenario = scenarios[s];
+		printf("\n%s\n", scenario.name);
+		printf("%8s %8s %10s %8s %8s %12s %14s %10s\n", "workers", "buffers", "ms/frame", "fps",
+				"speedup", "stalls/frm", "stall ms/frm", "max queue");
+
+		double inline_ms = 0;
+		for(size_t w = 0; w < sizeof(worker_counts) / sizeof(worker_counts[0]); w++) {
+			std::vector<lv_color_t> primary(STRIP_PX);
+			BenchDriver driver(primary.data(), scenario.bus_mbps, scenario.prepare_passes);
+			driver.set_render_workers(worker_counts[w]);
+			driver.create_pipeline();
+			LVGLRenderPipeline* pipeline = driver.get_pipeline();
+
+			lv_color_t* buf = primary.data();
+			uint64_t start = host_time_ns();
+			for(int f = 0; f < frames; f++) {
+				for(int i = 0; i < strips; i++) {
+					lv_area_t area;
+					lv_area_set(&area, 0, i * STRIP_H, HOR_RES - 1, (i + 1) * STRIP_H - 1);
+					render_strip(buf, layer, i, scenario.render_passes);
+					if(pipeline != NULL) {
+						buf = pipeline->submit(&disp_drv, &area, buf);
+					} else {
+						driver.prepare(&disp_drv, &area, buf);
+						driver.flush(&disp_drv, &area, buf);
+					}
+				}
+			}
+			if(pipeline != NULL) {
+				pipeline->sync();
+			}
+			double ms = (host_time_ns() - start) / 1e6 / frames;
+
+			LVGLRenderPipeline::stats_t stats;
+			memset(&stats, 0, sizeof(stats));
+			stats.buffer_count = 1;
+			if(pipeline != NULL) {
+				pipeline->get_stats(stats);
+			}
+			if(worker_counts[w] == 0) {
+				inline_ms = ms;
+			}
+
+			printf("%8zu %8zu %10.2f %8.1f %8.2f %12.2f %14.2f %10zu\n", worker_counts[w],
+					stats.buffer_count, ms, 1000 / ms, inline_ms / ms,
+					(double) stats.stalls / frames, stats.stall_time_us / 1000.0 / frames,
+					stats.max_queue_depth);
+
+			if(driver.flushes != (uint32_t)(frames * strips) || driver.order_errors != 0) {
+				printf("  %u strips flushed of %d, %u out of order\n", driver.flushes,
+						frames * strips, driver.order_errors);
+				errors++;
+			}
+		}
+	}
+
+	return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * RLEImageDecoder decode throughput
+ *
+ * Three 480x320 images of different compressibility (a flat UI screen, a
+ * horizontal gradient and noise) are decoded row by row through lvgl's
+ * decoder interface, from a variable source and from a file, as full rows
+ * (decoded straight into the caller's buffer) and as segments (decoded
+ * once into the row buffer, then copied). The copy of uncompressed rows,
+ * which is what a true color image costs, is the reference.
+ *
+ * Usage: bench_rle_decoder [--quick]
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "host_test.h"
+#include "rle_test_image.h"
+
+#include "lv_fs.h"
+#include "lv_img_decoder.h"
+#include "platform/filesystem_wrapper.h"
+#include "decoders/RLEImageDecoder.h"
+
+static const char* IMAGE_FILE = "bench_rle_decoder.rle";
+static const uint16_t W = 480;
+static const uint16_t H = 320;
+
+/** Segments read by lvgl when the image is partially masked */
+static const lv_coord_t SEGMENT_X = 40;
+static const lv_coord_t SEGMENT_LEN = 200;
+
+static std::vector<lv_color_t> make_ui(void)
+{
+	std::vector<lv_color_t> px((size_t) W * H, LV_COLOR_MAKE(0x20, 0x28, 0x30));
+	for(uint16_t y = 0; y < H; y++) {
+		for(uint16_t x = 0; x < W; x++) {
+			lv_color_t& p = px[(size_t) y * W + x];
+			if(y < 40) {
+				p = LV_COLOR_MAKE(0x30, 0x60, 0xA0);
+			} else if((x / 120) % 2 == (y / 70) % 2 && x % 120 > 8 && y % 70 > 8) {
+				p = LV_COLOR_MAKE(0xE0, 0xE0, 0xE0);
+			}
+			// Text-like marks inside the panels
+			if(x % 120 > 16 && x % 120 < 100 && y % 70 > 20 && y % 70 < 32 && ((x * 7 + y * 3) % 5) == 0) {
+				p = LV_COLOR_BLACK;
+			}
+		}
+	}
+	return px;
+}
+
+static std::vector<lv_color_t> make_gradient(void)
+{
+	std::vector<lv_color_t> px((size_t) W * H);
+	for(uint16_t y = 0; y < H; y++) {
+		for(uint16_t x = 0; x < W; x++) {
+			px[(size_t) y * W + x] = LV_COLOR_MAKE(x * 255 / W, y * 255 / H, 0x80);
+		}
+	}
+	return px;
+}
+
+static std::vector<lv_color_t> make_noise(void)
+{
+	std::vector<lv_color_t> px((size_t) W * H);
+	uint32_t seed = 1;
+	for(size_t i = 0; i < px.size(); i++) {
+		seed = seed * 1103515245u + 12345u;
+		px[i] = LV_COLOR_MAKE(seed >> 24, seed >> 16, seed >> 8);
+	}
+	return px;
+}
+
+/** Pixels per second decoding every row of src, or 0 if decoding failed */
+static double decode_rate(const void* src, const std::vector<lv_color_t>& ref, bool segments, int passes)
+{
+	std::vector<lv_color_t> row(W);
+	lv_coord_t x = segments ? SEGMENT_X : 0;
+	lv_coord_t len = segments ? SEGMENT_LEN : W;
+
+	lv_img_decoder_dsc_t dsc;
+	if(lv_img_decoder_open(&dsc, src, &lv_style_plain) != LV_RES_OK) {
+		return 0;
+	}
+
+	bool ok = true;
+	uint64_t start = host_time_ns();
+	for(int pass = 0; pass < passes; pass++) {
+		for(lv_coord_t y = 0; y < H; y++) {
+			if(segments) {
+				// lvgl reads a row once per masked segment, the row buffer serves the second read
+				ok &= lv_img_decoder_read_line(&dsc, x, y, len / 2, (uint8_t*) row.data()) == LV_RES_OK;
+				ok &= lv_img_decoder_read_line(&dsc, x + len / 2, y, len / 2,
+						(uint8_t*) &row[len / 2]) == LV_RES_OK;
+			} else {
+				ok &= lv_img_decoder_read_line(&dsc, x, y, len, (uint8_t*) row.data()) == LV_RES_OK;
+			}
+		}
+	}
+	uint64_t elapsed_ns = host_time_ns() - start;
+
+	// The last row decoded must match
+	ok &= memcmp(row.data(), &ref[(size_t)(H - 1) * W + x], len * sizeof(lv_color_t)) == 0;
+	lv_img_decoder_close(&dsc);
+
+	return ok ? (double) len * H * passes / (elapsed_ns / 1e9) : 0;
+}
+
+static double copy_rate(const std::vector<lv_color_t>& ref, int passes)
+{
+	std::vector<lv_color_t> row(W);
+	uint32_t checksum = 0;
+	uint64_t start = host_time_ns();
+	for(int pass = 0; pass < passes; pass++) {
+		for(lv_coord_t y = 0; y < H; y++) {
+			memcpy(row.data(), &ref[(size_t) y * W], W * sizeof(lv_color_t));
+			checksum += row[y % W].full;
+		}
+	}
+	uint64_t elapsed_ns = host_time_ns() - start;
+	volatile uint32_t sink = checksum;
+	(void) sink;
+	return (double) W * H * passes / (elapsed_ns / 1e9);
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = host_bench_quick(argc, argv);
+	int passes = quick ? 2 : 50;
+
+	lv_init();
+	RLEImageDecoder::register_decoder();
+
+	lv_fs_drv_t drv;
+	lv_fs_drv_init(&drv);
+	mbed_lvgl_fs_wrapper_default(&drv);
+	drv.letter = 'M';
+	lv_fs_drv_register(&drv);
+
+	char path[64];
+	snprintf(path, sizeof(path), "M:/%s", IMAGE_FILE);
+
+	printf("RLEImageDecoder: %ux%u images at %d bpp, %d passes, Mpx/s\n", W, H, LV_COLOR_DEPTH, passes);
+	printf("%-9s %7s %9s %9s %9s %9s %9s\n", "image", "ratio", "raw copy", "var rows", "var segs",
+			"file rows", "file segs");
+
+	struct {
+		const char* name;
+		std::vector<lv_color_t> (*make)(void);
+	} images[] = {
+		{ "ui", make_ui },
+		{ "gradient", make_gradient },
+		{ "noise", make_noise },
+	};
+
+	int errors = 0;
+	for(size_t i = 0; i < sizeof(images) / sizeof(images[0]); i++) {
+		std::vector<lv_color_t> px = images[i].make();
+		std::vector<uint8_t> data = rle_encode(px, W, H);
+		lv_img_dsc_t src = rle_variable_src(data);
+		if(!rle_write_file(IMAGE_FILE, data)) {
+			printf("cannot write %s\n", IMAGE_FILE);
+			return 1;
+		}
+
+		double rates[] = {
+			copy_rate(px, passes),
+			decode_rate(&src, px, false, passes),
+			decode_rate(&src, px, true, passes),
+			decode_rate(path, px, false, passes),
+			decode_rate(path, px, true, passes),
+		};
+		for(size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+			errors += (rates[r] == 0);
+		}
+
+		printf("%-9s %6.1f%% %9.1f %9.1f %9.1f %9.1f %9.1f\n", images[i].name,
+				100.0 * data.size() / (px.size() * sizeof(lv_color_t)),
+				rates[0] / 1e6, rates[1] / 1e6, rates[2] / 1e6, rates[3] / 1e6, rates[4] / 1e6);
+	}
+
+	remove(IMAGE_FILE);
+
+	if(errors != 0) {
+		printf("%d runs did not decode correctly\n", errors);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,247 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * StaticLayer on a gauge-over-gradient dashboard
+ *
+ * A gradient-filled, bordered panel holds a gauge: 60 blended tick marks
+ * and 12 scale labels that never change, a needle tip that moves every
+ * frame and a value label that is updated every frame. Two frame types
+ * are timed with and without a StaticLayer caching the panel and scale:
+ *  - needle: the needle moves and the value changes, only their areas
+ *    are redrawn
+ *  - redraw: the whole panel is invalidated (what an animation over it,
+ *    or a screen reload, costs)
+ * The frames drawn through the layer must be identical to the uncached
+ * ones, and the layer must only be rendered once.
+ *
+ * Usage: bench_static_layer [--quick]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "host_test.h"
+
+#include "lv_obj.h"
+#include "lv_label.h"
+#include "lv_hal_disp.h"
+#include "lv_refr.h"
+#include "widgets/StaticLayer.h"
+
+static const lv_coord_t HOR_RES = LV_HOR_RES_MAX;
+static const lv_coord_t VER_RES = LV_VER_RES_MAX;
+static const uint32_t STRIP_PX = LV_HOR_RES_MAX * 32;
+static const lv_coord_t PANEL_SIZE = 300;
+static const int TICKS = 60;
+static const int SCALE_LABELS = 12;
+static const lv_coord_t NEEDLE_SIZE = 12;
+
+static lv_color_t framebuffer[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+static lv_color_t strip[STRIP_PX];
+
+static void flush(lv_disp_drv_t* drv, const lv_area_t* area, lv_color_t* color_p)
+{
+	for(lv_coord_t y = area->y1; y <= area->y2; y++) {
+		lv_coord_t w = lv_area_get_width(area);
+		memcpy(&framebuffer[y * HOR_RES + area->x1], color_p, w * sizeof(lv_color_t));
+		color_p += w;
+	}
+	lv_disp_flush_ready(drv);
+}
+
+struct Dashboard {
+	lv_obj_t* panel;
+	lv_obj_t* ticks[TICKS];
+	lv_obj_t* scale[SCALE_LABELS];
+	lv_obj_t* needle;
+	lv_obj_t* value;
+	uint32_t frame;
+};
+
+static lv_style_t panel_style;
+static lv_style_t tick_style;
+static lv_style_t needle_style;
+
+static void init_display(void)
+{
+	static lv_disp_buf_t disp_buf;
+
+	lv_init();
+	lv_disp_buf_init(&disp_buf, strip, NULL, STRIP_PX);
+	lv_disp_drv_t drv;
+	lv_disp_drv_init(&drv);
+	drv.buffer = &disp_buf;
+	drv.flush_cb = flush;
+	lv_disp_drv_register(&drv);
+
+	lv_style_copy(&panel_style, &lv_style_pretty_color);
+	panel_style.body.main_color = lv_color_hex(0x102040);
+	panel_style.body.grad_color = lv_color_hex(0x3060a0);
+	panel_style.body.border.width = 4;
+
+	lv_style_copy(&tick_style, &lv_style_plain_color);
+	tick_style.body.main_color = LV_COLOR_WHITE;
+	tick_style.body.grad_color = LV_COLOR_WHITE;
+	tick_style.body.opa = LV_OPA_80;
+
+	lv_style_copy(&needle_style, &lv_style_plain_color);
+	needle_style.body.main_color = LV_COLOR_RED;
+	needle_style.body.grad_color = LV_COLOR_RED;
+}
+
+/** Top left corner of an object of the given size centered at angle a on a circle of radius r around the panel's center */
+static void place_on_circle(lv_obj_t* obj, double a, double r, lv_coord_t w, lv_coord_t h)
+{
+	lv_coord_t cx = PANEL_SIZE / 2 + (lv_coord_t) lround(cos(a) * r);
+	lv_coord_t cy = PANEL_SIZE / 2 + (lv_coord_t) lround(sin(a) * r);
+	lv_obj_set_pos(obj, cx - w / 2, cy - h / 2);
+}
+
+/** The gauge sweeps 270 degrees, from the bottom left to the bottom right */
+static double gauge_angle(double fraction)
+{
+	return (135.0 + 270.0 * fraction) * M_PI / 180.0;
+}
+
+static void set_needle(Dashboard& dash)
+{
+	uint32_t position = dash.frame % 200;
+	double fraction = ((position < 100) ? position : 200 - position) / 100.0;
+	place_on_circle(dash.needle, gauge_angle(fraction), 95, NEEDLE_SIZE, NEEDLE_SIZE);
+
+	char text[16];
+	snprintf(text, sizeof(text), "%3u km/h", (unsigned)(fraction * 220));
+	lv_label_set_text(dash.value, text);
+}
+
+static void build_dashboard(Dashboard& dash)
+{
+	dash.frame = 0;
+	dash.panel = lv_obj_create(lv_scr_act(), NULL);
+	lv_obj_set_style(dash.panel, &panel_style);
+	lv_obj_set_size(dash.panel, PANEL_SIZE, PANEL_SIZE);
+	lv_obj_set_pos(dash.panel, (HOR_RES - PANEL_SIZE) / 2, (VER_RES - PANEL_SIZE) / 2);
+
+	for(int i = 0; i < TICKS; i++) {
+		bool major = (i % 5) == 0;
+		lv_coord_t size = major ? 8 : 4;
+		dash.ticks[i] = lv_obj_create(dash.panel, NULL);
+		lv_obj_set_style(dash.ticks[i], &tick_style);
+		lv_obj_set_size(dash.ticks[i], size, size);
+		place_on_circle(dash.ticks[i], gauge_angle((double) i / (TICKS - 1)), 135, size, size);
+	}
+
+	for(int i = 0; i < SCALE_LABELS; i++) {
+		char text[8];
+		snprintf(text, sizeof(text), "%d", i * 20);
+		dash.scale[i] = lv_label_create(dash.panel, NULL);
+		lv_label_set_text(dash.scale[i], text);
+		place_on_circle(dash.scale[i], gauge_angle((double) i / (SCALE_LABELS - 1)), 112,
+				lv_obj_get_width(dash.scale[i]), lv_obj_get_height(dash.scale[i]));
+	}
+
+	dash.needle = lv_obj_create(dash.panel, NULL);
+	lv_obj_set_style(dash.needle, &needle_style);
+	lv_obj_set_size(dash.needle, NEEDLE_SIZE, NEEDLE_SIZE);
+
+	dash.value = lv_label_create(dash.panel, NULL);
+	lv_obj_set_pos(dash.value, PANEL_SIZE / 2 - 36, PANEL_SIZE / 2 - 8);
+	set_needle(dash);
+}
+
+static StaticLayer* attach_layer(Dashboard& dash)
+{
+	StaticLayer* layer = new StaticLayer(dash.panel);
+	for(int i = 0; i < TICKS; i++) {
+		layer->add_static(dash.ticks[i]);
+	}
+	for(int i = 0; i < SCALE_LABELS; i++) {
+		layer->add_static(dash.scale[i]);
+	}
+	return layer;
+}
+
+static void needle_frame(Dashboard& dash)
+{
+	dash.frame++;
+	set_needle(dash);
+	lv_refr_now(NULL);
+}
+
+static void redraw_frame(Dashboard& dash)
+{
+	lv_obj_invalidate(dash.panel);
+	lv_refr_now(NULL);
+}
+
+static double time_frames(void (*frame)(Dashboard&), Dashboard& dash, int count)
+{
+	uint64_t start = host_time_ns();
+	for(int i = 0; i < count; i++) {
+		frame(dash);
+	}
+	return (host_time_ns() - start) / 1e3 / count;
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = host_bench_quick(argc, argv);
+	int frames = quick ? 20 : 1000;
+
+	printf("StaticLayer: %dx%d gradient panel, %d ticks and %d labels static, %d frames each\n",
+			PANEL_SIZE, PANEL_SIZE, TICKS, SCALE_LABELS, frames);
+	printf("%-8s %14s %14s %9s %8s %8s\n", "frame", "uncached (us)", "layer (us)", "speedup", "renders", "hits");
+
+	// Uncached reference frames, the needle frames end where they started
+	// so both runs finish on the same frame
+	init_display();
+	Dashboard dash;
+	build_dashboard(dash);
+	lv_refr_now(NULL);
+	double needle_uncached = time_frames(needle_frame, dash, frames);
+	double redraw_uncached = time_frames(redraw_frame, dash, frames);
+	std::vector<lv_color_t> reference(framebuffer, framebuffer + HOR_RES * VER_RES);
+
+	init_display();
+	build_dashboard(dash);
+	StaticLayer* layer = attach_layer(dash);
+	lv_refr_now(NULL);
+	HOST_CHECK_EQUAL(1, layer->get_renders());
+
+	uint32_t hits = layer->get_hits();
+	double needle_layer = time_frames(needle_frame, dash, frames);
+	printf("%-8s %14.1f %14.1f %8.2fx %8u %8u\n", "needle", needle_uncached, needle_layer,
+			needle_uncached / needle_layer, (unsigned)(layer->get_renders() - 1),
+			(unsigned)(layer->get_hits() - hits));
+
+	hits = layer->get_hits();
+	double redraw_layer = time_frames(redraw_frame, dash, frames);
+	printf("%-8s %14.1f %14.1f %8.2fx %8u %8u\n", "redraw", redraw_uncached, redraw_layer,
+			redraw_uncached / redraw_layer, (unsigned)(layer->get_renders() - 1),
+			(unsigned)(layer->get_hits() - hits));
+
+	HOST_CHECK_EQUAL(1, layer->get_renders());
+	HOST_CHECK_EQUAL(0, layer->get_fallbacks());
+	HOST_CHECK(memcmp(reference.data(), framebuffer, reference.size() * sizeof(lv_color_t)) == 0);
+
+	delete layer;
+	return host_test_result();
+}
@@ -0,0 +1,216 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * StreamChart at 10k samples/s
+ *
+ * Producer threads push a two-series signal into a chart while the GUI
+ * thread runs LittlevGL's update loop (ticked by its Ticker), the way an
+ * application does. Producers push in 1ms bursts, like a sampling timer
+ * or DMA interrupt would. Scenarios:
+ *  - one producer at 10k samples/s
+ *  - four producers sharing 10k samples/s
+ *  - four producers at 10k samples/s each, more than the ring buffer
+ *    holds between frames, so samples are dropped
+ * For each one, every sample pushed must be either drawn or counted as
+ * dropped by the chart, and the drops must match the pushes producers saw
+ * fail. Whether the first two drop depends on the GUI thread keeping up
+ * with the refresh period on the host, so it is reported, not checked. The time the GUI thread spends draining and drawing per frame is
+ * measured around the chart's frame hook.
+ *
+ * Usage: bench_stream_chart [--quick]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "host_test.h"
+
+#include "LittlevGL.h"
+#include "widgets/StreamChart.h"
+
+static const lv_coord_t HOR_RES = LV_HOR_RES_MAX;
+static const lv_coord_t VER_RES = LV_VER_RES_MAX;
+static const uint32_t STRIP_PX = LV_HOR_RES_MAX * 32;
+static const lv_coord_t CHART_W = 400;
+static const lv_coord_t CHART_H = 200;
+
+static lv_color_t strip[STRIP_PX];
+
+/** Discards the frames, the chart's cost is what is measured */
+class NullDriver : public LVGLDisplayDriver
+{
+	public:
+
+		NullDriver() : LVGLDisplayDriver(mbed::Span<lv_color_t>(strip, STRIP_PX)) { }
+
+		virtual void flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p) { }
+};
+
+/** Times the chart's work in the frame hook */
+class TimedChart : public StreamChart
+{
+	public:
+
+		TimedChart(lv_obj_t* parent) : StreamChart(parent, CHART_W, CHART_H),
+				frames(0), total_ns(0), max_ns(0) { }
+
+		virtual void before_refresh(lv_disp_t* disp) {
+			uint64_t start = host_time_ns();
+			StreamChart::before_refresh(disp);
+			uint64_t elapsed = host_time_ns() - start;
+			frames++;
+			total_ns += elapsed;
+			if(elapsed > max_ns) {
+				max_ns = elapsed;
+			}
+		}
+
+		uint32_t frames;
+		uint64_t total_ns;
+		uint64_t max_ns;
+};
+
+typedef struct {
+	const char* name;
+	int producers;
+	uint32_t rate;		/** Samples/s per producer */
+	bool drops;			/** The ring overflows between frames */
+} scenario_t;
+
+/** Pushes rate samples/s in 1ms bursts until told to stop */
+static void produce(StreamChart* chart, uint32_t rate, int phase, std::atomic<bool>* stop,
+		std::atomic<uint32_t>* accepted, std::atomic<uint32_t>* rejected)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::time_point next = start;
+	uint64_t pushed = 0;
+	while(!*stop) {
+		next += std::chrono::milliseconds(1);
+		std::this_thread::sleep_until(next);
+
+		uint64_t due = (uint64_t) rate * std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - start).count() / 1000000;
+		for(; pushed < due; pushed++) {
+			double t = (double) pushed / rate;
+			int32_t values[2] = {
+				50 + (int32_t)(40 * sin(2 * M_PI * 50 * t + phase)),
+				50 + (int32_t)(20 * sin(2 * M_PI * 7 * t)) + (int32_t)(pushed % 7) - 3,
+			};
+			if(chart->push(values)) {
+				(*accepted)++;
+			} else {
+				(*rejected)++;
+			}
+		}
+	}
+}
+
+/** Runs the GUI loop until the frame hook ran frames more times */
+static void run_frames(LittlevGL& lvgl, TimedChart& chart, uint32_t frames)
+{
+	uint32_t target = chart.frames + frames;
+	while(chart.frames < target) {
+		lvgl.update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = host_bench_quick(argc, argv);
+	uint32_t duration_ms = quick ? 300 : 5000;
+
+	LittlevGL& lvgl = LittlevGL::get_instance();
+	lvgl.init();
+	NullDriver driver;
+	lvgl.add_display_driver(driver);
+	lvgl.set_default_display(driver);
+	lvgl.start();
+
+	const scenario_t scenarios[] = {
+		{ "1 producer, 10k samples/s", 1, 10000, false },
+		{ "4 producers, 10k samples/s in all", 4, 2500, false },
+		{ "4 producers, 40k samples/s in all (overflows)", 4, 10000, true },
+	};
+
+	printf("StreamChart: %dx%d, 2 series, %u-sample ring, %u ms refresh period, %u ms per scenario\n",
+			CHART_W, CHART_H, (unsigned) MBED_CONF_MBED_LVGL_STREAM_CHART_RING_SIZE,
+			(unsigned) LV_DISP_DEF_REFR_PERIOD, (unsigned) duration_ms);
+	printf("%-46s %9s %9s %9s %8s %9s %9s\n", "scenario", "pushed", "dropped", "drawn", "backlog",
+			"avg (us)", "max (us)");
+
+	for(size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+		const scenario_t& scenario = scenarios[s];
+
+		TimedChart chart(lv_scr_act());
+		chart.add_series(LV_COLOR_YELLOW);
+		chart.add_series(LV_COLOR_CYAN);
+		lv_obj_set_pos(chart.get_canvas(), (HOR_RES - CHART_W) / 2, (VER_RES - CHART_H) / 2);
+		// Keep about a second of samples on screen
+		chart.set_samples_per_column(scenario.producers * scenario.rate / CHART_W);
+		run_frames(lvgl, chart, 2);
+
+		std::atomic<bool> stop(false);
+		std::atomic<uint32_t> accepted(0);
+		std::atomic<uint32_t> rejected(0);
+		std::vector<std::thread> producers;
+		for(int p = 0; p < scenario.producers; p++) {
+			producers.push_back(std::thread(produce, &chart, scenario.rate, p, &stop, &accepted, &rejected));
+		}
+
+		uint32_t frames = chart.frames;
+		uint64_t total_ns = chart.total_ns;
+		chart.max_ns = 0;
+		uint64_t end = host_time_ns() + (uint64_t) duration_ms * 1000000;
+		while(host_time_ns() < end) {
+			lvgl.update();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		stop = true;
+		for(size_t p = 0; p < producers.size(); p++) {
+			producers[p].join();
+		}
+		frames = chart.frames - frames;
+		total_ns = chart.total_ns - total_ns;
+
+		// Drain what was pushed since the last frame
+		run_frames(lvgl, chart, 1);
+
+		const StreamChart::stats_t& stats = chart.get_stats();
+		printf("%-46s %9u %9u %9u %8u %9.1f %9.1f\n", scenario.name,
+				(unsigned)(accepted + rejected), (unsigned) stats.dropped, (unsigned) stats.samples,
+				(unsigned) stats.max_backlog, frames ? total_ns / 1e3 / frames : 0.0, chart.max_ns / 1e3);
+
+		// Every sample is accounted for
+		HOST_CHECK_EQUAL(accepted.load(), stats.samples);
+		HOST_CHECK_EQUAL(rejected.load(), stats.dropped);
+		HOST_CHECK(stats.max_backlog <= MBED_CONF_MBED_LVGL_STREAM_CHART_RING_SIZE);
+		if(scenario.drops) {
+			HOST_CHECK(stats.dropped > 0);
+		}
+	}
+
+	lvgl.stop();
+	return host_test_result();
+}
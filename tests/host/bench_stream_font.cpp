@@ -0,0 +1,245 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * StreamFont text throughput versus glyph cache size
+ *
+ * Generates a 3000 glyph CJK-like font (24x24, 4bpp) plus ASCII, then
+ * draws text whose characters follow a Zipf distribution (like real text)
+ * through the font API the way a label does, for several cache sizes.
+ * The font is read through the 'M' filesystem wrapper driver, whose reads
+ * are counted: on a target each one is a storage access, so the table also
+ * gives the throughput with a modelled cost per read (--read-us, default
+ * that of a random read from an SD card over SPI).
+ *
+ * Usage: bench_stream_font [--quick] [--read-us <us>]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "host_test.h"
+
+#include "lv_fs.h"
+#include "platform/filesystem_wrapper.h"
+#include "fonts/StreamFont.h"
+
+static const char* FONT_FILE = "bench_stream_font.lvsf";
+
+static const uint32_t CJK_FIRST = 0x4E00;
+static const uint32_t CJK_COUNT = 3000;
+static const uint32_t ASCII_FIRST = 0x20;
+static const uint32_t ASCII_COUNT = 95;
+static const uint8_t GLYPH_W = 24;
+static const uint8_t GLYPH_H = 24;
+static const uint8_t BPP = 4;
+static const uint32_t BITMAP_SIZE = (GLYPH_W * GLYPH_H * BPP + 7) / 8;
+
+static void put_u16(std::vector<uint8_t>& out, uint16_t v)
+{
+	out.push_back(v & 0xFF);
+	out.push_back(v >> 8);
+}
+
+static void put_u32(std::vector<uint8_t>& out, uint32_t v)
+{
+	put_u16(out, v & 0xFFFF);
+	put_u16(out, v >> 16);
+}
+
+/** First byte of each bitmap identifies its glyph */
+static uint8_t glyph_tag(uint32_t letter)
+{
+	return (uint8_t)(letter * 31 + 7);
+}
+
+static bool write_font(void)
+{
+	const uint32_t glyph_count = ASCII_COUNT + CJK_COUNT;
+	const uint32_t range_count = 2;
+	const uint32_t glyph_table_offset = 32 + range_count * 12;
+	const uint32_t bitmaps_offset = glyph_table_offset + glyph_count * 12;
+
+	std::vector<uint8_t> out;
+	out.insert(out.end(), { 'L', 'V', 'S', 'F' });
+	put_u16(out, 1);
+	out.push_back(BPP);
+	out.push_back(0);
+	put_u16(out, GLYPH_H + 2);
+	put_u16(out, 2);
+	put_u32(out, range_count);
+	put_u32(out, glyph_count);
+	put_u32(out, glyph_table_offset);
+	put_u32(out, BITMAP_SIZE);
+	put_u32(out, 0);
+
+	put_u32(out, ASCII_FIRST);
+	put_u16(out, ASCII_COUNT);
+	put_u16(out, 0);
+	put_u32(out, 0);
+	put_u32(out, CJK_FIRST);
+	put_u16(out, CJK_COUNT);
+	put_u16(out, 0);
+	put_u32(out, ASCII_COUNT);
+
+	for(uint32_t i = 0; i < glyph_count; i++) {
+		put_u32(out, bitmaps_offset + i * BITMAP_SIZE);
+		put_u16(out, (GLYPH_W + 1) * 16);
+		out.push_back(GLYPH_W);
+		out.push_back(GLYPH_H);
+		out.push_back(0);
+		out.push_back(0);
+		put_u16(out, 0);
+	}
+
+	for(uint32_t i = 0; i < glyph_count; i++) {
+		uint32_t letter = (i < ASCII_COUNT) ? (ASCII_FIRST + i) : (CJK_FIRST + i - ASCII_COUNT);
+		out.push_back(glyph_tag(letter));
+		for(uint32_t j = 1; j < BITMAP_SIZE; j++) {
+			out.push_back((uint8_t)(i + j));
+		}
+	}
+
+	FILE* f = fopen(FONT_FILE, "wb");
+	if(f == NULL) {
+		return false;
+	}
+	bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+	return (fclose(f) == 0) && ok;
+}
+
+/** Storage accesses made through the wrapper driver */
+static uint32_t storage_reads;
+
+static lv_fs_res_t counting_read(lv_fs_drv_t* drv, void* file_p, void* buf, uint32_t btr, uint32_t* br)
+{
+	storage_reads++;
+	return lv_fs_wrapper_read(drv, file_p, buf, btr, br);
+}
+
+/** Text of n characters: 1 in 8 is ASCII, the rest CJK following Zipf's law */
+static std::vector<uint32_t> make_text(size_t n)
+{
+	std::vector<double> cumulative(CJK_COUNT);
+	double sum = 0;
+	for(uint32_t rank = 0; rank < CJK_COUNT; rank++) {
+		sum += 1.0 / (rank + 1);
+		cumulative[rank] = sum;
+	}
+
+	std::vector<uint32_t> text(n);
+	uint32_t seed = 12345;
+	for(size_t i = 0; i < n; i++) {
+		seed = seed * 1103515245u + 12345u;
+		uint32_t r = seed >> 8;
+		if((r & 7) == 0) {
+			text[i] = ASCII_FIRST + (r >> 3) % ASCII_COUNT;
+			continue;
+		}
+		double u = ((r >> 3) / (double)(1u << 21)) * sum;
+		uint32_t rank = (uint32_t)(std::lower_bound(cumulative.begin(), cumulative.end(), u) - cumulative.begin());
+		text[i] = CJK_FIRST + ((rank >= CJK_COUNT) ? CJK_COUNT - 1 : rank);
+	}
+	return text;
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = host_bench_quick(argc, argv);
+	double read_us = 250;
+	for(int i = 1; i < argc - 1; i++) {
+		if(strcmp(argv[i], "--read-us") == 0) {
+			read_us = atof(argv[i + 1]);
+		}
+	}
+
+	if(!write_font()) {
+		printf("cannot write %s\n", FONT_FILE);
+		return 1;
+	}
+
+	lv_fs_drv_t drv;
+	lv_fs_drv_init(&drv);
+	mbed_lvgl_fs_wrapper_default(&drv);
+	drv.letter = 'M';
+	drv.read_cb = counting_read;
+	lv_fs_drv_register(&drv);
+
+	std::vector<uint32_t> text = make_text(quick ? 20000 : 400000);
+
+	printf("StreamFont: %u glyphs of %ux%u at %u bpp, %zu characters of Zipf-distributed text\n",
+			(unsigned)(CJK_COUNT + ASCII_COUNT), GLYPH_W, GLYPH_H, BPP, text.size());
+	printf("%6s %10s %10s %10s %12s %14s\n", "slots", "pool (B)", "misses/chr", "reads/chr",
+			"host chr/s", "chr/s @read-us");
+
+	const size_t slot_counts[] = { 8, 16, 32, 64, 128, 256, 512 };
+	int errors = 0;
+	for(size_t s = 0; s < sizeof(slot_counts) / sizeof(slot_counts[0]); s++) {
+		StreamFont font(slot_counts[s], BITMAP_SIZE);
+		char path[64];
+		snprintf(path, sizeof(path), "M:/%s", FONT_FILE);
+		if(!font.open(path)) {
+			printf("cannot open %s\n", path);
+			return 1;
+		}
+		const lv_font_t* lv_font = font.get_lv_font();
+
+		storage_reads = 0;
+		uint32_t checksum = 0;
+		uint64_t start = host_time_ns();
+		for(size_t i = 0; i < text.size(); i++) {
+			// What a label does for each letter
+			lv_font_glyph_dsc_t dsc;
+			uint32_t next = (i + 1 < text.size()) ? text[i + 1] : 0;
+			if(!lv_font_get_glyph_dsc(lv_font, &dsc, text[i], next)) {
+				errors++;
+				continue;
+			}
+			const uint8_t* bitmap = lv_font_get_glyph_bitmap(lv_font, text[i]);
+			if(bitmap == NULL || bitmap[0] != glyph_tag(text[i])) {
+				errors++;
+				continue;
+			}
+			for(uint32_t j = 0; j < BITMAP_SIZE; j++) {
+				checksum += bitmap[j];
+			}
+		}
+		uint64_t elapsed_ns = host_time_ns() - start;
+
+		double host_s = elapsed_ns / 1e9;
+		double modelled_s = host_s + storage_reads * read_us / 1e6;
+		printf("%6zu %10zu %10.3f %10.3f %12.0f %14.0f\n", slot_counts[s],
+				slot_counts[s] * BITMAP_SIZE,
+				(double) font.get_cache_misses() / text.size(),
+				(double) storage_reads / text.size(),
+				text.size() / host_s, text.size() / modelled_s);
+		(void) checksum;
+	}
+
+	remove(FONT_FILE);
+
+	if(errors != 0) {
+		printf("%d glyphs could not be drawn\n", errors);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,91 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_TESTS_HOST_HOST_TEST_H_
+#define MBED_LVGL_TESTS_HOST_HOST_TEST_H_
+
+/**
+ * Minimal helpers shared by the host tests and benchmarks
+ *
+ * A test is a function registered with HOST_TEST_RUN from main(), checks
+ * report the failing expression and carry on. host_test_result() is the
+ * exit code of the test executable. Benchmarks parse --quick (a short run,
+ * as done by ctest) with host_bench_quick().
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static int host_test_failures = 0;
+
+#define HOST_CHECK(expr)                                                        \
+	do {                                                                        \
+		if (!(expr)) {                                                          \
+			printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #expr);            \
+			host_test_failures++;                                               \
+		}                                                                       \
+	} while (0)
+
+#define HOST_CHECK_EQUAL(expected, actual)                                      \
+	do {                                                                        \
+		long long host_expected = (long long)(expected);                        \
+		long long host_actual = (long long)(actual);                            \
+		if (host_expected != host_actual) {                                     \
+			printf("  FAIL %s:%d: %s == %s (expected %lld, got %lld)\n",        \
+					__FILE__, __LINE__, #expected, #actual,                     \
+					host_expected, host_actual);                                \
+			host_test_failures++;                                               \
+		}                                                                       \
+	} while (0)
+
+#define HOST_TEST_RUN(test)                                                     \
+	do {                                                                        \
+		int host_failures_before = host_test_failures;                          \
+		test();                                                                 \
+		printf("%s %s\n", (host_test_failures == host_failures_before)          \
+				? "PASS" : "FAIL", #test);                                      \
+		fflush(stdout);                                                         \
+	} while (0)
+
+static inline int host_test_result(void)
+{
+	return host_test_failures == 0 ? 0 : 1;
+}
+
+/** Monotonic time in nanoseconds */
+static inline uint64_t host_time_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+/** Checks the command line of a benchmark for --quick */
+static inline bool host_bench_quick(int argc, char** argv)
+{
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--quick") == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+#endif /* MBED_LVGL_TESTS_HOST_HOST_TEST_H_ */
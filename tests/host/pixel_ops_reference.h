@@ -0,0 +1,67 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_TESTS_HOST_PIXEL_OPS_REFERENCE_H_
+#define MBED_LVGL_TESTS_HOST_PIXEL_OPS_REFERENCE_H_
+
+/**
+ * Scalar versions of the pixel_ops kernels, written the way lvgl would
+ * do it pixel by pixel. The vectorized kernels must match them exactly.
+ */
+
+#include <stdint.h>
+
+#include "lv_color.h"
+
+static inline void ref_fill(lv_color_t* dest, uint32_t len, lv_color_t color)
+{
+	for(uint32_t i = 0; i < len; i++) {
+		dest[i] = color;
+	}
+}
+
+static inline void ref_blend(lv_color_t* dest, const lv_color_t* src, uint32_t len, lv_opa_t opa)
+{
+	for(uint32_t i = 0; i < len; i++) {
+		dest[i] = lv_color_mix(src[i], dest[i], opa);
+	}
+}
+
+static inline uint16_t ref_rgb565(lv_color_t c)
+{
+	lv_color32_t c32;
+	c32.full = lv_color_to32(c);
+	return (uint16_t)(((c32.ch.red & 0xF8) << 8) | ((c32.ch.green & 0xFC) << 3) | (c32.ch.blue >> 3));
+}
+
+static inline uint8_t ref_rgb332(lv_color_t c)
+{
+	lv_color32_t c32;
+	c32.full = lv_color_to32(c);
+	return (uint8_t)((c32.ch.red & 0xE0) | ((c32.ch.green & 0xE0) >> 3) | (c32.ch.blue >> 6));
+}
+
+/** Pseudo-random pixels, the same sequence for a given seed */
+static inline void ref_random_pixels(lv_color_t* px, uint32_t len, uint32_t seed)
+{
+	for(uint32_t i = 0; i < len; i++) {
+		seed = seed * 1103515245u + 12345u;
+		px[i] = lv_color_make(seed >> 24, seed >> 16, seed >> 8);
+	}
+}
+
+#endif /* MBED_LVGL_TESTS_HOST_PIXEL_OPS_REFERENCE_H_ */
@@ -0,0 +1,124 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_TESTS_HOST_RLE_TEST_IMAGE_H_
+#define MBED_LVGL_TESTS_HOST_RLE_TEST_IMAGE_H_
+
+/**
+ * LVRL images for the RLEImageDecoder test and benchmark
+ *
+ * rle_encode() produces the same packets as tools/rle_img_conv.py.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "lv_img.h"
+
+static const uint32_t RLE_TEST_HEADER_SIZE = 16;
+static const uint32_t RLE_TEST_MAX_PACKET = 128;
+
+static inline void rle_put_u32(std::vector<uint8_t>& out, size_t pos, uint32_t v)
+{
+	out[pos] = v & 0xFF;
+	out[pos + 1] = (v >> 8) & 0xFF;
+	out[pos + 2] = (v >> 16) & 0xFF;
+	out[pos + 3] = v >> 24;
+}
+
+static inline void rle_put_pixel(std::vector<uint8_t>& out, lv_color_t c)
+{
+	const uint8_t* p = (const uint8_t*) &c;
+	out.insert(out.end(), p, p + sizeof(lv_color_t));
+}
+
+static inline void rle_encode_row(std::vector<uint8_t>& out, const lv_color_t* px, uint32_t n)
+{
+	uint32_t i = 0;
+	while(i < n) {
+		uint32_t run = 1;
+		while(i + run < n && run < RLE_TEST_MAX_PACKET && px[i + run].full == px[i].full) {
+			run++;
+		}
+
+		if(run > 1) {
+			out.push_back(0x80 | (run - 1));
+			rle_put_pixel(out, px[i]);
+			i += run;
+			continue;
+		}
+
+		// Literals until the next run of at least 2 pixels
+		uint32_t start = i;
+		while(i < n && i - start < RLE_TEST_MAX_PACKET) {
+			if(i + 1 < n && px[i + 1].full == px[i].full) {
+				break;
+			}
+			i++;
+		}
+		if(i == start) {
+			i++;
+		}
+		out.push_back(i - start - 1);
+		for(uint32_t j = start; j < i; j++) {
+			rle_put_pixel(out, px[j]);
+		}
+	}
+}
+
+/** Encodes w x h pixels as an LVRL image (header, row table, rows) */
+static inline std::vector<uint8_t> rle_encode(const std::vector<lv_color_t>& px, uint16_t w, uint16_t h)
+{
+	std::vector<uint8_t> out(RLE_TEST_HEADER_SIZE + (h + 1) * 4, 0);
+	const uint8_t header[] = { 'L', 'V', 'R', 'L', 1, LV_COLOR_DEPTH,
+			(uint8_t)(w & 0xFF), (uint8_t)(w >> 8), (uint8_t)(h & 0xFF), (uint8_t)(h >> 8), 0 };
+	std::copy(header, header + sizeof(header), out.begin());
+
+	for(uint16_t y = 0; y < h; y++) {
+		rle_put_u32(out, RLE_TEST_HEADER_SIZE + y * 4, out.size());
+		rle_encode_row(out, &px[(size_t) y * w], w);
+	}
+	rle_put_u32(out, RLE_TEST_HEADER_SIZE + h * 4, out.size());
+	return out;
+}
+
+/** Variable source (LV_IMG_CF_RAW) of an encoded image */
+static inline lv_img_dsc_t rle_variable_src(const std::vector<uint8_t>& data)
+{
+	lv_img_dsc_t dsc;
+	memset(&dsc, 0, sizeof(dsc));
+	dsc.header.cf = LV_IMG_CF_RAW;
+	dsc.data_size = data.size();
+	dsc.data = data.data();
+	return dsc;
+}
+
+static inline bool rle_write_file(const char* path, const std::vector<uint8_t>& data)
+{
+	FILE* f = fopen(path, "wb");
+	if(f == NULL) {
+		return false;
+	}
+	bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+	return (fclose(f) == 0) && ok;
+}
+
+#endif /* MBED_LVGL_TESTS_HOST_RLE_TEST_IMAGE_H_ */
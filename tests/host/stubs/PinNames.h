@@ -0,0 +1,9 @@
+/* Host stub of a target's PinNames.h */
+#ifndef HOST_STUB_PINNAMES_H_
+#define HOST_STUB_PINNAMES_H_
+
+typedef enum {
+	NC = (int) 0xFFFFFFFF,
+} PinName;
+
+#endif
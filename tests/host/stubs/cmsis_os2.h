@@ -0,0 +1,40 @@
+/* Host stub of the CMSIS-RTOS2 types used through mbed's rtos API */
+#ifndef HOST_STUB_CMSIS_OS2_H_
+#define HOST_STUB_CMSIS_OS2_H_
+
+#include <stdint.h>
+
+typedef enum {
+	osPriorityIdle = 1,
+	osPriorityLow = 8,
+	osPriorityBelowNormal = 16,
+	osPriorityNormal = 24,
+	osPriorityAboveNormal = 32,
+	osPriorityHigh = 40,
+	osPriorityRealtime = 48,
+} osPriority_t;
+
+typedef osPriority_t osPriority;
+
+typedef enum {
+	osOK = 0,
+	osError = -1,
+	osErrorTimeout = -2,
+	osErrorResource = -3,
+	osErrorParameter = -4,
+	osErrorNoMemory = -5,
+} osStatus_t;
+
+typedef osStatus_t osStatus;
+
+typedef void *osThreadId_t;
+
+#define osWaitForever 0xFFFFFFFFU
+
+#define osFlagsWaitAny 0x00000000U
+#define osFlagsWaitAll 0x00000001U
+#define osFlagsNoClear 0x00000002U
+#define osFlagsError 0x80000000U
+#define osFlagsErrorTimeout 0xFFFFFFFEU
+
+#endif
@@ -0,0 +1,71 @@
+/* Host stub of mbed's drivers/Ticker.h, the callback runs on a thread of its own */
+#ifndef HOST_STUB_DRIVERS_TICKER_H_
+#define HOST_STUB_DRIVERS_TICKER_H_
+
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "platform/Callback.h"
+#include "platform/NonCopyable.h"
+
+typedef uint64_t us_timestamp_t;
+
+namespace mbed {
+
+class Ticker : private NonCopyable<Ticker> {
+public:
+	Ticker() : _attached(false) { }
+
+	~Ticker()
+	{
+		detach();
+	}
+
+	void attach(Callback<void()> func, float t)
+	{
+		attach_us(func, (us_timestamp_t)(t * 1000000.0f));
+	}
+
+	void attach_us(Callback<void()> func, us_timestamp_t t)
+	{
+		detach();
+		_attached = true;
+		_thread = std::thread([this, func, t]() {
+			std::unique_lock<std::mutex> lock(_mutex);
+			std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+			while (true) {
+				next += std::chrono::microseconds(t);
+				if (_detached.wait_until(lock, next, [this]() { return !_attached; })) {
+					return;
+				}
+				func();
+			}
+		});
+	}
+
+	void detach()
+	{
+		if (!_thread.joinable()) {
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_attached = false;
+			_detached.notify_all();
+		}
+		_thread.join();
+	}
+
+private:
+	std::mutex _mutex;
+	std::condition_variable _detached;
+	bool _attached;
+	std::thread _thread;
+};
+
+} // namespace mbed
+
+#endif
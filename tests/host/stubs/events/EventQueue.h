@@ -0,0 +1,175 @@
+/* Host stub of mbed's events/EventQueue.h
+ *
+ * Events run on whichever thread dispatches the queue, like mbed's. The
+ * queue's memory is accounted for the same way equeue does it: every event
+ * takes an equeue_event header plus the callable bound to it (rounded up
+ * to a pointer), and posting fails once the buffer given to the
+ * constructor is used up.
+ */
+#ifndef HOST_STUB_EVENTS_EVENTQUEUE_H_
+#define HOST_STUB_EVENTS_EVENTQUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+#include "platform/Callback.h"
+#include "platform/NonCopyable.h"
+
+/** Same layout as equeue's event header */
+struct equeue_event {
+	unsigned size;
+	uint8_t id;
+	uint8_t generation;
+	struct equeue_event *next;
+	struct equeue_event *sibling;
+	struct equeue_event **ref;
+	unsigned target;
+	int period;
+	void (*dtor)(void *);
+	void (*cb)(void *);
+};
+
+#define EQUEUE_EVENT_SIZE (sizeof(struct equeue_event) + 2 * sizeof(void *))
+
+#define EVENTS_EVENT_SIZE (EQUEUE_EVENT_SIZE - 2 * sizeof(void *) + sizeof(mbed::Callback<void()>))
+
+#define EVENTS_QUEUE_SIZE (32 * EVENTS_EVENT_SIZE)
+
+namespace events {
+
+class EventQueue : private mbed::NonCopyable<EventQueue> {
+public:
+	EventQueue(unsigned size = EVENTS_QUEUE_SIZE, unsigned char *buffer = NULL)
+		: _capacity(size), _used(0), _next_id(1), _break(false)
+	{
+		(void) buffer;
+	}
+
+	~EventQueue()
+	{
+		// Pending events are destroyed without being run
+	}
+
+	void dispatch(int ms = -1)
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		std::chrono::steady_clock::time_point deadline =
+			std::chrono::steady_clock::now() + std::chrono::milliseconds(ms < 0 ? 0 : ms);
+
+		while (true) {
+			while (!_events.empty() && !_break) {
+				pending_t event = _events.front();
+				_events.pop_front();
+				lock.unlock();
+				event.call();
+				lock.lock();
+				// Like equeue, the event's memory is freed once it has run
+				_used -= event.size;
+			}
+
+			if (_break) {
+				_break = false;
+				return;
+			}
+			if (ms == 0) {
+				return;
+			}
+			if (ms < 0) {
+				_signal.wait(lock);
+			} else if (_signal.wait_until(lock, deadline) == std::cv_status::timeout && _events.empty()) {
+				return;
+			}
+		}
+	}
+
+	void dispatch_forever()
+	{
+		dispatch(-1);
+	}
+
+	void break_dispatch()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_break = true;
+		_signal.notify_all();
+	}
+
+	template <typename F>
+	int call(F f)
+	{
+		return post(sizeof(F), [f]() mutable { f(); });
+	}
+
+	template <typename F, typename A0>
+	int call(F f, A0 a0)
+	{
+		struct context {
+			F f;
+			A0 a0;
+		};
+		return post(sizeof(context), [f, a0]() mutable { f(a0); });
+	}
+
+	template <typename T, typename R>
+	int call(T *obj, R(T::*method)())
+	{
+		return call(mbed::callback(obj, method));
+	}
+
+	template <typename T, typename R, typename B0, typename A0>
+	int call(T *obj, R(T::*method)(B0), A0 a0)
+	{
+		return call(mbed::Callback<R(B0)>(obj, method), a0);
+	}
+
+	/** Bytes of the queue's buffer taken by pending events (host only) */
+	unsigned get_used_bytes()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _used;
+	}
+
+private:
+	struct pending_t {
+		std::function<void()> call;
+		unsigned size;
+	};
+
+	int post(size_t callable_size, std::function<void()> call)
+	{
+		// equeue_alloc: header plus the callable, aligned to a pointer
+		unsigned size = (unsigned)(sizeof(struct equeue_event) + callable_size);
+		size = (size + sizeof(void *) - 1) & ~(unsigned)(sizeof(void *) - 1);
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_used + size > _capacity) {
+			return 0;
+		}
+		_used += size;
+
+		pending_t event;
+		event.call = call;
+		event.size = size;
+		_events.push_back(event);
+		_signal.notify_all();
+		return _next_id++;
+	}
+
+	std::mutex _mutex;
+	std::condition_variable _signal;
+	std::deque<pending_t> _events;
+	unsigned _capacity;
+	unsigned _used;
+	int _next_id;
+	bool _break;
+};
+
+} // namespace events
+
+#endif
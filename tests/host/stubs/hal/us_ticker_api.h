@@ -0,0 +1,44 @@
+/* Host stub of mbed's hal/us_ticker_api.h and the ticker_read_us() of hal/ticker_api.h */
+#ifndef HOST_STUB_HAL_US_TICKER_API_H_
+#define HOST_STUB_HAL_US_TICKER_API_H_
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ticker_data_s ticker_data_t;
+
+/* Microseconds of the host's monotonic clock */
+static inline uint64_t host_stub_ticker_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000u + (uint64_t) ts.tv_nsec / 1000u;
+}
+
+static inline const ticker_data_t *get_us_ticker_data(void)
+{
+	return (const ticker_data_t *) 0;
+}
+
+/* Raw counter of the ticker peripheral: on a target its width and frequency vary */
+static inline uint32_t us_ticker_read(void)
+{
+	return (uint32_t) host_stub_ticker_us();
+}
+
+/* Ticker time in microseconds, extended to 64 bits */
+static inline uint64_t ticker_read_us(const ticker_data_t *ticker)
+{
+	(void) ticker;
+	return host_stub_ticker_us();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
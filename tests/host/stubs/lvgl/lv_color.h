@@ -0,0 +1,2 @@
+/* Host stub of lvgl v6's lv_color.h, see lv_stub.h */
+#include "lv_stub.h"
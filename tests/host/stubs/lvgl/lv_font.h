@@ -0,0 +1,50 @@
+/* Host stub of lvgl v6's lv_font.h */
+#ifndef HOST_STUB_LV_FONT_H
+#define HOST_STUB_LV_FONT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+	uint16_t adv_w;
+	uint8_t box_w;
+	uint8_t box_h;
+	int8_t ofs_x;
+	int8_t ofs_y;
+	uint8_t bpp;
+} lv_font_glyph_dsc_t;
+
+typedef struct _lv_font_struct {
+	bool (*get_glyph_dsc)(const struct _lv_font_struct *, lv_font_glyph_dsc_t *, uint32_t letter, uint32_t letter_next);
+	const uint8_t * (*get_glyph_bitmap)(const struct _lv_font_struct *, uint32_t);
+	uint8_t line_height;
+	uint8_t base_line;
+	void * dsc;
+} lv_font_t;
+
+static inline const uint8_t * lv_font_get_glyph_bitmap(const lv_font_t * font_p, uint32_t letter)
+{
+	return font_p->get_glyph_bitmap(font_p, letter);
+}
+
+static inline bool lv_font_get_glyph_dsc(const lv_font_t * font_p, lv_font_glyph_dsc_t * dsc_out,
+		uint32_t letter, uint32_t letter_next)
+{
+	return font_p->get_glyph_dsc(font_p, dsc_out, letter, letter_next);
+}
+
+static inline uint8_t lv_font_get_line_height(const lv_font_t * font_p)
+{
+	return font_p->line_height;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
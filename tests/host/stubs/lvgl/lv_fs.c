@@ -0,0 +1,130 @@
+/* Host stub of lvgl v6's lv_fs.c */
+#include "lv_fs.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LV_FS_STUB_MAX_DRIVERS 8
+
+static lv_fs_drv_t drivers[LV_FS_STUB_MAX_DRIVERS];
+static unsigned driver_count;
+
+void lv_fs_stub_reset(void)
+{
+	driver_count = 0;
+}
+
+void lv_fs_drv_init(lv_fs_drv_t * drv)
+{
+	memset(drv, 0, sizeof(lv_fs_drv_t));
+}
+
+void lv_fs_drv_register(lv_fs_drv_t * drv_p)
+{
+	if(driver_count < LV_FS_STUB_MAX_DRIVERS) {
+		drivers[driver_count++] = *drv_p;
+	}
+}
+
+static lv_fs_drv_t * get_drv(char letter)
+{
+	for(unsigned i = 0; i < driver_count; i++) {
+		if(drivers[i].letter == letter) return &drivers[i];
+	}
+	return NULL;
+}
+
+/* Same as lvgl: the letter, then ':' and any leading separators are dropped */
+static const char * get_real_path(const char * path)
+{
+	path++;
+	while(*path != '\0') {
+		if(*path == ':' || *path == '\\' || *path == '/') {
+			path++;
+		} else {
+			break;
+		}
+	}
+	return path;
+}
+
+lv_fs_res_t lv_fs_open(lv_fs_file_t * file_p, const char * path, lv_fs_mode_t mode)
+{
+	file_p->drv = NULL;
+	file_p->file_d = NULL;
+
+	if(path == NULL) return LV_FS_RES_INV_PARAM;
+
+	file_p->drv = get_drv(path[0]);
+	if(file_p->drv == NULL) return LV_FS_RES_NOT_EX;
+
+	if(file_p->drv->ready_cb != NULL && !file_p->drv->ready_cb(file_p->drv)) {
+		file_p->drv = NULL;
+		return LV_FS_RES_HW_ERR;
+	}
+	if(file_p->drv->open_cb == NULL) {
+		file_p->drv = NULL;
+		return LV_FS_RES_NOT_IMP;
+	}
+
+	file_p->file_d = malloc(file_p->drv->file_size);
+	lv_fs_res_t res = file_p->drv->open_cb(file_p->drv, file_p->file_d, get_real_path(path), mode);
+	if(res != LV_FS_RES_OK) {
+		free(file_p->file_d);
+		file_p->file_d = NULL;
+		file_p->drv = NULL;
+	}
+	return res;
+}
+
+lv_fs_res_t lv_fs_close(lv_fs_file_t * file_p)
+{
+	if(file_p->drv == NULL) return LV_FS_RES_INV_PARAM;
+	if(file_p->drv->close_cb == NULL) return LV_FS_RES_NOT_IMP;
+
+	lv_fs_res_t res = file_p->drv->close_cb(file_p->drv, file_p->file_d);
+	free(file_p->file_d);
+	file_p->file_d = NULL;
+	file_p->drv = NULL;
+	return res;
+}
+
+lv_fs_res_t lv_fs_read(lv_fs_file_t * file_p, void * buf, uint32_t btr, uint32_t * br)
+{
+	if(br != NULL) *br = 0;
+	if(file_p->drv == NULL) return LV_FS_RES_INV_PARAM;
+	if(file_p->drv->read_cb == NULL) return LV_FS_RES_NOT_IMP;
+
+	uint32_t br_tmp = 0;
+	lv_fs_res_t res = file_p->drv->read_cb(file_p->drv, file_p->file_d, buf, btr, &br_tmp);
+	if(br != NULL) *br = br_tmp;
+	return res;
+}
+
+lv_fs_res_t lv_fs_seek(lv_fs_file_t * file_p, uint32_t pos)
+{
+	if(file_p->drv == NULL) return LV_FS_RES_INV_PARAM;
+	if(file_p->drv->seek_cb == NULL) return LV_FS_RES_NOT_IMP;
+	return file_p->drv->seek_cb(file_p->drv, file_p->file_d, pos);
+}
+
+lv_fs_res_t lv_fs_tell(lv_fs_file_t * file_p, uint32_t * pos)
+{
+	if(file_p->drv == NULL) {
+		*pos = 0;
+		return LV_FS_RES_INV_PARAM;
+	}
+	if(file_p->drv->tell_cb == NULL) {
+		*pos = 0;
+		return LV_FS_RES_NOT_IMP;
+	}
+	return file_p->drv->tell_cb(file_p->drv, file_p->file_d, pos);
+}
+
+lv_fs_res_t lv_fs_size(lv_fs_file_t * file_p, uint32_t * size)
+{
+	if(file_p->drv == NULL) return LV_FS_RES_INV_PARAM;
+	if(file_p->drv->size_cb == NULL) return LV_FS_RES_NOT_IMP;
+	if(size == NULL) return LV_FS_RES_INV_PARAM;
+	return file_p->drv->size_cb(file_p->drv, file_p->file_d, size);
+}
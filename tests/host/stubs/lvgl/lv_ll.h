@@ -0,0 +1,2 @@
+/* Host stub of lvgl v6's lv_ll.h, see lv_stub.h */
+#include "lv_stub.h"
@@ -0,0 +1,1973 @@
+/* Host stub of the parts of lvgl v6 used by mbed-lvgl, see lv_stub.h */
+#include "lv_stub.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING
+#include "platform/mem_accounting.h"
+#define LV_MEM_CUSTOM_ALLOC mbed_lvgl_mem_alloc
+#define LV_MEM_CUSTOM_FREE mbed_lvgl_mem_free
+#else
+#define LV_MEM_CUSTOM_ALLOC malloc
+#define LV_MEM_CUSTOM_FREE free
+#endif
+
+lv_stub_stats_t lv_stub_stats;
+uint32_t lv_img_cache_stub_invalidations;
+
+/**********************
+ * Memory
+ **********************/
+
+/** Like lvgl's lv_mem_ent_t: the size in front of the data, for realloc */
+typedef union {
+	uint32_t d_size;
+	uint64_t align;
+} lv_mem_header_t;
+
+void * lv_mem_alloc(size_t size)
+{
+	if(size == 0) return NULL;
+	lv_mem_header_t * header = LV_MEM_CUSTOM_ALLOC(sizeof(lv_mem_header_t) + size);
+	if(header == NULL) return NULL;
+	header->d_size = size;
+	return header + 1;
+}
+
+void lv_mem_free(const void * data)
+{
+	if(data == NULL) return;
+	LV_MEM_CUSTOM_FREE((lv_mem_header_t *) data - 1);
+}
+
+void * lv_mem_realloc(void * data_p, size_t new_size)
+{
+	uint32_t old_size = (data_p != NULL) ? ((lv_mem_header_t *) data_p - 1)->d_size : 0;
+	if(old_size == new_size) return data_p;
+
+	void * new_p = lv_mem_alloc(new_size);
+	if(new_p != NULL && data_p != NULL) {
+		memcpy(new_p, data_p, (old_size < new_size) ? old_size : new_size);
+	}
+	if(new_p != NULL || new_size == 0) lv_mem_free(data_p);
+	return new_p;
+}
+
+/**********************
+ * Linked lists
+ **********************/
+
+#define LL_NODE_META_SIZE (sizeof(lv_ll_node_t *) + sizeof(lv_ll_node_t *))
+#define LL_PREV_P_OFFSET(ll_p) (ll_p->n_size)
+#define LL_NEXT_P_OFFSET(ll_p) (ll_p->n_size + sizeof(lv_ll_node_t *))
+
+static void node_set_prev(lv_ll_t * ll_p, lv_ll_node_t * act, lv_ll_node_t * prev)
+{
+	if(act == NULL) return;
+	memcpy(act + LL_PREV_P_OFFSET(ll_p), &prev, sizeof(lv_ll_node_t *));
+}
+
+static void node_set_next(lv_ll_t * ll_p, lv_ll_node_t * act, lv_ll_node_t * next)
+{
+	if(act == NULL) return;
+	memcpy(act + LL_NEXT_P_OFFSET(ll_p), &next, sizeof(lv_ll_node_t *));
+}
+
+void lv_ll_init(lv_ll_t * ll_p, uint32_t node_size)
+{
+	ll_p->head = NULL;
+	ll_p->tail = NULL;
+	/* Keep the pointers after the data aligned */
+	if(node_size & 0x7) node_size = (node_size & ~0x7u) + 8;
+	ll_p->n_size = node_size;
+}
+
+void * lv_ll_ins_head(lv_ll_t * ll_p)
+{
+	lv_ll_node_t * n_new = lv_mem_alloc(ll_p->n_size + LL_NODE_META_SIZE);
+	if(n_new == NULL) return NULL;
+	node_set_prev(ll_p, n_new, NULL);
+	node_set_next(ll_p, n_new, ll_p->head);
+	if(ll_p->head != NULL) node_set_prev(ll_p, ll_p->head, n_new);
+	ll_p->head = n_new;
+	if(ll_p->tail == NULL) ll_p->tail = n_new;
+	return n_new;
+}
+
+void * lv_ll_ins_tail(lv_ll_t * ll_p)
+{
+	lv_ll_node_t * n_new = lv_mem_alloc(ll_p->n_size + LL_NODE_META_SIZE);
+	if(n_new == NULL) return NULL;
+	node_set_next(ll_p, n_new, NULL);
+	node_set_prev(ll_p, n_new, ll_p->tail);
+	if(ll_p->tail != NULL) node_set_next(ll_p, ll_p->tail, n_new);
+	ll_p->tail = n_new;
+	if(ll_p->head == NULL) ll_p->head = n_new;
+	return n_new;
+}
+
+void * lv_ll_ins_prev(lv_ll_t * ll_p, void * n_act)
+{
+	lv_ll_node_t * prev = lv_ll_get_prev(ll_p, n_act);
+	if(prev == NULL) return lv_ll_ins_head(ll_p);
+
+	lv_ll_node_t * n_new = lv_mem_alloc(ll_p->n_size + LL_NODE_META_SIZE);
+	if(n_new == NULL) return NULL;
+	node_set_next(ll_p, prev, n_new);
+	node_set_prev(ll_p, n_new, prev);
+	node_set_next(ll_p, n_new, n_act);
+	node_set_prev(ll_p, n_act, n_new);
+	return n_new;
+}
+
+void lv_ll_rem(lv_ll_t * ll_p, void * node_p)
+{
+	lv_ll_node_t * prev = lv_ll_get_prev(ll_p, node_p);
+	lv_ll_node_t * next = lv_ll_get_next(ll_p, node_p);
+
+	if(prev == NULL) ll_p->head = next;
+	else node_set_next(ll_p, prev, next);
+	if(next == NULL) ll_p->tail = prev;
+	else node_set_prev(ll_p, next, prev);
+
+	lv_mem_free(node_p);
+}
+
+void * lv_ll_get_head(const lv_ll_t * ll_p)
+{
+	return ll_p->head;
+}
+
+void * lv_ll_get_tail(const lv_ll_t * ll_p)
+{
+	return ll_p->tail;
+}
+
+void * lv_ll_get_next(const lv_ll_t * ll_p, const void * n_act)
+{
+	lv_ll_node_t * next;
+	memcpy(&next, (const lv_ll_node_t *)n_act + LL_NEXT_P_OFFSET(ll_p), sizeof(lv_ll_node_t *));
+	return next;
+}
+
+void * lv_ll_get_prev(const lv_ll_t * ll_p, const void * n_act)
+{
+	lv_ll_node_t * prev;
+	memcpy(&prev, (const lv_ll_node_t *)n_act + LL_PREV_P_OFFSET(ll_p), sizeof(lv_ll_node_t *));
+	return prev;
+}
+
+uint32_t lv_ll_get_len(const lv_ll_t * ll_p)
+{
+	uint32_t len = 0;
+	void * node;
+	for(node = lv_ll_get_head(ll_p); node != NULL; node = lv_ll_get_next(ll_p, node)) len++;
+	return len;
+}
+
+/**********************
+ * Styles
+ **********************/
+
+lv_style_t lv_style_scr;
+lv_style_t lv_style_transp;
+lv_style_t lv_style_plain;
+lv_style_t lv_style_plain_color;
+lv_style_t lv_style_pretty;
+lv_style_t lv_style_pretty_color;
+
+void lv_style_init(void)
+{
+	memset(&lv_style_scr, 0, sizeof(lv_style_t));
+	lv_style_scr.body.opa = LV_OPA_COVER;
+	lv_style_scr.body.main_color = LV_COLOR_WHITE;
+	lv_style_scr.body.grad_color = LV_COLOR_WHITE;
+	lv_style_scr.body.border.color = LV_COLOR_BLACK;
+	lv_style_scr.body.border.opa = LV_OPA_COVER;
+	lv_style_scr.body.border.part = LV_BORDER_FULL;
+	lv_style_scr.text.color = lv_color_make(0x30, 0x30, 0x30);
+	lv_style_scr.text.sel_color = lv_color_make(0x55, 0x96, 0xd8);
+	lv_style_scr.text.font = &lv_font_roboto_16;
+	lv_style_scr.text.letter_space = 0;
+	lv_style_scr.text.line_space = 2;
+	lv_style_scr.text.opa = LV_OPA_COVER;
+	lv_style_scr.image.opa = LV_OPA_COVER;
+	lv_style_scr.image.color = lv_color_make(0x20, 0x20, 0x20);
+	lv_style_scr.image.intense = LV_OPA_TRANSP;
+	lv_style_scr.line.opa = LV_OPA_COVER;
+	lv_style_scr.line.color = lv_color_make(0x20, 0x20, 0x20);
+	lv_style_scr.line.width = 2;
+
+	lv_style_copy(&lv_style_plain, &lv_style_scr);
+	lv_style_plain.body.padding.left = LV_HOR_RES_MAX / 48;
+	lv_style_plain.body.padding.right = LV_HOR_RES_MAX / 48;
+	lv_style_plain.body.padding.top = LV_HOR_RES_MAX / 48;
+	lv_style_plain.body.padding.bottom = LV_HOR_RES_MAX / 48;
+
+	lv_style_copy(&lv_style_transp, &lv_style_plain);
+	lv_style_transp.glass = 1;
+	lv_style_transp.body.opa = LV_OPA_TRANSP;
+	lv_style_transp.body.border.width = 0;
+
+	lv_style_copy(&lv_style_plain_color, &lv_style_plain);
+	lv_style_plain_color.text.color = lv_color_make(0xf0, 0xf0, 0xf0);
+	lv_style_plain_color.body.main_color = lv_color_make(0x55, 0x96, 0xd8);
+	lv_style_plain_color.body.grad_color = lv_style_plain_color.body.main_color;
+
+	lv_style_copy(&lv_style_pretty, &lv_style_plain);
+	lv_style_pretty.body.main_color = LV_COLOR_WHITE;
+	lv_style_pretty.body.grad_color = LV_COLOR_SILVER;
+	lv_style_pretty.body.border.color = lv_color_make(0x40, 0x40, 0x40);
+	lv_style_pretty.body.border.width = 1;
+	lv_style_pretty.body.border.opa = LV_OPA_30;
+
+	lv_style_copy(&lv_style_pretty_color, &lv_style_pretty);
+	lv_style_pretty_color.text.color = lv_color_make(0xe0, 0xe0, 0xe0);
+	lv_style_pretty_color.body.main_color = lv_color_make(0x6b, 0x9a, 0xc7);
+	lv_style_pretty_color.body.grad_color = lv_color_make(0x2b, 0x59, 0x8b);
+	lv_style_pretty_color.body.border.color = lv_color_make(0x15, 0x2c, 0x42);
+}
+
+void lv_style_copy(lv_style_t * dest, const lv_style_t * src)
+{
+	memcpy(dest, src, sizeof(lv_style_t));
+}
+
+/**********************
+ * Font: 95 ASCII glyphs of 8x12 at 4 bpp, generated
+ **********************/
+
+#define FONT_FIRST 0x20
+#define FONT_COUNT 95
+#define FONT_BOX_W 8
+#define FONT_BOX_H 12
+#define FONT_BPP 4
+#define FONT_GLYPH_BYTES ((FONT_BOX_W * FONT_BOX_H * FONT_BPP) / 8)
+
+static uint8_t font_bitmaps[FONT_COUNT][FONT_GLYPH_BYTES];
+static bool font_ready;
+
+static void font_generate(void)
+{
+	/* Strokes picked from the bits of the letter, edges anti-aliased */
+	for(uint32_t i = 0; i < FONT_COUNT; i++) {
+		uint32_t letter = FONT_FIRST + i;
+		uint32_t seed = letter * 2654435761u;
+		uint8_t * bitmap = font_bitmaps[i];
+		memset(bitmap, 0, FONT_GLYPH_BYTES);
+		if(letter == ' ') continue;
+
+		for(uint32_t y = 0; y < FONT_BOX_H; y++) {
+			for(uint32_t x = 0; x < FONT_BOX_W; x++) {
+				bool vertical = (x == 1 && (seed & 1)) || (x == 6 && (seed & 2)) || (x == 3 && (seed & 4));
+				bool horizontal = (y == 1 && (seed & 8)) || (y == 6 && (seed & 16)) || (y == 10 && (seed & 32));
+				bool diagonal = (seed & 64) && ((x * 3 / 2) == y);
+				uint8_t a = (vertical || horizontal || diagonal) ? 15 : 0;
+				if(a == 0 && x > 0 && x < FONT_BOX_W - 1 && ((x == 2 && (seed & 1)) || (x == 5 && (seed & 2)))) {
+					a = 5;
+				}
+				uint32_t bit = (y * FONT_BOX_W + x) * FONT_BPP;
+				bitmap[bit >> 3] |= (uint8_t)(a << (4 - (bit & 7)));
+			}
+		}
+	}
+	font_ready = true;
+}
+
+static bool font_get_glyph_dsc(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t letter,
+		uint32_t letter_next)
+{
+	(void) font;
+	(void) letter_next;
+	if(letter < FONT_FIRST || letter >= FONT_FIRST + FONT_COUNT) return false;
+	dsc_out->adv_w = FONT_BOX_W + 1;
+	dsc_out->box_w = FONT_BOX_W;
+	dsc_out->box_h = FONT_BOX_H;
+	dsc_out->ofs_x = 0;
+	dsc_out->ofs_y = 0;
+	dsc_out->bpp = FONT_BPP;
+	return true;
+}
+
+static const uint8_t * font_get_glyph_bitmap(const lv_font_t * font, uint32_t letter)
+{
+	(void) font;
+	if(!font_ready) font_generate();
+	if(letter < FONT_FIRST || letter >= FONT_FIRST + FONT_COUNT) return NULL;
+	return font_bitmaps[letter - FONT_FIRST];
+}
+
+lv_font_t lv_font_roboto_16 = {
+	font_get_glyph_dsc, font_get_glyph_bitmap, 16, 3, NULL,
+};
+
+/**********************
+ * Displays
+ **********************/
+
+static lv_ll_t disp_ll;
+static lv_disp_t * disp_def;
+static lv_disp_t * disp_refr;
+static lv_ll_t img_decoder_ll;
+lv_ll_t _lv_task_ll;
+static bool task_deleted;
+static uint32_t sys_time;
+static bool lv_initialized;
+
+static void obj_del_tree(lv_obj_t * obj);
+
+void lv_init(void)
+{
+	if(lv_initialized) {
+		lv_disp_t * disp;
+		while((disp = lv_ll_get_head(&disp_ll)) != NULL) {
+			lv_disp_remove(disp);
+		}
+	}
+
+	lv_style_init();
+	lv_ll_init(&disp_ll, sizeof(lv_disp_t));
+	if(lv_initialized) {
+		lv_img_decoder_t * decoder;
+		while((decoder = lv_ll_get_head(&img_decoder_ll)) != NULL) {
+			lv_img_decoder_delete(decoder);
+		}
+	}
+	lv_ll_init(&img_decoder_ll, sizeof(lv_img_decoder_t));
+	if(lv_initialized) {
+		lv_task_t * task;
+		while((task = lv_ll_get_head(&_lv_task_ll)) != NULL) {
+			lv_task_del(task);
+		}
+	}
+	lv_ll_init(&_lv_task_ll, sizeof(lv_task_t));
+	disp_def = NULL;
+	disp_refr = NULL;
+	memset(&lv_stub_stats, 0, sizeof(lv_stub_stats));
+	lv_img_cache_stub_invalidations = 0;
+	lv_anim_stub_running = 0;
+	if(!font_ready) font_generate();
+	lv_initialized = true;
+}
+
+void lv_disp_drv_init(lv_disp_drv_t * driver)
+{
+	memset(driver, 0, sizeof(lv_disp_drv_t));
+	driver->hor_res = LV_HOR_RES_MAX;
+	driver->ver_res = LV_VER_RES_MAX;
+	driver->antialiasing = 1;
+	driver->color_chroma_key = LV_COLOR_TRANSP;
+}
+
+void lv_disp_buf_init(lv_disp_buf_t * disp_buf, void * buf1, void * buf2, uint32_t size_in_px_cnt)
+{
+	memset(disp_buf, 0, sizeof(lv_disp_buf_t));
+	disp_buf->buf1 = buf1;
+	disp_buf->buf2 = buf2;
+	disp_buf->buf_act = disp_buf->buf1;
+	disp_buf->size = size_in_px_cnt;
+}
+
+lv_disp_t * lv_disp_drv_register(lv_disp_drv_t * driver)
+{
+	if(!lv_initialized) lv_init();
+
+	lv_disp_t * disp = lv_ll_ins_head(&disp_ll);
+	memset(disp, 0, sizeof(lv_disp_t));
+	memcpy(&disp->driver, driver, sizeof(lv_disp_drv_t));
+	lv_ll_init(&disp->scr_ll, sizeof(lv_obj_t));
+
+	if(disp_def == NULL) disp_def = disp;
+
+	lv_disp_t * disp_def_tmp = disp_def;
+	disp_def = disp; /* Screens are created on the default display */
+	disp->act_scr = lv_obj_create(NULL, NULL);
+	disp->top_layer = lv_obj_create(NULL, NULL);
+	disp->sys_layer = lv_obj_create(NULL, NULL);
+	disp_def = disp_def_tmp;
+
+	disp->last_activity_time = lv_tick_get();
+	disp->refr_task = lv_task_create(lv_disp_refr_task, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, disp);
+
+	lv_obj_invalidate(disp->act_scr);
+	return disp;
+}
+
+void lv_disp_remove(lv_disp_t * disp)
+{
+	lv_obj_t * scr;
+	while((scr = lv_ll_get_head(&disp->scr_ll)) != NULL) {
+		obj_del_tree(scr);
+	}
+	if(disp->refr_task != NULL) lv_task_del(disp->refr_task);
+	if(disp_def == disp) disp_def = NULL;
+	lv_ll_rem(&disp_ll, disp);
+	if(disp_def == NULL) disp_def = lv_ll_get_head(&disp_ll);
+}
+
+uint32_t lv_disp_get_inactive_time(const lv_disp_t * disp)
+{
+	if(disp != NULL) return lv_tick_elaps(disp->last_activity_time);
+
+	uint32_t t = UINT32_MAX;
+	lv_disp_t * d;
+	LV_LL_READ(disp_ll, d) {
+		uint32_t elaps = lv_tick_elaps(d->last_activity_time);
+		if(elaps < t) t = elaps;
+	}
+	return t;
+}
+
+void lv_disp_trig_activity(lv_disp_t * disp)
+{
+	if(disp == NULL) disp = lv_disp_get_default();
+	if(disp != NULL) disp->last_activity_time = lv_tick_get();
+}
+
+lv_disp_t * lv_disp_get_default(void)
+{
+	return disp_def;
+}
+
+void lv_disp_set_default(lv_disp_t * disp)
+{
+	disp_def = disp;
+}
+
+lv_disp_t * lv_disp_get_next(lv_disp_t * disp)
+{
+	if(disp == NULL) return lv_ll_get_head(&disp_ll);
+	return lv_ll_get_next(&disp_ll, disp);
+}
+
+lv_coord_t lv_disp_get_hor_res(lv_disp_t * disp)
+{
+	if(disp == NULL) disp = lv_disp_get_default();
+	if(disp == NULL) return LV_HOR_RES_MAX;
+	return disp->driver.hor_res;
+}
+
+lv_coord_t lv_disp_get_ver_res(lv_disp_t * disp)
+{
+	if(disp == NULL) disp = lv_disp_get_default();
+	if(disp == NULL) return LV_VER_RES_MAX;
+	return disp->driver.ver_res;
+}
+
+bool lv_disp_get_antialiasing(lv_disp_t * disp)
+{
+	if(disp == NULL) disp = lv_disp_get_default();
+	if(disp == NULL) return false;
+	return disp->driver.antialiasing ? true : false;
+}
+
+lv_disp_buf_t * lv_disp_get_buf(lv_disp_t * disp)
+{
+	return disp->driver.buffer;
+}
+
+bool lv_disp_is_double_buf(lv_disp_t * disp)
+{
+	return disp->driver.buffer->buf1 && disp->driver.buffer->buf2;
+}
+
+bool lv_disp_is_true_double_buf(lv_disp_t * disp)
+{
+	uint32_t scr_size = (uint32_t)disp->driver.hor_res * disp->driver.ver_res;
+	return lv_disp_is_double_buf(disp) && disp->driver.buffer->size == scr_size;
+}
+
+void lv_disp_flush_ready(lv_disp_drv_t * disp_drv)
+{
+	disp_drv->buffer->flushing = 0;
+}
+
+lv_obj_t * lv_disp_get_scr_act(lv_disp_t * disp)
+{
+	if(disp == NULL) disp = lv_disp_get_default();
+	if(disp == NULL) return NULL;
+	return disp->act_scr;
+}
+
+lv_obj_t * lv_disp_get_layer_top(lv_disp_t * disp)
+{
+	if(disp == NULL) disp = lv_disp_get_default();
+	if(disp == NULL) return NULL;
+	return disp->top_layer;
+}
+
+lv_obj_t * lv_disp_get_layer_sys(lv_disp_t * disp)
+{
+	if(disp == NULL) disp = lv_disp_get_default();
+	if(disp == NULL) return NULL;
+	return disp->sys_layer;
+}
+
+void lv_disp_load_scr(lv_obj_t * scr)
+{
+	lv_disp_t * disp = lv_obj_get_disp(scr);
+	disp->act_scr = scr;
+	lv_obj_invalidate(scr);
+}
+
+lv_obj_t * lv_scr_act(void)
+{
+	return lv_disp_get_scr_act(lv_disp_get_default());
+}
+
+/**********************
+ * Objects
+ **********************/
+
+static bool obj_design(lv_obj_t * obj, const lv_area_t * mask_p, lv_design_mode_t mode);
+static lv_res_t obj_signal(lv_obj_t * obj, lv_signal_t sign, void * param);
+
+lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
+{
+	lv_obj_t * new_obj;
+
+	if(parent == NULL) {
+		lv_disp_t * disp = lv_disp_get_default();
+		new_obj = lv_ll_ins_head(&disp->scr_ll);
+		memset(new_obj, 0, sizeof(lv_obj_t));
+		new_obj->disp = disp;
+		lv_area_set(&new_obj->coords, 0, 0, lv_disp_get_hor_res(disp) - 1, lv_disp_get_ver_res(disp) - 1);
+		new_obj->style_p = &lv_style_scr;
+	} else {
+		new_obj = lv_ll_ins_head(&parent->child_ll);
+		memset(new_obj, 0, sizeof(lv_obj_t));
+		new_obj->par = parent;
+		new_obj->coords.x1 = parent->coords.x1;
+		new_obj->coords.y1 = parent->coords.y1;
+		new_obj->coords.x2 = parent->coords.x1 + 100 - 1;
+		new_obj->coords.y2 = parent->coords.y1 + 50 - 1;
+		new_obj->style_p = &lv_style_plain;
+	}
+
+	lv_ll_init(&new_obj->child_ll, sizeof(lv_obj_t));
+	new_obj->signal_cb = obj_signal;
+	new_obj->design_cb = obj_design;
+	new_obj->opa_scale = LV_OPA_COVER;
+
+	if(copy != NULL) {
+		lv_area_copy(&new_obj->coords, &copy->coords);
+		new_obj->ext_draw_pad = copy->ext_draw_pad;
+		new_obj->hidden = copy->hidden;
+		new_obj->opa_scale_en = copy->opa_scale_en;
+		new_obj->opa_scale = copy->opa_scale;
+		new_obj->style_p = copy->style_p;
+		if(copy->par != NULL && parent != NULL) {
+			lv_obj_set_pos(new_obj, lv_obj_get_x(copy), lv_obj_get_y(copy));
+		}
+	}
+
+	if(parent != NULL) {
+		parent->signal_cb(parent, LV_SIGNAL_CHILD_CHG, new_obj);
+		lv_obj_invalidate(new_obj);
+	}
+
+	return new_obj;
+}
+
+static void obj_del_tree(lv_obj_t * obj)
+{
+	lv_obj_t * child;
+	while((child = lv_ll_get_head(&obj->child_ll)) != NULL) {
+		obj_del_tree(child);
+	}
+
+	obj->signal_cb(obj, LV_SIGNAL_CLEANUP, NULL);
+	lv_mem_free(obj->ext_attr);
+
+	lv_obj_t * par = obj->par;
+	if(par == NULL) {
+		lv_disp_t * disp = obj->disp;
+		if(disp->act_scr == obj) disp->act_scr = NULL;
+		lv_ll_rem(&disp->scr_ll, obj);
+	} else {
+		lv_ll_rem(&par->child_ll, obj);
+	}
+}
+
+lv_res_t lv_obj_del(lv_obj_t * obj)
+{
+	lv_obj_invalidate(obj);
+	lv_obj_t * par = obj->par;
+	obj_del_tree(obj);
+	if(par != NULL) {
+		par->signal_cb(par, LV_SIGNAL_CHILD_CHG, NULL);
+	}
+	return LV_RES_INV;
+}
+
+void lv_obj_clean(lv_obj_t * obj)
+{
+	lv_obj_t * child;
+	while((child = lv_ll_get_head(&obj->child_ll)) != NULL) {
+		lv_obj_del(child);
+	}
+}
+
+lv_obj_t * lv_obj_get_screen(const lv_obj_t * obj)
+{
+	const lv_obj_t * act_p = obj;
+	while(act_p->par != NULL) act_p = act_p->par;
+	return (lv_obj_t *)act_p;
+}
+
+lv_disp_t * lv_obj_get_disp(const lv_obj_t * obj)
+{
+	return lv_obj_get_screen(obj)->disp;
+}
+
+void lv_obj_invalidate(const lv_obj_t * obj)
+{
+	if(lv_obj_get_hidden(obj)) return;
+
+	lv_obj_t * scr = lv_obj_get_screen(obj);
+	lv_disp_t * disp = scr->disp;
+	if(scr != lv_disp_get_scr_act(disp)) return;
+
+	/* Truncate the area to the parents */
+	lv_area_t area_trunc;
+	lv_area_copy(&area_trunc, &obj->coords);
+	area_trunc.x1 -= obj->ext_draw_pad;
+	area_trunc.y1 -= obj->ext_draw_pad;
+	area_trunc.x2 += obj->ext_draw_pad;
+	area_trunc.y2 += obj->ext_draw_pad;
+
+	lv_obj_t * par = obj->par;
+	while(par != NULL) {
+		if(!lv_area_intersect(&area_trunc, &area_trunc, &par->coords)) return;
+		if(par->hidden) return;
+		par = par->par;
+	}
+
+	lv_inv_area(disp, &area_trunc);
+}
+
+static void refresh_children_position(lv_obj_t * obj, lv_coord_t x_diff, lv_coord_t y_diff)
+{
+	lv_obj_t * i;
+	LV_LL_READ(obj->child_ll, i) {
+		i->coords.x1 += x_diff;
+		i->coords.y1 += y_diff;
+		i->coords.x2 += x_diff;
+		i->coords.y2 += y_diff;
+		refresh_children_position(i, x_diff, y_diff);
+	}
+}
+
+void lv_obj_set_pos(lv_obj_t * obj, lv_coord_t x, lv_coord_t y)
+{
+	lv_obj_t * par = obj->par;
+	if(par != NULL) {
+		x = x + par->coords.x1;
+		y = y + par->coords.y1;
+	}
+
+	lv_coord_t diff_x = x - obj->coords.x1;
+	lv_coord_t diff_y = y - obj->coords.y1;
+	if(diff_x == 0 && diff_y == 0) return;
+
+	lv_obj_invalidate(obj);
+
+	lv_area_t ori;
+	lv_obj_get_coords(obj, &ori);
+	obj->coords.x1 += diff_x;
+	obj->coords.y1 += diff_y;
+	obj->coords.x2 += diff_x;
+	obj->coords.y2 += diff_y;
+	refresh_children_position(obj, diff_x, diff_y);
+
+	obj->signal_cb(obj, LV_SIGNAL_CORD_CHG, &ori);
+	if(par != NULL) par->signal_cb(par, LV_SIGNAL_CHILD_CHG, obj);
+
+	lv_obj_invalidate(obj);
+}
+
+void lv_obj_set_x(lv_obj_t * obj, lv_coord_t x)
+{
+	lv_obj_set_pos(obj, x, lv_obj_get_y(obj));
+}
+
+void lv_obj_set_y(lv_obj_t * obj, lv_coord_t y)
+{
+	lv_obj_set_pos(obj, lv_obj_get_x(obj), y);
+}
+
+void lv_obj_set_size(lv_obj_t * obj, lv_coord_t w, lv_coord_t h)
+{
+	if(lv_obj_get_width(obj) == w && lv_obj_get_height(obj) == h) return;
+
+	lv_obj_invalidate(obj);
+
+	lv_area_t ori;
+	lv_obj_get_coords(obj, &ori);
+	obj->coords.x2 = obj->coords.x1 + w - 1;
+	obj->coords.y2 = obj->coords.y1 + h - 1;
+
+	obj->signal_cb(obj, LV_SIGNAL_CORD_CHG, &ori);
+	lv_obj_t * par = obj->par;
+	if(par != NULL) par->signal_cb(par, LV_SIGNAL_CHILD_CHG, obj);
+
+	lv_obj_t * i;
+	LV_LL_READ(obj->child_ll, i) {
+		i->signal_cb(i, LV_SIGNAL_PARENT_SIZE_CHG, NULL);
+	}
+
+	lv_obj_invalidate(obj);
+}
+
+void lv_obj_set_width(lv_obj_t * obj, lv_coord_t w)
+{
+	lv_obj_set_size(obj, w, lv_obj_get_height(obj));
+}
+
+void lv_obj_set_height(lv_obj_t * obj, lv_coord_t h)
+{
+	lv_obj_set_size(obj, lv_obj_get_width(obj), h);
+}
+
+void lv_obj_set_hidden(lv_obj_t * obj, bool en)
+{
+	if(!obj->hidden) lv_obj_invalidate(obj);
+	obj->hidden = en ? 1 : 0;
+	if(!obj->hidden) lv_obj_invalidate(obj);
+
+	lv_obj_t * par = lv_obj_get_parent(obj);
+	if(par != NULL) par->signal_cb(par, LV_SIGNAL_CHILD_CHG, obj);
+}
+
+void lv_obj_set_style(lv_obj_t * obj, const lv_style_t * style)
+{
+	obj->style_p = style;
+	lv_obj_refresh_style(obj);
+}
+
+void lv_obj_refresh_style(lv_obj_t * obj)
+{
+	lv_obj_invalidate(obj);
+	obj->signal_cb(obj, LV_SIGNAL_STYLE_CHG, NULL);
+	lv_obj_invalidate(obj);
+}
+
+void lv_obj_set_opa_scale_enable(lv_obj_t * obj, bool en)
+{
+	obj->opa_scale_en = en ? 1 : 0;
+}
+
+void lv_obj_set_opa_scale(lv_obj_t * obj, lv_opa_t opa_scale)
+{
+	obj->opa_scale = opa_scale;
+	lv_obj_invalidate(obj);
+}
+
+void lv_obj_set_signal_cb(lv_obj_t * obj, lv_signal_cb_t signal_cb)
+{
+	obj->signal_cb = signal_cb;
+}
+
+void lv_obj_set_design_cb(lv_obj_t * obj, lv_design_cb_t design_cb)
+{
+	obj->design_cb = design_cb;
+}
+
+void * lv_obj_allocate_ext_attr(lv_obj_t * obj, uint16_t ext_size)
+{
+	obj->ext_attr = lv_mem_realloc(obj->ext_attr, ext_size);
+	return obj->ext_attr;
+}
+
+void lv_obj_refresh_ext_draw_pad(lv_obj_t * obj)
+{
+	obj->ext_draw_pad = 0;
+	obj->signal_cb(obj, LV_SIGNAL_REFR_EXT_DRAW_PAD, NULL);
+	lv_obj_invalidate(obj);
+}
+
+lv_obj_t * lv_obj_get_parent(const lv_obj_t * obj)
+{
+	return obj->par;
+}
+
+lv_obj_t * lv_obj_get_child(const lv_obj_t * obj, const lv_obj_t * child)
+{
+	if(child == NULL) return lv_ll_get_head(&obj->child_ll);
+	return lv_ll_get_next(&obj->child_ll, child);
+}
+
+lv_obj_t * lv_obj_get_child_back(const lv_obj_t * obj, const lv_obj_t * child)
+{
+	if(child == NULL) return lv_ll_get_tail(&obj->child_ll);
+	return lv_ll_get_prev(&obj->child_ll, child);
+}
+
+void lv_obj_get_coords(const lv_obj_t * obj, lv_area_t * cords_p)
+{
+	lv_area_copy(cords_p, &obj->coords);
+}
+
+lv_coord_t lv_obj_get_x(const lv_obj_t * obj)
+{
+	return obj->par != NULL ? obj->coords.x1 - obj->par->coords.x1 : obj->coords.x1;
+}
+
+lv_coord_t lv_obj_get_y(const lv_obj_t * obj)
+{
+	return obj->par != NULL ? obj->coords.y1 - obj->par->coords.y1 : obj->coords.y1;
+}
+
+lv_coord_t lv_obj_get_width(const lv_obj_t * obj)
+{
+	return lv_area_get_width(&obj->coords);
+}
+
+lv_coord_t lv_obj_get_height(const lv_obj_t * obj)
+{
+	return lv_area_get_height(&obj->coords);
+}
+
+const lv_style_t * lv_obj_get_style(const lv_obj_t * obj)
+{
+	/* Objects without a style inherit their parent's */
+	const lv_obj_t * par = obj;
+	while(par != NULL) {
+		if(par->style_p != NULL) return par->style_p;
+		par = par->par;
+	}
+	return &lv_style_scr;
+}
+
+bool lv_obj_get_hidden(const lv_obj_t * obj)
+{
+	return obj->hidden == 0 ? false : true;
+}
+
+lv_opa_t lv_obj_get_opa_scale(const lv_obj_t * obj)
+{
+	const lv_obj_t * parent = obj;
+	while(parent != NULL) {
+		if(parent->opa_scale_en) return parent->opa_scale;
+		parent = lv_obj_get_parent(parent);
+	}
+	return LV_OPA_COVER;
+}
+
+lv_signal_cb_t lv_obj_get_signal_cb(const lv_obj_t * obj)
+{
+	return obj->signal_cb;
+}
+
+lv_design_cb_t lv_obj_get_design_cb(const lv_obj_t * obj)
+{
+	return obj->design_cb;
+}
+
+void * lv_obj_get_ext_attr(const lv_obj_t * obj)
+{
+	return obj->ext_attr;
+}
+
+static bool obj_design(lv_obj_t * obj, const lv_area_t * mask_p, lv_design_mode_t mode)
+{
+	if(mode == LV_DESIGN_COVER_CHK) {
+		/* Radius is not drawn by the stub, the body covers its whole area */
+		if(!lv_area_is_in(mask_p, &obj->coords)) return false;
+		const lv_style_t * style = lv_obj_get_style(obj);
+		if(style->body.opa != LV_OPA_COVER || style->glass) return false;
+		if(lv_obj_get_opa_scale(obj) != LV_OPA_COVER) return false;
+		return true;
+	} else if(mode == LV_DESIGN_DRAW_MAIN) {
+		const lv_style_t * style = lv_obj_get_style(obj);
+		lv_draw_rect(&obj->coords, mask_p, style, lv_obj_get_opa_scale(obj));
+	}
+	return true;
+}
+
+static lv_res_t obj_signal(lv_obj_t * obj, lv_signal_t sign, void * param)
+{
+	(void) obj;
+	if(sign == LV_SIGNAL_GET_TYPE) {
+		((lv_obj_type_t *)param)->type[0] = "lv_obj";
+	}
+	return LV_RES_OK;
+}
+
+void lv_obj_get_type(lv_obj_t * obj, lv_obj_type_t * buf)
+{
+	/* Ancestors add their type first, return the most derived first */
+	lv_obj_type_t tmp;
+	memset(&tmp, 0, sizeof(tmp));
+	memset(buf, 0, sizeof(lv_obj_type_t));
+	obj->signal_cb(obj, LV_SIGNAL_GET_TYPE, &tmp);
+
+	uint8_t cnt = 0;
+	while(cnt < LV_MAX_ANCESTOR_NUM && tmp.type[cnt] != NULL) cnt++;
+	for(uint8_t i = 0; i < cnt; i++) buf->type[i] = tmp.type[cnt - 1 - i];
+}
+
+/**********************
+ * Invalidation and refresh
+ **********************/
+
+void lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
+{
+	if(disp == NULL) disp = lv_disp_get_default();
+	if(disp == NULL) return;
+
+	/* Clear the invalidate buffer if the parameter is NULL */
+	if(area_p == NULL) {
+		disp->inv_p = 0;
+		return;
+	}
+
+	lv_area_t scr_area;
+	lv_area_set(&scr_area, 0, 0, lv_disp_get_hor_res(disp) - 1, lv_disp_get_ver_res(disp) - 1);
+
+	lv_area_t com_area;
+	if(!lv_area_intersect(&com_area, area_p, &scr_area)) return;
+
+	if(disp->driver.rounder_cb) disp->driver.rounder_cb(&disp->driver, &com_area);
+
+	/* Save only if this area is not in one of the saved areas */
+	for(uint16_t i = 0; i < disp->inv_p; i++) {
+		if(lv_area_is_in(&com_area, &disp->inv_areas[i])) return;
+	}
+
+	/* Save the area */
+	if(disp->inv_p < LV_INV_BUF_SIZE) {
+		lv_area_copy(&disp->inv_areas[disp->inv_p], &com_area);
+	} else {
+		/* If no place for the area add the screen */
+		disp->inv_p = 0;
+		lv_area_copy(&disp->inv_areas[disp->inv_p], &scr_area);
+	}
+	disp->inv_p++;
+}
+
+lv_disp_t * lv_refr_get_disp_refreshing(void)
+{
+	return disp_refr;
+}
+
+void lv_refr_set_disp_refreshing(lv_disp_t * disp)
+{
+	disp_refr = disp;
+}
+
+void lv_disp_refr_task(lv_task_t * task)
+{
+	lv_refr_now((lv_disp_t *)task->user_data);
+}
+
+uint16_t lv_anim_stub_running;
+
+uint16_t lv_anim_count_running(void)
+{
+	return lv_anim_stub_running;
+}
+
+void lv_indev_read_task(lv_task_t * task)
+{
+	(void)task;
+}
+
+static void refr_join_area(void)
+{
+	uint32_t join_from;
+	uint32_t join_in;
+	lv_area_t joined_area;
+	for(join_in = 0; join_in < disp_refr->inv_p; join_in++) {
+		if(disp_refr->inv_area_joined[join_in] != 0) continue;
+
+		for(join_from = 0; join_from < disp_refr->inv_p; join_from++) {
+			if(disp_refr->inv_area_joined[join_from] != 0 || join_in == join_from) continue;
+
+			if(!lv_area_is_on(&disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from])) continue;
+
+			lv_area_join(&joined_area, &disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]);
+
+			/* Join two areas only if the joined area size is smaller */
+			if(lv_area_get_size(&joined_area) < (lv_area_get_size(&disp_refr->inv_areas[join_in]) +
+												  lv_area_get_size(&disp_refr->inv_areas[join_from]))) {
+				lv_area_copy(&disp_refr->inv_areas[join_in], &joined_area);
+				disp_refr->inv_area_joined[join_from] = 1;
+			}
+		}
+	}
+}
+
+static void refr_obj(lv_obj_t * obj, const lv_area_t * mask_ori_p)
+{
+	if(lv_obj_get_hidden(obj)) return;
+
+	lv_area_t obj_area;
+	lv_area_t obj_ext_mask;
+	lv_area_copy(&obj_area, &obj->coords);
+	obj_area.x1 -= obj->ext_draw_pad;
+	obj_area.y1 -= obj->ext_draw_pad;
+	obj_area.x2 += obj->ext_draw_pad;
+	obj_area.y2 += obj->ext_draw_pad;
+	if(!lv_area_intersect(&obj_ext_mask, mask_ori_p, &obj_area)) return;
+
+	obj->design_cb(obj, &obj_ext_mask, LV_DESIGN_DRAW_MAIN);
+
+	/* Children are clipped to the object itself */
+	lv_area_t obj_mask;
+	if(lv_area_intersect(&obj_mask, mask_ori_p, &obj->coords)) {
+		lv_obj_t * child_p;
+		LV_LL_READ_BACK(obj->child_ll, child_p) {
+			refr_obj(child_p, &obj_mask);
+		}
+	}
+
+	obj->design_cb(obj, &obj_ext_mask, LV_DESIGN_DRAW_POST);
+}
+
+/** Topmost object fully covering the area, nothing behind it needs to be drawn */
+static lv_obj_t * refr_get_top_obj(const lv_area_t * area_p, lv_obj_t * obj)
+{
+	lv_obj_t * found_p = NULL;
+
+	if(lv_area_is_in(area_p, &obj->coords) && !obj->hidden) {
+		lv_obj_t * i;
+		LV_LL_READ(obj->child_ll, i) {
+			found_p = refr_get_top_obj(area_p, i);
+			if(found_p != NULL) break;
+		}
+
+		if(found_p == NULL) {
+			if(obj->design_cb(obj, area_p, LV_DESIGN_COVER_CHK)) found_p = obj;
+		}
+	}
+
+	return found_p;
+}
+
+static void refr_obj_and_children(lv_obj_t * top_p, const lv_area_t * mask_p)
+{
+	if(top_p == NULL) top_p = lv_disp_get_scr_act(disp_refr);
+	if(top_p == NULL) return;
+
+	refr_obj(top_p, mask_p);
+
+	/* Draw the newer siblings of the top object and of its parents */
+	lv_obj_t * par = lv_obj_get_parent(top_p);
+	lv_obj_t * border_p = top_p;
+	while(par != NULL) {
+		lv_obj_t * i = lv_ll_get_prev(&par->child_ll, border_p);
+		while(i != NULL) {
+			refr_obj(i, mask_p);
+			i = lv_ll_get_prev(&par->child_ll, i);
+		}
+
+		par->design_cb(par, mask_p, LV_DESIGN_DRAW_POST);
+
+		border_p = par;
+		par = lv_obj_get_parent(par);
+	}
+}
+
+static void refr_vdb_flush(void)
+{
+	lv_disp_buf_t * vdb = lv_disp_get_buf(disp_refr);
+
+	/* Wait for the previous flush to finish */
+	while(vdb->flushing);
+
+	vdb->flushing = 1;
+
+	lv_stub_stats.flushes++;
+	lv_stub_stats.flushed_px += lv_area_get_size(&vdb->area);
+
+	if(disp_refr->driver.flush_cb) {
+		disp_refr->driver.flush_cb(&disp_refr->driver, &vdb->area, vdb->buf_act);
+	}
+
+	if(vdb->buf1 && vdb->buf2) {
+		if(vdb->buf_act == vdb->buf1) vdb->buf_act = vdb->buf2;
+		else vdb->buf_act = vdb->buf1;
+	}
+}
+
+static void refr_area_part(const lv_area_t * area_p)
+{
+	lv_disp_buf_t * vdb = lv_disp_get_buf(disp_refr);
+
+	/* With one buffer wait until it's flushed before drawing into it */
+	if(!lv_disp_is_double_buf(disp_refr)) {
+		while(vdb->flushing);
+	}
+
+	lv_area_t start_mask;
+	lv_area_intersect(&start_mask, area_p, &vdb->area);
+
+	lv_obj_t * top_p = refr_get_top_obj(&start_mask, lv_disp_get_scr_act(disp_refr));
+	refr_obj_and_children(top_p, &start_mask);
+
+	if(!lv_disp_is_true_double_buf(disp_refr)) {
+		refr_vdb_flush();
+	}
+}
+
+static void refr_area(const lv_area_t * area_p)
+{
+	lv_disp_buf_t * vdb = lv_disp_get_buf(disp_refr);
+
+	/* True double buffering: draw into the whole screen sized buffer */
+	if(lv_disp_is_true_double_buf(disp_refr)) {
+		vdb->area.x1 = 0;
+		vdb->area.x2 = lv_disp_get_hor_res(disp_refr) - 1;
+		vdb->area.y1 = 0;
+		vdb->area.y2 = lv_disp_get_ver_res(disp_refr) - 1;
+		refr_area_part(area_p);
+		return;
+	}
+
+	lv_coord_t w = lv_area_get_width(area_p);
+	lv_coord_t h = lv_area_get_height(area_p);
+	lv_coord_t y2 = area_p->y2 >= lv_disp_get_ver_res(disp_refr) ? lv_disp_get_ver_res(disp_refr) - 1 : area_p->y2;
+
+	int32_t max_row = (uint32_t)vdb->size / w;
+	if(max_row > h) max_row = h;
+
+	/* Always use the full row */
+	lv_coord_t row;
+	lv_coord_t row_last = 0;
+	for(row = area_p->y1; row + max_row - 1 <= y2; row += max_row) {
+		vdb->area.x1 = area_p->x1;
+		vdb->area.x2 = area_p->x2;
+		vdb->area.y1 = row;
+		vdb->area.y2 = row + max_row - 1;
+		if(vdb->area.y2 > y2) vdb->area.y2 = y2;
+		row_last = vdb->area.y2;
+		refr_area_part(area_p);
+	}
+
+	/* If the last y coordinates are not handled yet ... */
+	if(y2 != row_last) {
+		vdb->area.x1 = area_p->x1;
+		vdb->area.x2 = area_p->x2;
+		vdb->area.y1 = row;
+		vdb->area.y2 = y2;
+		refr_area_part(area_p);
+	}
+}
+
+void lv_refr_now(lv_disp_t * disp)
+{
+	if(disp == NULL) disp = lv_disp_get_default();
+	disp_refr = disp;
+
+	refr_join_area();
+
+	uint32_t px_num = 0;
+	for(uint32_t i = 0; i < disp_refr->inv_p; i++) {
+		if(disp_refr->inv_area_joined[i] == 0) {
+			refr_area(&disp_refr->inv_areas[i]);
+			px_num += lv_area_get_size(&disp_refr->inv_areas[i]);
+		}
+	}
+
+	if(px_num != 0) {
+		lv_stub_stats.refreshes++;
+
+		/* Flush the whole screen sized buffer at once */
+		if(lv_disp_is_true_double_buf(disp_refr)) {
+			refr_vdb_flush();
+		}
+	}
+
+	memset(disp_refr->inv_areas, 0, sizeof(disp_refr->inv_areas));
+	memset(disp_refr->inv_area_joined, 0, sizeof(disp_refr->inv_area_joined));
+	disp_refr->inv_p = 0;
+
+	disp_refr = NULL;
+}
+
+/**********************
+ * Drawing into the virtual display buffer
+ **********************/
+
+/** Clips the area to the mask and the VDB, false if nothing is left to draw */
+static bool vdb_clip(const lv_area_t * area, const lv_area_t * mask, lv_area_t * res, lv_color_t ** vdb_buf,
+		lv_coord_t * vdb_w)
+{
+	if(disp_refr == NULL) return false;
+	lv_disp_buf_t * vdb = lv_disp_get_buf(disp_refr);
+
+	if(!lv_area_intersect(res, area, mask)) return false;
+	if(!lv_area_intersect(res, res, &vdb->area)) return false;
+
+	*vdb_w = lv_area_get_width(&vdb->area);
+	*vdb_buf = vdb->buf_act;
+	return true;
+}
+
+static inline lv_color_t * vdb_px(lv_color_t * vdb_buf, lv_coord_t vdb_w, lv_coord_t x, lv_coord_t y)
+{
+	lv_disp_buf_t * vdb = lv_disp_get_buf(disp_refr);
+	return &vdb_buf[(uint32_t)(y - vdb->area.y1) * vdb_w + (x - vdb->area.x1)];
+}
+
+void lv_draw_fill(const lv_area_t * cords_p, const lv_area_t * mask_p, lv_color_t color, lv_opa_t opa)
+{
+	if(opa < LV_OPA_MIN) return;
+	if(opa > LV_OPA_MAX) opa = LV_OPA_COVER;
+
+	lv_area_t res;
+	lv_color_t * vdb_buf;
+	lv_coord_t vdb_w;
+	if(!vdb_clip(cords_p, mask_p, &res, &vdb_buf, &vdb_w)) return;
+
+	for(lv_coord_t y = res.y1; y <= res.y2; y++) {
+		lv_color_t * px = vdb_px(vdb_buf, vdb_w, res.x1, y);
+		for(lv_coord_t x = res.x1; x <= res.x2; x++, px++) {
+			*px = (opa == LV_OPA_COVER) ? color : lv_color_mix(color, *px, opa);
+		}
+	}
+	lv_stub_stats.fill_px += lv_area_get_size(&res);
+}
+
+static lv_opa_t opa_scaled(lv_opa_t opa, lv_opa_t opa_scale)
+{
+	return opa_scale == LV_OPA_COVER ? opa : (lv_opa_t)(((uint16_t)opa * opa_scale) >> 8);
+}
+
+void lv_draw_rect(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale)
+{
+	if(lv_area_get_height(coords) < 1 || lv_area_get_width(coords) < 1) return;
+
+	/* Body: vertical gradient from main_color to grad_color */
+	lv_opa_t opa = opa_scaled(style->body.opa, opa_scale);
+	if(opa >= LV_OPA_MIN) {
+		lv_coord_t h = lv_area_get_height(coords);
+		bool gradient = style->body.main_color.full != style->body.grad_color.full;
+		if(!gradient) {
+			lv_draw_fill(coords, mask, style->body.main_color, opa);
+		} else {
+			lv_area_t row;
+			row.x1 = coords->x1;
+			row.x2 = coords->x2;
+			for(lv_coord_t y = coords->y1; y <= coords->y2; y++) {
+				if(y < mask->y1 || y > mask->y2) continue;
+				row.y1 = y;
+				row.y2 = y;
+				lv_opa_t mix = (lv_opa_t)(255 - ((int32_t)(y - coords->y1) * 255) / (h > 1 ? h - 1 : 1));
+				lv_color_t color = lv_color_mix(style->body.main_color, style->body.grad_color, mix);
+				lv_draw_fill(&row, mask, color, opa);
+			}
+		}
+	}
+
+	/* Border */
+	lv_coord_t bw = style->body.border.width;
+	lv_opa_t bopa = opa_scaled(style->body.border.opa, opa_scale);
+	if(bw > 0 && bopa >= LV_OPA_MIN) {
+		lv_area_t edge;
+		lv_border_part_t part = style->body.border.part;
+		if(part & LV_BORDER_TOP) {
+			lv_area_set(&edge, coords->x1, coords->y1, coords->x2, coords->y1 + bw - 1);
+			lv_draw_fill(&edge, mask, style->body.border.color, bopa);
+		}
+		if(part & LV_BORDER_BOTTOM) {
+			lv_area_set(&edge, coords->x1, coords->y2 - bw + 1, coords->x2, coords->y2);
+			lv_draw_fill(&edge, mask, style->body.border.color, bopa);
+		}
+		if(part & LV_BORDER_LEFT) {
+			lv_area_set(&edge, coords->x1, coords->y1 + bw, coords->x1 + bw - 1, coords->y2 - bw);
+			lv_draw_fill(&edge, mask, style->body.border.color, bopa);
+		}
+		if(part & LV_BORDER_RIGHT) {
+			lv_area_set(&edge, coords->x2 - bw + 1, coords->y1 + bw, coords->x2, coords->y2 - bw);
+			lv_draw_fill(&edge, mask, style->body.border.color, bopa);
+		}
+	}
+}
+
+void lv_draw_img(const lv_area_t * coords, const lv_area_t * mask, const void * src, const lv_style_t * style,
+				 lv_opa_t opa_scale)
+{
+	if(src == NULL) return;
+
+	const lv_img_dsc_t * img = src;
+	lv_opa_t opa = opa_scaled(style->image.opa, opa_scale);
+	if(opa < LV_OPA_MIN) return;
+
+	lv_area_t res;
+	lv_color_t * vdb_buf;
+	lv_coord_t vdb_w;
+	if(!vdb_clip(coords, mask, &res, &vdb_buf, &vdb_w)) return;
+
+	lv_coord_t img_w = img->header.w;
+	for(lv_coord_t y = res.y1; y <= res.y2; y++) {
+		lv_color_t * px = vdb_px(vdb_buf, vdb_w, res.x1, y);
+		uint32_t src_i = (uint32_t)(y - coords->y1) * img_w + (res.x1 - coords->x1);
+
+		switch(img->header.cf) {
+			case LV_IMG_CF_TRUE_COLOR:
+			case LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED: {
+				const lv_color_t * src_px = (const lv_color_t *)img->data + src_i;
+				bool keyed = img->header.cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED;
+				lv_color_t chroma = LV_COLOR_TRANSP;
+				for(lv_coord_t x = res.x1; x <= res.x2; x++, px++, src_px++) {
+					if(keyed && src_px->full == chroma.full) continue;
+					*px = (opa > LV_OPA_MAX) ? *src_px : lv_color_mix(*src_px, *px, opa);
+				}
+				break;
+			}
+			case LV_IMG_CF_ALPHA_8BIT: {
+				const uint8_t * alpha = img->data + src_i;
+				for(lv_coord_t x = res.x1; x <= res.x2; x++, px++, alpha++) {
+					lv_opa_t a = (opa > LV_OPA_MAX) ? *alpha : (lv_opa_t)(((uint16_t)*alpha * opa) >> 8);
+					if(a < LV_OPA_MIN) continue;
+					*px = (a > LV_OPA_MAX) ? style->image.color : lv_color_mix(style->image.color, *px, a);
+				}
+				break;
+			}
+			default:
+				return;
+		}
+	}
+	lv_stub_stats.img_px += lv_area_get_size(&res);
+}
+
+void lv_img_cache_invalidate_src(const void * src)
+{
+	(void) src;
+	lv_img_cache_stub_invalidations++;
+}
+
+/**********************
+ * Image decoders
+ **********************/
+
+lv_img_src_t lv_img_src_get_type(const void * src)
+{
+	if(src == NULL) return LV_IMG_SRC_UNKNOWN;
+	const uint8_t * u8_p = src;
+
+	/* The first byte of a path is printable, of a symbol 0x80 and over, of a header it's cf */
+	if(u8_p[0] >= 0x20 && u8_p[0] <= 0x7F) return LV_IMG_SRC_FILE;
+	if(u8_p[0] >= 0x80) return LV_IMG_SRC_SYMBOL;
+	return LV_IMG_SRC_VARIABLE;
+}
+
+lv_img_decoder_t * lv_img_decoder_create(void)
+{
+	lv_img_decoder_t * decoder = lv_ll_ins_head(&img_decoder_ll);
+	if(decoder == NULL) return NULL;
+	memset(decoder, 0, sizeof(lv_img_decoder_t));
+	return decoder;
+}
+
+void lv_img_decoder_delete(lv_img_decoder_t * decoder)
+{
+	lv_ll_rem(&img_decoder_ll, decoder);
+}
+
+void lv_img_decoder_set_info_cb(lv_img_decoder_t * decoder, lv_img_decoder_info_f_t info_cb)
+{
+	decoder->info_cb = info_cb;
+}
+
+void lv_img_decoder_set_open_cb(lv_img_decoder_t * decoder, lv_img_decoder_open_f_t open_cb)
+{
+	decoder->open_cb = open_cb;
+}
+
+void lv_img_decoder_set_read_line_cb(lv_img_decoder_t * decoder, lv_img_decoder_read_line_f_t read_line_cb)
+{
+	decoder->read_line_cb = read_line_cb;
+}
+
+void lv_img_decoder_set_close_cb(lv_img_decoder_t * decoder, lv_img_decoder_close_f_t close_cb)
+{
+	decoder->close_cb = close_cb;
+}
+
+lv_res_t lv_img_decoder_get_info(const char * src, lv_img_header_t * header)
+{
+	lv_img_decoder_t * d;
+	LV_LL_READ(img_decoder_ll, d) {
+		if(d->info_cb && d->info_cb(d, src, header) == LV_RES_OK) return LV_RES_OK;
+	}
+	return LV_RES_INV;
+}
+
+lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t * dsc, const void * src, const lv_style_t * style)
+{
+	memset(dsc, 0, sizeof(lv_img_decoder_dsc_t));
+	dsc->style = style;
+	dsc->src = src;
+	dsc->src_type = lv_img_src_get_type(src);
+
+	lv_img_decoder_t * d;
+	LV_LL_READ(img_decoder_ll, d) {
+		if(d->info_cb == NULL || d->open_cb == NULL) continue;
+		if(d->info_cb(d, src, &dsc->header) != LV_RES_OK) continue;
+
+		dsc->decoder = d;
+		if(d->open_cb(d, dsc) == LV_RES_OK) return LV_RES_OK;
+	}
+
+	dsc->decoder = NULL;
+	return LV_RES_INV;
+}
+
+lv_res_t lv_img_decoder_read_line(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+								  uint8_t * buf)
+{
+	if(dsc->decoder == NULL || dsc->decoder->read_line_cb == NULL) return LV_RES_INV;
+	return dsc->decoder->read_line_cb(dsc->decoder, dsc, x, y, len, buf);
+}
+
+void lv_img_decoder_close(lv_img_decoder_dsc_t * dsc)
+{
+	if(dsc->decoder && dsc->decoder->close_cb) dsc->decoder->close_cb(dsc->decoder, dsc);
+}
+
+static uint32_t txt_next_letter(const char ** txt)
+{
+	const uint8_t * p = (const uint8_t *)*txt;
+	uint32_t letter;
+	if(p[0] < 0x80) {
+		letter = p[0];
+		*txt += 1;
+	} else if((p[0] & 0xE0) == 0xC0 && p[1] != 0) {
+		letter = ((uint32_t)(p[0] & 0x1F) << 6) | (p[1] & 0x3F);
+		*txt += 2;
+	} else if((p[0] & 0xF0) == 0xE0 && p[1] != 0 && p[2] != 0) {
+		letter = ((uint32_t)(p[0] & 0x0F) << 12) | ((uint32_t)(p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+		*txt += 3;
+	} else {
+		letter = '?';
+		*txt += 1;
+	}
+	return letter;
+}
+
+/* Recoloring commands, as lvgl's lv_txt_is_cmd: "#rrggbb text#" */
+enum {
+	TXT_CMD_STATE_WAIT,
+	TXT_CMD_STATE_PAR,
+	TXT_CMD_STATE_IN,
+};
+
+static bool txt_is_cmd(uint8_t * state, uint32_t c)
+{
+	bool ret = false;
+	if(c == '#') {
+		if(*state == TXT_CMD_STATE_WAIT) {
+			*state = TXT_CMD_STATE_PAR;
+			ret = true;
+		} else if(*state == TXT_CMD_STATE_PAR) {
+			/* "##" is an escaped '#' */
+			*state = TXT_CMD_STATE_WAIT;
+		} else if(*state == TXT_CMD_STATE_IN) {
+			*state = TXT_CMD_STATE_WAIT;
+			ret = true;
+		}
+	}
+	if(*state == TXT_CMD_STATE_PAR) {
+		if(c == ' ') *state = TXT_CMD_STATE_IN;
+		ret = true;
+	}
+	return ret;
+}
+
+static lv_coord_t txt_line_width(const char * txt, const lv_font_t * font, lv_coord_t letter_space,
+		lv_txt_flag_t flag, const char ** line_end)
+{
+	lv_coord_t w = 0;
+	uint8_t cmd_state = TXT_CMD_STATE_WAIT;
+	const char * p = txt;
+	while(*p != '\0' && *p != '\n') {
+		uint32_t letter = txt_next_letter(&p);
+		if((flag & LV_TXT_FLAG_RECOLOR) && txt_is_cmd(&cmd_state, letter)) continue;
+		lv_font_glyph_dsc_t dsc;
+		if(lv_font_get_glyph_dsc(font, &dsc, letter, 0)) w += dsc.adv_w + letter_space;
+	}
+	if(w > 0) w -= letter_space;
+	*line_end = p;
+	return w;
+}
+
+void lv_txt_get_size(lv_point_t * size_res, const char * text, const lv_font_t * font, lv_coord_t letter_space,
+					 lv_coord_t line_space, lv_coord_t max_width, lv_txt_flag_t flag)
+{
+	(void) max_width;
+	size_res->x = 0;
+	size_res->y = 0;
+	if(text == NULL || font == NULL) return;
+
+	lv_coord_t line_height = lv_font_get_line_height(font);
+	const char * p = text;
+	while(true) {
+		const char * end;
+		lv_coord_t w = txt_line_width(p, font, letter_space, flag, &end);
+		if(w > size_res->x) size_res->x = w;
+		size_res->y += line_height;
+		if(*end == '\0') break;
+		size_res->y += line_space;
+		p = end + 1;
+	}
+}
+
+static void draw_letter(lv_coord_t pos_x, lv_coord_t pos_y, const lv_area_t * mask, const lv_font_t * font,
+		uint32_t letter, lv_color_t color, lv_opa_t opa)
+{
+	lv_font_glyph_dsc_t g;
+	if(!lv_font_get_glyph_dsc(font, &g, letter, 0)) return;
+
+	const uint8_t * map_p = lv_font_get_glyph_bitmap(font, letter);
+	if(map_p == NULL) return;
+
+	lv_coord_t x1 = pos_x + g.ofs_x;
+	lv_coord_t y1 = pos_y + (font->line_height - font->base_line) - g.box_h - g.ofs_y;
+	lv_area_t box;
+	lv_area_set(&box, x1, y1, x1 + g.box_w - 1, y1 + g.box_h - 1);
+
+	lv_area_t res;
+	lv_color_t * vdb_buf;
+	lv_coord_t vdb_w;
+	if(!vdb_clip(&box, mask, &res, &vdb_buf, &vdb_w)) return;
+
+	uint8_t bpp = g.bpp;
+	uint8_t max = (uint8_t)((1 << bpp) - 1);
+	for(lv_coord_t y = res.y1; y <= res.y2; y++) {
+		lv_color_t * px = vdb_px(vdb_buf, vdb_w, res.x1, y);
+		for(lv_coord_t x = res.x1; x <= res.x2; x++, px++) {
+			uint32_t bit = ((uint32_t)(y - y1) * g.box_w + (x - x1)) * bpp;
+			uint8_t v = (map_p[bit >> 3] >> (8 - bpp - (bit & 7))) & max;
+			if(v == 0) continue;
+			lv_opa_t a = (lv_opa_t)((v * 255) / max);
+			if(opa != LV_OPA_COVER) a = (lv_opa_t)(((uint16_t)a * opa) >> 8);
+			*px = (a > LV_OPA_MAX) ? color : lv_color_mix(color, *px, a);
+		}
+	}
+	lv_stub_stats.glyphs++;
+}
+
+void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale,
+				   const char * txt, lv_txt_flag_t flag, lv_point_t * offset, uint16_t sel_start, uint16_t sel_end,
+				   void * hint)
+{
+	(void) offset;
+	(void) hint;
+
+	const lv_font_t * font = style->text.font;
+	lv_opa_t opa = opa_scaled(style->text.opa, opa_scale);
+	if(font == NULL || txt == NULL || opa < LV_OPA_MIN) return;
+
+	/* Selected letters get a background of the selection color */
+	lv_style_t sel_style;
+	lv_style_copy(&sel_style, &lv_style_plain_color);
+	sel_style.body.main_color = style->text.sel_color;
+	sel_style.body.grad_color = style->text.sel_color;
+
+	lv_coord_t w = lv_area_get_width(coords);
+	lv_coord_t line_height = lv_font_get_line_height(font) + style->text.line_space;
+	lv_coord_t pos_y = coords->y1;
+
+	uint8_t cmd_state = TXT_CMD_STATE_WAIT;
+	lv_color_t recolor = style->text.color;
+	uint16_t letter_id = 0;
+
+	const char * p = txt;
+	while(pos_y <= mask->y2) {
+		const char * end;
+		lv_coord_t line_w = txt_line_width(p, font, style->text.letter_space, flag, &end);
+
+		lv_coord_t pos_x = coords->x1;
+		if(flag & LV_TXT_FLAG_CENTER) pos_x += (w - line_w) / 2;
+		else if(flag & LV_TXT_FLAG_RIGHT) pos_x += w - line_w;
+
+		while(p < end) {
+			const char * letter_p = p;
+			uint32_t letter = txt_next_letter(&p);
+			letter_id++;
+
+			if(flag & LV_TXT_FLAG_RECOLOR) {
+				uint8_t state_before = cmd_state;
+				if(txt_is_cmd(&cmd_state, letter)) {
+					if(state_before == TXT_CMD_STATE_WAIT && cmd_state == TXT_CMD_STATE_PAR) {
+						/* The color follows the '#' */
+						char hex[7] = { 0 };
+						for(int i = 0; i < 6 && letter_p[1 + i] != '\0' && letter_p[1 + i] != ' '; i++) {
+							hex[i] = letter_p[1 + i];
+						}
+						recolor = lv_color_hex((uint32_t) strtoul(hex, NULL, 16));
+					}
+					continue;
+				}
+			}
+
+			lv_font_glyph_dsc_t dsc;
+			if(!lv_font_get_glyph_dsc(font, &dsc, letter, 0)) continue;
+			if(pos_y + line_height > mask->y1 && pos_x + dsc.adv_w >= mask->x1 && pos_x <= mask->x2) {
+				if(sel_start != LV_LABEL_TEXT_SEL_OFF && sel_end != LV_LABEL_TEXT_SEL_OFF &&
+						letter_id > sel_start && letter_id <= sel_end) {
+					lv_area_t sel_area;
+					lv_area_set(&sel_area, pos_x, pos_y, pos_x + dsc.adv_w + style->text.letter_space - 1,
+							pos_y + line_height - 1);
+					lv_draw_rect(&sel_area, mask, &sel_style, opa);
+				}
+				lv_color_t color = (cmd_state == TXT_CMD_STATE_IN) ? recolor : style->text.color;
+				draw_letter(pos_x, pos_y, mask, font, letter, color, opa);
+			}
+			pos_x += dsc.adv_w + style->text.letter_space;
+		}
+
+		if(*end == '\0') break;
+		p = end + 1;
+		letter_id++;
+		pos_y += line_height;
+	}
+}
+
+/**********************
+ * Label
+ **********************/
+
+typedef struct {
+	char * text;
+	lv_label_long_mode_t long_mode;
+	lv_label_align_t align;
+	uint8_t body_draw : 1;
+	uint8_t recolor : 1;
+	uint16_t sel_start;
+	uint16_t sel_end;
+} lv_label_ext_t;
+
+static lv_signal_cb_t ancestor_signal;
+
+static void label_refr_size(lv_obj_t * label)
+{
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	if(ext->long_mode != LV_LABEL_LONG_EXPAND) return;
+
+	const lv_style_t * style = lv_obj_get_style(label);
+	lv_point_t size;
+	lv_txt_get_size(&size, ext->text, style->text.font, style->text.letter_space, style->text.line_space,
+					LV_COORD_MAX, LV_TXT_FLAG_EXPAND | (ext->recolor ? LV_TXT_FLAG_RECOLOR : 0));
+	lv_obj_set_size(label, size.x > 0 ? size.x : 1, size.y);
+}
+
+static bool label_design(lv_obj_t * label, const lv_area_t * mask, lv_design_mode_t mode)
+{
+	if(mode == LV_DESIGN_COVER_CHK) return false;
+	if(mode != LV_DESIGN_DRAW_MAIN) return true;
+
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	const lv_style_t * style = lv_obj_get_style(label);
+	lv_opa_t opa_scale = lv_obj_get_opa_scale(label);
+
+	if(ext->body_draw) lv_draw_rect(&label->coords, mask, style, opa_scale);
+
+	lv_txt_flag_t flag = LV_TXT_FLAG_NONE;
+	if(ext->align == LV_LABEL_ALIGN_CENTER) flag |= LV_TXT_FLAG_CENTER;
+	if(ext->align == LV_LABEL_ALIGN_RIGHT) flag |= LV_TXT_FLAG_RIGHT;
+	if(ext->recolor) flag |= LV_TXT_FLAG_RECOLOR;
+
+	lv_draw_label(&label->coords, mask, style, opa_scale, ext->text, flag, NULL, ext->sel_start, ext->sel_end, NULL);
+	return true;
+}
+
+static lv_res_t label_signal(lv_obj_t * label, lv_signal_t sign, void * param)
+{
+	lv_res_t res = ancestor_signal(label, sign, param);
+	if(res != LV_RES_OK) return res;
+
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	if(sign == LV_SIGNAL_CLEANUP) {
+		lv_mem_free(ext->text);
+		ext->text = NULL;
+	} else if(sign == LV_SIGNAL_STYLE_CHG) {
+		label_refr_size(label);
+	} else if(sign == LV_SIGNAL_GET_TYPE) {
+		lv_obj_type_t * buf = param;
+		uint8_t i;
+		for(i = 0; i < LV_MAX_ANCESTOR_NUM - 1 && buf->type[i] != NULL; i++);
+		buf->type[i] = "lv_label";
+	}
+	return res;
+}
+
+lv_obj_t * lv_label_create(lv_obj_t * par, const lv_obj_t * copy)
+{
+	lv_obj_t * new_label = lv_obj_create(par, copy);
+	if(ancestor_signal == NULL) ancestor_signal = lv_obj_get_signal_cb(new_label);
+
+	lv_label_ext_t * ext = lv_obj_allocate_ext_attr(new_label, sizeof(lv_label_ext_t));
+	ext->text = NULL;
+	ext->long_mode = LV_LABEL_LONG_EXPAND;
+	ext->align = LV_LABEL_ALIGN_LEFT;
+	ext->body_draw = 0;
+	ext->recolor = 0;
+	ext->sel_start = LV_LABEL_TEXT_SEL_OFF;
+	ext->sel_end = LV_LABEL_TEXT_SEL_OFF;
+
+	lv_obj_set_design_cb(new_label, label_design);
+	lv_obj_set_signal_cb(new_label, label_signal);
+
+	/* Labels inherit their parent's style */
+	new_label->style_p = NULL;
+
+	if(copy == NULL) {
+		lv_label_set_text(new_label, "Text");
+	} else {
+		lv_label_ext_t * copy_ext = lv_obj_get_ext_attr(copy);
+		ext->long_mode = copy_ext->long_mode;
+		ext->align = copy_ext->align;
+		ext->body_draw = copy_ext->body_draw;
+		ext->recolor = copy_ext->recolor;
+		lv_label_set_text(new_label, copy_ext->text);
+	}
+
+	return new_label;
+}
+
+void lv_label_set_text(lv_obj_t * label, const char * text)
+{
+	lv_obj_invalidate(label);
+
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	if(text == NULL) text = ext->text;
+
+	/* Like lvgl, the text is stored in a buffer reused when it fits */
+	size_t len = strlen(text) + 1;
+	if(ext->text != text) {
+		char * copy = lv_mem_alloc(len);
+		memcpy(copy, text, len);
+		lv_mem_free(ext->text);
+		ext->text = copy;
+	}
+
+	label_refr_size(label);
+	lv_obj_invalidate(label);
+}
+
+void lv_label_set_long_mode(lv_obj_t * label, lv_label_long_mode_t long_mode)
+{
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	ext->long_mode = long_mode;
+	label_refr_size(label);
+	lv_obj_invalidate(label);
+}
+
+void lv_label_set_align(lv_obj_t * label, lv_label_align_t align)
+{
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	ext->align = align;
+	lv_obj_invalidate(label);
+}
+
+void lv_label_set_body_draw(lv_obj_t * label, bool en)
+{
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	ext->body_draw = en ? 1 : 0;
+	lv_obj_invalidate(label);
+}
+
+void lv_label_set_recolor(lv_obj_t * label, bool en)
+{
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	ext->recolor = en ? 1 : 0;
+	label_refr_size(label);
+	lv_obj_invalidate(label);
+}
+
+void lv_label_set_text_sel_start(lv_obj_t * label, uint16_t index)
+{
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	ext->sel_start = index;
+	lv_obj_invalidate(label);
+}
+
+void lv_label_set_text_sel_end(lv_obj_t * label, uint16_t index)
+{
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	ext->sel_end = index;
+	lv_obj_invalidate(label);
+}
+
+char * lv_label_get_text(const lv_obj_t * label)
+{
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	return ext->text;
+}
+
+lv_label_long_mode_t lv_label_get_long_mode(const lv_obj_t * label)
+{
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	return ext->long_mode;
+}
+
+lv_label_align_t lv_label_get_align(const lv_obj_t * label)
+{
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	return ext->align;
+}
+
+bool lv_label_get_body_draw(const lv_obj_t * label)
+{
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	return ext->body_draw ? true : false;
+}
+
+bool lv_label_get_recolor(const lv_obj_t * label)
+{
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	return ext->recolor ? true : false;
+}
+
+uint16_t lv_label_get_text_sel_start(const lv_obj_t * label)
+{
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	return ext->sel_start;
+}
+
+uint16_t lv_label_get_text_sel_end(const lv_obj_t * label)
+{
+	lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+	return ext->sel_end;
+}
+
+/**********************
+ * Canvas
+ **********************/
+
+typedef struct {
+	lv_img_dsc_t dsc;
+} lv_canvas_ext_t;
+
+static bool canvas_design(lv_obj_t * canvas, const lv_area_t * mask, lv_design_mode_t mode)
+{
+	lv_canvas_ext_t * ext = lv_obj_get_ext_attr(canvas);
+	if(mode == LV_DESIGN_COVER_CHK) {
+		return ext->dsc.data != NULL && ext->dsc.header.cf == LV_IMG_CF_TRUE_COLOR &&
+			   lv_area_is_in(mask, &canvas->coords) && lv_obj_get_opa_scale(canvas) == LV_OPA_COVER;
+	}
+	if(mode == LV_DESIGN_DRAW_MAIN && ext->dsc.data != NULL) {
+		lv_draw_img(&canvas->coords, mask, &ext->dsc, lv_obj_get_style(canvas), lv_obj_get_opa_scale(canvas));
+	}
+	return true;
+}
+
+lv_obj_t * lv_canvas_create(lv_obj_t * par, const lv_obj_t * copy)
+{
+	lv_obj_t * new_canvas = lv_obj_create(par, copy);
+	lv_canvas_ext_t * ext = lv_obj_allocate_ext_attr(new_canvas, sizeof(lv_canvas_ext_t));
+	memset(ext, 0, sizeof(lv_canvas_ext_t));
+	ext->dsc.header.cf = LV_IMG_CF_TRUE_COLOR;
+	lv_obj_set_design_cb(new_canvas, canvas_design);
+	new_canvas->style_p = &lv_style_plain;
+	return new_canvas;
+}
+
+void lv_canvas_set_buffer(lv_obj_t * canvas, void * buf, lv_coord_t w, lv_coord_t h, lv_img_cf_t cf)
+{
+	lv_canvas_ext_t * ext = lv_obj_get_ext_attr(canvas);
+	ext->dsc.header.cf = cf;
+	ext->dsc.header.w = w;
+	ext->dsc.header.h = h;
+	ext->dsc.data = buf;
+	ext->dsc.data_size = (uint32_t)w * h * sizeof(lv_color_t);
+	lv_obj_set_size(canvas, w, h);
+	lv_obj_invalidate(canvas);
+}
+
+lv_img_dsc_t * lv_canvas_get_img(lv_obj_t * canvas)
+{
+	lv_canvas_ext_t * ext = lv_obj_get_ext_attr(canvas);
+	return &ext->dsc;
+}
+
+/*********************
+ * lv_hal_tick / lv_task
+ *********************/
+
+void lv_tick_inc(uint32_t tick_period)
+{
+	sys_time += tick_period;
+}
+
+uint32_t lv_tick_get(void)
+{
+	return sys_time;
+}
+
+uint32_t lv_tick_elaps(uint32_t prev_tick)
+{
+	return sys_time - prev_tick;
+}
+
+lv_task_t * lv_task_create(lv_task_cb_t task_xcb, uint32_t period, lv_task_prio_t prio, void * user_data)
+{
+	if(!lv_initialized) lv_init();
+
+	// Keep the list sorted by priority, like lvgl
+	lv_task_t * next;
+	LV_LL_READ(_lv_task_ll, next) {
+		if(next->prio < prio) break;
+	}
+	lv_task_t * task;
+	if(next == NULL) {
+		task = lv_ll_ins_tail(&_lv_task_ll);
+	} else {
+		task = lv_ll_ins_prev(&_lv_task_ll, next);
+	}
+
+	memset(task, 0, sizeof(lv_task_t));
+	task->period = period;
+	task->last_run = lv_tick_get();
+	task->task_cb = task_xcb;
+	task->user_data = user_data;
+	task->prio = prio;
+	return task;
+}
+
+void lv_task_del(lv_task_t * task)
+{
+	lv_ll_rem(&_lv_task_ll, task);
+	task_deleted = true;
+}
+
+void lv_task_set_period(lv_task_t * task, uint32_t period)
+{
+	task->period = period;
+}
+
+void lv_task_ready(lv_task_t * task)
+{
+	task->last_run = lv_tick_get() - task->period - 1;
+}
+
+void lv_task_reset(lv_task_t * task)
+{
+	task->last_run = lv_tick_get();
+}
+
+void lv_task_handler(void)
+{
+	lv_task_t * task = lv_ll_get_head(&_lv_task_ll);
+	while(task != NULL) {
+		lv_task_t * next = lv_ll_get_next(&_lv_task_ll, task);
+		if(task->prio != LV_TASK_PRIO_OFF && lv_tick_elaps(task->last_run) >= task->period) {
+			task->last_run = lv_tick_get();
+			task_deleted = false;
+			bool once = task->once;
+			if(task->task_cb) task->task_cb(task);
+			if(!task_deleted && once) lv_task_del(task);
+			if(task_deleted) {
+				// The list changed under us, start over (tasks that ran are not due anymore)
+				task_deleted = false;
+				next = lv_ll_get_head(&_lv_task_ll);
+			}
+		}
+		task = next;
+	}
+}
@@ -0,0 +1,874 @@
+/* Host stub of the parts of lvgl v6 used by mbed-lvgl
+ *
+ * Types, constants and function names match lvgl v6 so the library's
+ * sources compile unchanged. The implementation (lv_stub.c) is a small
+ * lvgl: objects, styles, invalidation, strip refresh through the display
+ * driver and software drawing of rectangles, images, labels and canvases
+ * following lvgl's semantics (virtual display buffer relative to the
+ * strip, back to front drawing, cover check). Anti-aliasing, radius,
+ * shadows, themes and input devices are left out.
+ */
+#ifndef HOST_STUB_LV_STUB_H
+#define HOST_STUB_LV_STUB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "lv_font.h"
+
+#ifndef LV_COLOR_DEPTH
+#define LV_COLOR_DEPTH 16
+#endif
+#ifndef LV_COLOR_16_SWAP
+#define LV_COLOR_16_SWAP 0
+#endif
+#ifndef LV_HOR_RES_MAX
+#define LV_HOR_RES_MAX 480
+#endif
+#ifndef LV_VER_RES_MAX
+#define LV_VER_RES_MAX 320
+#endif
+#ifndef LV_INV_BUF_SIZE
+#define LV_INV_BUF_SIZE 32
+#endif
+#ifndef LV_COLOR_TRANSP
+#define LV_COLOR_TRANSP LV_COLOR_LIME
+#endif
+#ifndef LV_DISP_DEF_REFR_PERIOD
+#define LV_DISP_DEF_REFR_PERIOD 30
+#endif
+
+/* Parts of lv_conf.h the library tests for */
+#define LV_USE_LABEL 1
+#define LV_LABEL_TEXT_SEL 1
+#define LV_USE_IMG 1
+#define LV_USE_CANVAS 1
+#define LV_IMG_CF_ALPHA 1
+#define LV_USE_ANIMATION 1
+
+/*********************
+ * lv_color.h
+ *********************/
+
+typedef uint8_t lv_opa_t;
+
+#define LV_OPA_TRANSP 0
+#define LV_OPA_0 0
+#define LV_OPA_10 25
+#define LV_OPA_20 51
+#define LV_OPA_30 76
+#define LV_OPA_40 102
+#define LV_OPA_50 127
+#define LV_OPA_60 153
+#define LV_OPA_70 178
+#define LV_OPA_80 204
+#define LV_OPA_90 229
+#define LV_OPA_100 255
+#define LV_OPA_COVER 255
+#define LV_OPA_MIN 16
+#define LV_OPA_MAX 251
+
+typedef union {
+	struct {
+		uint8_t blue;
+		uint8_t green;
+		uint8_t red;
+		uint8_t alpha;
+	} ch;
+	uint32_t full;
+} lv_color32_t;
+
+typedef union {
+	struct {
+		uint16_t blue : 5;
+		uint16_t green : 6;
+		uint16_t red : 5;
+	} ch;
+	uint16_t full;
+} lv_color16_t;
+
+typedef union {
+	struct {
+		uint8_t blue : 2;
+		uint8_t green : 3;
+		uint8_t red : 3;
+	} ch;
+	uint8_t full;
+} lv_color8_t;
+
+#if LV_COLOR_DEPTH == 8
+typedef lv_color8_t lv_color_t;
+#define LV_COLOR_MAKE(r8, g8, b8) ((lv_color_t){{(uint8_t)((b8 >> 6) & 0x3U), (uint8_t)((g8 >> 5) & 0x7U), (uint8_t)((r8 >> 5) & 0x7U)}})
+#elif LV_COLOR_DEPTH == 16
+typedef lv_color16_t lv_color_t;
+#define LV_COLOR_MAKE(r8, g8, b8) ((lv_color_t){{(uint16_t)((b8 >> 3) & 0x1FU), (uint16_t)((g8 >> 2) & 0x3FU), (uint16_t)((r8 >> 3) & 0x1FU)}})
+#elif LV_COLOR_DEPTH == 32
+typedef lv_color32_t lv_color_t;
+#define LV_COLOR_MAKE(r8, g8, b8) ((lv_color_t){{b8, g8, r8, 0xff}})
+#else
+#error "The host stub of lvgl supports LV_COLOR_DEPTH 8, 16 and 32"
+#endif
+
+#define LV_COLOR_WHITE LV_COLOR_MAKE(0xFF, 0xFF, 0xFF)
+#define LV_COLOR_SILVER LV_COLOR_MAKE(0xC0, 0xC0, 0xC0)
+#define LV_COLOR_GRAY LV_COLOR_MAKE(0x80, 0x80, 0x80)
+#define LV_COLOR_BLACK LV_COLOR_MAKE(0x00, 0x00, 0x00)
+#define LV_COLOR_RED LV_COLOR_MAKE(0xFF, 0x00, 0x00)
+#define LV_COLOR_MAROON LV_COLOR_MAKE(0x80, 0x00, 0x00)
+#define LV_COLOR_YELLOW LV_COLOR_MAKE(0xFF, 0xFF, 0x00)
+#define LV_COLOR_OLIVE LV_COLOR_MAKE(0x80, 0x80, 0x00)
+#define LV_COLOR_LIME LV_COLOR_MAKE(0x00, 0xFF, 0x00)
+#define LV_COLOR_GREEN LV_COLOR_MAKE(0x00, 0x80, 0x00)
+#define LV_COLOR_CYAN LV_COLOR_MAKE(0x00, 0xFF, 0xFF)
+#define LV_COLOR_AQUA LV_COLOR_CYAN
+#define LV_COLOR_TEAL LV_COLOR_MAKE(0x00, 0x80, 0x80)
+#define LV_COLOR_BLUE LV_COLOR_MAKE(0x00, 0x00, 0xFF)
+#define LV_COLOR_NAVY LV_COLOR_MAKE(0x00, 0x00, 0x80)
+#define LV_COLOR_MAGENTA LV_COLOR_MAKE(0xFF, 0x00, 0xFF)
+#define LV_COLOR_PURPLE LV_COLOR_MAKE(0x80, 0x00, 0x80)
+#define LV_COLOR_ORANGE LV_COLOR_MAKE(0xFF, 0xA5, 0x00)
+
+static inline lv_color_t lv_color_make(uint8_t r8, uint8_t g8, uint8_t b8)
+{
+	return LV_COLOR_MAKE(r8, g8, b8);
+}
+
+static inline lv_color_t lv_color_hex(uint32_t c)
+{
+	return lv_color_make((uint8_t)((c >> 16) & 0xFF), (uint8_t)((c >> 8) & 0xFF), (uint8_t)(c & 0xFF));
+}
+
+static inline uint16_t lv_color_to16(lv_color_t color)
+{
+#if LV_COLOR_DEPTH == 8
+	lv_color16_t ret;
+	ret.ch.red = color.ch.red * 4;
+	ret.ch.green = color.ch.green * 9;
+	ret.ch.blue = color.ch.blue * 10;
+	return ret.full;
+#elif LV_COLOR_DEPTH == 16
+	return color.full;
+#else
+	lv_color16_t ret;
+	ret.ch.red = color.ch.red >> 3;
+	ret.ch.green = color.ch.green >> 2;
+	ret.ch.blue = color.ch.blue >> 3;
+	return ret.full;
+#endif
+}
+
+static inline uint32_t lv_color_to32(lv_color_t color)
+{
+#if LV_COLOR_DEPTH == 8
+	lv_color32_t ret;
+	ret.ch.red = color.ch.red * 36;
+	ret.ch.green = color.ch.green * 36;
+	ret.ch.blue = color.ch.blue * 85;
+	ret.ch.alpha = 0xFF;
+	return ret.full;
+#elif LV_COLOR_DEPTH == 16
+	lv_color32_t ret;
+	ret.ch.red = (color.ch.red * 263 + 7) >> 5;
+	ret.ch.green = (color.ch.green * 259 + 3) >> 6;
+	ret.ch.blue = (color.ch.blue * 263 + 7) >> 5;
+	ret.ch.alpha = 0xFF;
+	return ret.full;
+#else
+	return color.full;
+#endif
+}
+
+/** lvgl v6's lv_color_mix, bit for bit */
+static inline lv_color_t lv_color_mix(lv_color_t c1, lv_color_t c2, uint8_t mix)
+{
+	lv_color_t ret;
+	ret.ch.red = (uint16_t)((uint16_t)c1.ch.red * mix + (c2.ch.red * (255 - mix))) >> 8;
+	ret.ch.green = (uint16_t)((uint16_t)c1.ch.green * mix + (c2.ch.green * (255 - mix))) >> 8;
+	ret.ch.blue = (uint16_t)((uint16_t)c1.ch.blue * mix + (c2.ch.blue * (255 - mix))) >> 8;
+#if LV_COLOR_DEPTH == 32
+	ret.ch.alpha = 0xFF;
+#endif
+	return ret;
+}
+
+static inline uint8_t lv_color_brightness(lv_color_t color)
+{
+	lv_color32_t c32;
+	c32.full = lv_color_to32(color);
+	uint16_t bright = (uint16_t)(3u * c32.ch.red + c32.ch.blue + 4u * c32.ch.green);
+	return (uint8_t)(bright >> 3);
+}
+
+/*********************
+ * lv_area.h
+ *********************/
+
+typedef int16_t lv_coord_t;
+
+#define LV_COORD_MAX (16383)
+#define LV_COORD_MIN (-16384)
+
+typedef struct {
+	lv_coord_t x;
+	lv_coord_t y;
+} lv_point_t;
+
+typedef struct {
+	lv_coord_t x1;
+	lv_coord_t y1;
+	lv_coord_t x2;
+	lv_coord_t y2;
+} lv_area_t;
+
+static inline void lv_area_set(lv_area_t * area_p, lv_coord_t x1, lv_coord_t y1, lv_coord_t x2, lv_coord_t y2)
+{
+	area_p->x1 = x1;
+	area_p->y1 = y1;
+	area_p->x2 = x2;
+	area_p->y2 = y2;
+}
+
+static inline void lv_area_copy(lv_area_t * dest, const lv_area_t * src)
+{
+	memcpy(dest, src, sizeof(lv_area_t));
+}
+
+static inline lv_coord_t lv_area_get_width(const lv_area_t * area_p)
+{
+	return (lv_coord_t)(area_p->x2 - area_p->x1 + 1);
+}
+
+static inline lv_coord_t lv_area_get_height(const lv_area_t * area_p)
+{
+	return (lv_coord_t)(area_p->y2 - area_p->y1 + 1);
+}
+
+static inline uint32_t lv_area_get_size(const lv_area_t * area_p)
+{
+	return (uint32_t)(area_p->x2 - area_p->x1 + 1) * (area_p->y2 - area_p->y1 + 1);
+}
+
+static inline bool lv_area_intersect(lv_area_t * res_p, const lv_area_t * a1_p, const lv_area_t * a2_p)
+{
+	lv_area_t res;
+	res.x1 = a1_p->x1 > a2_p->x1 ? a1_p->x1 : a2_p->x1;
+	res.y1 = a1_p->y1 > a2_p->y1 ? a1_p->y1 : a2_p->y1;
+	res.x2 = a1_p->x2 < a2_p->x2 ? a1_p->x2 : a2_p->x2;
+	res.y2 = a1_p->y2 < a2_p->y2 ? a1_p->y2 : a2_p->y2;
+	*res_p = res;
+	return (res.x1 <= res.x2) && (res.y1 <= res.y2);
+}
+
+static inline void lv_area_join(lv_area_t * a_res_p, const lv_area_t * a1_p, const lv_area_t * a2_p)
+{
+	lv_area_t res;
+	res.x1 = a1_p->x1 < a2_p->x1 ? a1_p->x1 : a2_p->x1;
+	res.y1 = a1_p->y1 < a2_p->y1 ? a1_p->y1 : a2_p->y1;
+	res.x2 = a1_p->x2 > a2_p->x2 ? a1_p->x2 : a2_p->x2;
+	res.y2 = a1_p->y2 > a2_p->y2 ? a1_p->y2 : a2_p->y2;
+	*a_res_p = res;
+}
+
+static inline bool lv_area_is_on(const lv_area_t * a1_p, const lv_area_t * a2_p)
+{
+	return (a1_p->x1 <= a2_p->x2) && (a1_p->x2 >= a2_p->x1) && (a1_p->y1 <= a2_p->y2) && (a1_p->y2 >= a2_p->y1);
+}
+
+static inline bool lv_area_is_in(const lv_area_t * ain_p, const lv_area_t * aholder_p)
+{
+	return ain_p->x1 >= aholder_p->x1 && ain_p->y1 >= aholder_p->y1 && ain_p->x2 <= aholder_p->x2 &&
+		   ain_p->y2 <= aholder_p->y2;
+}
+
+/*********************
+ * lv_mem.h
+ *********************/
+
+/** Like lvgl with LV_MEM_CUSTOM: LV_MEM_CUSTOM_ALLOC/FREE, mem_accounting's when enabled */
+void * lv_mem_alloc(size_t size);
+void lv_mem_free(const void * data);
+void * lv_mem_realloc(void * data_p, size_t new_size);
+
+/*********************
+ * lv_ll.h
+ *********************/
+
+typedef uint8_t lv_ll_node_t;
+
+/** Nodes are the data followed by the previous and next node pointers, like lvgl */
+typedef struct {
+	uint32_t n_size;
+	lv_ll_node_t * head;
+	lv_ll_node_t * tail;
+} lv_ll_t;
+
+void lv_ll_init(lv_ll_t * ll_p, uint32_t node_size);
+void * lv_ll_ins_head(lv_ll_t * ll_p);
+void * lv_ll_ins_tail(lv_ll_t * ll_p);
+void * lv_ll_ins_prev(lv_ll_t * ll_p, void * n_act);
+void lv_ll_rem(lv_ll_t * ll_p, void * node_p);
+void * lv_ll_get_head(const lv_ll_t * ll_p);
+void * lv_ll_get_tail(const lv_ll_t * ll_p);
+void * lv_ll_get_next(const lv_ll_t * ll_p, const void * n_act);
+void * lv_ll_get_prev(const lv_ll_t * ll_p, const void * n_act);
+uint32_t lv_ll_get_len(const lv_ll_t * ll_p);
+
+#define LV_LL_READ(list, i) for(i = lv_ll_get_head(&list); i != NULL; i = lv_ll_get_next(&list, i))
+#define LV_LL_READ_BACK(list, i) for(i = lv_ll_get_tail(&list); i != NULL; i = lv_ll_get_prev(&list, i))
+
+/*********************
+ * lv_style.h
+ *********************/
+
+typedef uint8_t lv_border_part_t;
+#define LV_BORDER_NONE 0x00
+#define LV_BORDER_BOTTOM 0x01
+#define LV_BORDER_TOP 0x02
+#define LV_BORDER_LEFT 0x04
+#define LV_BORDER_RIGHT 0x08
+#define LV_BORDER_FULL 0x0F
+
+typedef struct {
+	uint8_t glass : 1;
+
+	struct {
+		lv_color_t main_color;
+		lv_color_t grad_color;
+		lv_coord_t radius;
+		lv_opa_t opa;
+
+		struct {
+			lv_color_t color;
+			lv_coord_t width;
+			lv_border_part_t part;
+			lv_opa_t opa;
+		} border;
+
+		struct {
+			lv_color_t color;
+			lv_coord_t width;
+			uint8_t type;
+		} shadow;
+
+		struct {
+			lv_coord_t top;
+			lv_coord_t bottom;
+			lv_coord_t left;
+			lv_coord_t right;
+			lv_coord_t inner;
+		} padding;
+	} body;
+
+	struct {
+		lv_color_t color;
+		lv_color_t sel_color;
+		const lv_font_t * font;
+		lv_coord_t letter_space;
+		lv_coord_t line_space;
+		lv_opa_t opa;
+	} text;
+
+	struct {
+		lv_color_t color;
+		lv_opa_t intense;
+		lv_opa_t opa;
+	} image;
+
+	struct {
+		lv_color_t color;
+		lv_coord_t width;
+		lv_opa_t opa;
+		uint8_t rounded : 1;
+	} line;
+} lv_style_t;
+
+extern lv_style_t lv_style_scr;
+extern lv_style_t lv_style_transp;
+extern lv_style_t lv_style_plain;
+extern lv_style_t lv_style_plain_color;
+extern lv_style_t lv_style_pretty;
+extern lv_style_t lv_style_pretty_color;
+
+void lv_style_init(void);
+void lv_style_copy(lv_style_t * dest, const lv_style_t * src);
+
+/** The stub's only font, ASCII glyphs generated at start-up */
+extern lv_font_t lv_font_roboto_16;
+
+/*********************
+ * lv_obj.h
+ *********************/
+
+enum {
+	LV_RES_INV = 0,
+	LV_RES_OK,
+};
+typedef uint8_t lv_res_t;
+
+enum {
+	LV_DESIGN_DRAW_MAIN,
+	LV_DESIGN_DRAW_POST,
+	LV_DESIGN_COVER_CHK,
+};
+typedef uint8_t lv_design_mode_t;
+
+enum {
+	LV_SIGNAL_CLEANUP,
+	LV_SIGNAL_CHILD_CHG,
+	LV_SIGNAL_CORD_CHG,
+	LV_SIGNAL_PARENT_SIZE_CHG,
+	LV_SIGNAL_STYLE_CHG,
+	LV_SIGNAL_REFR_EXT_DRAW_PAD,
+	LV_SIGNAL_GET_TYPE,
+};
+typedef uint8_t lv_signal_t;
+
+#define LV_MAX_ANCESTOR_NUM 8
+
+/** Types of an object, most derived first (eg: "lv_label", "lv_obj") */
+typedef struct {
+	const char * type[LV_MAX_ANCESTOR_NUM];
+} lv_obj_type_t;
+
+struct _lv_obj_t;
+struct _disp_t;
+
+typedef bool (*lv_design_cb_t)(struct _lv_obj_t * obj, const lv_area_t * mask_p, lv_design_mode_t mode);
+typedef lv_res_t (*lv_signal_cb_t)(struct _lv_obj_t * obj, lv_signal_t sign, void * param);
+
+typedef struct _lv_obj_t {
+	struct _lv_obj_t * par;
+	lv_ll_t child_ll;
+	lv_area_t coords;
+
+	lv_signal_cb_t signal_cb;
+	lv_design_cb_t design_cb;
+
+	void * ext_attr;
+	const lv_style_t * style_p;
+
+	lv_coord_t ext_draw_pad;
+
+	uint8_t hidden : 1;
+	uint8_t opa_scale_en : 1;
+	lv_opa_t opa_scale;
+
+	/** Host only: the display of a screen */
+	struct _disp_t * disp;
+
+	void * user_data;
+} lv_obj_t;
+
+lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy);
+lv_res_t lv_obj_del(lv_obj_t * obj);
+void lv_obj_clean(lv_obj_t * obj);
+void lv_obj_invalidate(const lv_obj_t * obj);
+void lv_obj_set_pos(lv_obj_t * obj, lv_coord_t x, lv_coord_t y);
+void lv_obj_set_x(lv_obj_t * obj, lv_coord_t x);
+void lv_obj_set_y(lv_obj_t * obj, lv_coord_t y);
+void lv_obj_set_size(lv_obj_t * obj, lv_coord_t w, lv_coord_t h);
+void lv_obj_set_width(lv_obj_t * obj, lv_coord_t w);
+void lv_obj_set_height(lv_obj_t * obj, lv_coord_t h);
+void lv_obj_set_hidden(lv_obj_t * obj, bool en);
+void lv_obj_set_style(lv_obj_t * obj, const lv_style_t * style);
+void lv_obj_refresh_style(lv_obj_t * obj);
+void lv_obj_set_opa_scale_enable(lv_obj_t * obj, bool en);
+void lv_obj_set_opa_scale(lv_obj_t * obj, lv_opa_t opa_scale);
+void lv_obj_set_signal_cb(lv_obj_t * obj, lv_signal_cb_t signal_cb);
+void lv_obj_set_design_cb(lv_obj_t * obj, lv_design_cb_t design_cb);
+void * lv_obj_allocate_ext_attr(lv_obj_t * obj, uint16_t ext_size);
+void lv_obj_refresh_ext_draw_pad(lv_obj_t * obj);
+void lv_obj_get_type(lv_obj_t * obj, lv_obj_type_t * buf);
+
+lv_obj_t * lv_obj_get_screen(const lv_obj_t * obj);
+struct _disp_t * lv_obj_get_disp(const lv_obj_t * obj);
+lv_obj_t * lv_obj_get_parent(const lv_obj_t * obj);
+lv_obj_t * lv_obj_get_child(const lv_obj_t * obj, const lv_obj_t * child);
+lv_obj_t * lv_obj_get_child_back(const lv_obj_t * obj, const lv_obj_t * child);
+void lv_obj_get_coords(const lv_obj_t * obj, lv_area_t * cords_p);
+lv_coord_t lv_obj_get_x(const lv_obj_t * obj);
+lv_coord_t lv_obj_get_y(const lv_obj_t * obj);
+lv_coord_t lv_obj_get_width(const lv_obj_t * obj);
+lv_coord_t lv_obj_get_height(const lv_obj_t * obj);
+const lv_style_t * lv_obj_get_style(const lv_obj_t * obj);
+bool lv_obj_get_hidden(const lv_obj_t * obj);
+lv_opa_t lv_obj_get_opa_scale(const lv_obj_t * obj);
+lv_signal_cb_t lv_obj_get_signal_cb(const lv_obj_t * obj);
+lv_design_cb_t lv_obj_get_design_cb(const lv_obj_t * obj);
+void * lv_obj_get_ext_attr(const lv_obj_t * obj);
+
+/*********************
+ * lv_anim.h
+ *********************/
+
+/** Host only: the stub runs no animations, lv_anim_count_running returns this */
+extern uint16_t lv_anim_stub_running;
+uint16_t lv_anim_count_running(void);
+
+/*********************
+ * lv_hal_tick.h / lv_task.h
+ *********************/
+
+void lv_tick_inc(uint32_t tick_period);
+uint32_t lv_tick_get(void);
+uint32_t lv_tick_elaps(uint32_t prev_tick);
+
+struct _lv_task_t;
+typedef void (*lv_task_cb_t)(struct _lv_task_t *);
+
+typedef enum {
+	LV_TASK_PRIO_OFF = 0,
+	LV_TASK_PRIO_LOWEST,
+	LV_TASK_PRIO_LOW,
+	LV_TASK_PRIO_MID,
+	LV_TASK_PRIO_HIGH,
+	LV_TASK_PRIO_HIGHEST,
+	_LV_TASK_PRIO_NUM,
+} lv_task_prio_t;
+
+typedef struct _lv_task_t {
+	uint32_t period;
+	uint32_t last_run;
+	lv_task_cb_t task_cb;
+	void * user_data;
+	uint8_t prio : 3;
+	uint8_t once : 1;
+} lv_task_t;
+
+/** Tasks run from lv_task_handler() once their period elapsed, highest priority first */
+lv_task_t * lv_task_create(lv_task_cb_t task_xcb, uint32_t period, lv_task_prio_t prio, void * user_data);
+void lv_task_del(lv_task_t * task);
+void lv_task_set_period(lv_task_t * task, uint32_t period);
+void lv_task_ready(lv_task_t * task);
+void lv_task_reset(lv_task_t * task);
+void lv_task_handler(void);
+
+/*********************
+ * lv_gc.h
+ *********************/
+
+#define LV_GC_ROOT(x) x
+
+/** lvgl's task list, highest priority first */
+extern lv_ll_t _lv_task_ll;
+
+/*********************
+ * lv_hal_disp.h
+ *********************/
+
+typedef struct {
+	void * buf1;
+	void * buf2;
+	void * buf_act;
+	uint32_t size;
+	lv_area_t area;
+	volatile uint32_t flushing : 1;
+} lv_disp_buf_t;
+
+typedef struct _disp_drv_t {
+	lv_coord_t hor_res;
+	lv_coord_t ver_res;
+	lv_disp_buf_t * buffer;
+	uint32_t antialiasing : 1;
+	uint32_t rotated : 1;
+
+	void (*flush_cb)(struct _disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
+	void (*rounder_cb)(struct _disp_drv_t * disp_drv, lv_area_t * area);
+	void (*set_px_cb)(struct _disp_drv_t * disp_drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+					  lv_color_t color, lv_opa_t opa);
+	void (*monitor_cb)(struct _disp_drv_t * disp_drv, uint32_t time, uint32_t px);
+	void (*gpu_blend_cb)(struct _disp_drv_t * disp_drv, lv_color_t * dest, const lv_color_t * src, uint32_t length,
+						 lv_opa_t opa);
+	void (*gpu_fill_cb)(struct _disp_drv_t * disp_drv, lv_color_t * dest_buf, lv_coord_t dest_width,
+						const lv_area_t * fill_area, lv_color_t color);
+
+	lv_color_t color_chroma_key;
+	void * user_data;
+} lv_disp_drv_t;
+
+typedef struct _disp_t {
+	lv_disp_drv_t driver;
+	lv_task_t * refr_task;
+	lv_ll_t scr_ll;
+	lv_obj_t * act_scr;
+	lv_obj_t * top_layer;
+	lv_obj_t * sys_layer;
+
+	lv_area_t inv_areas[LV_INV_BUF_SIZE];
+	uint8_t inv_area_joined[LV_INV_BUF_SIZE];
+	uint32_t inv_p : 10;
+
+	uint32_t last_activity_time;
+} lv_disp_t;
+
+void lv_disp_drv_init(lv_disp_drv_t * driver);
+void lv_disp_buf_init(lv_disp_buf_t * disp_buf, void * buf1, void * buf2, uint32_t size_in_px_cnt);
+lv_disp_t * lv_disp_drv_register(lv_disp_drv_t * driver);
+void lv_disp_remove(lv_disp_t * disp);
+lv_disp_t * lv_disp_get_default(void);
+void lv_disp_set_default(lv_disp_t * disp);
+lv_disp_t * lv_disp_get_next(lv_disp_t * disp);
+lv_coord_t lv_disp_get_hor_res(lv_disp_t * disp);
+lv_coord_t lv_disp_get_ver_res(lv_disp_t * disp);
+bool lv_disp_get_antialiasing(lv_disp_t * disp);
+lv_disp_buf_t * lv_disp_get_buf(lv_disp_t * disp);
+bool lv_disp_is_double_buf(lv_disp_t * disp);
+bool lv_disp_is_true_double_buf(lv_disp_t * disp);
+void lv_disp_flush_ready(lv_disp_drv_t * disp_drv);
+
+/** Milliseconds since the last input activity on a display, on any display if NULL */
+uint32_t lv_disp_get_inactive_time(const lv_disp_t * disp);
+void lv_disp_trig_activity(lv_disp_t * disp);
+
+lv_obj_t * lv_disp_get_scr_act(lv_disp_t * disp);
+lv_obj_t * lv_disp_get_layer_top(lv_disp_t * disp);
+lv_obj_t * lv_disp_get_layer_sys(lv_disp_t * disp);
+void lv_disp_load_scr(lv_obj_t * scr);
+lv_obj_t * lv_scr_act(void);
+
+/*********************
+ * lv_refr.h
+ *********************/
+
+void lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p);
+void lv_refr_now(lv_disp_t * disp);
+lv_disp_t * lv_refr_get_disp_refreshing(void);
+void lv_refr_set_disp_refreshing(lv_disp_t * disp);
+
+/** Refresh task of a display (task->user_data), created by lv_disp_drv_register */
+void lv_disp_refr_task(lv_task_t * task);
+
+/*********************
+ * lv_indev.h
+ *********************/
+
+/** Input device read task, the stub has no input devices */
+void lv_indev_read_task(lv_task_t * task);
+
+/*********************
+ * lv_img / lv_draw_img.h / lv_img_cache.h
+ *********************/
+
+enum {
+	LV_IMG_CF_UNKNOWN = 0,
+	LV_IMG_CF_RAW,
+	LV_IMG_CF_RAW_ALPHA,
+	LV_IMG_CF_RAW_CHROMA_KEYED,
+	LV_IMG_CF_TRUE_COLOR,
+	LV_IMG_CF_TRUE_COLOR_ALPHA,
+	LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED,
+	LV_IMG_CF_INDEXED_1BIT,
+	LV_IMG_CF_INDEXED_2BIT,
+	LV_IMG_CF_INDEXED_4BIT,
+	LV_IMG_CF_INDEXED_8BIT,
+	LV_IMG_CF_ALPHA_1BIT,
+	LV_IMG_CF_ALPHA_2BIT,
+	LV_IMG_CF_ALPHA_4BIT,
+	LV_IMG_CF_ALPHA_8BIT,
+	LV_IMG_CF_RESERVED_15,
+	LV_IMG_CF_RESERVED_16,
+	LV_IMG_CF_RESERVED_17,
+	LV_IMG_CF_RESERVED_18,
+	LV_IMG_CF_RESERVED_19,
+	LV_IMG_CF_RESERVED_20,
+	LV_IMG_CF_RESERVED_21,
+	LV_IMG_CF_RESERVED_22,
+	LV_IMG_CF_RESERVED_23,
+	LV_IMG_CF_USER_ENCODED_0,
+	LV_IMG_CF_USER_ENCODED_1,
+	LV_IMG_CF_USER_ENCODED_2,
+	LV_IMG_CF_USER_ENCODED_3,
+	LV_IMG_CF_USER_ENCODED_4,
+	LV_IMG_CF_USER_ENCODED_5,
+	LV_IMG_CF_USER_ENCODED_6,
+	LV_IMG_CF_USER_ENCODED_7,
+};
+typedef uint8_t lv_img_cf_t;
+
+typedef struct {
+	uint32_t cf : 5;
+	uint32_t always_zero : 3;
+	uint32_t reserved : 2;
+	uint32_t w : 11;
+	uint32_t h : 11;
+} lv_img_header_t;
+
+typedef struct {
+	lv_img_header_t header;
+	uint32_t data_size;
+	const uint8_t * data;
+} lv_img_dsc_t;
+
+#define LV_IMG_PX_SIZE_ALPHA_BYTE (LV_COLOR_DEPTH / 8 + 1)
+
+/**
+ * Draws an image, the stub accepts lv_img_dsc_t sources of true color
+ * (plain or chroma keyed) and 8 bit alpha, recolored with style->image.color
+ */
+void lv_draw_img(const lv_area_t * coords, const lv_area_t * mask, const void * src, const lv_style_t * style,
+				 lv_opa_t opa_scale);
+
+void lv_img_cache_invalidate_src(const void * src);
+
+/** Host only: how many times lv_img_cache_invalidate_src was called */
+extern uint32_t lv_img_cache_stub_invalidations;
+
+/*********************
+ * lv_img_decoder.h
+ *********************/
+
+enum {
+	LV_IMG_SRC_VARIABLE,
+	LV_IMG_SRC_FILE,
+	LV_IMG_SRC_SYMBOL,
+	LV_IMG_SRC_UNKNOWN,
+};
+typedef uint8_t lv_img_src_t;
+
+struct _lv_img_decoder;
+struct _lv_img_decoder_dsc;
+
+typedef lv_res_t (*lv_img_decoder_info_f_t)(struct _lv_img_decoder * decoder, const void * src,
+		lv_img_header_t * header);
+typedef lv_res_t (*lv_img_decoder_open_f_t)(struct _lv_img_decoder * decoder, struct _lv_img_decoder_dsc * dsc);
+typedef lv_res_t (*lv_img_decoder_read_line_f_t)(struct _lv_img_decoder * decoder, struct _lv_img_decoder_dsc * dsc,
+		lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t * buf);
+typedef void (*lv_img_decoder_close_f_t)(struct _lv_img_decoder * decoder, struct _lv_img_decoder_dsc * dsc);
+
+typedef struct _lv_img_decoder {
+	lv_img_decoder_info_f_t info_cb;
+	lv_img_decoder_open_f_t open_cb;
+	lv_img_decoder_read_line_f_t read_line_cb;
+	lv_img_decoder_close_f_t close_cb;
+	void * user_data;
+} lv_img_decoder_t;
+
+typedef struct _lv_img_decoder_dsc {
+	lv_img_decoder_t * decoder;
+	const void * src;
+	const lv_style_t * style;
+	lv_img_src_t src_type;
+	lv_img_header_t header;
+	const uint8_t * img_data;
+	uint32_t time_to_open;
+	const char * error_msg;
+	void * user_data;
+} lv_img_decoder_dsc_t;
+
+lv_img_src_t lv_img_src_get_type(const void * src);
+
+lv_img_decoder_t * lv_img_decoder_create(void);
+void lv_img_decoder_delete(lv_img_decoder_t * decoder);
+void lv_img_decoder_set_info_cb(lv_img_decoder_t * decoder, lv_img_decoder_info_f_t info_cb);
+void lv_img_decoder_set_open_cb(lv_img_decoder_t * decoder, lv_img_decoder_open_f_t open_cb);
+void lv_img_decoder_set_read_line_cb(lv_img_decoder_t * decoder, lv_img_decoder_read_line_f_t read_line_cb);
+void lv_img_decoder_set_close_cb(lv_img_decoder_t * decoder, lv_img_decoder_close_f_t close_cb);
+
+/** Tries the decoders, newest first, like lvgl (the stub has no built-in decoder) */
+lv_res_t lv_img_decoder_get_info(const char * src, lv_img_header_t * header);
+lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t * dsc, const void * src, const lv_style_t * style);
+lv_res_t lv_img_decoder_read_line(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+								  uint8_t * buf);
+void lv_img_decoder_close(lv_img_decoder_dsc_t * dsc);
+
+/*********************
+ * lv_draw.h
+ *********************/
+
+void lv_draw_fill(const lv_area_t * cords_p, const lv_area_t * mask_p, lv_color_t color, lv_opa_t opa);
+void lv_draw_rect(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale);
+
+enum {
+	LV_TXT_FLAG_NONE = 0x00,
+	LV_TXT_FLAG_RECOLOR = 0x01,
+	LV_TXT_FLAG_EXPAND = 0x02,
+	LV_TXT_FLAG_CENTER = 0x04,
+	LV_TXT_FLAG_RIGHT = 0x08,
+};
+typedef uint8_t lv_txt_flag_t;
+
+void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale,
+				   const char * txt, lv_txt_flag_t flag, lv_point_t * offset, uint16_t sel_start, uint16_t sel_end,
+				   void * hint);
+
+/** Size of a text drawn with the given font and spacing (no wrapping) */
+void lv_txt_get_size(lv_point_t * size_res, const char * text, const lv_font_t * font, lv_coord_t letter_space,
+					 lv_coord_t line_space, lv_coord_t max_width, lv_txt_flag_t flag);
+
+/*********************
+ * lv_label.h
+ *********************/
+
+enum {
+	LV_LABEL_LONG_EXPAND,
+	LV_LABEL_LONG_BREAK,
+	LV_LABEL_LONG_DOT,
+	LV_LABEL_LONG_SROLL,
+	LV_LABEL_LONG_SROLL_CIRC,
+	LV_LABEL_LONG_CROP,
+};
+typedef uint8_t lv_label_long_mode_t;
+
+enum {
+	LV_LABEL_ALIGN_LEFT,
+	LV_LABEL_ALIGN_CENTER,
+	LV_LABEL_ALIGN_RIGHT,
+};
+typedef uint8_t lv_label_align_t;
+
+#define LV_LABEL_TEXT_SEL_OFF 0xFFFF
+
+lv_obj_t * lv_label_create(lv_obj_t * par, const lv_obj_t * copy);
+void lv_label_set_text(lv_obj_t * label, const char * text);
+void lv_label_set_long_mode(lv_obj_t * label, lv_label_long_mode_t long_mode);
+void lv_label_set_align(lv_obj_t * label, lv_label_align_t align);
+void lv_label_set_body_draw(lv_obj_t * label, bool en);
+char * lv_label_get_text(const lv_obj_t * label);
+lv_label_long_mode_t lv_label_get_long_mode(const lv_obj_t * label);
+lv_label_align_t lv_label_get_align(const lv_obj_t * label);
+bool lv_label_get_body_draw(const lv_obj_t * label);
+void lv_label_set_recolor(lv_obj_t * label, bool en);
+bool lv_label_get_recolor(const lv_obj_t * label);
+void lv_label_set_text_sel_start(lv_obj_t * label, uint16_t index);
+void lv_label_set_text_sel_end(lv_obj_t * label, uint16_t index);
+uint16_t lv_label_get_text_sel_start(const lv_obj_t * label);
+uint16_t lv_label_get_text_sel_end(const lv_obj_t * label);
+
+/*********************
+ * lv_canvas.h
+ *********************/
+
+lv_obj_t * lv_canvas_create(lv_obj_t * par, const lv_obj_t * copy);
+void lv_canvas_set_buffer(lv_obj_t * canvas, void * buf, lv_coord_t w, lv_coord_t h, lv_img_cf_t cf);
+lv_img_dsc_t * lv_canvas_get_img(lv_obj_t * canvas);
+
+/*********************
+ * lv_obj_init / host helpers
+ *********************/
+
+/** lv_init: drops every display and object of a previous test */
+void lv_init(void);
+
+/** Host only: counts of what the stub drew */
+typedef struct {
+	uint32_t refreshes;		/** lv_refr_now calls that had something to draw */
+	uint32_t flushes;		/** flush_cb calls */
+	uint32_t flushed_px;	/** Pixels flushed */
+	uint32_t glyphs;		/** Glyphs drawn */
+	uint32_t img_px;		/** Image pixels drawn */
+	uint32_t fill_px;		/** Pixels filled */
+} lv_stub_stats_t;
+
+extern lv_stub_stats_t lv_stub_stats;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
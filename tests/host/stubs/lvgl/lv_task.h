@@ -0,0 +1,2 @@
+/* Host stub of lvgl v6's lv_task.h, see lv_stub.h */
+#include "lv_stub.h"
@@ -0,0 +1,78 @@
+/* Host stub of mbed's platform/Callback.h */
+#ifndef HOST_STUB_PLATFORM_CALLBACK_H_
+#define HOST_STUB_PLATFORM_CALLBACK_H_
+
+#include <cstddef>
+#include <functional>
+
+namespace mbed {
+
+template <typename F>
+class Callback;
+
+/**
+ * Same footprint as mbed's Callback (four words) and the same ways of
+ * being constructed that the library uses
+ */
+template <typename R, typename... Args>
+class Callback<R(Args...)> {
+public:
+	Callback(R (*func)(Args...) = 0)
+	{
+		if (func) {
+			_func = func;
+		}
+	}
+
+	template <typename T, typename U>
+	Callback(U *obj, R (T::*method)(Args...))
+	{
+		_func = [obj, method](Args... args) -> R { return (obj->*method)(args...); };
+	}
+
+	template <typename T, typename U>
+	Callback(U *obj, R (T::*method)(Args...) const)
+	{
+		_func = [obj, method](Args... args) -> R { return (obj->*method)(args...); };
+	}
+
+	R operator()(Args... args) const
+	{
+		return _func(args...);
+	}
+
+	R call(Args... args) const
+	{
+		return _func(args...);
+	}
+
+	explicit operator bool() const
+	{
+		return static_cast<bool>(_func);
+	}
+
+private:
+	std::function<R(Args...)> _func;
+};
+
+template <typename R, typename... Args>
+Callback<R(Args...)> callback(R (*func)(Args...))
+{
+	return Callback<R(Args...)>(func);
+}
+
+template <typename T, typename U, typename R, typename... Args>
+Callback<R(Args...)> callback(U *obj, R (T::*method)(Args...))
+{
+	return Callback<R(Args...)>(obj, method);
+}
+
+template <typename T, typename U, typename R, typename... Args>
+Callback<R(Args...)> callback(U *obj, R (T::*method)(Args...) const)
+{
+	return Callback<R(Args...)>(obj, method);
+}
+
+} // namespace mbed
+
+#endif
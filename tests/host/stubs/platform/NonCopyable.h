@@ -0,0 +1,20 @@
+/* Host stub of mbed's platform/NonCopyable.h */
+#ifndef HOST_STUB_PLATFORM_NONCOPYABLE_H_
+#define HOST_STUB_PLATFORM_NONCOPYABLE_H_
+
+namespace mbed {
+
+template <typename T>
+class NonCopyable {
+protected:
+	NonCopyable() { }
+	~NonCopyable() { }
+
+private:
+	NonCopyable(const NonCopyable &);
+	NonCopyable &operator=(const NonCopyable &);
+};
+
+} // namespace mbed
+
+#endif
@@ -0,0 +1,28 @@
+/* Host stub of mbed's platform/ScopedLock.h */
+#ifndef HOST_STUB_PLATFORM_SCOPEDLOCK_H_
+#define HOST_STUB_PLATFORM_SCOPEDLOCK_H_
+
+#include "platform/NonCopyable.h"
+
+namespace mbed {
+
+template <typename Lockable>
+class ScopedLock : private NonCopyable<ScopedLock<Lockable> > {
+public:
+	ScopedLock(Lockable &lockable) : _lockable(lockable)
+	{
+		_lockable.lock();
+	}
+
+	~ScopedLock()
+	{
+		_lockable.unlock();
+	}
+
+private:
+	Lockable &_lockable;
+};
+
+} // namespace mbed
+
+#endif
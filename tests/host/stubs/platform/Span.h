@@ -0,0 +1,55 @@
+/* Host stub of mbed's platform/Span.h (the parts the library uses) */
+#ifndef HOST_STUB_PLATFORM_SPAN_H_
+#define HOST_STUB_PLATFORM_SPAN_H_
+
+#include <stddef.h>
+
+namespace mbed {
+
+#define SPAN_DYNAMIC_EXTENT -1
+
+template <typename ElementType, ptrdiff_t Extent = SPAN_DYNAMIC_EXTENT>
+class Span {
+public:
+	typedef ElementType element_type;
+	typedef ptrdiff_t index_type;
+	typedef element_type *pointer;
+
+	Span() : _data(NULL), _size(Extent > 0 ? Extent : 0) { }
+
+	Span(pointer ptr, index_type count) : _data(ptr), _size(count) { }
+
+	template <size_t Count>
+	Span(element_type (&elements)[Count]) : _data(elements), _size(Count) { }
+
+	template <typename OtherElementType, ptrdiff_t OtherExtent>
+	Span(const Span<OtherElementType, OtherExtent> &other) : _data(other.data()), _size(other.size()) { }
+
+	index_type size() const
+	{
+		return _size;
+	}
+
+	bool empty() const
+	{
+		return _size == 0;
+	}
+
+	pointer data() const
+	{
+		return _data;
+	}
+
+	element_type &operator[](index_type index) const
+	{
+		return _data[index];
+	}
+
+private:
+	pointer _data;
+	index_type _size;
+};
+
+} // namespace mbed
+
+#endif
@@ -0,0 +1,23 @@
+/* Host stub of mbed's platform/mbed_assert.h, asserts even in release builds */
+#ifndef HOST_STUB_PLATFORM_MBED_ASSERT_H_
+#define HOST_STUB_PLATFORM_MBED_ASSERT_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MBED_ASSERT(expr)                                                       \
+	do {                                                                        \
+		if (!(expr)) {                                                          \
+			fprintf(stderr, "%s:%d: MBED_ASSERT(%s) failed\n",                  \
+					__FILE__, __LINE__, #expr);                                 \
+			abort();                                                            \
+		}                                                                       \
+	} while (0)
+
+#ifdef __cplusplus
+#define MBED_STATIC_ASSERT(expr, msg) static_assert(expr, msg)
+#else
+#define MBED_STATIC_ASSERT(expr, msg) _Static_assert(expr, msg)
+#endif
+
+#endif
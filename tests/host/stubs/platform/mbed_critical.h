@@ -0,0 +1,51 @@
+/* Host stub of mbed's platform/mbed_critical.h, on the compiler's atomic builtins */
+#ifndef HOST_STUB_PLATFORM_MBED_CRITICAL_H_
+#define HOST_STUB_PLATFORM_MBED_CRITICAL_H_
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Weak so every translation unit shares the one critical section */
+__attribute__((weak)) pthread_mutex_t host_stub_critical_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+/* Threads stand in for interrupts on the host */
+static inline bool core_util_is_isr_active(void)
+{
+	return false;
+}
+
+static inline void core_util_critical_section_enter(void)
+{
+	pthread_mutex_lock(&host_stub_critical_mutex);
+}
+
+static inline void core_util_critical_section_exit(void)
+{
+	pthread_mutex_unlock(&host_stub_critical_mutex);
+}
+
+static inline bool core_util_atomic_cas_u32(volatile uint32_t *ptr, uint32_t *expectedCurrentValue, uint32_t desiredValue)
+{
+	return __atomic_compare_exchange_n(ptr, expectedCurrentValue, desiredValue, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t core_util_atomic_incr_u32(volatile uint32_t *valuePtr, uint32_t delta)
+{
+	return __atomic_add_fetch(valuePtr, delta, __ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t core_util_atomic_decr_u32(volatile uint32_t *valuePtr, uint32_t delta)
+{
+	return __atomic_sub_fetch(valuePtr, delta, __ATOMIC_SEQ_CST);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
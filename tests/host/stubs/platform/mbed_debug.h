@@ -0,0 +1,16 @@
+/* Host stub of mbed's platform/mbed_debug.h */
+#ifndef HOST_STUB_PLATFORM_MBED_DEBUG_H_
+#define HOST_STUB_PLATFORM_MBED_DEBUG_H_
+
+#include <stdarg.h>
+#include <stdio.h>
+
+static inline void debug(const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+}
+
+#endif
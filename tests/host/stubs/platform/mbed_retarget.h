@@ -0,0 +1,7 @@
+/* Host stub of mbed's platform/mbed_retarget.h, the host C library already provides stdio */
+#ifndef HOST_STUB_PLATFORM_MBED_RETARGET_H_
+#define HOST_STUB_PLATFORM_MBED_RETARGET_H_
+
+#include <stdio.h>
+
+#endif
@@ -0,0 +1,47 @@
+/* Host stub of mbed's rtos/ConditionVariable.h, on a std::condition_variable_any */
+#ifndef HOST_STUB_RTOS_CONDITIONVARIABLE_H_
+#define HOST_STUB_RTOS_CONDITIONVARIABLE_H_
+
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+
+#include "platform/NonCopyable.h"
+#include "rtos/Mutex.h"
+
+namespace rtos {
+
+class ConditionVariable : private mbed::NonCopyable<ConditionVariable> {
+public:
+	ConditionVariable(Mutex &mutex) : _mutex(mutex) { }
+
+	/* The mutex must be locked (once) by the caller, as with mbed */
+	void wait()
+	{
+		_cond.wait(_mutex);
+	}
+
+	/* Returns true if the wait timed out */
+	bool wait_for(uint32_t millisec)
+	{
+		return _cond.wait_for(_mutex, std::chrono::milliseconds(millisec)) == std::cv_status::timeout;
+	}
+
+	void notify_one()
+	{
+		_cond.notify_one();
+	}
+
+	void notify_all()
+	{
+		_cond.notify_all();
+	}
+
+private:
+	Mutex &_mutex;
+	std::condition_variable_any _cond;
+};
+
+} // namespace rtos
+
+#endif
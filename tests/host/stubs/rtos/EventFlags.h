@@ -0,0 +1,82 @@
+/* Host stub of mbed's rtos/EventFlags.h, on a std::condition_variable */
+#ifndef HOST_STUB_RTOS_EVENTFLAGS_H_
+#define HOST_STUB_RTOS_EVENTFLAGS_H_
+
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "cmsis_os2.h"
+#include "platform/NonCopyable.h"
+
+namespace rtos {
+
+class EventFlags : private mbed::NonCopyable<EventFlags> {
+public:
+	EventFlags() : _flags(0) { }
+	EventFlags(const char *name) : _flags(0) { (void) name; }
+
+	/* Returns the flags after setting */
+	uint32_t set(uint32_t flags)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_flags |= flags;
+		_cond.notify_all();
+		return _flags;
+	}
+
+	/* Returns the flags before clearing */
+	uint32_t clear(uint32_t flags = 0x7fffffff)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		uint32_t previous = _flags;
+		_flags &= ~flags;
+		return previous;
+	}
+
+	uint32_t get() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _flags;
+	}
+
+	uint32_t wait_all(uint32_t flags = 0, uint32_t millisec = osWaitForever, bool clear = true)
+	{
+		return wait(flags, true, millisec, clear);
+	}
+
+	uint32_t wait_any(uint32_t flags = 0, uint32_t millisec = osWaitForever, bool clear = true)
+	{
+		return wait(flags, false, millisec, clear);
+	}
+
+private:
+	/* Returns the flags before clearing, osFlagsErrorTimeout if they were not set in time */
+	uint32_t wait(uint32_t flags, bool all, uint32_t millisec, bool clear)
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		auto ready = [this, flags, all]() {
+			return all ? ((_flags & flags) == flags) : ((_flags & flags) != 0);
+		};
+		if (millisec == osWaitForever) {
+			_cond.wait(lock, ready);
+		} else if (!_cond.wait_for(lock, std::chrono::milliseconds(millisec), ready)) {
+			return osFlagsErrorTimeout;
+		}
+
+		uint32_t result = _flags;
+		if (clear) {
+			_flags &= ~flags;
+		}
+		return result;
+	}
+
+	mutable std::mutex _mutex;
+	std::condition_variable _cond;
+	uint32_t _flags;
+};
+
+} // namespace rtos
+
+#endif
@@ -0,0 +1,21 @@
+/* Host stub of mbed's rtos/Kernel.h */
+#ifndef HOST_STUB_RTOS_KERNEL_H_
+#define HOST_STUB_RTOS_KERNEL_H_
+
+#include <stdint.h>
+#include <chrono>
+
+namespace rtos {
+namespace Kernel {
+
+/* Milliseconds of the host's monotonic clock */
+inline uint64_t get_ms_count()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace Kernel
+} // namespace rtos
+
+#endif
@@ -0,0 +1,37 @@
+/* Host stub of mbed's rtos/Mutex.h (recursive, like the RTX mutex) */
+#ifndef HOST_STUB_RTOS_MUTEX_H_
+#define HOST_STUB_RTOS_MUTEX_H_
+
+#include <mutex>
+
+#include "platform/NonCopyable.h"
+
+namespace rtos {
+
+class Mutex : private mbed::NonCopyable<Mutex> {
+public:
+	Mutex() { }
+	Mutex(const char *name) { (void) name; }
+
+	void lock()
+	{
+		_mutex.lock();
+	}
+
+	bool trylock()
+	{
+		return _mutex.try_lock();
+	}
+
+	void unlock()
+	{
+		_mutex.unlock();
+	}
+
+private:
+	std::recursive_mutex _mutex;
+};
+
+} // namespace rtos
+
+#endif
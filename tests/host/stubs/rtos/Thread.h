@@ -0,0 +1,55 @@
+/* Host stub of mbed's rtos/Thread.h, runs on a std::thread */
+#ifndef HOST_STUB_RTOS_THREAD_H_
+#define HOST_STUB_RTOS_THREAD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <thread>
+
+#include "cmsis_os2.h"
+#include "platform/Callback.h"
+#include "platform/NonCopyable.h"
+
+namespace rtos {
+
+class Thread : private mbed::NonCopyable<Thread> {
+public:
+	Thread(osPriority priority = osPriorityNormal, uint32_t stack_size = 0,
+			unsigned char *stack_mem = NULL, const char *name = NULL)
+	{
+		(void) priority;
+		(void) stack_size;
+		(void) stack_mem;
+		(void) name;
+	}
+
+	~Thread()
+	{
+		// mbed terminates the thread, the host can only wait for it
+		join();
+	}
+
+	osStatus start(mbed::Callback<void()> task)
+	{
+		if (_thread.joinable()) {
+			return osErrorParameter;
+		}
+		_thread = std::thread([task]() { task(); });
+		return osOK;
+	}
+
+	osStatus join()
+	{
+		if (_thread.joinable() && _thread.get_id() != std::this_thread::get_id()) {
+			_thread.join();
+		}
+		return osOK;
+	}
+
+private:
+	std::thread _thread;
+};
+
+} // namespace rtos
+
+#endif
@@ -0,0 +1,20 @@
+/* Host stub of uDisplay's DisplayInterface.h
+ *
+ * The signatures are uDisplay's: implementations whose signatures differ
+ * do not override them and cannot be instantiated.
+ */
+#ifndef HOST_STUB_UDISPLAY_DISPLAYINTERFACE_H_
+#define HOST_STUB_UDISPLAY_DISPLAYINTERFACE_H_
+
+#include <stdint.h>
+
+class DisplayInterface {
+public:
+	virtual ~DisplayInterface() { }
+
+	virtual void write_command(uint8_t command) = 0;
+
+	virtual void write_data(uint8_t *data, uint32_t length) = 0;
+};
+
+#endif
@@ -0,0 +1,57 @@
+/* Host stub of uDisplay's ST7789.h: the commands ST7789LVGL sends through it */
+#ifndef HOST_STUB_UDISPLAY_ST7789_H_
+#define HOST_STUB_UDISPLAY_ST7789_H_
+
+#include <stdint.h>
+
+#include "PinNames.h"
+#include "DisplayInterface.h"
+
+class ST7789Display {
+public:
+	ST7789Display(DisplayInterface &interface, PinName reset, PinName backlight = NC) :
+		_interface(interface)
+	{
+		(void) reset;
+		(void) backlight;
+	}
+
+	virtual ~ST7789Display() { }
+
+	void write_command(uint8_t command)
+	{
+		_interface.write_command(command);
+	}
+
+	void write_data(uint8_t *data, uint32_t length)
+	{
+		_interface.write_data(data, length);
+	}
+
+	void set_column_address(uint16_t start, uint16_t end)
+	{
+		write_address(0x2A, start, end);
+	}
+
+	void set_row_address(uint16_t start, uint16_t end)
+	{
+		write_address(0x2B, start, end);
+	}
+
+	void start_ram_write(void)
+	{
+		write_command(0x2C);
+	}
+
+private:
+	void write_address(uint8_t command, uint16_t start, uint16_t end)
+	{
+		uint8_t params[4] = { (uint8_t)(start >> 8), (uint8_t) start, (uint8_t)(end >> 8), (uint8_t) end };
+		write_command(command);
+		write_data(params, sizeof(params));
+	}
+
+	DisplayInterface &_interface;
+};
+
+#endif
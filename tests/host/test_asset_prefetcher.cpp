@@ -0,0 +1,362 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * AssetPrefetcher against a slow block device
+ *
+ * fopen is wrapped (-Wl,--wrap=fopen) so paths under "slow/" are served
+ * from memory by a stream that takes a fixed latency per 512-byte block,
+ * and that can be held closed to keep the worker busy. Checks that:
+ * - prefetch() does not wait on the device
+ * - prefetch_queue_depth requests fit in the queues, even when the GUI
+ *   thread only dispatches once all of them completed
+ * - the pending callback fires once per completion, after it is queued
+ * - requests still queued when the prefetcher is destroyed are freed
+ * - a screen transition reading its assets through the 'M' driver is
+ *   much faster once they were prefetched
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__SANITIZE_ADDRESS__)
+#include <sanitizer/lsan_interface.h>
+#endif
+
+#include "host_test.h"
+
+#include "platform/AssetCache.h"
+#include "platform/AssetPrefetcher.h"
+#include "platform/filesystem_wrapper.h"
+
+static const size_t DEPTH = MBED_CONF_MBED_LVGL_PREFETCH_QUEUE_DEPTH;
+static const size_t FILE_SIZE = 2048;
+static const size_t BLOCK_SIZE = 512;
+
+/** The fake block device */
+static struct {
+	std::mutex mutex;
+	std::condition_variable changed;
+	bool open;						/** Reads block while false */
+	uint32_t latency_us;			/** Per block read */
+	std::atomic<unsigned> reads_started;
+	std::atomic<unsigned> files_closed;
+} device;
+
+static void device_reset(bool open, uint32_t latency_us)
+{
+	std::lock_guard<std::mutex> lock(device.mutex);
+	device.open = open;
+	device.latency_us = latency_us;
+	device.reads_started = 0;
+	device.files_closed = 0;
+}
+
+static void device_open(void)
+{
+	std::lock_guard<std::mutex> lock(device.mutex);
+	device.open = true;
+	device.changed.notify_all();
+}
+
+typedef struct {
+	char fill;
+	size_t pos;
+} fake_file_t;
+
+static ssize_t fake_read(void* cookie, char* buf, size_t size)
+{
+	fake_file_t* file = (fake_file_t*) cookie;
+
+	device.reads_started++;
+	{
+		std::unique_lock<std::mutex> lock(device.mutex);
+		device.changed.wait(lock, []() { return device.open; });
+	}
+
+	size_t left = FILE_SIZE - file->pos;
+	if(size > left) {
+		size = left;
+	}
+	size_t blocks = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	std::this_thread::sleep_for(std::chrono::microseconds(blocks * device.latency_us));
+
+	memset(buf, file->fill, size);
+	file->pos += size;
+	return (ssize_t) size;
+}
+
+static int fake_seek(void* cookie, off64_t* offset, int whence)
+{
+	fake_file_t* file = (fake_file_t*) cookie;
+	off64_t base = (whence == SEEK_SET) ? 0 : (whence == SEEK_CUR) ? (off64_t) file->pos : (off64_t) FILE_SIZE;
+	file->pos = (size_t)(base + *offset);
+	*offset = (off64_t) file->pos;
+	return 0;
+}
+
+static int fake_close(void* cookie)
+{
+	delete (fake_file_t*) cookie;
+	device.files_closed++;
+	return 0;
+}
+
+extern "C" FILE* __real_fopen(const char* path, const char* mode);
+
+extern "C" FILE* __wrap_fopen(const char* path, const char* mode)
+{
+	if(strncmp(path, "slow/", 5) != 0) {
+		return __real_fopen(path, mode);
+	}
+
+	fake_file_t* file = new fake_file_t;
+	file->fill = path[strlen(path) - 1];
+	file->pos = 0;
+
+	cookie_io_functions_t io = { fake_read, NULL, fake_seek, fake_close };
+	return fopencookie(file, mode, io);
+}
+
+/** Completion callbacks seen by the GUI thread */
+static unsigned completions;
+static unsigned successes;
+
+static void on_complete(const char* path, bool success)
+{
+	(void) path;
+	completions++;
+	if(success) {
+		successes++;
+	}
+}
+
+static bool wait_for(std::function<bool()> condition, uint32_t timeout_ms)
+{
+	uint64_t deadline = host_time_ns() + (uint64_t) timeout_ms * 1000000ull;
+	while(!condition()) {
+		if(host_time_ns() > deadline) {
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return true;
+}
+
+static void test_prefetch_does_not_wait_for_the_device(void)
+{
+	device_reset(true, 20000);
+	completions = successes = 0;
+
+	AssetCache cache(DEPTH * FILE_SIZE, DEPTH);
+	AssetPrefetcher prefetcher(cache);
+
+	uint64_t start = host_time_ns();
+	HOST_CHECK(prefetcher.prefetch("M:/slow/a", on_complete));
+	uint64_t elapsed_us = (host_time_ns() - start) / 1000;
+
+	// Reading the file takes 4 blocks of 20ms
+	HOST_CHECK(elapsed_us < 20000);
+
+	// Nothing is delivered before the GUI thread dispatches
+	HOST_CHECK(wait_for([]() { return device.files_closed == 1; }, 5000));
+	HOST_CHECK_EQUAL(0, completions);
+
+	HOST_CHECK(wait_for([&prefetcher]() { prefetcher.dispatch(); return completions == 1; }, 5000));
+	HOST_CHECK_EQUAL(1, successes);
+	HOST_CHECK(cache.contains("slow/a"));
+	HOST_CHECK_EQUAL(FILE_SIZE, cache.get_used_bytes());
+}
+
+static void test_queue_depth_requests_fit(void)
+{
+	device_reset(false, 100);
+	completions = successes = 0;
+
+	AssetCache cache(DEPTH * FILE_SIZE, DEPTH);
+	AssetPrefetcher prefetcher(cache);
+
+	// The worker holds the first request until the device opens, so all
+	// of them are in the worker's queue at once
+	char path[16];
+	for(size_t i = 0; i < DEPTH; i++) {
+		snprintf(path, sizeof(path), "M:/slow/%c", (char)('a' + i));
+		HOST_CHECK(prefetcher.prefetch(path, on_complete));
+	}
+	HOST_CHECK(!prefetcher.prefetch("M:/slow/z", on_complete));
+
+	// And all of their completions wait in the GUI queue
+	device_open();
+	HOST_CHECK(wait_for([]() { return device.files_closed == DEPTH; }, 5000));
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+	prefetcher.dispatch();
+	HOST_CHECK_EQUAL(DEPTH, completions);
+	HOST_CHECK_EQUAL(DEPTH, successes);
+	HOST_CHECK_EQUAL(DEPTH * FILE_SIZE, cache.get_used_bytes());
+}
+
+static std::atomic<unsigned> pending;
+
+static void on_pending(void)
+{
+	pending++;
+}
+
+static void test_pending_callback_signals_each_completion(void)
+{
+	device_reset(true, 100);
+	completions = successes = 0;
+	pending = 0;
+
+	AssetCache cache(DEPTH * FILE_SIZE, DEPTH);
+	AssetPrefetcher prefetcher(cache);
+	prefetcher.set_pending_callback(on_pending);
+
+	HOST_CHECK(prefetcher.prefetch("M:/slow/a", on_complete));
+	HOST_CHECK(prefetcher.prefetch("M:/slow/b", on_complete));
+
+	// Once signalled, a single dispatch delivers everything that was signalled
+	HOST_CHECK(wait_for([]() { return pending == 2; }, 5000));
+	prefetcher.dispatch();
+	HOST_CHECK_EQUAL(2, completions);
+	HOST_CHECK_EQUAL(2, successes);
+}
+
+static void test_destruction_frees_queued_requests(void)
+{
+	device_reset(false, 100);
+	completions = successes = 0;
+
+	std::thread opener;
+	{
+		AssetCache cache(DEPTH * FILE_SIZE, DEPTH);
+		AssetPrefetcher prefetcher(cache);
+
+		char path[16];
+		for(size_t i = 0; i < DEPTH; i++) {
+			snprintf(path, sizeof(path), "M:/slow/%c", (char)('a' + i));
+			HOST_CHECK(prefetcher.prefetch(path, on_complete));
+		}
+		HOST_CHECK(wait_for([]() { return device.reads_started == 1; }, 5000));
+
+		// Let the worker finish the request it holds while the prefetcher
+		// is being destroyed, the rest stays queued
+		opener = std::thread([]() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			device_open();
+		});
+	}
+	opener.join();
+
+	// No callbacks ran and nothing was leaked
+	HOST_CHECK_EQUAL(0, completions);
+#if defined(__SANITIZE_ADDRESS__)
+	HOST_CHECK_EQUAL(0, __lsan_do_recoverable_leak_check());
+#endif
+}
+
+/** The cache the 'M' driver serves files from, as set up by LittlevGL::init_fs */
+static AssetCache* fs_cache;
+
+static bool fs_cache_acquire(const char* fn, const uint8_t** data, uint32_t* size)
+{
+	return fs_cache->acquire(fn, data, size);
+}
+
+static void fs_cache_release(const uint8_t* data)
+{
+	fs_cache->release(data);
+}
+
+/** Opens and reads assets the way a screen transition loads its images, in microseconds */
+static uint64_t load_assets(const char* const* paths, size_t count)
+{
+	static uint8_t buf[FILE_SIZE];
+
+	uint64_t start = host_time_ns();
+	for(size_t i = 0; i < count; i++) {
+		lv_fs_file_t file;
+		HOST_CHECK_EQUAL(LV_FS_RES_OK, lv_fs_open(&file, paths[i], LV_FS_MODE_RD));
+		uint32_t br = 0;
+		HOST_CHECK_EQUAL(LV_FS_RES_OK, lv_fs_read(&file, buf, sizeof(buf), &br));
+		HOST_CHECK_EQUAL(FILE_SIZE, br);
+		HOST_CHECK_EQUAL(paths[i][strlen(paths[i]) - 1], buf[FILE_SIZE - 1]);
+		lv_fs_close(&file);
+	}
+	return (host_time_ns() - start) / 1000;
+}
+
+static void test_prefetched_transition_is_faster(void)
+{
+	device_reset(true, 2000);
+	completions = successes = 0;
+
+	AssetCache cache(DEPTH * FILE_SIZE, DEPTH);
+	AssetPrefetcher prefetcher(cache);
+
+	lv_fs_stub_reset();
+	lv_fs_drv_t drv;
+	lv_fs_drv_init(&drv);
+	mbed_lvgl_fs_wrapper_default(&drv);
+	drv.letter = 'M';
+	lv_fs_drv_register(&drv);
+	fs_cache = &cache;
+	mbed_lvgl_fs_wrapper_set_cache(fs_cache_acquire, fs_cache_release);
+
+	static const char* const assets[] = { "M:/slow/a", "M:/slow/b", "M:/slow/c", "M:/slow/d" };
+	static const size_t count = sizeof(assets) / sizeof(assets[0]);
+
+	// Straight from the device: 4 files of 4 blocks of 2ms
+	uint64_t cold_us = load_assets(assets, count);
+	HOST_CHECK_EQUAL(count, device.files_closed);
+
+	// Prefetched while the previous screen was shown
+	for(size_t i = 0; i < count; i++) {
+		HOST_CHECK(prefetcher.prefetch(assets[i], on_complete));
+	}
+	HOST_CHECK(wait_for([&prefetcher]() { prefetcher.dispatch(); return completions == count; }, 5000));
+	HOST_CHECK_EQUAL(count, successes);
+
+	unsigned reads = device.reads_started;
+	uint64_t prefetched_us = load_assets(assets, count);
+	HOST_CHECK_EQUAL(reads, device.reads_started);
+
+	printf("  transition: %llu us cold, %llu us prefetched\n",
+			(unsigned long long) cold_us, (unsigned long long) prefetched_us);
+	HOST_CHECK(cold_us >= count * 4 * 2000);
+	HOST_CHECK(prefetched_us * 10 < cold_us);
+
+	mbed_lvgl_fs_wrapper_set_cache(NULL, NULL);
+	lv_fs_stub_reset();
+}
+
+int main(void)
+{
+	HOST_TEST_RUN(test_prefetch_does_not_wait_for_the_device);
+	HOST_TEST_RUN(test_queue_depth_requests_fit);
+	HOST_TEST_RUN(test_pending_callback_signals_each_completion);
+	HOST_TEST_RUN(test_destruction_frees_queued_requests);
+	HOST_TEST_RUN(test_prefetched_transition_is_faster);
+	return host_test_result();
+}
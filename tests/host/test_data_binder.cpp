@@ -0,0 +1,174 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * DataBinder coalescing values published between refreshes
+ *
+ * Checks that:
+ * - many values published between two refreshes are applied once, the
+ *   latest one, to a label and to a custom binding
+ * - a refresh with nothing published applies nothing, a value equal to
+ *   the one applied is counted as unchanged
+ * - values published by another thread while the GUI refreshes are all
+ *   counted, and the last one ends up applied
+ */
+
+#include <string.h>
+
+#include <atomic>
+#include <thread>
+
+#include "host_test.h"
+
+#include "LittlevGL.h"
+#include "lv_label.h"
+#include "widgets/DataBinder.h"
+
+static const int32_t VALUES = 1000;
+
+static lv_color_t draw_buffer[LV_HOR_RES_MAX * 10];
+
+class NullDriver : public LVGLDisplayDriver
+{
+	public:
+
+		NullDriver() : LVGLDisplayDriver(mbed::Span<lv_color_t>(draw_buffer, sizeof(draw_buffer) / sizeof(draw_buffer[0]))) {
+		}
+
+		virtual void flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p) {
+			(void) area;
+			(void) color_p;
+			lv_disp_flush_ready(disp_drv);
+		}
+};
+
+static uint32_t apply_calls;
+static int32_t applied_value;
+
+static void apply_value(lv_obj_t* obj, int32_t value)
+{
+	(void) obj;
+	apply_calls++;
+	applied_value = value;
+}
+
+/** Runs the display's refresh task, frame hooks included */
+static void refresh(void)
+{
+	lv_disp_t* disp = lv_disp_get_default();
+	disp->refr_task->task_cb(disp->refr_task);
+}
+
+static void test_latest_value_applied_once(void)
+{
+	DataBinder binder;
+	lv_obj_t* label = lv_label_create(lv_scr_act(), NULL);
+	int label_id = binder.bind_label(label, "%d rpm");
+	int custom_id = binder.bind(lv_scr_act(), apply_value);
+	HOST_CHECK(label_id >= 0);
+	HOST_CHECK(custom_id >= 0 && custom_id != label_id);
+	apply_calls = 0;
+
+	for(int32_t i = 1; i <= VALUES; i++) {
+		binder.publish(label_id, i);
+		binder.publish(custom_id, -i);
+	}
+	refresh();
+
+	HOST_CHECK_EQUAL(1, apply_calls);
+	HOST_CHECK_EQUAL(-VALUES, applied_value);
+	HOST_CHECK(strcmp(lv_label_get_text(label), "1000 rpm") == 0);
+	const DataBinder::stats_t& stats = binder.get_stats();
+	HOST_CHECK_EQUAL(2 * VALUES, stats.published);
+	HOST_CHECK_EQUAL(2, stats.applied);
+	HOST_CHECK_EQUAL(0, stats.unchanged);
+
+	// Nothing published
+	refresh();
+	HOST_CHECK_EQUAL(1, apply_calls);
+	HOST_CHECK_EQUAL(2, stats.applied);
+
+	// Back to the value applied
+	binder.publish(custom_id, 5);
+	binder.publish(custom_id, -VALUES);
+	refresh();
+	HOST_CHECK_EQUAL(1, apply_calls);
+	HOST_CHECK_EQUAL(2 * VALUES + 2, stats.published);
+	HOST_CHECK_EQUAL(2, stats.applied);
+	HOST_CHECK_EQUAL(1, stats.unchanged);
+
+	binder.publish(custom_id, 7);
+	refresh();
+	HOST_CHECK_EQUAL(2, apply_calls);
+	HOST_CHECK_EQUAL(7, applied_value);
+	HOST_CHECK_EQUAL(3, stats.applied);
+
+	binder.reset_stats();
+	HOST_CHECK_EQUAL(0, stats.published);
+	HOST_CHECK_EQUAL(0, stats.applied);
+
+	binder.unbind(label_id);
+	binder.unbind(custom_id);
+	lv_obj_del(label);
+}
+
+static void test_producer_thread(void)
+{
+	DataBinder binder;
+	int id = binder.bind(lv_scr_act(), apply_value);
+	apply_calls = 0;
+
+	std::atomic<bool> done(false);
+	std::thread producer([&binder, &done, id]() {
+		for(int32_t i = 1; i <= VALUES * 10; i++) {
+			binder.publish(id, i);
+		}
+		done = true;
+	});
+
+	uint32_t refreshes = 0;
+	while(!done) {
+		refresh();
+		refreshes++;
+		std::this_thread::yield();
+	}
+	producer.join();
+	refresh();
+	refreshes++;
+
+	const DataBinder::stats_t& stats = binder.get_stats();
+	HOST_CHECK_EQUAL(VALUES * 10, stats.published);
+	HOST_CHECK_EQUAL(VALUES * 10, applied_value);
+	HOST_CHECK_EQUAL(apply_calls, stats.applied);
+	HOST_CHECK(stats.applied <= refreshes);
+	HOST_CHECK_EQUAL(0, stats.unchanged);
+
+	binder.unbind(id);
+}
+
+int main(void)
+{
+	LittlevGL& lvgl = LittlevGL::get_instance();
+	lvgl.init();
+	NullDriver driver;
+	lvgl.add_display_driver(driver);
+	lvgl.set_default_display(driver);
+
+	HOST_TEST_RUN(test_latest_value_applied_once);
+	HOST_TEST_RUN(test_producer_thread);
+	return host_test_result();
+}
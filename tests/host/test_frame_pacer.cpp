@@ -0,0 +1,214 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * LVGLFramePacer's modes, fed with frame costs the way lvgl's monitor
+ * callback reports them
+ *
+ * The refresh task runs once per applied period (the stub's tick is
+ * advanced by it), so the dropped frame count follows the period. Checks:
+ * - a single slow frame is absorbed by the average
+ * - NOMINAL to STRETCHED to DEGRADED as frames get more expensive, the
+ *   period staying a multiple of the nominal one, at most pacing_max_period
+ * - costs between half and 90% of the period change nothing (hysteresis)
+ * - DEGRADED to STRETCHED to NOMINAL once frames are cheap, only after
+ *   enough cheap frames, with antialiasing and effects restored
+ * - disabling the pacer goes back to the nominal period at once
+ */
+
+#include "host_test.h"
+
+#include "lv_obj.h"
+#include "lv_hal_disp.h"
+#include "LVGLFramePacer.h"
+
+static const uint32_t NOMINAL = LV_DISP_DEF_REFR_PERIOD;
+static const uint32_t MAX_PERIOD = MBED_CONF_MBED_LVGL_PACING_MAX_PERIOD;
+
+static lv_color_t strip[LV_HOR_RES_MAX * 10];
+
+static void flush(lv_disp_drv_t* drv, const lv_area_t* area, lv_color_t* color_p)
+{
+	(void) area;
+	(void) color_p;
+	lv_disp_flush_ready(drv);
+}
+
+static lv_disp_t* init_display(void)
+{
+	static lv_disp_buf_t disp_buf;
+
+	lv_init();
+	lv_disp_buf_init(&disp_buf, strip, NULL, sizeof(strip) / sizeof(strip[0]));
+	lv_disp_drv_t drv;
+	lv_disp_drv_init(&drv);
+	drv.buffer = &disp_buf;
+	drv.flush_cb = flush;
+	return lv_disp_drv_register(&drv);
+}
+
+/** Degrade callback calls */
+static int degrade_calls;
+static bool effects_degraded;
+
+static void on_degrade(lv_disp_t* disp, bool degraded)
+{
+	(void) disp;
+	degrade_calls++;
+	effects_degraded = degraded;
+}
+
+/** One refresh: the task runs once its period elapsed, then the frame costs cost_ms */
+static void run_frame(LVGLFramePacer& pacer, lv_disp_t* disp, uint32_t cost_ms)
+{
+	lv_tick_inc(disp->refr_task->period);
+	pacer.before_refresh(disp->refr_task);
+	pacer.frame_done(disp, cost_ms);
+}
+
+/** Runs frames of the same cost until the mode changes, returns how many it took */
+static int frames_until_mode_change(LVGLFramePacer& pacer, lv_disp_t* disp, uint32_t cost_ms, int limit)
+{
+	LVGLFramePacer::mode_t mode = pacer.get_mode();
+	for(int i = 1; i <= limit; i++) {
+		run_frame(pacer, disp, cost_ms);
+		if(pacer.get_mode() != mode) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static void test_modes_and_hysteresis(void)
+{
+	lv_disp_t* disp = init_display();
+	LVGLFramePacer pacer;
+	pacer.set_enabled(true);
+	pacer.set_degrade_callback(on_degrade);
+	degrade_calls = 0;
+	effects_degraded = false;
+
+	// Cheap frames, and a single slow one, stay at the nominal period
+	for(int i = 0; i < 20; i++) {
+		run_frame(pacer, disp, 10);
+	}
+	run_frame(pacer, disp, 2 * NOMINAL);
+	for(int i = 0; i < 5; i++) {
+		run_frame(pacer, disp, 10);
+	}
+	HOST_CHECK_EQUAL(LVGLFramePacer::PACING_NOMINAL, pacer.get_mode());
+	HOST_CHECK_EQUAL(NOMINAL, disp->refr_task->period);
+	HOST_CHECK_EQUAL(0, pacer.get_dropped_frames());
+
+	// Over budget: the period is stretched to twice the nominal one
+	HOST_CHECK(frames_until_mode_change(pacer, disp, NOMINAL + 10, 50) > 0);
+	HOST_CHECK_EQUAL(LVGLFramePacer::PACING_STRETCHED, pacer.get_mode());
+	HOST_CHECK_EQUAL(2 * NOMINAL, pacer.get_period());
+	run_frame(pacer, disp, NOMINAL + 10);
+	HOST_CHECK_EQUAL(2 * NOMINAL, disp->refr_task->period);
+
+	// Between half and 90% of the period nothing changes
+	for(int i = 0; i < 200; i++) {
+		run_frame(pacer, disp, NOMINAL + 10);
+	}
+	HOST_CHECK_EQUAL(LVGLFramePacer::PACING_STRETCHED, pacer.get_mode());
+	HOST_CHECK_EQUAL(2 * NOMINAL, pacer.get_period());
+
+	// Each refresh now stands for two nominal frames, one of them dropped
+	pacer.reset_stats();
+	for(int i = 0; i < 10; i++) {
+		run_frame(pacer, disp, NOMINAL + 10);
+	}
+	HOST_CHECK_EQUAL(10, pacer.get_frames());
+	HOST_CHECK_EQUAL(10, pacer.get_dropped_frames());
+
+	// Frames that don't fit any period up to the maximum clamp the period to
+	// it first, then degrade effects
+	HOST_CHECK(disp->driver.antialiasing);
+	for(int i = 0; i < 50 && pacer.get_mode() != LVGLFramePacer::PACING_DEGRADED; i++) {
+		run_frame(pacer, disp, 2 * MAX_PERIOD);
+		HOST_CHECK(pacer.get_period() <= MAX_PERIOD);
+		HOST_CHECK_EQUAL(0, pacer.get_period() % NOMINAL);
+	}
+	HOST_CHECK_EQUAL(LVGLFramePacer::PACING_DEGRADED, pacer.get_mode());
+	HOST_CHECK_EQUAL((MAX_PERIOD / NOMINAL) * NOMINAL, pacer.get_period());
+	HOST_CHECK(!disp->driver.antialiasing);
+	HOST_CHECK_EQUAL(1, degrade_calls);
+	HOST_CHECK(effects_degraded);
+
+	// Staying over budget doesn't stretch or degrade any further
+	for(int i = 0; i < 50; i++) {
+		run_frame(pacer, disp, 2 * MAX_PERIOD);
+	}
+	HOST_CHECK(pacer.get_period() <= MAX_PERIOD);
+	HOST_CHECK_EQUAL((MAX_PERIOD / NOMINAL) * NOMINAL, disp->refr_task->period);
+	HOST_CHECK_EQUAL(1, degrade_calls);
+
+	// Cheap frames undo the steps in reverse order, each after enough of them
+	int frames = frames_until_mode_change(pacer, disp, 5, 200);
+	HOST_CHECK(frames >= 30);
+	HOST_CHECK_EQUAL(LVGLFramePacer::PACING_STRETCHED, pacer.get_mode());
+	HOST_CHECK(disp->driver.antialiasing);
+	HOST_CHECK_EQUAL(2, degrade_calls);
+	HOST_CHECK(!effects_degraded);
+
+	frames = frames_until_mode_change(pacer, disp, 5, 500);
+	HOST_CHECK(frames >= 30 * (int)((MAX_PERIOD / NOMINAL) - 1));
+	HOST_CHECK_EQUAL(LVGLFramePacer::PACING_NOMINAL, pacer.get_mode());
+	HOST_CHECK_EQUAL(NOMINAL, pacer.get_period());
+	run_frame(pacer, disp, 5);
+	HOST_CHECK_EQUAL(NOMINAL, disp->refr_task->period);
+
+	// No frames dropped at the nominal period
+	pacer.reset_stats();
+	for(int i = 0; i < 10; i++) {
+		run_frame(pacer, disp, 5);
+	}
+	HOST_CHECK_EQUAL(0, pacer.get_dropped_frames());
+
+	lv_disp_remove(disp);
+}
+
+static void test_disable_restores_nominal(void)
+{
+	lv_disp_t* disp = init_display();
+	LVGLFramePacer pacer;
+	pacer.set_enabled(true);
+	degrade_calls = 0;
+
+	for(int i = 0; i < 100 && pacer.get_mode() != LVGLFramePacer::PACING_DEGRADED; i++) {
+		run_frame(pacer, disp, 2 * MAX_PERIOD);
+	}
+	HOST_CHECK_EQUAL(LVGLFramePacer::PACING_DEGRADED, pacer.get_mode());
+	HOST_CHECK(!disp->driver.antialiasing);
+
+	pacer.set_enabled(false);
+	HOST_CHECK_EQUAL(NOMINAL, pacer.get_period());
+	run_frame(pacer, disp, 2 * MAX_PERIOD);
+	HOST_CHECK_EQUAL(LVGLFramePacer::PACING_NOMINAL, pacer.get_mode());
+	HOST_CHECK(disp->driver.antialiasing);
+	HOST_CHECK_EQUAL(0, degrade_calls);
+
+	lv_disp_remove(disp);
+}
+
+int main(void)
+{
+	HOST_TEST_RUN(test_modes_and_hysteresis);
+	HOST_TEST_RUN(test_disable_restores_nominal);
+	return host_test_result();
+}
@@ -0,0 +1,211 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * LittlevGL's idle parking, through update() as the GUI thread calls it
+ *
+ * A helper thread plays the interrupt calling wake() once the GUI is
+ * parked, or after a while, so a test that wrongly parks fails instead of
+ * hanging. Checks that:
+ * - the GUI doesn't park while a display has invalid areas, an animation
+ *   runs or there was recent input, nor before the idle timeout
+ * - it parks until wake(), or until the next application task is due
+ * - lvgl's tick catches up with the time parked only when LittlevGL's
+ *   ticker drives it, an application driving the tick keeps it
+ * - get_idle_time() and get_idle_count() add up the parks
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "host_test.h"
+
+#include "LittlevGL.h"
+#include "lv_hal_tick.h"
+
+static const uint32_t IDLE_TIMEOUT = 50;
+
+static lv_color_t draw_buffer[LV_HOR_RES_MAX * 10];
+
+class NullDriver : public LVGLDisplayDriver
+{
+	public:
+
+		NullDriver() : LVGLDisplayDriver(mbed::Span<lv_color_t>(draw_buffer, sizeof(draw_buffer) / sizeof(draw_buffer[0]))) {
+		}
+
+		virtual void flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p) {
+			(void) area;
+			(void) color_p;
+			lv_disp_flush_ready(disp_drv);
+		}
+};
+
+static void sleep_ms(uint32_t ms)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+/**
+ * Calls update(), a helper thread wakes the GUI wake_after_ms after it parked
+ *
+ * @retval true if update() parked the GUI
+ */
+static bool update_parks(LittlevGL& lvgl, uint32_t wake_after_ms = 20)
+{
+	uint32_t count = lvgl.get_idle_count();
+	std::atomic<bool> done(false);
+	std::thread waker([&lvgl, &done, wake_after_ms]() {
+		// Give up waiting after a while, update() doesn't return otherwise
+		for(uint32_t i = 0; i < 2000 && !done && lvgl.get_idle_state() != LittlevGL::IDLE_PARKED; i++) {
+			sleep_ms(1);
+		}
+		for(uint32_t i = 0; i < wake_after_ms && !done; i++) {
+			sleep_ms(1);
+		}
+		if(!done) {
+			lvgl.wake();
+		}
+	});
+
+	lvgl.update();
+	done = true;
+	waker.join();
+	return lvgl.get_idle_count() != count;
+}
+
+/** Lets the idle timeout elapse with nothing to do */
+static void settle(void)
+{
+	lv_tick_inc(IDLE_TIMEOUT);
+}
+
+static void app_task(lv_task_t* task)
+{
+	(void) task;
+}
+
+static void test_busy_gui_doesnt_park(void)
+{
+	LittlevGL& lvgl = LittlevGL::get_instance();
+	lv_disp_t* disp = lv_disp_get_default();
+
+	// Redrawn areas: keep the refresh task from clearing them
+	lv_obj_invalidate(lv_scr_act());
+	disp->refr_task->prio = LV_TASK_PRIO_OFF;
+	settle();
+	HOST_CHECK(disp->inv_p != 0);
+	HOST_CHECK(!update_parks(lvgl));
+	HOST_CHECK_EQUAL(LittlevGL::IDLE_ACTIVE, lvgl.get_idle_state());
+	disp->refr_task->prio = LV_TASK_PRIO_MID;
+	lv_tick_inc(LV_DISP_DEF_REFR_PERIOD);
+	HOST_CHECK(!update_parks(lvgl));
+	HOST_CHECK_EQUAL(0, disp->inv_p);
+
+	// Not before the idle timeout since the GUI was last busy
+	lv_tick_inc(IDLE_TIMEOUT - LV_DISP_DEF_REFR_PERIOD - 1);
+	HOST_CHECK(!update_parks(lvgl));
+
+	// A running animation
+	settle();
+	lv_anim_stub_running = 1;
+	HOST_CHECK(!update_parks(lvgl));
+	lv_anim_stub_running = 0;
+
+	// Recent input
+	settle();
+	lv_disp_trig_activity(NULL);
+	HOST_CHECK(!update_parks(lvgl));
+	lv_tick_inc(IDLE_TIMEOUT - 1);
+	HOST_CHECK(!update_parks(lvgl));
+
+	HOST_CHECK_EQUAL(0, lvgl.get_idle_count());
+	HOST_CHECK_EQUAL(0, lvgl.get_idle_time());
+}
+
+static void test_park_until_woken(void)
+{
+	LittlevGL& lvgl = LittlevGL::get_instance();
+	settle();
+	uint32_t tick = lv_tick_get();
+	uint64_t start = host_time_ns();
+	HOST_CHECK(update_parks(lvgl, 100));
+	uint64_t parked_ms = (host_time_ns() - start) / 1000000;
+
+	HOST_CHECK(parked_ms >= 100);
+	HOST_CHECK_EQUAL(LittlevGL::IDLE_ACTIVE, lvgl.get_idle_state());
+	HOST_CHECK_EQUAL(1, lvgl.get_idle_count());
+	HOST_CHECK(lvgl.get_idle_time() >= 100 && lvgl.get_idle_time() <= (parked_ms + 1));
+
+	// The application drives the tick, it isn't advanced behind its back
+	HOST_CHECK_EQUAL(tick, lv_tick_get());
+
+	// Just woken up: the idle timeout starts over
+	HOST_CHECK(!update_parks(lvgl));
+}
+
+static void test_park_until_application_task(void)
+{
+	LittlevGL& lvgl = LittlevGL::get_instance();
+	settle();
+	lv_task_t* task = lv_task_create(app_task, 150, LV_TASK_PRIO_MID, NULL);
+	uint64_t idle_time = lvgl.get_idle_time();
+
+	// Woken up by nobody: the park ends when the task is due
+	uint64_t start = host_time_ns();
+	HOST_CHECK(update_parks(lvgl, 5000));
+	uint64_t parked_ms = (host_time_ns() - start) / 1000000;
+	HOST_CHECK(parked_ms >= 150 && parked_ms < 2000);
+	HOST_CHECK_EQUAL(2, lvgl.get_idle_count());
+	HOST_CHECK(lvgl.get_idle_time() - idle_time >= 150);
+
+	lv_task_del(task);
+}
+
+static void test_tick_catches_up(void)
+{
+	LittlevGL& lvgl = LittlevGL::get_instance();
+	// LittlevGL's ticker drives the tick: it is stopped while parked, and
+	// the tick advanced by the time parked
+	lvgl.start();
+	settle();
+	uint32_t tick = lv_tick_get();
+	uint64_t idle_time = lvgl.get_idle_time();
+	HOST_CHECK(update_parks(lvgl, 200));
+	uint32_t parked = (uint32_t)(lvgl.get_idle_time() - idle_time);
+	HOST_CHECK(parked >= 200);
+	HOST_CHECK(lv_tick_elaps(tick) >= parked);
+	HOST_CHECK_EQUAL(3, lvgl.get_idle_count());
+	lvgl.stop();
+}
+
+int main(void)
+{
+	LittlevGL& lvgl = LittlevGL::get_instance();
+	lvgl.init();
+	NullDriver driver;
+	lvgl.add_display_driver(driver);
+	lvgl.set_default_display(driver);
+	lvgl.set_idle_parking(true, IDLE_TIMEOUT);
+
+	HOST_TEST_RUN(test_busy_gui_doesnt_park);
+	HOST_TEST_RUN(test_park_until_woken);
+	HOST_TEST_RUN(test_park_until_application_task);
+	HOST_TEST_RUN(test_tick_catches_up);
+	return host_test_result();
+}
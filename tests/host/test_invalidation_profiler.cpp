@@ -0,0 +1,173 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * InvalidationProfiler registered as a frame hook of LittlevGL
+ *
+ * A panel holding a label and an indicator filling a box is invalidated
+ * over a few frames. Checks that:
+ * - each invalidation goes to the smallest object enclosing its area, with
+ *   its pixels, the worst offenders first
+ * - attribution is geometric: an area spanning two objects goes to their
+ *   container, and a child filling its parent is blamed for the parent
+ * - the heatmap counts the frames that redrew each cell, and nothing else
+ */
+
+#include <string.h>
+
+#include "host_test.h"
+
+#include "LittlevGL.h"
+#include "lv_label.h"
+#include "lv_refr.h"
+#include "platform/InvalidationProfiler.h"
+
+static const uint8_t CELL_SIZE = 8;
+
+static lv_color_t draw_buffer[LV_HOR_RES_MAX * 10];
+
+class NullDriver : public LVGLDisplayDriver
+{
+	public:
+
+		NullDriver() : LVGLDisplayDriver(mbed::Span<lv_color_t>(draw_buffer, sizeof(draw_buffer) / sizeof(draw_buffer[0]))) {
+		}
+
+		virtual void flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p) {
+			(void) area;
+			(void) color_p;
+			lv_disp_flush_ready(disp_drv);
+		}
+};
+
+/** Runs the display's refresh task, frame hooks included */
+static void refresh(void)
+{
+	lv_disp_t* disp = lv_disp_get_default();
+	disp->refr_task->task_cb(disp->refr_task);
+}
+
+static const InvalidationProfiler::entry_t* find_entry(const InvalidationProfiler::entry_t* entries,
+		size_t count, lv_obj_t* obj)
+{
+	for(size_t i = 0; i < count; i++) {
+		if(entries[i].obj == obj) {
+			return &entries[i];
+		}
+	}
+	return NULL;
+}
+
+static void invalidate_area(lv_coord_t x1, lv_coord_t y1, lv_coord_t x2, lv_coord_t y2)
+{
+	lv_area_t area;
+	lv_area_set(&area, x1, y1, x2, y2);
+	lv_inv_area(lv_disp_get_default(), &area);
+}
+
+static void test_attribution_and_heatmap(void)
+{
+	LittlevGL& lvgl = LittlevGL::get_instance();
+	lvgl.init();
+	NullDriver driver;
+	lvgl.add_display_driver(driver);
+	lvgl.set_default_display(driver);
+
+	InvalidationProfiler profiler(driver, CELL_SIZE);
+	lvgl.add_frame_hook(profiler);
+
+	lv_obj_t* panel = lv_obj_create(lv_scr_act(), NULL);
+	lv_obj_set_pos(panel, 16, 16);
+	lv_obj_set_size(panel, 200, 100);
+
+	lv_obj_t* label = lv_label_create(panel, NULL);
+	lv_label_set_text(label, "42");
+	lv_obj_set_pos(label, 8, 8);
+
+	lv_obj_t* box = lv_obj_create(lv_scr_act(), NULL);
+	lv_obj_set_pos(box, 240, 160);
+	lv_obj_set_size(box, 64, 32);
+	lv_obj_t* indicator = lv_obj_create(box, NULL);
+	lv_obj_set_pos(indicator, 0, 0);
+	lv_obj_set_size(indicator, 64, 32);
+
+	refresh();
+	profiler.reset();
+
+	// The label changes every frame, the box every other frame
+	for(int frame = 0; frame < 6; frame++) {
+		lv_obj_invalidate(label);
+		if((frame % 2) == 0) {
+			lv_obj_invalidate(box);
+		}
+		refresh();
+	}
+
+	// Spanning the label and the panel's empty part: the panel's
+	lv_area_t label_area;
+	lv_obj_get_coords(label, &label_area);
+	invalidate_area(label_area.x1, label_area.y1, label_area.x2 + 50, label_area.y2);
+	refresh();
+
+	HOST_CHECK_EQUAL(7, profiler.get_frames());
+	HOST_CHECK_EQUAL(0, profiler.get_unattributed_pixels());
+
+	InvalidationProfiler::entry_t entries[MBED_CONF_MBED_LVGL_INVALIDATION_PROFILER_SLOTS];
+	size_t count = profiler.get_entries(entries, MBED_CONF_MBED_LVGL_INVALIDATION_PROFILER_SLOTS);
+	HOST_CHECK_EQUAL(3, count);
+	for(size_t i = 1; i < count; i++) {
+		HOST_CHECK(entries[i - 1].pixels >= entries[i].pixels);
+	}
+
+	const InvalidationProfiler::entry_t* entry = find_entry(entries, count, label);
+	HOST_CHECK(entry != NULL);
+	HOST_CHECK(strcmp(entry->type, "lv_label") == 0);
+	HOST_CHECK_EQUAL(6, entry->invalidations);
+	HOST_CHECK_EQUAL(6 * (uint64_t) lv_area_get_size(&label_area), entry->pixels);
+
+	// The box invalidated itself, its indicator covers it
+	HOST_CHECK(find_entry(entries, count, box) == NULL);
+	entry = find_entry(entries, count, indicator);
+	HOST_CHECK(entry != NULL);
+	HOST_CHECK_EQUAL(3, entry->invalidations);
+	HOST_CHECK_EQUAL(3 * 64 * 32, entry->pixels);
+
+	entry = find_entry(entries, count, panel);
+	HOST_CHECK(entry != NULL);
+	HOST_CHECK_EQUAL(1, entry->invalidations);
+	HOST_CHECK_EQUAL((uint64_t)(lv_area_get_width(&label_area) + 50) * lv_area_get_height(&label_area), entry->pixels);
+
+	// Frames that redrew each cell
+	HOST_CHECK_EQUAL(7, profiler.get_heat(label_area.x1, label_area.y1));
+	HOST_CHECK_EQUAL(1, profiler.get_heat(label_area.x2 + 40, label_area.y1));
+	HOST_CHECK_EQUAL(3, profiler.get_heat(240 + 32, 160 + 16));
+	HOST_CHECK_EQUAL(0, profiler.get_heat(0, LV_VER_RES_MAX - 1));
+	HOST_CHECK_EQUAL(0, profiler.get_heat(LV_HOR_RES_MAX - 1, 0));
+
+	profiler.reset();
+	HOST_CHECK_EQUAL(0, profiler.get_frames());
+	HOST_CHECK_EQUAL(0, profiler.get_entries(entries, MBED_CONF_MBED_LVGL_INVALIDATION_PROFILER_SLOTS));
+	HOST_CHECK_EQUAL(0, profiler.get_heat(label_area.x1, label_area.y1));
+
+	lvgl.remove_frame_hook(profiler);
+}
+
+int main(void)
+{
+	HOST_TEST_RUN(test_attribution_and_heatmap);
+	return host_test_result();
+}
@@ -0,0 +1,165 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Heap accounting of a screen built under a tag, the stub allocating
+ * through the LV_MEM_CUSTOM wrappers like lvgl
+ *
+ * Checks that:
+ * - the screen's allocations are charged to its tag, those of a nested
+ *   tag to the nested one, and those made after it to untagged
+ * - deleting the screen brings the tag's and the total live usage back to
+ *   where they were, the peaks keeping the screen's size until reset
+ */
+
+#include <string.h>
+
+#include "host_test.h"
+
+#include "lv_obj.h"
+#include "lv_label.h"
+#include "lv_hal_disp.h"
+#include "platform/mem_accounting.h"
+
+static const size_t TAGS = MBED_CONF_MBED_LVGL_MEM_TAGS;
+
+static lv_color_t strip[LV_HOR_RES_MAX * 10];
+
+static void flush(lv_disp_drv_t* drv, const lv_area_t* area, lv_color_t* color_p)
+{
+	(void) area;
+	(void) color_p;
+	lv_disp_flush_ready(drv);
+}
+
+static void init_display(void)
+{
+	static lv_disp_buf_t disp_buf;
+
+	lv_init();
+	lv_disp_buf_init(&disp_buf, strip, NULL, sizeof(strip) / sizeof(strip[0]));
+	lv_disp_drv_t drv;
+	lv_disp_drv_init(&drv);
+	drv.buffer = &disp_buf;
+	drv.flush_cb = flush;
+	lv_disp_drv_register(&drv);
+}
+
+/** Usage charged to a tag, zeroed if it isn't registered */
+static mbed_lvgl_mem_tag_stats_t get_tag(const char* name)
+{
+	mbed_lvgl_mem_tag_stats_t stats[TAGS];
+	size_t count = mbed_lvgl_mem_get_tag_stats(stats, TAGS);
+	for(size_t i = 0; i < count; i++) {
+		if(strcmp(stats[i].name, name) == 0) {
+			return stats[i];
+		}
+	}
+	mbed_lvgl_mem_tag_stats_t none;
+	memset(&none, 0, sizeof(none));
+	return none;
+}
+
+static lv_obj_t* build_settings_screen(void)
+{
+	LVGLMemTag tag("settings");
+
+	lv_obj_t* screen = lv_obj_create(NULL, NULL);
+	lv_obj_t* panel = lv_obj_create(screen, NULL);
+	lv_obj_set_size(panel, 200, 100);
+	lv_label_set_text(lv_label_create(panel, NULL), "Brightness");
+	lv_label_set_text(lv_label_create(panel, NULL), "Volume");
+
+	{
+		LVGLMemTag dialog("dialog");
+		lv_label_set_text(lv_label_create(screen, NULL), "Saved");
+	}
+
+	lv_label_set_text(lv_label_create(screen, NULL), "Back");
+	return screen;
+}
+
+static void test_deleted_screen_gives_back_its_memory(void)
+{
+	init_display();
+
+	mbed_lvgl_mem_stats_t baseline;
+	mbed_lvgl_mem_get_stats(&baseline);
+	mbed_lvgl_mem_tag_stats_t untagged_baseline = get_tag("untagged");
+	HOST_CHECK(baseline.live_blocks != 0);
+	HOST_CHECK_EQUAL(baseline.live_bytes, untagged_baseline.live_bytes);
+
+	lv_obj_t* screen = build_settings_screen();
+
+	// Made after the tag went out of scope: untagged
+	lv_obj_t* status = lv_label_create(lv_scr_act(), NULL);
+
+	mbed_lvgl_mem_tag_stats_t settings = get_tag("settings");
+	mbed_lvgl_mem_tag_stats_t dialog = get_tag("dialog");
+	mbed_lvgl_mem_tag_stats_t untagged = get_tag("untagged");
+	HOST_CHECK(settings.live_bytes != 0);
+	HOST_CHECK(dialog.live_bytes != 0);
+	HOST_CHECK(untagged.live_bytes > untagged_baseline.live_bytes);
+
+	// Default texts replaced along the way, the new one allocated first
+	HOST_CHECK(settings.allocs > settings.live_blocks);
+	HOST_CHECK(settings.peak_bytes > settings.live_bytes);
+
+	// A label each, the screen holding more
+	HOST_CHECK_EQUAL(untagged.live_blocks - untagged_baseline.live_blocks, dialog.live_blocks);
+	HOST_CHECK(dialog.live_bytes < settings.live_bytes);
+
+	mbed_lvgl_mem_stats_t built;
+	mbed_lvgl_mem_get_stats(&built);
+	HOST_CHECK_EQUAL(untagged.live_bytes + settings.live_bytes + dialog.live_bytes, built.live_bytes);
+	HOST_CHECK(built.peak_bytes >= built.live_bytes);
+
+	lv_obj_del(screen);
+
+	// The screen's tags are back to nothing, their peaks kept
+	mbed_lvgl_mem_tag_stats_t deleted = get_tag("settings");
+	HOST_CHECK_EQUAL(0, deleted.live_bytes);
+	HOST_CHECK_EQUAL(0, deleted.live_blocks);
+	HOST_CHECK_EQUAL(settings.allocs, deleted.allocs);
+	HOST_CHECK_EQUAL(settings.peak_bytes, deleted.peak_bytes);
+	HOST_CHECK_EQUAL(0, get_tag("dialog").live_bytes);
+	HOST_CHECK_EQUAL(untagged.live_bytes, get_tag("untagged").live_bytes);
+
+	lv_obj_del(status);
+
+	mbed_lvgl_mem_stats_t stats;
+	mbed_lvgl_mem_get_stats(&stats);
+	HOST_CHECK_EQUAL(baseline.live_bytes, stats.live_bytes);
+	HOST_CHECK_EQUAL(baseline.live_blocks, stats.live_blocks);
+	HOST_CHECK_EQUAL(built.peak_bytes, stats.peak_bytes);
+	HOST_CHECK_EQUAL(stats.allocs - baseline.allocs, stats.frees - baseline.frees);
+	HOST_CHECK_EQUAL(0, stats.failures);
+
+	mbed_lvgl_mem_reset_peaks();
+	mbed_lvgl_mem_get_stats(&stats);
+	HOST_CHECK_EQUAL(baseline.live_bytes, stats.peak_bytes);
+	HOST_CHECK_EQUAL(0, get_tag("settings").peak_bytes);
+
+	// Registered once
+	HOST_CHECK_EQUAL(mbed_lvgl_mem_register_tag("settings"), mbed_lvgl_mem_register_tag("settings"));
+}
+
+int main(void)
+{
+	HOST_TEST_RUN(test_deleted_screen_gives_back_its_memory);
+	return host_test_result();
+}
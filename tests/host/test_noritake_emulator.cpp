@@ -0,0 +1,83 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * NoritakeVFDEmulator's decoding of the graphic commands
+ *
+ * Like ST7789Emulator it is used as uDisplay's DisplayInterface, whose
+ * stub has pure virtual methods: it must override them exactly to compile.
+ */
+
+#include "host_test.h"
+
+#include "emulators/NoritakeVFDEmulator.h"
+
+static void send(DisplayInterface& bus, const uint8_t* bytes, uint32_t len)
+{
+	uint8_t copy[64];
+	memcpy(copy, bytes, len);
+	bus.write_data(copy, len);
+}
+
+static void test_bit_image_at_cursor(void)
+{
+	NoritakeVFDEmulator vfd(128, 32);
+	DisplayInterface& bus = vfd;
+
+	// Cursor to x = 10, row 1 (dots 8 to 15), then a 2x16 dot image
+	const uint8_t cursor[] = { 0x1F, 0x24, 10, 0, 1, 0 };
+	const uint8_t image[] = { 0x1F, 0x28, 0x66, 0x11, 2, 0, 2, 0, 1, 0x80, 0x01, 0xFF, 0x00 };
+	send(bus, cursor, sizeof(cursor));
+	send(bus, image, sizeof(image));
+
+	HOST_CHECK(vfd.get_dot(10, 8));
+	HOST_CHECK(!vfd.get_dot(10, 9));
+	HOST_CHECK(vfd.get_dot(10, 23));
+	HOST_CHECK(vfd.get_dot(11, 8));
+	HOST_CHECK(vfd.get_dot(11, 15));
+	HOST_CHECK(!vfd.get_dot(11, 16));
+	HOST_CHECK_EQUAL(1u, vfd.get_stats().images);
+	HOST_CHECK_EQUAL(4u, vfd.get_stats().image_bytes);
+	HOST_CHECK_EQUAL(10u, vfd.get_stats().dots_changed);
+	HOST_CHECK_EQUAL(0u, vfd.get_stats().other_bytes);
+}
+
+static void test_dot_unit_image_clips(void)
+{
+	NoritakeVFDEmulator vfd(128, 32);
+	DisplayInterface& bus = vfd;
+
+	// 2x8 dots at (127, 24): the second column is off the display
+	const uint8_t image[] = { 0x1F, 0x28, 0x64, 0x21, 127, 0, 24, 0, 2, 0, 8, 0, 1, 0xF0, 0xFF };
+	send(bus, image, sizeof(image));
+
+	HOST_CHECK(vfd.get_dot(127, 24));
+	HOST_CHECK(vfd.get_dot(127, 27));
+	HOST_CHECK(!vfd.get_dot(127, 28));
+	HOST_CHECK_EQUAL(1u, vfd.get_stats().clipped_bytes);
+
+	// Clear
+	bus.write_command(0x0C);
+	HOST_CHECK(!vfd.get_dot(127, 24));
+}
+
+int main(void)
+{
+	HOST_TEST_RUN(test_bit_image_at_cursor);
+	HOST_TEST_RUN(test_dot_unit_image_clips);
+	return host_test_result();
+}
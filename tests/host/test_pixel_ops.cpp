@@ -0,0 +1,286 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * pixel_ops kernels against scalar references, bit for bit
+ *
+ * Every length from 0 to past two vector widths, at every alignment of
+ * source and destination, so both the vector loops and their scalar
+ * tails are covered. Pixels around the run must stay untouched. Built
+ * once per color depth and instruction set (see CMakeLists.txt).
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "host_test.h"
+#include "pixel_ops_reference.h"
+
+#include "platform/pixel_ops.h"
+
+static const uint32_t MAX_LEN = 70;
+static const uint32_t MAX_OFFSET = 4;
+static const uint32_t GUARD = 8;
+static const uint32_t BUF_LEN = GUARD + MAX_OFFSET + MAX_LEN + GUARD;
+
+static const lv_opa_t OPAS[] = { 0, 1, 2, 15, 16, 127, 128, 129, 200, 250, 251, 254, 255 };
+
+static bool same(const void* a, const void* b, size_t bytes)
+{
+	return memcmp(a, b, bytes) == 0;
+}
+
+static void test_fill(void)
+{
+	lv_color_t expected[BUF_LEN];
+	lv_color_t actual[BUF_LEN];
+	lv_color_t color = lv_color_make(0x12, 0xA4, 0x7E);
+
+	int mismatches = 0;
+	for(uint32_t offset = 0; offset < MAX_OFFSET; offset++) {
+		for(uint32_t len = 0; len <= MAX_LEN; len++) {
+			ref_random_pixels(expected, BUF_LEN, len);
+			memcpy(actual, expected, sizeof(actual));
+			ref_fill(expected + GUARD + offset, len, color);
+			mbed_lvgl_px_fill(actual + GUARD + offset, len, color);
+			mismatches += !same(expected, actual, sizeof(actual));
+		}
+	}
+	HOST_CHECK_EQUAL(0, mismatches);
+}
+
+static void test_copy(void)
+{
+	lv_color_t src[BUF_LEN];
+	lv_color_t expected[BUF_LEN];
+	lv_color_t actual[BUF_LEN];
+	ref_random_pixels(src, BUF_LEN, 7);
+
+	int mismatches = 0;
+	for(uint32_t offset = 0; offset < MAX_OFFSET; offset++) {
+		for(uint32_t len = 0; len <= MAX_LEN; len++) {
+			ref_random_pixels(expected, BUF_LEN, len);
+			memcpy(actual, expected, sizeof(actual));
+			for(uint32_t i = 0; i < len; i++) {
+				expected[GUARD + offset + i] = src[GUARD + i];
+			}
+			mbed_lvgl_px_copy(actual + GUARD + offset, src + GUARD, len);
+			mismatches += !same(expected, actual, sizeof(actual));
+		}
+	}
+	HOST_CHECK_EQUAL(0, mismatches);
+}
+
+static void test_blend_matches_lv_color_mix(void)
+{
+	lv_color_t src[BUF_LEN];
+	lv_color_t expected[BUF_LEN];
+	lv_color_t actual[BUF_LEN];
+
+	int mismatches = 0;
+	for(size_t o = 0; o < sizeof(OPAS) / sizeof(OPAS[0]); o++) {
+		for(uint32_t src_offset = 0; src_offset < MAX_OFFSET; src_offset++) {
+			for(uint32_t dest_offset = 0; dest_offset < MAX_OFFSET; dest_offset++) {
+				for(uint32_t len = 0; len <= MAX_LEN; len++) {
+					ref_random_pixels(src, BUF_LEN, len + 1000);
+					ref_random_pixels(expected, BUF_LEN, len);
+					memcpy(actual, expected, sizeof(actual));
+					ref_blend(expected + GUARD + dest_offset, src + GUARD + src_offset, len, OPAS[o]);
+					mbed_lvgl_px_blend(actual + GUARD + dest_offset, src + GUARD + src_offset, len, OPAS[o]);
+					mismatches += !same(expected, actual, sizeof(actual));
+				}
+			}
+		}
+	}
+	HOST_CHECK_EQUAL(0, mismatches);
+}
+
+static void test_blend_every_opacity(void)
+{
+	// Extreme channels are where rounding differences would show
+	static const uint8_t levels[] = { 0x00, 0x01, 0x7F, 0x80, 0xFE, 0xFF };
+	const uint32_t n = sizeof(levels) * sizeof(levels);
+	lv_color_t src[n];
+	lv_color_t dest[n];
+	for(uint32_t i = 0; i < n; i++) {
+		uint8_t a = levels[i / sizeof(levels)];
+		uint8_t b = levels[i % sizeof(levels)];
+		src[i] = lv_color_make(a, b, a);
+		dest[i] = lv_color_make(b, a, b);
+	}
+
+	int mismatches = 0;
+	for(uint32_t opa = 0; opa <= 255; opa++) {
+		lv_color_t expected[n];
+		lv_color_t actual[n];
+		memcpy(expected, dest, sizeof(dest));
+		memcpy(actual, dest, sizeof(dest));
+		ref_blend(expected, src, n, (lv_opa_t) opa);
+		mbed_lvgl_px_blend(actual, src, n, (lv_opa_t) opa);
+		mismatches += !same(expected, actual, sizeof(actual));
+	}
+	HOST_CHECK_EQUAL(0, mismatches);
+}
+
+static void test_to_rgb565(void)
+{
+	lv_color_t src[BUF_LEN];
+	ref_random_pixels(src, BUF_LEN, 3);
+
+	int mismatches = 0;
+	for(int swap = 0; swap < 2; swap++) {
+		for(uint32_t len = 0; len <= MAX_LEN; len++) {
+			uint8_t expected[BUF_LEN * 2];
+			uint8_t actual[BUF_LEN * 2];
+			memset(expected, 0xA5, sizeof(expected));
+			memset(actual, 0xA5, sizeof(actual));
+			for(uint32_t i = 0; i < len; i++) {
+				uint16_t v = ref_rgb565(src[i]);
+				expected[i * 2] = swap ? (v >> 8) : (v & 0xFF);
+				expected[i * 2 + 1] = swap ? (v & 0xFF) : (v >> 8);
+			}
+			mbed_lvgl_px_to_rgb565(actual, src, len, swap != 0);
+			mismatches += !same(expected, actual, sizeof(actual));
+
+			// In place, when the destination is no larger than the source
+			if(sizeof(lv_color_t) >= 2) {
+				lv_color_t in_place[BUF_LEN];
+				memcpy(in_place, src, sizeof(in_place));
+				mbed_lvgl_px_to_rgb565((uint8_t*) in_place, in_place, len, swap != 0);
+				mismatches += !same(expected, in_place, len * 2);
+			}
+		}
+	}
+	HOST_CHECK_EQUAL(0, mismatches);
+}
+
+static void test_to_rgb332(void)
+{
+	lv_color_t src[BUF_LEN];
+	ref_random_pixels(src, BUF_LEN, 5);
+
+	uint8_t expected[BUF_LEN];
+	uint8_t actual[BUF_LEN];
+	for(uint32_t i = 0; i < BUF_LEN; i++) {
+		expected[i] = ref_rgb332(src[i]);
+	}
+	mbed_lvgl_px_to_rgb332(actual, src, BUF_LEN);
+	HOST_CHECK(same(expected, actual, BUF_LEN));
+
+	mbed_lvgl_px_to_rgb332((uint8_t*) src, src, BUF_LEN);
+	HOST_CHECK(same(expected, src, BUF_LEN));
+}
+
+static void test_lut_expand(void)
+{
+	uint16_t lut[256];
+	for(uint32_t i = 0; i < 256; i++) {
+		lut[i] = (uint16_t)(i * 0x0101 ^ 0x5A3C);
+	}
+
+	uint8_t src[BUF_LEN];
+	for(uint32_t i = 0; i < BUF_LEN; i++) {
+		src[i] = (uint8_t)(i * 37 + 11);
+	}
+
+	int mismatches = 0;
+	for(uint32_t offset = 0; offset < MAX_OFFSET; offset++) {
+		for(uint32_t len = 0; len <= MAX_LEN; len++) {
+			uint16_t expected[BUF_LEN];
+			uint16_t actual[BUF_LEN];
+			memset(expected, 0xA5, sizeof(expected));
+			memset(actual, 0xA5, sizeof(actual));
+			for(uint32_t i = 0; i < len; i++) {
+				expected[GUARD + i] = lut[src[offset + i]];
+			}
+			mbed_lvgl_px_lut_expand16(actual + GUARD, src + offset, len, lut);
+			mismatches += !same(expected, actual, sizeof(actual));
+		}
+	}
+	HOST_CHECK_EQUAL(0, mismatches);
+}
+
+#if LV_COLOR_DEPTH == 8
+static void test_rgb565_lut_matches_conversion(void)
+{
+	// Entry i is RGB332 pixel i, as lvgl expands it
+	for(int swap = 0; swap < 2; swap++) {
+		uint16_t lut[256];
+		mbed_lvgl_px_make_rgb565_lut(lut, swap != 0);
+
+		int mismatches = 0;
+		for(uint32_t i = 0; i < 256; i++) {
+			uint8_t r = ((i >> 5) & 0x07) * 36;
+			uint8_t g = ((i >> 2) & 0x07) * 36;
+			uint8_t b = (i & 0x03) * 85;
+			uint16_t v = (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+			uint8_t expected[2] = { (uint8_t)(swap ? (v >> 8) : (v & 0xFF)), (uint8_t)(swap ? (v & 0xFF) : (v >> 8)) };
+			mismatches += !same(expected, &lut[i], 2);
+		}
+		HOST_CHECK_EQUAL(0, mismatches);
+	}
+}
+#endif
+
+static void test_to_mono_vtiled(void)
+{
+	const lv_coord_t w = 13;
+	const lv_coord_t h = 16;
+	lv_color_t src[w * h];
+	ref_random_pixels(src, w * h, 9);
+
+	uint8_t actual[w * (h / 8)];
+	mbed_lvgl_px_to_mono_vtiled(actual, src, w, h);
+
+	int mismatches = 0;
+	for(lv_coord_t y = 0; y < h; y++) {
+		for(lv_coord_t x = 0; x < w; x++) {
+			bool dark = lv_color_brightness(src[y * w + x]) < MBED_LVGL_MONO_THRESHOLD;
+			bool bit = (actual[x * (h / 8) + y / 8] >> (7 - (y % 8))) & 1;
+			mismatches += (dark != bit);
+		}
+	}
+	HOST_CHECK_EQUAL(0, mismatches);
+}
+
+int main()
+{
+#if defined(__AVX2__)
+	const char* isa = "AVX2";
+#elif defined(__SSE2__)
+	const char* isa = "SSE2";
+#elif defined(__ARM_NEON)
+	const char* isa = "NEON";
+#else
+	const char* isa = "C";
+#endif
+	printf("pixel_ops at LV_COLOR_DEPTH %d, %s kernels\n", LV_COLOR_DEPTH, isa);
+
+	HOST_TEST_RUN(test_fill);
+	HOST_TEST_RUN(test_copy);
+	HOST_TEST_RUN(test_blend_matches_lv_color_mix);
+	HOST_TEST_RUN(test_blend_every_opacity);
+	HOST_TEST_RUN(test_to_rgb565);
+	HOST_TEST_RUN(test_to_rgb332);
+	HOST_TEST_RUN(test_lut_expand);
+#if LV_COLOR_DEPTH == 8
+	HOST_TEST_RUN(test_rgb565_lut_matches_conversion);
+#endif
+	HOST_TEST_RUN(test_to_mono_vtiled);
+
+	return host_test_result();
+}
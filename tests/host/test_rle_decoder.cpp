@@ -0,0 +1,241 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * RLEImageDecoder: decoding and rejection of malformed images
+ *
+ * Images with a row table that points outside the data must fail to open
+ * instead of being read out of bounds (the test runs under ASan).
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "host_test.h"
+#include "rle_test_image.h"
+
+#include "lv_fs.h"
+#include "lv_img_decoder.h"
+#include "platform/filesystem_wrapper.h"
+#include "decoders/RLEImageDecoder.h"
+
+static const char* IMAGE_FILE = "test_rle_decoder.rle";
+static const uint16_t W = 37;
+static const uint16_t H = 11;
+
+/** Runs, literals and a packet longer than the maximum */
+static std::vector<lv_color_t> make_pixels(void)
+{
+	std::vector<lv_color_t> px((size_t) W * H);
+	for(uint16_t y = 0; y < H; y++) {
+		for(uint16_t x = 0; x < W; x++) {
+			lv_color_t c = (x < 10 || y == 3) ? LV_COLOR_MAKE(0x20, 0x40, 0x80)
+					: LV_COLOR_MAKE(x * 7, y * 23, (x * y) & 0xFF);
+			px[(size_t) y * W + x] = c;
+		}
+	}
+	return px;
+}
+
+static std::vector<uint8_t> encoded(void)
+{
+	return rle_encode(make_pixels(), W, H);
+}
+
+static bool decodes_to_pixels(const void* src)
+{
+	std::vector<lv_color_t> px = make_pixels();
+	lv_img_decoder_dsc_t dsc;
+	if(lv_img_decoder_open(&dsc, src, &lv_style_plain) != LV_RES_OK) {
+		return false;
+	}
+
+	bool ok = dsc.header.w == W && dsc.header.h == H;
+	lv_color_t row[W];
+	for(uint16_t y = 0; ok && y < H; y++) {
+		// Full rows take the direct path, segments the decoded row
+		ok = lv_img_decoder_read_line(&dsc, 0, y, W, (uint8_t*) row) == LV_RES_OK &&
+				memcmp(row, &px[(size_t) y * W], sizeof(row)) == 0;
+		ok = ok && lv_img_decoder_read_line(&dsc, 5, y, 20, (uint8_t*) row) == LV_RES_OK &&
+				memcmp(row, &px[(size_t) y * W + 5], 20 * sizeof(lv_color_t)) == 0;
+		ok = ok && lv_img_decoder_read_line(&dsc, 25, y, 12, (uint8_t*) row) == LV_RES_OK &&
+				memcmp(row, &px[(size_t) y * W + 25], 12 * sizeof(lv_color_t)) == 0;
+	}
+	ok = ok && lv_img_decoder_read_line(&dsc, 30, 0, 8, (uint8_t*) row) == LV_RES_INV;
+	ok = ok && lv_img_decoder_read_line(&dsc, 0, H, W, (uint8_t*) row) == LV_RES_INV;
+
+	lv_img_decoder_close(&dsc);
+	return ok;
+}
+
+/** Opens a variable source made of (a copy of) data, exactly data.size() bytes long */
+static lv_res_t open_variable(const std::vector<uint8_t>& data)
+{
+	// An exact size heap copy lets ASan catch any read past the end
+	uint8_t* copy = new uint8_t[data.size()];
+	memcpy(copy, data.data(), data.size());
+	lv_img_dsc_t src;
+	memset(&src, 0, sizeof(src));
+	src.header.cf = LV_IMG_CF_RAW;
+	src.data_size = data.size();
+	src.data = copy;
+
+	lv_img_decoder_dsc_t dsc;
+	lv_res_t res = lv_img_decoder_open(&dsc, &src, &lv_style_plain);
+	if(res == LV_RES_OK) {
+		lv_color_t row[W];
+		for(uint16_t y = 0; y < H; y++) {
+			lv_img_decoder_read_line(&dsc, 0, y, W, (uint8_t*) row);
+		}
+		lv_img_decoder_close(&dsc);
+	}
+	delete[] copy;
+	return res;
+}
+
+static void set_row_offset(std::vector<uint8_t>& data, uint16_t row, uint32_t offset)
+{
+	rle_put_u32(data, RLE_TEST_HEADER_SIZE + row * 4, offset);
+}
+
+static uint32_t row_offset(const std::vector<uint8_t>& data, uint16_t row)
+{
+	const uint8_t* p = &data[RLE_TEST_HEADER_SIZE + row * 4];
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static void test_decodes_variable_and_file_sources(void)
+{
+	std::vector<uint8_t> data = encoded();
+	lv_img_dsc_t src = rle_variable_src(data);
+	HOST_CHECK(decodes_to_pixels(&src));
+
+	HOST_CHECK(rle_write_file(IMAGE_FILE, data));
+	char path[64];
+	snprintf(path, sizeof(path), "M:/%s", IMAGE_FILE);
+	HOST_CHECK(decodes_to_pixels(path));
+}
+
+static void test_rejects_truncated_table(void)
+{
+	std::vector<uint8_t> data = encoded();
+
+	// Data ends within the row table
+	data.resize(RLE_TEST_HEADER_SIZE + H * 4);
+	HOST_CHECK_EQUAL(LV_RES_INV, open_variable(data));
+
+	data.resize(RLE_TEST_HEADER_SIZE);
+	HOST_CHECK_EQUAL(LV_RES_INV, open_variable(data));
+}
+
+static void test_rejects_rows_past_the_end(void)
+{
+	std::vector<uint8_t> data = encoded();
+	uint32_t end = data.size();
+
+	// The data is cut short of what the table says
+	std::vector<uint8_t> cut(data.begin(), data.end() - 1);
+	HOST_CHECK_EQUAL(LV_RES_INV, open_variable(cut));
+
+	// Last row ends far out of the data
+	std::vector<uint8_t> far = data;
+	set_row_offset(far, H, end + 100000);
+	HOST_CHECK_EQUAL(LV_RES_INV, open_variable(far));
+
+	// A huge offset would wrap around with 32-bit additions
+	std::vector<uint8_t> wrap = data;
+	set_row_offset(wrap, H - 1, 0xFFFFFFF0u);
+	set_row_offset(wrap, H, 0xFFFFFFFFu);
+	HOST_CHECK_EQUAL(LV_RES_INV, open_variable(wrap));
+}
+
+static void test_rejects_rows_going_backwards(void)
+{
+	std::vector<uint8_t> data = encoded();
+
+	// Row 4 starts before row 3: its length would underflow
+	std::vector<uint8_t> backwards = data;
+	set_row_offset(backwards, 4, row_offset(data, 3) - 1);
+	HOST_CHECK_EQUAL(LV_RES_INV, open_variable(backwards));
+
+	// The first row overlaps the header and table
+	std::vector<uint8_t> overlap = data;
+	set_row_offset(overlap, 0, 4);
+	HOST_CHECK_EQUAL(LV_RES_INV, open_variable(overlap));
+}
+
+static void test_rejects_bad_header(void)
+{
+	std::vector<uint8_t> data = encoded();
+
+	std::vector<uint8_t> version = data;
+	version[4] = 2;
+	HOST_CHECK_EQUAL(LV_RES_INV, open_variable(version));
+
+	std::vector<uint8_t> depth = data;
+	depth[5] = LV_COLOR_DEPTH == 16 ? 32 : 16;
+	HOST_CHECK_EQUAL(LV_RES_INV, open_variable(depth));
+
+	// The table of a taller image does not fit in the data
+	std::vector<uint8_t> taller = data;
+	taller[8] = 0xFF;
+	taller[9] = 0xFF;
+	HOST_CHECK_EQUAL(LV_RES_INV, open_variable(taller));
+}
+
+static void test_rejects_file_with_rows_past_the_end(void)
+{
+	std::vector<uint8_t> data = encoded();
+	data.resize(data.size() - 1);
+	HOST_CHECK(rle_write_file(IMAGE_FILE, data));
+
+	char path[64];
+	snprintf(path, sizeof(path), "M:/%s", IMAGE_FILE);
+
+	// The wrapper driver has no size callback, the short read of the last row fails
+	lv_img_decoder_dsc_t dsc;
+	if(lv_img_decoder_open(&dsc, path, &lv_style_plain) == LV_RES_OK) {
+		lv_color_t row[W];
+		HOST_CHECK_EQUAL(LV_RES_OK, lv_img_decoder_read_line(&dsc, 0, 0, W, (uint8_t*) row));
+		HOST_CHECK_EQUAL(LV_RES_INV, lv_img_decoder_read_line(&dsc, 0, H - 1, W, (uint8_t*) row));
+		lv_img_decoder_close(&dsc);
+	}
+}
+
+int main()
+{
+	lv_init();
+	RLEImageDecoder::register_decoder();
+
+	lv_fs_drv_t drv;
+	lv_fs_drv_init(&drv);
+	mbed_lvgl_fs_wrapper_default(&drv);
+	drv.letter = 'M';
+	lv_fs_drv_register(&drv);
+
+	HOST_TEST_RUN(test_decodes_variable_and_file_sources);
+	HOST_TEST_RUN(test_rejects_truncated_table);
+	HOST_TEST_RUN(test_rejects_rows_past_the_end);
+	HOST_TEST_RUN(test_rejects_rows_going_backwards);
+	HOST_TEST_RUN(test_rejects_bad_header);
+	HOST_TEST_RUN(test_rejects_file_with_rows_past_the_end);
+
+	remove(IMAGE_FILE);
+	return host_test_result();
+}
@@ -0,0 +1,276 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * ScreenManager switching between screens of the same size, the GUI
+ * running through lv_task_handler() with the tick advanced by the test
+ *
+ * Checks that:
+ * - cached screens are shown without being rebuilt, the least recently
+ *   used one is deleted past max_screens or past the heap budget
+ * - prebuild() builds a screen once the display is idle, not while an
+ *   animation runs, and not at all when max_screens leaves no room for it
+ *   next to the screen shown
+ * - the latency of a transition is measured up to the refresh drawing it
+ */
+
+#include "host_test.h"
+
+#include "LittlevGL.h"
+#include "lv_hal_tick.h"
+#include "lv_label.h"
+#include "platform/mem_accounting.h"
+#include "widgets/ScreenManager.h"
+
+/** Period of ScreenManager's prebuild task */
+static const uint32_t PREBUILD_PERIOD = 50;
+
+static const int SCREENS = 3;
+
+static lv_color_t draw_buffer[LV_HOR_RES_MAX * 10];
+
+class NullDriver : public LVGLDisplayDriver
+{
+	public:
+
+		NullDriver() : LVGLDisplayDriver(mbed::Span<lv_color_t>(draw_buffer, sizeof(draw_buffer) / sizeof(draw_buffer[0]))) {
+		}
+
+		virtual void flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p) {
+			(void) area;
+			(void) color_p;
+			lv_disp_flush_ready(disp_drv);
+		}
+};
+
+static NullDriver* driver;
+
+static uint32_t builds[SCREENS];
+
+/** Time the builders take */
+static uint32_t build_ms;
+
+template <int N>
+static lv_obj_t* build_screen(void)
+{
+	builds[N]++;
+	uint64_t end = host_time_ns() + (uint64_t) build_ms * 1000000;
+	while(host_time_ns() < end) {
+	}
+
+	lv_obj_t* screen = lv_obj_create(NULL, NULL);
+	lv_obj_t* panel = lv_obj_create(screen, NULL);
+	lv_obj_set_size(panel, 200, 100);
+	lv_label_set_text(lv_label_create(panel, NULL), "Screen");
+	return screen;
+}
+
+static void add_screens(ScreenManager& manager)
+{
+	HOST_CHECK_EQUAL(0, manager.add_screen("a", build_screen<0>));
+	HOST_CHECK_EQUAL(1, manager.add_screen("b", build_screen<1>));
+	HOST_CHECK_EQUAL(2, manager.add_screen("c", build_screen<2>));
+	for(int i = 0; i < SCREENS; i++) {
+		builds[i] = 0;
+	}
+	build_ms = 0;
+}
+
+/** What update() does once the tick advanced */
+static void run(uint32_t elapsed_ms)
+{
+	lv_tick_inc(elapsed_ms);
+	lv_task_handler();
+}
+
+/** Runs the display's refresh task, frame hooks included */
+static void refresh(void)
+{
+	lv_disp_t* disp = lv_disp_get_default();
+	disp->refr_task->task_cb(disp->refr_task);
+}
+
+static void test_lru_eviction(void)
+{
+	ScreenManager manager(*driver, 2);
+	add_screens(manager);
+
+	manager.show(0);
+	manager.show(1);
+	HOST_CHECK(manager.get_screen(0) != NULL);
+
+	// A third screen: the least recently used goes
+	manager.show(2);
+	HOST_CHECK(manager.get_screen(0) == NULL);
+	HOST_CHECK(manager.get_screen(1) != NULL);
+	HOST_CHECK_EQUAL(2, manager.get_active());
+	HOST_CHECK(lv_scr_act() == manager.get_screen(2));
+
+	// From the cache, then c is the least recently used
+	manager.show(1);
+	HOST_CHECK_EQUAL(1, builds[1]);
+	manager.show(0);
+	HOST_CHECK_EQUAL(2, builds[0]);
+	HOST_CHECK(manager.get_screen(2) == NULL);
+	HOST_CHECK(manager.get_screen(1) != NULL);
+
+	// The screen shown stays
+	manager.evict(0);
+	HOST_CHECK(lv_scr_act() == manager.get_screen(0));
+	manager.evict(1);
+	HOST_CHECK(manager.get_screen(1) == NULL);
+
+	const ScreenManager::stats_t& stats = manager.get_stats();
+	HOST_CHECK_EQUAL(5, stats.shows);
+	HOST_CHECK_EQUAL(1, stats.hits);
+	HOST_CHECK_EQUAL(2, stats.evictions);
+}
+
+static void test_budget_eviction(void)
+{
+	// What a screen costs
+	mbed_lvgl_mem_stats_t before, after;
+	mbed_lvgl_mem_get_stats(&before);
+	lv_obj_t* screen = build_screen<0>();
+	mbed_lvgl_mem_get_stats(&after);
+	lv_obj_del(screen);
+	uint32_t cost = after.live_bytes - before.live_bytes;
+	HOST_CHECK(cost != 0);
+
+	// Room for two and a half screens, more than enough screens allowed
+	ScreenManager manager(*driver, SCREENS + 1, (cost * 5) / 2);
+	add_screens(manager);
+
+	manager.show(0);
+	manager.show(1);
+	HOST_CHECK_EQUAL(2 * cost, manager.get_used_bytes());
+	HOST_CHECK_EQUAL(0, manager.get_stats().evictions);
+
+	manager.show(2);
+	HOST_CHECK(manager.get_screen(0) == NULL);
+	HOST_CHECK(manager.get_screen(1) != NULL);
+	HOST_CHECK_EQUAL(2 * cost, manager.get_used_bytes());
+	HOST_CHECK_EQUAL(1, manager.get_stats().evictions);
+
+	manager.evict(1);
+	HOST_CHECK_EQUAL(cost, manager.get_used_bytes());
+}
+
+static void test_prebuild(void)
+{
+	ScreenManager manager(*driver, SCREENS);
+	add_screens(manager);
+
+	manager.show(0);
+	manager.prebuild(1);
+	manager.prebuild(0);
+
+	// Not while an animation runs
+	lv_anim_stub_running = 1;
+	run(PREBUILD_PERIOD);
+	run(PREBUILD_PERIOD);
+	HOST_CHECK_EQUAL(0, builds[1]);
+	lv_anim_stub_running = 0;
+
+	run(PREBUILD_PERIOD);
+	HOST_CHECK_EQUAL(1, builds[1]);
+	HOST_CHECK(manager.get_screen(1) != NULL);
+	HOST_CHECK_EQUAL(0, manager.get_active());
+	HOST_CHECK(lv_scr_act() == manager.get_screen(0));
+
+	// Shown from the cache
+	manager.show(1);
+	HOST_CHECK_EQUAL(1, builds[1]);
+	HOST_CHECK_EQUAL(1, builds[0]);
+
+	const ScreenManager::stats_t& stats = manager.get_stats();
+	HOST_CHECK_EQUAL(1, stats.prebuilt);
+	HOST_CHECK_EQUAL(1, stats.hits);
+	HOST_CHECK_EQUAL(0, stats.evictions);
+}
+
+static void test_prebuild_without_room(void)
+{
+	ScreenManager manager(*driver, 1);
+	add_screens(manager);
+
+	// Nothing shown: the screen is built
+	manager.prebuild(0);
+	run(PREBUILD_PERIOD);
+	run(PREBUILD_PERIOD);
+	HOST_CHECK_EQUAL(1, builds[0]);
+	manager.show(0);
+	HOST_CHECK_EQUAL(1, manager.get_stats().hits);
+
+	// The screen shown takes the only place: not built just to be evicted
+	manager.prebuild(1);
+	run(PREBUILD_PERIOD);
+	run(PREBUILD_PERIOD);
+	HOST_CHECK_EQUAL(0, builds[1]);
+	HOST_CHECK(manager.get_screen(1) == NULL);
+	HOST_CHECK(manager.get_screen(0) != NULL);
+
+	const ScreenManager::stats_t& stats = manager.get_stats();
+	HOST_CHECK_EQUAL(1, stats.prebuilt);
+	HOST_CHECK_EQUAL(0, stats.evictions);
+}
+
+static void test_transition_latency(void)
+{
+	ScreenManager manager(*driver, SCREENS);
+	add_screens(manager);
+
+	// Built on show
+	build_ms = 20;
+	manager.show(0);
+	HOST_CHECK_EQUAL(0, manager.get_stats().last_latency_us);
+	refresh();
+	uint32_t built_latency = manager.get_stats().last_latency_us;
+	HOST_CHECK(built_latency >= 20000);
+	HOST_CHECK_EQUAL(built_latency, manager.get_stats().max_latency_us);
+	HOST_CHECK(manager.get_stats().max_build_us >= 20000);
+
+	// Nothing new drawn, nothing measured
+	refresh();
+	HOST_CHECK_EQUAL(built_latency, manager.get_stats().last_latency_us);
+
+	manager.show(1);
+	refresh();
+	manager.show(0);
+	refresh();
+	const ScreenManager::stats_t& stats = manager.get_stats();
+	HOST_CHECK_EQUAL(1, stats.hits);
+	HOST_CHECK(stats.last_latency_us < built_latency);
+	HOST_CHECK(stats.max_latency_us >= built_latency);
+}
+
+int main(void)
+{
+	LittlevGL& lvgl = LittlevGL::get_instance();
+	lvgl.init();
+	NullDriver null_driver;
+	lvgl.add_display_driver(null_driver);
+	lvgl.set_default_display(null_driver);
+	driver = &null_driver;
+
+	HOST_TEST_RUN(test_lru_eviction);
+	HOST_TEST_RUN(test_budget_eviction);
+	HOST_TEST_RUN(test_prebuild);
+	HOST_TEST_RUN(test_prebuild_without_room);
+	HOST_TEST_RUN(test_transition_latency);
+	return host_test_result();
+}
@@ -0,0 +1,466 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * ST7789Emulator's controller model, and ST7789LVGL driving it
+ *
+ * The emulator is used as uDisplay's DisplayInterface, whose stub
+ * declares it with pure virtual methods: a signature that doesn't match
+ * leaves the emulator abstract and this test doesn't compile.
+ *
+ * Strips are rendered at LV_COLOR_DEPTH 32 so the driver sends RGB565
+ * high byte first, like the panel expects.
+ *
+ * Hardware scrolling is checked against a full re-render: after each
+ * scroll only the rows that came into view are flushed, and what the
+ * panel shows must be what flushing the whole frame to a second emulator
+ * shows.
+ *
+ * Tearing is counted on the emulator's model of the panel scan, for the
+ * same frames flushed with and without the emulator as the driver's
+ * frame sync source.
+ */
+
+#include <vector>
+
+#include "host_test.h"
+#include "pixel_ops_reference.h"
+
+#include "drivers/ST7789LVGL.h"
+#include "emulators/ST7789Emulator.h"
+
+/** Exposes the flush path */
+class TestST7789 : public ST7789LVGL
+{
+	public:
+
+		TestST7789(DisplayInterface& bus, lv_coord_t w, lv_coord_t h, lv_color_t* buffer, uint32_t size) :
+				ST7789LVGL(bus, NC, NC, mbed::Span<lv_color_t>(buffer, size)) {
+			set_resolution(w, h);
+		}
+
+		using ST7789LVGL::flush;
+		using ST7789LVGL::set_scroll_region;
+		using ST7789LVGL::scroll;
+		using ST7789LVGL::start_frame;
+		using ST7789LVGL::take_frame_start;
+		using ST7789LVGL::wait_frame_sync;
+};
+
+static void command(ST7789Emulator& emu, uint8_t cmd, const uint8_t* params = NULL, uint32_t len = 0)
+{
+	emu.write_command(cmd);
+	if(len != 0) {
+		std::vector<uint8_t> bytes(params, params + len);
+		emu.write_data(bytes.data(), len);
+	}
+}
+
+static void set_window(ST7789Emulator& emu, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+{
+	uint8_t caset[4] = { (uint8_t)(x1 >> 8), (uint8_t) x1, (uint8_t)(x2 >> 8), (uint8_t) x2 };
+	uint8_t raset[4] = { (uint8_t)(y1 >> 8), (uint8_t) y1, (uint8_t)(y2 >> 8), (uint8_t) y2 };
+	command(emu, 0x2A, caset, sizeof(caset));
+	command(emu, 0x2B, raset, sizeof(raset));
+}
+
+/** Writes pixels numbered from first, RGB565 high byte first */
+static void write_pixels(ST7789Emulator& emu, uint16_t first, uint32_t count)
+{
+	std::vector<uint8_t> bytes;
+	for(uint32_t i = 0; i < count; i++) {
+		bytes.push_back((uint8_t)((first + i) >> 8));
+		bytes.push_back((uint8_t)(first + i));
+	}
+	emu.write_data(bytes.data(), bytes.size());
+}
+
+static void test_window_wraps_inside(void)
+{
+	ST7789Emulator emu;
+	set_window(emu, 10, 5, 13, 6);
+
+	// 8 pixels fill the 4x2 window, the 9th and 10th start over at its top-left
+	command(emu, 0x2C);
+	write_pixels(emu, 100, 10);
+
+	HOST_CHECK_EQUAL(108, emu.get_gram_pixel(10, 5));
+	HOST_CHECK_EQUAL(109, emu.get_gram_pixel(11, 5));
+	HOST_CHECK_EQUAL(102, emu.get_gram_pixel(12, 5));
+	HOST_CHECK_EQUAL(107, emu.get_gram_pixel(13, 6));
+	HOST_CHECK_EQUAL(0, emu.get_gram_pixel(14, 5));
+	HOST_CHECK_EQUAL(0, emu.get_gram_pixel(10, 7));
+	HOST_CHECK_EQUAL(1u, emu.get_stats().window_wraps);
+	HOST_CHECK_EQUAL(10u, emu.get_stats().pixels);
+}
+
+static void test_ram_write_continue(void)
+{
+	ST7789Emulator emu;
+	set_window(emu, 0, 0, 3, 3);
+
+	// RAMWRC carries on at the address counter, RAMWR starts over
+	command(emu, 0x2C);
+	write_pixels(emu, 1, 3);
+	command(emu, 0x3C);
+	write_pixels(emu, 4, 2);
+	HOST_CHECK_EQUAL(4, emu.get_gram_pixel(3, 0));
+	HOST_CHECK_EQUAL(5, emu.get_gram_pixel(0, 1));
+
+	command(emu, 0x2C);
+	write_pixels(emu, 50, 1);
+	HOST_CHECK_EQUAL(50, emu.get_gram_pixel(0, 0));
+	HOST_CHECK_EQUAL(2, emu.get_gram_pixel(1, 0));
+}
+
+static void test_madctl_mirrors_and_exchanges(void)
+{
+	ST7789Emulator emu;
+	const uint8_t mirror[1] = { 0xC0 };	// MY | MX
+	command(emu, 0x36, mirror, 1);
+	set_window(emu, 0, 0, 0, 0);
+	command(emu, 0x2C);
+	write_pixels(emu, 7, 1);
+	HOST_CHECK_EQUAL(7, emu.get_gram_pixel(239, 319));
+
+	// Exchanged, columns address GRAM rows
+	const uint8_t exchange[1] = { 0x20 };	// MV
+	command(emu, 0x36, exchange, 1);
+	set_window(emu, 300, 10, 300, 10);
+	command(emu, 0x2C);
+	write_pixels(emu, 9, 1);
+	HOST_CHECK_EQUAL(9, emu.get_gram_pixel(10, 300));
+	HOST_CHECK_EQUAL(0u, emu.get_stats().out_of_range);
+
+	// Outside of GRAM pixels are dropped
+	command(emu, 0x36, mirror, 1);
+	set_window(emu, 240, 0, 240, 0);
+	command(emu, 0x2C);
+	write_pixels(emu, 1, 1);
+	HOST_CHECK_EQUAL(1u, emu.get_stats().out_of_range);
+}
+
+/** Renders a frame in strips through the driver, keeping a copy of what was rendered */
+static void render_frame(TestST7789& display, lv_coord_t w, lv_coord_t h, lv_coord_t strip_h,
+		std::vector<lv_color_t>& buffer, std::vector<lv_color_t>& frame, uint32_t seed)
+{
+	lv_disp_drv_t disp_drv;
+	lv_disp_drv_init(&disp_drv);
+	frame.resize((size_t) w * h);
+	for(lv_coord_t y = 0; y < h; y += strip_h) {
+		lv_area_t area;
+		lv_area_set(&area, 0, y, w - 1, y + strip_h - 1);
+		ref_random_pixels(buffer.data(), w * strip_h, seed + y);
+		memcpy(&frame[(size_t) y * w], buffer.data(), w * strip_h * sizeof(lv_color_t));
+		display.prepare(&disp_drv, &area, buffer.data());
+		display.flush(&disp_drv, &area, buffer.data());
+	}
+}
+
+/** Counts the panel pixels that differ from a rendered frame */
+static uint32_t panel_mismatches(const ST7789Emulator& emu, const std::vector<lv_color_t>& frame,
+		lv_coord_t w, lv_coord_t h)
+{
+	uint32_t mismatches = 0;
+	for(lv_coord_t y = 0; y < h; y++) {
+		for(lv_coord_t x = 0; x < w; x++) {
+			if(emu.get_panel_pixel(x, y) != ref_rgb565(frame[(size_t) y * w + x])) {
+				mismatches++;
+			}
+		}
+	}
+	return mismatches;
+}
+
+static void test_gram_offset(void)
+{
+	// A 240x240 panel rotated by 180 degrees shows GRAM rows 80 to 319
+	const lv_coord_t size = 240;
+	const lv_coord_t strip_h = 24;
+	ST7789Emulator emu(size, size, 0, 80);
+	std::vector<lv_color_t> buffer(size * strip_h);
+	TestST7789 display(emu, size, size, buffer.data(), buffer.size());
+	display.set_gram_offset(0, 80);
+
+	std::vector<lv_color_t> frame;
+	render_frame(display, size, size, strip_h, buffer, frame, 1);
+
+	HOST_CHECK_EQUAL(0u, panel_mismatches(emu, frame, size, size));
+	HOST_CHECK_EQUAL(0u, emu.get_stats().window_wraps);
+	HOST_CHECK_EQUAL(0u, emu.get_stats().out_of_range);
+	HOST_CHECK_EQUAL((uint32_t) size * size, emu.get_stats().pixels);
+
+	// Rows the panel doesn't show were left alone
+	uint32_t written = 0;
+	for(uint16_t y = 0; y < 80; y++) {
+		for(uint16_t x = 0; x < ST7789Emulator::GRAM_WIDTH; x++) {
+			written += (emu.get_gram_pixel(x, y) != 0);
+		}
+	}
+	HOST_CHECK_EQUAL(0u, written);
+}
+
+static void test_gram_offset_partial_window(void)
+{
+	// A 135x240 panel centered in GRAM columns (52 to 186), rows 40 to 279
+	const lv_coord_t w = 135;
+	const lv_coord_t h = 240;
+	ST7789Emulator emu(w, h, 52, 40);
+	std::vector<lv_color_t> buffer(w * 16);
+	TestST7789 display(emu, w, h, buffer.data(), buffer.size());
+	display.set_gram_offset(52, 40);
+
+	lv_disp_drv_t disp_drv;
+	lv_disp_drv_init(&disp_drv);
+	lv_area_t area;
+	lv_area_set(&area, 20, 100, 59, 109);
+	uint32_t px = lv_area_get_size(&area);
+	ref_random_pixels(buffer.data(), px, 5);
+	std::vector<lv_color_t> rendered(buffer.begin(), buffer.begin() + px);
+	display.prepare(&disp_drv, &area, buffer.data());
+	display.flush(&disp_drv, &area, buffer.data());
+
+	uint32_t mismatches = 0;
+	for(lv_coord_t y = area.y1; y <= area.y2; y++) {
+		for(lv_coord_t x = area.x1; x <= area.x2; x++) {
+			uint16_t expected = ref_rgb565(rendered[(y - area.y1) * lv_area_get_width(&area) + (x - area.x1)]);
+			mismatches += (emu.get_panel_pixel(x, y) != expected);
+			mismatches += (emu.get_gram_pixel(52 + x, 40 + y) != expected);
+		}
+	}
+	HOST_CHECK_EQUAL(0u, mismatches);
+	HOST_CHECK_EQUAL(px, emu.get_stats().pixels);
+	HOST_CHECK_EQUAL(0, emu.get_panel_pixel(area.x1 - 1, area.y1));
+	HOST_CHECK_EQUAL(0, emu.get_panel_pixel(area.x2 + 1, area.y2));
+}
+
+/** lvgl's view of a display that scrolls a band of rows in hardware */
+class ScrollingFrame
+{
+	public:
+
+		ScrollingFrame(TestST7789& display, lv_coord_t w, lv_coord_t h, lv_coord_t strip_h) :
+				display(display), w(w), h(h), strip_h(strip_h), seed(100),
+				buffer((size_t) w * strip_h), frame((size_t) w * h) {
+			lv_disp_drv_init(&disp_drv);
+		}
+
+		/** Draws new content in rows y1 to y2 and flushes them strip by strip */
+		void redraw(lv_coord_t y1, lv_coord_t y2) {
+			for(lv_coord_t y = y1; y <= y2; y += strip_h) {
+				lv_coord_t last = (y + strip_h - 1 < y2) ? (y + strip_h - 1) : y2;
+				lv_area_t area;
+				lv_area_set(&area, 0, y, w - 1, last);
+				uint32_t px = lv_area_get_size(&area);
+				ref_random_pixels(buffer.data(), px, seed++);
+				memcpy(&frame[(size_t) y * w], buffer.data(), px * sizeof(lv_color_t));
+				display.prepare(&disp_drv, &area, buffer.data());
+				display.flush(&disp_drv, &area, buffer.data());
+			}
+		}
+
+		/** Scrolls the band's content by dy rows and redraws the rows that came into view */
+		void scroll(lv_coord_t top, lv_coord_t bottom, lv_coord_t dy) {
+			std::vector<lv_color_t> old(frame);
+			lv_coord_t first_new = bottom + 1;
+			lv_coord_t last_new = top - 1;
+			for(lv_coord_t y = top; y <= bottom; y++) {
+				lv_coord_t from = y - dy;
+				if(from >= top && from <= bottom) {
+					memcpy(&frame[(size_t) y * w], &old[(size_t) from * w], w * sizeof(lv_color_t));
+				} else {
+					first_new = (y < first_new) ? y : first_new;
+					last_new = (y > last_new) ? y : last_new;
+				}
+			}
+
+			display.scroll(dy);
+			if(first_new <= last_new) {
+				redraw(first_new, last_new);
+			}
+		}
+
+		TestST7789& display;
+		lv_coord_t w;
+		lv_coord_t h;
+		lv_coord_t strip_h;
+		uint32_t seed;
+		lv_disp_drv_t disp_drv;
+		std::vector<lv_color_t> buffer;
+		std::vector<lv_color_t> frame;
+};
+
+/** Counts the pixels where the panel differs from the whole frame flushed without scrolling */
+static uint32_t rerender_mismatches(const ST7789Emulator& emu, const ScrollingFrame& view,
+		uint16_t panel_x, uint16_t panel_y)
+{
+	ST7789Emulator reference(view.w, view.h, panel_x, panel_y);
+	std::vector<lv_color_t> buffer(view.frame);
+	TestST7789 display(reference, view.w, view.h, buffer.data(), buffer.size());
+	display.set_gram_offset(panel_x, panel_y);
+
+	lv_disp_drv_t disp_drv;
+	lv_disp_drv_init(&disp_drv);
+	lv_area_t area;
+	lv_area_set(&area, 0, 0, view.w - 1, view.h - 1);
+	display.prepare(&disp_drv, &area, buffer.data());
+	display.flush(&disp_drv, &area, buffer.data());
+
+	uint32_t mismatches = 0;
+	for(lv_coord_t y = 0; y < view.h; y++) {
+		for(lv_coord_t x = 0; x < view.w; x++) {
+			mismatches += (emu.get_panel_pixel(x, y) != reference.get_panel_pixel(x, y));
+		}
+	}
+	return mismatches;
+}
+
+static void test_scroll_matches_full_rerender(void)
+{
+	// Fixed header (rows 0 to 39) and footer (rows 280 to 319) around the band
+	const lv_coord_t w = 240;
+	const lv_coord_t h = 320;
+	const lv_coord_t top = 40;
+	const lv_coord_t bottom = 279;
+	ST7789Emulator emu;
+	std::vector<lv_color_t> buffer(w * 32);
+	TestST7789 display(emu, w, h, buffer.data(), buffer.size());
+	ScrollingFrame view(display, w, h, 32);
+
+	display.set_scroll_region(top, bottom);
+	view.redraw(0, h - 1);
+	HOST_CHECK_EQUAL(0u, panel_mismatches(emu, view.frame, w, h));
+
+	// Up and down, by less than the band, by exactly the band (scroll_height)
+	// and by more, so the display RAM offset wraps around both ways
+	const lv_coord_t steps[] = { -37, -100, 60, -240, 150, 13, -500, 240, 1, -1 };
+	for(size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+		view.scroll(top, bottom, steps[i]);
+		HOST_CHECK_EQUAL(0u, panel_mismatches(emu, view.frame, w, h));
+		HOST_CHECK_EQUAL(0u, rerender_mismatches(emu, view, 0, 0));
+	}
+
+	// Strips across the edges of the band and across the display RAM wrap
+	view.redraw(24, 71);
+	view.redraw(260, 299);
+	view.redraw(100, 259);
+	HOST_CHECK_EQUAL(0u, panel_mismatches(emu, view.frame, w, h));
+	HOST_CHECK_EQUAL(0u, rerender_mismatches(emu, view, 0, 0));
+	HOST_CHECK_EQUAL(0u, emu.get_stats().out_of_range);
+	HOST_CHECK_EQUAL(0u, emu.get_stats().window_wraps);
+}
+
+static void test_scroll_with_gram_offset(void)
+{
+	// 240x240 panel at GRAM row 80, scrolling everything but a 20 row header
+	const lv_coord_t size = 240;
+	ST7789Emulator emu(size, size, 0, 80);
+	std::vector<lv_color_t> buffer(size * 20);
+	TestST7789 display(emu, size, size, buffer.data(), buffer.size());
+	display.set_gram_offset(0, 80);
+	ScrollingFrame view(display, size, size, 20);
+
+	display.set_scroll_region(20, size - 1);
+	view.redraw(0, size - 1);
+
+	const lv_coord_t steps[] = { -50, -170, 33, 220 };
+	for(size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+		view.scroll(20, size - 1, steps[i]);
+		HOST_CHECK_EQUAL(0u, panel_mismatches(emu, view.frame, size, size));
+		HOST_CHECK_EQUAL(0u, rerender_mismatches(emu, view, 0, 80));
+	}
+
+	// Turning scrolling off shows display RAM as is: the driver redraws everything
+	display.set_scroll_region(0, -1);
+	view.redraw(0, size - 1);
+	HOST_CHECK_EQUAL(0u, panel_mismatches(emu, view.frame, size, size));
+	HOST_CHECK_EQUAL(0u, emu.get_stats().out_of_range);
+}
+
+/**
+ * Flushes frames of 240x240 in 24-row strips the way LittlevGL does: the
+ * first strip of each frame waits for the frame sync, if there is one.
+ * Frames start at a varying phase of the panel's refresh.
+ *
+ * @retval torn RAM writes
+ */
+static uint32_t flush_frames(bool sync, int frames)
+{
+	const lv_coord_t size = 240;
+	const lv_coord_t strip_h = 24;
+	ST7789Emulator emu(size, size);
+
+	// 62.5MHz SPI writes a frame in less than the panel takes to scan it
+	ST7789Emulator::bus_config_t bus = { 62500000, 200, 20, 2000 };
+	emu.set_bus_config(bus);
+
+	std::vector<lv_color_t> buffer(size * strip_h);
+	TestST7789 display(emu, size, size, buffer.data(), buffer.size());
+	display.set_frame_sync(sync ? &emu : NULL);
+
+	lv_disp_drv_t disp_drv;
+	lv_disp_drv_init(&disp_drv);
+	for(int frame = 0; frame < frames; frame++) {
+		// The application's work between frames
+		emu.advance(3000000 + (frame * 1700000) % 11000000);
+
+		display.start_frame();
+		for(lv_coord_t y = 0; y < size; y += strip_h) {
+			// Rendering a strip
+			emu.advance(50000);
+			lv_area_t area;
+			lv_area_set(&area, 0, y, size - 1, y + strip_h - 1);
+			ref_random_pixels(buffer.data(), size * strip_h, frame * size + y);
+			if(display.take_frame_start()) {
+				display.wait_frame_sync();
+			}
+			display.prepare(&disp_drv, &area, buffer.data());
+			display.flush(&disp_drv, &area, buffer.data());
+		}
+	}
+
+	// NOP, closes the last RAM write
+	command(emu, 0x00);
+	HOST_CHECK_EQUAL((uint32_t) frames * (size / strip_h), emu.get_stats().windows_written);
+	HOST_CHECK_EQUAL(0u, display.get_sync_timeouts());
+	return emu.get_stats().torn_writes;
+}
+
+static void test_frame_sync_prevents_tearing(void)
+{
+	const int frames = 60;
+	uint32_t torn_free = flush_frames(false, frames);
+	uint32_t torn_synced = flush_frames(true, frames);
+
+	printf("  torn flushes in %d frames: %u free running, %u with frame sync\n",
+			frames, (unsigned) torn_free, (unsigned) torn_synced);
+	HOST_CHECK(torn_free > 0);
+	HOST_CHECK_EQUAL(0u, torn_synced);
+}
+
+int main(void)
+{
+	HOST_TEST_RUN(test_window_wraps_inside);
+	HOST_TEST_RUN(test_ram_write_continue);
+	HOST_TEST_RUN(test_madctl_mirrors_and_exchanges);
+	HOST_TEST_RUN(test_gram_offset);
+	HOST_TEST_RUN(test_gram_offset_partial_window);
+	HOST_TEST_RUN(test_scroll_matches_full_rerender);
+	HOST_TEST_RUN(test_scroll_with_gram_offset);
+	HOST_TEST_RUN(test_frame_sync_prevents_tearing);
+	return host_test_result();
+}
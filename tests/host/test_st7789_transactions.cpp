@@ -0,0 +1,319 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Bus traffic of ST7789LVGL flushes, on a recording fake interface
+ *
+ * Every call of the interface is one chip-select cycle. With a batched
+ * interface each flush must be a single transaction (one chip-select
+ * cycle, no idle gap between cycles), whatever the color depth, including
+ * strips that wrap around the hardware scroll band and full-frame regions.
+ * The pixel bytes that reach display RAM are checked too.
+ */
+
+#include <vector>
+
+#include "host_test.h"
+#include "pixel_ops_reference.h"
+
+#include "drivers/ST7789LVGL.h"
+
+static const lv_coord_t WIDTH = 240;
+static const lv_coord_t HEIGHT = 320;
+
+/** Records what an ST7789 would receive, and how */
+class RecordingBus : public DisplayInterface, public BatchedDisplayInterface
+{
+	public:
+
+		typedef struct {
+			uint16_t x1, x2, y1, y2;
+		} window_t;
+
+		RecordingBus() {
+			reset();
+		}
+
+		void reset(void) {
+			cs_cycles = 0;
+			transactions = 0;
+			dc_toggles = 0;
+			dc = false;
+			current_cmd = 0;
+			params.clear();
+			windows.clear();
+			pixels.clear();
+		}
+
+		/** Idle gaps between chip-select cycles since the last reset */
+		uint32_t idle_gaps(void) const {
+			return (cs_cycles > 0) ? (cs_cycles - 1) : 0;
+		}
+
+		virtual void write_command(uint8_t command) {
+			cs_cycles++;
+			set_dc(false);
+			decode_command(command);
+		}
+
+		virtual void write_data(uint8_t* data, uint32_t length) {
+			cs_cycles++;
+			set_dc(true);
+			decode_data(data, length);
+		}
+
+		virtual void execute(const DisplayTransaction& transaction) {
+			cs_cycles++;
+			transactions++;
+			for(size_t i = 0; i < transaction.get_step_count(); i++) {
+				const DisplayTransaction::step_t& step = transaction.get_step(i);
+				set_dc(step.type == DisplayTransaction::STEP_DATA);
+				if(step.type == DisplayTransaction::STEP_COMMAND) {
+					decode_command(step.data[0]);
+					continue;
+				}
+				for(uint32_t row = 0; row < step.len / step.row_len; row++) {
+					decode_data(DisplayTransaction::get_row(step, row), step.row_len);
+				}
+			}
+		}
+
+		uint32_t cs_cycles;
+		uint32_t transactions;
+		uint32_t dc_toggles;
+		std::vector<window_t> windows;
+		std::vector<uint8_t> pixels;
+
+	protected:
+
+		void set_dc(bool data) {
+			if(data != dc) {
+				dc_toggles++;
+			}
+			dc = data;
+		}
+
+		void decode_command(uint8_t command) {
+			apply_params();
+			current_cmd = command;
+			if(command == 0x2C) {
+				windows.push_back(window);
+			}
+		}
+
+		void decode_data(const uint8_t* data, uint32_t length) {
+			if(current_cmd == 0x2C || current_cmd == 0x3C) {
+				pixels.insert(pixels.end(), data, data + length);
+			} else {
+				params.insert(params.end(), data, data + length);
+			}
+		}
+
+		void apply_params(void) {
+			if(params.size() == 4 && current_cmd == 0x2A) {
+				window.x1 = (params[0] << 8) | params[1];
+				window.x2 = (params[2] << 8) | params[3];
+			} else if(params.size() == 4 && current_cmd == 0x2B) {
+				window.y1 = (params[0] << 8) | params[1];
+				window.y2 = (params[2] << 8) | params[3];
+			}
+			params.clear();
+		}
+
+		bool dc;
+		uint8_t current_cmd;
+		std::vector<uint8_t> params;
+		window_t window;
+};
+
+/** Exposes the flush path */
+class TestST7789 : public ST7789LVGL
+{
+	public:
+
+		TestST7789(DisplayInterface& bus, lv_color_t* buffer, uint32_t size) :
+				ST7789LVGL(bus, NC, NC, mbed::Span<lv_color_t>(buffer, size)) {
+			set_resolution(WIDTH, HEIGHT);
+		}
+
+		using ST7789LVGL::flush;
+		using ST7789LVGL::flush_regions;
+		using ST7789LVGL::set_scroll_region;
+		using ST7789LVGL::scroll;
+};
+
+/** Bytes the panel must receive for rendered pixels */
+static void expect_pixels(std::vector<uint8_t>& out, const lv_color_t* px, uint32_t len)
+{
+	for(uint32_t i = 0; i < len; i++) {
+#if LV_COLOR_DEPTH == 16
+		// Sent as rendered (LV_COLOR_16_SWAP picks the byte order)
+		const uint8_t* bytes = (const uint8_t*) &px[i];
+		out.push_back(bytes[0]);
+		out.push_back(bytes[1]);
+#else
+		uint16_t v = ref_rgb565(px[i]);
+		out.push_back(v >> 8);
+		out.push_back(v & 0xFF);
+#endif
+	}
+}
+
+static bool window_is(const RecordingBus::window_t& w, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+{
+	return w.x1 == x1 && w.y1 == y1 && w.x2 == x2 && w.y2 == y2;
+}
+
+static void test_strip_is_one_transaction(void)
+{
+	const lv_coord_t strip_h = 40;
+	std::vector<lv_color_t> buffer(WIDTH * strip_h);
+	RecordingBus bus;
+	TestST7789 display(bus, buffer.data(), buffer.size());
+	display.set_batched_interface(&bus);
+	lv_disp_drv_t disp_drv;
+	lv_disp_drv_init(&disp_drv);
+
+	for(lv_coord_t y = 0; y < HEIGHT; y += strip_h) {
+		lv_area_t area;
+		lv_area_set(&area, 0, y, WIDTH - 1, y + strip_h - 1);
+		ref_random_pixels(buffer.data(), buffer.size(), y);
+		std::vector<uint8_t> expected;
+		expect_pixels(expected, buffer.data(), buffer.size());
+
+		bus.reset();
+		display.prepare(&disp_drv, &area, buffer.data());
+		display.flush(&disp_drv, &area, buffer.data());
+
+		HOST_CHECK_EQUAL(1u, bus.transactions);
+		HOST_CHECK_EQUAL(1u, bus.cs_cycles);
+		HOST_CHECK_EQUAL(0u, bus.idle_gaps());
+		// CASET, RASET and RAMWR each followed by their data
+		HOST_CHECK_EQUAL(5u, bus.dc_toggles);
+		HOST_CHECK_EQUAL((size_t) 1, bus.windows.size());
+		HOST_CHECK(window_is(bus.windows[0], 0, y, WIDTH - 1, y + strip_h - 1));
+		HOST_CHECK(bus.pixels == expected);
+	}
+}
+
+static void test_wrapped_strip_is_one_transaction(void)
+{
+	const lv_coord_t strip_h = 64;
+	std::vector<lv_color_t> buffer(WIDTH * strip_h);
+	RecordingBus bus;
+	TestST7789 display(bus, buffer.data(), buffer.size());
+	display.set_batched_interface(&bus);
+	lv_disp_drv_t disp_drv;
+	lv_disp_drv_init(&disp_drv);
+
+	// Band of rows 40 to 279, content moved up by 100 rows: band row 140
+	// (lvgl row 180) is where display RAM wraps around
+	display.set_scroll_region(40, 279);
+	display.scroll(-100);
+
+	lv_area_t area;
+	lv_area_set(&area, 0, 150, WIDTH - 1, 150 + strip_h - 1);
+	ref_random_pixels(buffer.data(), buffer.size(), 7);
+	std::vector<uint8_t> expected;
+	expect_pixels(expected, buffer.data(), buffer.size());
+
+	bus.reset();
+	display.prepare(&disp_drv, &area, buffer.data());
+	display.flush(&disp_drv, &area, buffer.data());
+
+	HOST_CHECK_EQUAL(1u, bus.transactions);
+	HOST_CHECK_EQUAL(1u, bus.cs_cycles);
+	HOST_CHECK_EQUAL(0u, bus.idle_gaps());
+	HOST_CHECK_EQUAL((size_t) 2, bus.windows.size());
+	if(bus.windows.size() == 2) {
+		// lvgl rows 150..179 are RAM rows 250..279, rows 180..213 wrap to 40..73
+		HOST_CHECK(window_is(bus.windows[0], 0, 250, WIDTH - 1, 279));
+		HOST_CHECK(window_is(bus.windows[1], 0, 40, WIDTH - 1, 73));
+	}
+	HOST_CHECK(bus.pixels == expected);
+}
+
+static void test_full_frame_regions_are_one_transaction(void)
+{
+	std::vector<lv_color_t> frame(WIDTH * HEIGHT);
+	ref_random_pixels(frame.data(), frame.size(), 3);
+	RecordingBus bus;
+	TestST7789 display(bus, frame.data(), frame.size());
+	display.set_batched_interface(&bus);
+	lv_disp_drv_t disp_drv;
+	lv_disp_drv_init(&disp_drv);
+
+	lv_area_t screen;
+	lv_area_set(&screen, 0, 0, WIDTH - 1, HEIGHT - 1);
+	lv_area_t regions[2];
+	lv_area_set(&regions[0], 10, 20, 99, 59);
+	lv_area_set(&regions[1], 120, 200, 239, 209);
+	LVGLFlushDescriptor desc(frame.data(), &screen, true);
+	std::vector<uint8_t> expected;
+	for(size_t i = 0; i < 2; i++) {
+		HOST_CHECK(desc.add_region(&regions[i]));
+		for(lv_coord_t y = regions[i].y1; y <= regions[i].y2; y++) {
+			expect_pixels(expected, &frame[y * WIDTH + regions[i].x1], lv_area_get_width(&regions[i]));
+		}
+	}
+
+	bus.reset();
+	display.flush_regions(&disp_drv, desc);
+
+	HOST_CHECK_EQUAL(1u, bus.transactions);
+	HOST_CHECK_EQUAL(1u, bus.cs_cycles);
+	HOST_CHECK_EQUAL(0u, bus.idle_gaps());
+	HOST_CHECK_EQUAL((size_t) 2, bus.windows.size());
+	if(bus.windows.size() == 2) {
+		HOST_CHECK(window_is(bus.windows[0], 10, 20, 99, 59));
+		HOST_CHECK(window_is(bus.windows[1], 120, 200, 239, 209));
+	}
+	HOST_CHECK(bus.pixels == expected);
+}
+
+static void test_individual_calls_without_batched_interface(void)
+{
+	const lv_coord_t strip_h = 16;
+	std::vector<lv_color_t> buffer(WIDTH * strip_h);
+	RecordingBus bus;
+	TestST7789 display(bus, buffer.data(), buffer.size());
+	lv_disp_drv_t disp_drv;
+	lv_disp_drv_init(&disp_drv);
+
+	lv_area_t area;
+	lv_area_set(&area, 0, 100, WIDTH - 1, 100 + strip_h - 1);
+	ref_random_pixels(buffer.data(), buffer.size(), 11);
+	std::vector<uint8_t> expected;
+	expect_pixels(expected, buffer.data(), buffer.size());
+
+	bus.reset();
+	display.prepare(&disp_drv, &area, buffer.data());
+	display.flush(&disp_drv, &area, buffer.data());
+
+	HOST_CHECK_EQUAL(0u, bus.transactions);
+	HOST_CHECK_EQUAL((size_t) 1, bus.windows.size());
+	HOST_CHECK(bus.pixels == expected);
+}
+
+int main(void)
+{
+	HOST_TEST_RUN(test_strip_is_one_transaction);
+	HOST_TEST_RUN(test_wrapped_strip_is_one_transaction);
+	HOST_TEST_RUN(test_full_frame_regions_are_one_transaction);
+	HOST_TEST_RUN(test_individual_calls_without_batched_interface);
+	return host_test_result();
+}
@@ -0,0 +1,147 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * StaticLayer re-rendering on changes of its static children
+ *
+ * A panel holds a static box and a dynamic one, frames are flushed to a
+ * framebuffer. Checks that:
+ * - hiding a static child, which only its parent is told about, renders
+ *   the layer again and the box is gone from the frame
+ * - moving a static child renders the layer again
+ * - changes of the dynamic child are drawn over the layer, which is not
+ *   rendered again
+ */
+
+#include <string.h>
+
+#include "host_test.h"
+
+#include "lv_obj.h"
+#include "lv_hal_disp.h"
+#include "lv_refr.h"
+#include "widgets/StaticLayer.h"
+
+static const lv_coord_t HOR_RES = LV_HOR_RES_MAX;
+
+static lv_color_t framebuffer[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+static lv_color_t strip[LV_HOR_RES_MAX * 10];
+
+static void flush(lv_disp_drv_t* drv, const lv_area_t* area, lv_color_t* color_p)
+{
+	for(lv_coord_t y = area->y1; y <= area->y2; y++) {
+		lv_coord_t w = lv_area_get_width(area);
+		memcpy(&framebuffer[y * HOR_RES + area->x1], color_p, w * sizeof(lv_color_t));
+		color_p += w;
+	}
+	lv_disp_flush_ready(drv);
+}
+
+static void init_display(void)
+{
+	static lv_disp_buf_t disp_buf;
+
+	lv_init();
+	lv_disp_buf_init(&disp_buf, strip, NULL, sizeof(strip) / sizeof(strip[0]));
+	lv_disp_drv_t drv;
+	lv_disp_drv_init(&drv);
+	drv.buffer = &disp_buf;
+	drv.flush_cb = flush;
+	lv_disp_drv_register(&drv);
+}
+
+static lv_color_t pixel(lv_coord_t x, lv_coord_t y)
+{
+	return framebuffer[y * HOR_RES + x];
+}
+
+static bool same_color(lv_color_t a, lv_color_t b)
+{
+	return lv_color_to32(a) == lv_color_to32(b);
+}
+
+static void test_static_child_changes(void)
+{
+	init_display();
+
+	static lv_style_t panel_style;
+	lv_style_copy(&panel_style, &lv_style_plain_color);
+	panel_style.body.main_color = LV_COLOR_BLUE;
+	panel_style.body.grad_color = LV_COLOR_BLUE;
+
+	static lv_style_t box_style;
+	lv_style_copy(&box_style, &lv_style_plain_color);
+	box_style.body.main_color = LV_COLOR_RED;
+	box_style.body.grad_color = LV_COLOR_RED;
+
+	lv_obj_t* panel = lv_obj_create(lv_scr_act(), NULL);
+	lv_obj_set_style(panel, &panel_style);
+	lv_obj_set_pos(panel, 10, 10);
+	lv_obj_set_size(panel, 100, 100);
+
+	lv_obj_t* box = lv_obj_create(panel, NULL);
+	lv_obj_set_style(box, &box_style);
+	lv_obj_set_pos(box, 10, 10);
+	lv_obj_set_size(box, 20, 20);
+
+	lv_obj_t* dynamic = lv_obj_create(panel, box);
+	lv_obj_set_pos(dynamic, 50, 50);
+
+	StaticLayer layer(panel);
+	layer.add_static(box);
+	lv_refr_now(NULL);
+	HOST_CHECK_EQUAL(1, layer.get_renders());
+	HOST_CHECK_EQUAL(0, layer.get_fallbacks());
+	HOST_CHECK(same_color(LV_COLOR_RED, pixel(30, 30)));
+	HOST_CHECK(same_color(LV_COLOR_RED, pixel(70, 70)));
+
+	lv_obj_set_hidden(box, true);
+	lv_refr_now(NULL);
+	HOST_CHECK_EQUAL(2, layer.get_renders());
+	HOST_CHECK(same_color(LV_COLOR_BLUE, pixel(30, 30)));
+
+	lv_obj_set_hidden(box, false);
+	lv_refr_now(NULL);
+	HOST_CHECK_EQUAL(3, layer.get_renders());
+	HOST_CHECK(same_color(LV_COLOR_RED, pixel(30, 30)));
+
+	lv_obj_set_pos(box, 10, 60);
+	lv_refr_now(NULL);
+	HOST_CHECK_EQUAL(4, layer.get_renders());
+	HOST_CHECK(same_color(LV_COLOR_BLUE, pixel(30, 30)));
+	HOST_CHECK(same_color(LV_COLOR_RED, pixel(30, 80)));
+
+	// Drawn over the layer served from the buffer
+	uint32_t hits = layer.get_hits();
+	lv_obj_set_hidden(dynamic, true);
+	lv_refr_now(NULL);
+	HOST_CHECK(same_color(LV_COLOR_BLUE, pixel(70, 70)));
+	lv_obj_set_pos(dynamic, 60, 20);
+	lv_obj_set_hidden(dynamic, false);
+	lv_refr_now(NULL);
+	HOST_CHECK(same_color(LV_COLOR_RED, pixel(80, 30)));
+	HOST_CHECK_EQUAL(4, layer.get_renders());
+	HOST_CHECK(layer.get_hits() > hits);
+
+	lv_obj_del(panel);
+}
+
+int main(void)
+{
+	HOST_TEST_RUN(test_static_child_changes);
+	return host_test_result();
+}
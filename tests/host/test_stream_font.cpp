@@ -0,0 +1,151 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * StreamFont reading files written by tools/stream_font_conv.py
+ *
+ * Checks that:
+ * - glyphs of a converted font are found in each range, with their metrics
+ *   and bitmaps
+ * - a range table larger than the file is rejected before anything is
+ *   allocated for it, whether or not the driver can tell the file size
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "host_test.h"
+
+#include "lv_fs.h"
+#include "platform/filesystem_wrapper.h"
+#include "fonts/StreamFont.h"
+
+static const char* FONT_FILE = "test_stream_font.lvsf";
+
+/**
+ * stream_font_conv.py output for a 1 bpp BDF font with 'A', 'B' and U+4E00
+ * (FONT_ASCENT 7, FONT_DESCENT 1)
+ */
+static const uint8_t converted_font[] = {
+	0x4c, 0x56, 0x53, 0x46, 0x01, 0x00, 0x01, 0x00, 0x08, 0x00, 0x01, 0x00,
+	0x02, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00,
+	0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0x00, 0x00, 0x00,
+	0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4e, 0x00, 0x00,
+	0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x5c, 0x00, 0x00, 0x00,
+	0x60, 0x00, 0x05, 0x07, 0x00, 0x00, 0x00, 0x00, 0x61, 0x00, 0x00, 0x00,
+	0x60, 0x00, 0x05, 0x07, 0x00, 0x00, 0x00, 0x00, 0x66, 0x00, 0x00, 0x00,
+	0x90, 0x00, 0x09, 0x01, 0x00, 0x03, 0x00, 0x00, 0x22, 0xa3, 0xf8, 0xc6,
+	0x20, 0xf4, 0x7d, 0x18, 0xc7, 0xc0, 0xff, 0x80,
+};
+
+/** Offset of range_count in the header */
+static const size_t RANGE_COUNT_OFFSET = 12;
+
+static bool write_file(const std::vector<uint8_t>& data)
+{
+	FILE* f = fopen(FONT_FILE, "wb");
+	if(f == NULL) {
+		return false;
+	}
+	bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+	return (fclose(f) == 0) && ok;
+}
+
+static void register_driver(bool with_size)
+{
+	lv_fs_stub_reset();
+	lv_fs_drv_t drv;
+	lv_fs_drv_init(&drv);
+	mbed_lvgl_fs_wrapper_default(&drv);
+	drv.letter = 'M';
+	if(!with_size) {
+		drv.size_cb = NULL;
+	}
+	lv_fs_drv_register(&drv);
+}
+
+static bool open_font(StreamFont& font)
+{
+	char path[64];
+	snprintf(path, sizeof(path), "M:/%s", FONT_FILE);
+	return font.open(path);
+}
+
+static void test_converted_font(void)
+{
+	register_driver(true);
+	HOST_CHECK(write_file(std::vector<uint8_t>(converted_font, converted_font + sizeof(converted_font))));
+
+	StreamFont font(4, 8);
+	HOST_CHECK(open_font(font));
+	const lv_font_t* lv_font = font.get_lv_font();
+	HOST_CHECK_EQUAL(8, lv_font->line_height);
+	HOST_CHECK_EQUAL(1, lv_font->base_line);
+
+	lv_font_glyph_dsc_t dsc;
+	HOST_CHECK(lv_font_get_glyph_dsc(lv_font, &dsc, 'B', 0));
+	HOST_CHECK_EQUAL(6, dsc.adv_w);
+	HOST_CHECK_EQUAL(5, dsc.box_w);
+	HOST_CHECK_EQUAL(7, dsc.box_h);
+	HOST_CHECK_EQUAL(1, dsc.bpp);
+	const uint8_t* bitmap = lv_font_get_glyph_bitmap(lv_font, 'B');
+	HOST_CHECK(bitmap != NULL && bitmap[0] == 0xf4);
+
+	HOST_CHECK(lv_font_get_glyph_dsc(lv_font, &dsc, 0x4E00, 0));
+	HOST_CHECK_EQUAL(9, dsc.adv_w);
+	HOST_CHECK_EQUAL(9, dsc.box_w);
+	HOST_CHECK_EQUAL(1, dsc.box_h);
+	HOST_CHECK_EQUAL(3, dsc.ofs_y);
+	bitmap = lv_font_get_glyph_bitmap(lv_font, 0x4E00);
+	HOST_CHECK(bitmap != NULL && bitmap[0] == 0xff && bitmap[1] == 0x80);
+
+	HOST_CHECK(!lv_font_get_glyph_dsc(lv_font, &dsc, 'C', 0));
+
+	remove(FONT_FILE);
+}
+
+static void test_oversized_range_table_is_rejected(void)
+{
+	std::vector<uint8_t> huge(converted_font, converted_font + sizeof(converted_font));
+	huge[RANGE_COUNT_OFFSET + 3] = 0x10;
+
+	// Cut in the middle of the second range
+	std::vector<uint8_t> truncated(converted_font, converted_font + 32 + 12 + 6);
+
+	for(int with_size = 1; with_size >= 0; with_size--) {
+		register_driver(with_size != 0);
+		StreamFont font(4, 8);
+
+		HOST_CHECK(write_file(huge));
+		HOST_CHECK(!open_font(font));
+		HOST_CHECK(font.get_lv_font()->get_glyph_dsc == NULL);
+
+		HOST_CHECK(write_file(truncated));
+		HOST_CHECK(!open_font(font));
+	}
+
+	remove(FONT_FILE);
+}
+
+int main(void)
+{
+	HOST_TEST_RUN(test_converted_font);
+	HOST_TEST_RUN(test_oversized_range_table_is_rejected);
+	return host_test_result();
+}
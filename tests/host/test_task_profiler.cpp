@@ -0,0 +1,248 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * TaskProfiler on tasks run by the stub's lv_task_handler(), the tick being
+ * advanced by the test
+ *
+ * Checks that:
+ * - calls, late runs (more than half a period late) and overruns (longer
+ *   than the period) are counted per task
+ * - a task created where a deleted one was starts with fresh statistics
+ * - a full table counts untracked tasks, which only take the slots of
+ *   deleted ones
+ * - reset() forgets deleted tasks and compacts the table
+ */
+
+#include <string.h>
+
+#include "host_test.h"
+
+#include "lv_task.h"
+#include "lv_hal_tick.h"
+#include "platform/TaskProfiler.h"
+
+static const size_t SLOTS = MBED_CONF_MBED_LVGL_TASK_PROFILER_SLOTS;
+
+static uint32_t task_a_calls;
+static uint32_t task_b_calls;
+static uint32_t busy_ms;
+
+static void task_a(lv_task_t* task)
+{
+	(void) task;
+	task_a_calls++;
+}
+
+static void task_b(lv_task_t* task)
+{
+	(void) task;
+	task_b_calls++;
+}
+
+/** Runs for busy_ms */
+static void busy_task(lv_task_t* task)
+{
+	(void) task;
+	uint64_t end = host_time_ns() + (uint64_t) busy_ms * 1000000;
+	while(host_time_ns() < end) {
+	}
+}
+
+/** What update() does: attach, then run the tasks due */
+static void run_tasks(uint32_t elapsed_ms)
+{
+	lv_tick_inc(elapsed_ms);
+	TaskProfiler::attach();
+	lv_task_handler();
+}
+
+static const TaskProfiler::entry_t* find_entry(const TaskProfiler::entry_t* entries, size_t count, lv_task_t* task)
+{
+	for(size_t i = 0; i < count; i++) {
+		if(entries[i].task == task) {
+			return &entries[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Reinitializes a task the way lv_task_create() would have if it had
+ * allocated it where a deleted task was (ASan keeps freed memory from
+ * being reused)
+ */
+static void recreate_in_place(lv_task_t* task, lv_task_cb_t task_cb, uint32_t period)
+{
+	memset(task, 0, sizeof(*task));
+	task->period = period;
+	task->last_run = lv_tick_get();
+	task->task_cb = task_cb;
+	task->prio = LV_TASK_PRIO_MID;
+}
+
+/** Starts from no tasks and no statistics */
+static void start(void)
+{
+	lv_init();
+	TaskProfiler::attach();
+	TaskProfiler::reset();
+}
+
+static void test_calls_late_runs_and_overruns(void)
+{
+	start();
+	task_a_calls = 0;
+
+	lv_task_t* a = lv_task_create(task_a, 10, LV_TASK_PRIO_MID, NULL);
+	lv_task_t* busy = lv_task_create(busy_task, 2, LV_TASK_PRIO_MID, NULL);
+	TaskProfiler::set_task_name(a, "a");
+
+	// On time, then 5 ms late (not late yet), then 8 ms late
+	busy_ms = 0;
+	run_tasks(10);
+	run_tasks(10);
+	run_tasks(15);
+	run_tasks(18);
+
+	// Overrunning its 2 ms period, twice
+	busy_ms = 3;
+	run_tasks(10);
+	run_tasks(10);
+
+	HOST_CHECK(a->task_cb != task_a);
+	HOST_CHECK(TaskProfiler::get_task_cb(a) == task_a);
+	HOST_CHECK_EQUAL(6, task_a_calls);
+
+	TaskProfiler::entry_t entries[SLOTS];
+	size_t count = TaskProfiler::snapshot(entries, SLOTS);
+	HOST_CHECK_EQUAL(2, count);
+
+	const TaskProfiler::entry_t* entry = find_entry(entries, count, a);
+	HOST_CHECK(entry != NULL);
+	HOST_CHECK(strcmp(entry->name, "a") == 0);
+	HOST_CHECK(entry->alive);
+	HOST_CHECK_EQUAL(10, entry->period);
+	HOST_CHECK_EQUAL(6, entry->calls);
+	HOST_CHECK_EQUAL(1, entry->late_runs);
+	HOST_CHECK_EQUAL(0, entry->overruns);
+
+	entry = find_entry(entries, count, busy);
+	HOST_CHECK(entry != NULL);
+	HOST_CHECK(entry->task_cb == busy_task);
+	HOST_CHECK_EQUAL(6, entry->calls);
+	HOST_CHECK_EQUAL(2, entry->overruns);
+	HOST_CHECK(entry->max_us >= 3000);
+	HOST_CHECK(entry->total_us >= 6000);
+
+	lv_task_del(a);
+	lv_task_del(busy);
+}
+
+static void test_reused_task_memory(void)
+{
+	start();
+	task_a_calls = 0;
+	task_b_calls = 0;
+
+	lv_task_t* task = lv_task_create(task_a, 10, LV_TASK_PRIO_MID, NULL);
+	run_tasks(10);
+	run_tasks(30);
+	HOST_CHECK_EQUAL(2, task_a_calls);
+
+	// Deleted, and a new task allocated at the same address
+	recreate_in_place(task, task_b, 20);
+	run_tasks(20);
+	run_tasks(20);
+	HOST_CHECK_EQUAL(2, task_a_calls);
+	HOST_CHECK_EQUAL(2, task_b_calls);
+
+	TaskProfiler::entry_t entries[SLOTS];
+	HOST_CHECK_EQUAL(1, TaskProfiler::snapshot(entries, SLOTS));
+	HOST_CHECK(entries[0].task == task);
+	HOST_CHECK(entries[0].task_cb == task_b);
+	HOST_CHECK_EQUAL(20, entries[0].period);
+	HOST_CHECK_EQUAL(2, entries[0].calls);
+	HOST_CHECK_EQUAL(0, entries[0].late_runs);
+	HOST_CHECK(TaskProfiler::get_task_cb(task) == task_b);
+
+	lv_task_del(task);
+}
+
+static void test_reset_and_full_table(void)
+{
+	start();
+
+	lv_task_t* tasks[SLOTS];
+	for(size_t i = 0; i < SLOTS; i++) {
+		tasks[i] = lv_task_create(task_a, 10, LV_TASK_PRIO_MID, NULL);
+	}
+	run_tasks(10);
+
+	// One task too many, first in lvgl's list
+	lv_task_t* untracked = lv_task_create(task_b, 10, LV_TASK_PRIO_HIGH, NULL);
+	run_tasks(10);
+
+	TaskProfiler::entry_t entries[SLOTS];
+	HOST_CHECK_EQUAL(SLOTS, TaskProfiler::snapshot(entries, SLOTS));
+	HOST_CHECK(find_entry(entries, SLOTS, untracked) == NULL);
+	HOST_CHECK(untracked->task_cb == task_b);
+	HOST_CHECK(TaskProfiler::get_untracked() != 0);
+
+	// It takes the slot of the deleted task, not one of a task further down the list
+	lv_task_t* deleted = tasks[SLOTS - 1];
+	lv_task_del(deleted);
+	run_tasks(10);
+	HOST_CHECK(untracked->task_cb != task_b);
+	size_t count = TaskProfiler::snapshot(entries, SLOTS);
+	HOST_CHECK_EQUAL(SLOTS, count);
+	HOST_CHECK(find_entry(entries, count, deleted) == NULL);
+	HOST_CHECK_EQUAL(1, find_entry(entries, count, untracked)->calls);
+	for(size_t i = 0; i < SLOTS - 1; i++) {
+		HOST_CHECK_EQUAL(3, find_entry(entries, count, tasks[i])->calls);
+	}
+
+	// Deleted tasks are dropped and the others moved up, with cleared statistics
+	lv_task_del(tasks[0]);
+	run_tasks(10);
+	TaskProfiler::reset();
+	HOST_CHECK_EQUAL(0, TaskProfiler::get_untracked());
+	count = TaskProfiler::snapshot(entries, SLOTS);
+	HOST_CHECK_EQUAL(SLOTS - 1, count);
+	HOST_CHECK(find_entry(entries, count, tasks[0]) == NULL);
+	for(size_t i = 0; i < count; i++) {
+		HOST_CHECK(entries[i].alive);
+		HOST_CHECK_EQUAL(0, entries[i].calls);
+		HOST_CHECK_EQUAL(0, entries[i].total_us);
+	}
+
+	// The freed slot is there for a new task
+	lv_task_t* task = lv_task_create(task_a, 10, LV_TASK_PRIO_MID, NULL);
+	run_tasks(10);
+	count = TaskProfiler::snapshot(entries, SLOTS);
+	HOST_CHECK_EQUAL(SLOTS, count);
+	HOST_CHECK_EQUAL(1, find_entry(entries, count, task)->calls);
+	HOST_CHECK_EQUAL(0, TaskProfiler::get_untracked());
+}
+
+int main(void)
+{
+	HOST_TEST_RUN(test_calls_late_runs_and_overruns);
+	HOST_TEST_RUN(test_reused_task_memory);
+	HOST_TEST_RUN(test_reset_and_full_table);
+	return host_test_result();
+}
@@ -0,0 +1,339 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Chrome trace export of events recorded from two threads taking turns,
+ * many more than the ring holds
+ *
+ * The exported JSON is parsed back and checked:
+ * - it is valid JSON, with a traceEvents array
+ * - each thread has its name, and its 'B' and 'E' events balance, none
+ *   ending a span that didn't begin
+ * - timestamps are unwrapped relative to the oldest event and don't go
+ *   backwards within a thread
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "host_test.h"
+
+#include "platform/trace.h"
+
+static const uint32_t RING_EVENTS = MBED_CONF_MBED_LVGL_TRACE_BUFFER_EVENTS;
+
+/** Frames recorded by each thread, 6 events each */
+static const uint32_t FRAMES = RING_EVENTS;
+
+/** Frames a thread records before handing over to the other one */
+static const uint32_t FRAMES_PER_TURN = 4;
+
+static std::atomic<uint32_t> turn;
+
+static void record_frames(uint32_t frames)
+{
+	for(uint32_t i = 0; i < frames; i++) {
+		MBED_LVGL_TRACE_BEGIN("frame");
+		MBED_LVGL_TRACE_BEGIN_ARG("flush", i + 1);
+		MBED_LVGL_TRACE_INSTANT("malloc", 64);
+		MBED_LVGL_TRACE_END("flush");
+		MBED_LVGL_TRACE_COUNTER("dirty", i % 8);
+		MBED_LVGL_TRACE_END("frame");
+	}
+}
+
+/** Records frames in turns with the other thread, so the ring ends up with both */
+static void record(const char* thread_name, uint32_t thread_index)
+{
+	mbed_lvgl_trace_name_thread(thread_name);
+	for(uint32_t i = 0; i < FRAMES; i += FRAMES_PER_TURN) {
+		while((turn % 2) != thread_index) {
+			std::this_thread::yield();
+		}
+		record_frames(FRAMES_PER_TURN);
+		turn++;
+	}
+}
+
+/**
+ * Minimal JSON reader: checks the syntax and keeps, for the objects of
+ * the traceEvents array, their string and number members
+ */
+class JsonReader
+{
+	public:
+
+		typedef std::map<std::string, std::string> object_t;
+
+		JsonReader(const std::string& text) : text(text), pos(0), depth(0) {
+		}
+
+		bool parse(void) {
+			if(!value(NULL)) {
+				return false;
+			}
+			skip_space();
+			return pos == text.size();
+		}
+
+		std::vector<object_t> events;
+
+	private:
+
+		void skip_space(void) {
+			while(pos < text.size() && strchr(" \t\r\n", text[pos]) != NULL) {
+				pos++;
+			}
+		}
+
+		bool expect(char c) {
+			skip_space();
+			if(pos < text.size() && text[pos] == c) {
+				pos++;
+				return true;
+			}
+			return false;
+		}
+
+		bool string(std::string* out) {
+			if(!expect('"')) {
+				return false;
+			}
+			std::string s;
+			while(pos < text.size() && text[pos] != '"') {
+				if((unsigned char) text[pos] < 0x20) {
+					return false;
+				}
+				if(text[pos] == '\\') {
+					pos++;
+					if(pos >= text.size() || strchr("\"\\/bfnrtu", text[pos]) == NULL) {
+						return false;
+					}
+				}
+				s += text[pos++];
+			}
+			if(out != NULL) {
+				*out = s;
+			}
+			return expect('"');
+		}
+
+		bool number(std::string* out) {
+			size_t start = pos;
+			if(pos < text.size() && text[pos] == '-') {
+				pos++;
+			}
+			size_t digits = pos;
+			while(pos < text.size() && (isdigit((unsigned char) text[pos]) || strchr(".eE+-", text[pos]) != NULL)) {
+				pos++;
+			}
+			if(pos == digits) {
+				return false;
+			}
+			if(out != NULL) {
+				*out = text.substr(start, pos - start);
+			}
+			return true;
+		}
+
+		bool object(object_t* out) {
+			if(!expect('{')) {
+				return false;
+			}
+			if(expect('}')) {
+				return true;
+			}
+			do {
+				std::string key;
+				std::string member;
+				if(!string(&key) || !expect(':') || !value(&member, key == "traceEvents")) {
+					return false;
+				}
+				if(out != NULL) {
+					(*out)[key] = member;
+				}
+			} while(expect(','));
+			return expect('}');
+		}
+
+		bool array(bool trace_events) {
+			if(!expect('[')) {
+				return false;
+			}
+			if(expect(']')) {
+				return true;
+			}
+			do {
+				skip_space();
+				if(trace_events && pos < text.size() && text[pos] == '{') {
+					events.push_back(object_t());
+					if(!object(&events.back())) {
+						return false;
+					}
+				} else if(!value(NULL)) {
+					return false;
+				}
+			} while(expect(','));
+			return expect(']');
+		}
+
+		bool value(std::string* out, bool trace_events = false) {
+			if(++depth > 16) {
+				return false;
+			}
+			skip_space();
+			bool ok = false;
+			if(pos < text.size()) {
+				char c = text[pos];
+				if(c == '{') {
+					ok = object(NULL);
+				} else if(c == '[') {
+					ok = array(trace_events);
+				} else if(c == '"') {
+					ok = string(out);
+				} else if(text.compare(pos, 4, "true") == 0 || text.compare(pos, 4, "null") == 0) {
+					pos += 4;
+					ok = true;
+				} else if(text.compare(pos, 5, "false") == 0) {
+					pos += 5;
+					ok = true;
+				} else {
+					ok = number(out);
+				}
+			}
+			depth--;
+			return ok;
+		}
+
+		const std::string& text;
+		size_t pos;
+		int depth;
+};
+
+static std::string export_trace(size_t* written)
+{
+	FILE* file = tmpfile();
+	HOST_CHECK(file != NULL);
+	*written = mbed_lvgl_trace_write(file);
+	std::string text;
+	rewind(file);
+	char buffer[4096];
+	size_t n;
+	while((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+		text.append(buffer, n);
+	}
+	fclose(file);
+	return text;
+}
+
+static void test_two_threads_wrapping_the_ring(void)
+{
+	mbed_lvgl_trace_clear();
+
+	turn = 0;
+	std::thread gui(record, "gui", 0);
+	std::thread worker(record, "render0", 1);
+	gui.join();
+	worker.join();
+
+	size_t written = 0;
+	std::string text = export_trace(&written);
+	JsonReader reader(text);
+	HOST_CHECK(reader.parse());
+
+	// All that the ring still holds, less the ends of overwritten spans
+	HOST_CHECK(written <= RING_EVENTS);
+	HOST_CHECK(written > RING_EVENTS - 16);
+
+	std::map<std::string, int> names;
+	std::map<std::string, int> depth;
+	std::map<std::string, unsigned long long> last_ts;
+	size_t events = 0;
+	for(size_t i = 0; i < reader.events.size(); i++) {
+		JsonReader::object_t& event = reader.events[i];
+		const std::string& tid = event["tid"];
+		HOST_CHECK(!tid.empty());
+		if(event["ph"] == "M") {
+			names[tid]++;
+			continue;
+		}
+		events++;
+
+		unsigned long long ts = strtoull(event["ts"].c_str(), NULL, 10);
+		if(last_ts.count(tid) != 0) {
+			HOST_CHECK(ts >= last_ts[tid]);
+		}
+		last_ts[tid] = ts;
+
+		if(event["ph"] == "B") {
+			depth[tid]++;
+		} else if(event["ph"] == "E") {
+			HOST_CHECK(depth[tid] > 0);
+			depth[tid]--;
+		}
+	}
+	HOST_CHECK_EQUAL(written, events);
+	HOST_CHECK_EQUAL(2, names.size());
+	HOST_CHECK_EQUAL(2, depth.size());
+	for(std::map<std::string, int>::iterator it = depth.begin(); it != depth.end(); ++it) {
+		HOST_CHECK_EQUAL(0, it->second);
+		HOST_CHECK_EQUAL(1, names.count(it->first));
+	}
+
+	// Unwrapped from the oldest event: within the recording's duration
+	unsigned long long newest = 0;
+	for(std::map<std::string, unsigned long long>::iterator it = last_ts.begin(); it != last_ts.end(); ++it) {
+		newest = (it->second > newest) ? it->second : newest;
+	}
+	HOST_CHECK(newest < 10000000);
+}
+
+static void test_paused_and_cleared(void)
+{
+	mbed_lvgl_trace_clear();
+	mbed_lvgl_trace_enable(false);
+	record_frames(FRAMES);
+	mbed_lvgl_trace_enable(true);
+
+	size_t written = 1;
+	std::string text = export_trace(&written);
+	JsonReader reader(text);
+	HOST_CHECK(reader.parse());
+	HOST_CHECK_EQUAL(0, written);
+
+	MBED_LVGL_TRACE_BEGIN("frame");
+	MBED_LVGL_TRACE_END("frame");
+	text = export_trace(&written);
+	JsonReader again(text);
+	HOST_CHECK(again.parse());
+	HOST_CHECK_EQUAL(2, written);
+}
+
+int main(void)
+{
+	HOST_TEST_RUN(test_two_threads_wrapping_the_ring);
+	HOST_TEST_RUN(test_paused_and_cleared);
+	return host_test_result();
+}
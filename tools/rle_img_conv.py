@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+# LittlevGL for Mbed-OS library
+# Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Converts an image into the row-compressed "LVRL" format understood by
+RLEImageDecoder (see decoders/RLEImageDecoder.h for the format).
+
+Examples:
+    rle_img_conv.py splash.png splash.rle
+    rle_img_conv.py --depth 16 --swap splash.png splash.rle
+    rle_img_conv.py --c-array splash_img splash.png splash_img.c
+"""
+
+import argparse
+import struct
+import sys
+
+from PIL import Image
+
+MAX_PACKET = 128
+FLAG_CHROMA = 0x01
+
+
+def pack_pixel(rgb, depth, swap):
+    r, g, b = rgb
+    if depth == 32:
+        return bytes((b, g, r, 0xFF))
+    if depth == 16:
+        value = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+        return struct.pack('>H' if swap else '<H', value)
+    if depth == 8:
+        return bytes((((r >> 5) << 5) | ((g >> 5) << 2) | (b >> 6),))
+    # 1 bit, matches lv_color_brightness thresholding
+    return bytes((1 if (r * 2 + g * 5 + b) >> 3 > 128 else 0,))
+
+
+def encode_row(pixels):
+    out = bytearray()
+    i = 0
+    n = len(pixels)
+    while i < n:
+        # Count the run starting here
+        run = 1
+        while i + run < n and run < MAX_PACKET and pixels[i + run] == pixels[i]:
+            run += 1
+
+        if run > 1:
+            out.append(0x80 | (run - 1))
+            out += pixels[i]
+            i += run
+            continue
+
+        # Gather literals until the next run of at least 2 pixels
+        start = i
+        while i < n and i - start < MAX_PACKET:
+            if i + 1 < n and pixels[i + 1] == pixels[i]:
+                break
+            i += 1
+        if i == start:
+            i += 1
+        out.append(i - start - 1)
+        for p in pixels[start:i]:
+            out += p
+    return bytes(out)
+
+
+def convert(image, depth, swap, chroma):
+    image = image.convert('RGB')
+    w, h = image.size
+    rows = []
+    for y in range(h):
+        pixels = [pack_pixel(image.getpixel((x, y)), depth, swap) for x in range(w)]
+        rows.append(encode_row(pixels))
+
+    header = b'LVRL' + struct.pack('<BBHHB5x', 1, depth, w, h, FLAG_CHROMA if chroma else 0)
+
+    offset = len(header) + (h + 1) * 4
+    table = bytearray()
+    for row in rows:
+        table += struct.pack('<I', offset)
+        offset += len(row)
+    table += struct.pack('<I', offset)
+
+    return header + bytes(table) + b''.join(rows), w, h
+
+
+def write_c_array(path, name, data):
+    with open(path, 'w') as f:
+        f.write('#include "lvgl.h"\n\n')
+        f.write('static const uint8_t %s_map[] = {\n' % name)
+        for i in range(0, len(data), 16):
+            f.write('  ' + ', '.join('0x%02x' % b for b in data[i:i + 16]) + ',\n')
+        f.write('};\n\n')
+        f.write('const lv_img_dsc_t %s = {\n' % name)
+        f.write('  .header.always_zero = 0,\n')
+        f.write('  .header.w = 0,\n')
+        f.write('  .header.h = 0,\n')
+        f.write('  .data_size = sizeof(%s_map),\n' % name)
+        f.write('  .header.cf = LV_IMG_CF_RAW,\n')
+        f.write('  .data = %s_map,\n' % name)
+        f.write('};\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert an image to the LVRL compressed format')
+    parser.add_argument('input', help='source image (any format PIL can read)')
+    parser.add_argument('output', help='output file')
+    parser.add_argument('--depth', type=int, choices=(1, 8, 16, 32), default=16,
+                        help='LV_COLOR_DEPTH of the target (default: 16)')
+    parser.add_argument('--swap', action='store_true', help='target uses LV_COLOR_16_SWAP')
+    parser.add_argument('--chroma', action='store_true', help='treat LV_COLOR_TRANSP pixels as transparent')
+    parser.add_argument('--c-array', metavar='NAME', help='emit a C source file declaring lv_img_dsc_t NAME')
+    args = parser.parse_args()
+
+    data, w, h = convert(Image.open(args.input), args.depth, args.swap, args.chroma)
+
+    if args.c_array:
+        write_c_array(args.output, args.c_array, data)
+    else:
+        with open(args.output, 'wb') as f:
+            f.write(data)
+
+    raw = w * h * max(1, args.depth // 8)
+    sys.stdout.write('%dx%d: %d bytes (%.1f%% of raw)\n' % (w, h, len(data), 100.0 * len(data) / raw))
+
+
+if __name__ == '__main__':
+    main()
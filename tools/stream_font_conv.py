@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+# LittlevGL for Mbed-OS library
+# Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Converts a font into the "LVSF" format streamed by StreamFont (see
+fonts/StreamFont.h for the format).
+
+BDF fonts are read directly. TTF/OTF fonts are rendered at the given
+pixel size with FreeType (pip install freetype-py).
+
+Examples:
+    stream_font_conv.py --size 24 --bpp 4 --range 0x20-0x7E --range 0x4E00-0x9FFF NotoSansSC.otf cjk_24.lvsf
+    stream_font_conv.py unifont.bdf unifont_16.lvsf
+"""
+
+import argparse
+import struct
+import sys
+
+HEADER_SIZE = 32
+RANGE_SIZE = 12
+GLYPH_SIZE = 12
+MAX_RANGE_LENGTH = 0xFFFF
+
+
+class Glyph(object):
+    """A rendered glyph, pixels are rows of values in 0..255"""
+
+    def __init__(self, adv_w, ofs_x, ofs_y, rows):
+        self.adv_w = adv_w          # 1/16 px
+        self.ofs_x = ofs_x
+        self.ofs_y = ofs_y          # bottom of the box above the baseline
+        self.rows = rows
+
+
+def parse_ranges(specs):
+    codepoints = set()
+    for spec in specs:
+        for part in spec.split(','):
+            first, _, last = part.partition('-')
+            first = int(first, 0)
+            last = int(last, 0) if last else first
+            if last < first:
+                raise ValueError('empty range %s' % part)
+            codepoints.update(range(first, last + 1))
+    return codepoints
+
+
+def load_bdf(path, codepoints):
+    glyphs = {}
+    ascent = descent = None
+    with open(path, 'r', encoding='latin-1') as f:
+        lines = iter(f.read().splitlines())
+
+    for line in lines:
+        words = line.split()
+        if not words:
+            continue
+        if words[0] == 'FONT_ASCENT':
+            ascent = int(words[1])
+        elif words[0] == 'FONT_DESCENT':
+            descent = int(words[1])
+        elif words[0] == 'STARTCHAR':
+            encoding = -1
+            dwidth = 0
+            bbx = (0, 0, 0, 0)
+            rows = []
+            for line in lines:
+                words = line.split()
+                if not words:
+                    continue
+                if words[0] == 'ENCODING':
+                    encoding = int(words[1])
+                elif words[0] == 'DWIDTH':
+                    dwidth = int(words[1])
+                elif words[0] == 'BBX':
+                    bbx = tuple(int(w) for w in words[1:5])
+                elif words[0] == 'BITMAP':
+                    for line in lines:
+                        if line.strip() == 'ENDCHAR':
+                            break
+                        bits = int(line.strip(), 16)
+                        width = len(line.strip()) * 4
+                        rows.append([255 if (bits >> (width - 1 - x)) & 1 else 0 for x in range(bbx[0])])
+                    break
+            if encoding < 0 or (codepoints is not None and encoding not in codepoints):
+                continue
+            w, h, xoff, yoff = bbx
+            glyphs[encoding] = Glyph(dwidth * 16, xoff, yoff, rows[:h])
+
+    if ascent is None or descent is None:
+        raise ValueError('%s has no FONT_ASCENT/FONT_DESCENT' % path)
+    return glyphs, ascent + descent, descent
+
+
+def load_freetype(path, size, bpp, codepoints):
+    try:
+        import freetype
+    except ImportError:
+        sys.exit('TTF/OTF fonts need FreeType: pip install freetype-py')
+
+    face = freetype.Face(path)
+    face.set_pixel_sizes(0, size)
+    if codepoints is None:
+        codepoints = set(c for c, _ in face.get_chars())
+
+    flags = freetype.FT_LOAD_RENDER
+    if bpp == 1:
+        flags |= freetype.FT_LOAD_TARGET_MONO
+
+    glyphs = {}
+    for c in sorted(codepoints):
+        if face.get_char_index(c) == 0:
+            continue
+        face.load_char(c, flags)
+        slot = face.glyph
+        bitmap = slot.bitmap
+        rows = []
+        for y in range(bitmap.rows):
+            line = bitmap.buffer[y * bitmap.pitch:(y + 1) * bitmap.pitch]
+            if bpp == 1:
+                rows.append([255 if (line[x >> 3] >> (7 - (x & 7))) & 1 else 0 for x in range(bitmap.width)])
+            else:
+                rows.append(list(line[:bitmap.width]))
+        # Advance is in 26.6 fixed point
+        glyphs[c] = Glyph((slot.advance.x + 2) >> 2, slot.bitmap_left, slot.bitmap_top - bitmap.rows, rows)
+
+    ascent = face.size.ascender >> 6
+    descent = -(face.size.descender >> 6)
+    return glyphs, ascent + descent, descent
+
+
+def pack_bitmap(rows, bpp):
+    # bpp bits per pixel, MSB first, rows are not padded
+    out = bytearray()
+    acc = 0
+    nbits = 0
+    for row in rows:
+        for value in row:
+            acc = (acc << bpp) | (value >> (8 - bpp))
+            nbits += bpp
+            if nbits == 8:
+                out.append(acc)
+                acc = 0
+                nbits = 0
+    if nbits:
+        out.append(acc << (8 - nbits))
+    return bytes(out)
+
+
+def convert(glyphs, line_height, base_line, bpp):
+    letters = sorted(glyphs)
+
+    ranges = []
+    for i, c in enumerate(letters):
+        if ranges and c == ranges[-1][0] + ranges[-1][1] and ranges[-1][1] < MAX_RANGE_LENGTH:
+            ranges[-1][1] += 1
+        else:
+            ranges.append([c, 1, i])
+
+    glyph_table_offset = HEADER_SIZE + len(ranges) * RANGE_SIZE
+    bitmap_offset = glyph_table_offset + len(letters) * GLYPH_SIZE
+
+    table = bytearray()
+    bitmaps = bytearray()
+    max_bitmap_size = 0
+    for c in letters:
+        g = glyphs[c]
+        box_h = len(g.rows)
+        box_w = len(g.rows[0]) if box_h else 0
+        if box_w > 255 or box_h > 255 or not -128 <= g.ofs_x <= 127 or not -128 <= g.ofs_y <= 127:
+            raise ValueError('glyph U+%04X does not fit the glyph table' % c)
+        bitmap = pack_bitmap(g.rows, bpp)
+        table += struct.pack('<IHBBbbH', bitmap_offset + len(bitmaps), min(g.adv_w, 0xFFFF),
+                             box_w, box_h, g.ofs_x, g.ofs_y, 0)
+        bitmaps += bitmap
+        max_bitmap_size = max(max_bitmap_size, len(bitmap))
+
+    header = b'LVSF' + struct.pack('<HBBHHIIIII', 1, bpp, 0, line_height, base_line,
+                                   len(ranges), len(letters), glyph_table_offset, max_bitmap_size, 0)
+    range_table = b''.join(struct.pack('<IHHI', first, length, 0, glyph_id) for first, length, glyph_id in ranges)
+
+    return header + range_table + bytes(table) + bytes(bitmaps), len(ranges), max_bitmap_size
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert a font to the LVSF stream font format')
+    parser.add_argument('input', help='source font (BDF, or TTF/OTF with freetype-py)')
+    parser.add_argument('output', help='output file')
+    parser.add_argument('--size', type=int, default=16, help='pixel size of TTF/OTF fonts (default: 16)')
+    parser.add_argument('--bpp', type=int, choices=(1, 2, 4, 8), default=None,
+                        help='bits per pixel (default: 1 for BDF, 4 otherwise)')
+    parser.add_argument('--range', action='append', default=[], metavar='FIRST[-LAST][,...]',
+                        help='codepoints to include, eg: 0x20-0x7E (default: all of the font)')
+    args = parser.parse_args()
+
+    codepoints = parse_ranges(args.range) if args.range else None
+
+    if args.input.lower().endswith('.bdf'):
+        bpp = args.bpp or 1
+        glyphs, line_height, base_line = load_bdf(args.input, codepoints)
+    else:
+        bpp = args.bpp or 4
+        glyphs, line_height, base_line = load_freetype(args.input, args.size, bpp, codepoints)
+
+    if not glyphs:
+        sys.exit('no glyphs selected')
+
+    data, range_count, max_bitmap_size = convert(glyphs, line_height, base_line, bpp)
+    with open(args.output, 'wb') as f:
+        f.write(data)
+
+    sys.stdout.write('%d glyphs in %d ranges: %d bytes, %d resident (range table), '
+                     'stream_font_max_glyph_size >= %d\n'
+                     % (len(glyphs), range_count, len(data), range_count * RANGE_SIZE, max_bitmap_size))
+
+
+if __name__ == '__main__':
+    main()
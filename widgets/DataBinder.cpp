@@ -0,0 +1,234 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataBinder.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if LV_USE_LABEL
+#include "lv_label.h"
+#endif
+#if LV_USE_BAR
+#include "lv_bar.h"
+#endif
+#if LV_USE_SLIDER
+#include "lv_slider.h"
+#endif
+#if LV_USE_GAUGE
+#include "lv_gauge.h"
+#endif
+
+#include "LittlevGL.h"
+
+#include "platform/mbed_assert.h"
+#include "platform/mbed_critical.h"
+
+/** Longest label text produced by a binding */
+#define DATA_BINDER_LABEL_LEN	32
+
+DataBinder::DataBinder()
+{
+	for(size_t i = 0; i < MBED_CONF_MBED_LVGL_DATA_BINDING_SLOTS; i++) {
+		slots[i].type = BINDING_FREE;
+	}
+	reset_stats();
+	LittlevGL::get_instance().add_frame_hook(*this);
+}
+
+DataBinder::~DataBinder()
+{
+	LittlevGL::get_instance().remove_frame_hook(*this);
+}
+
+void DataBinder::reset_stats(void)
+{
+	memset(&stats, 0, sizeof(stats));
+}
+
+int DataBinder::claim(binding_type_t type, lv_obj_t* obj)
+{
+	MBED_ASSERT(obj != NULL);
+	for(size_t i = 0; i < MBED_CONF_MBED_LVGL_DATA_BINDING_SLOTS; i++) {
+		slot_t* slot = &slots[i];
+		if(slot->type != BINDING_FREE) {
+			continue;
+		}
+
+		slot->obj = obj;
+		slot->disp = lv_obj_get_disp(obj);
+		slot->apply = NULL;
+		slot->value = 0;
+		slot->seq = 0;
+		slot->applied_seq = 0;
+		slot->applied_value = 0;
+		slot->applied = false;
+		slot->type = type;
+		return (int) i;
+	}
+	return -1;
+}
+
+#if LV_USE_LABEL
+int DataBinder::bind_label(lv_obj_t* label, const char* format)
+{
+	int id = claim(BINDING_LABEL, label);
+	if(id >= 0) {
+		slots[id].format = format;
+	}
+	return id;
+}
+#endif
+
+#if LV_USE_BAR
+int DataBinder::bind_bar(lv_obj_t* bar)
+{
+	return claim(BINDING_BAR, bar);
+}
+#endif
+
+#if LV_USE_SLIDER
+int DataBinder::bind_slider(lv_obj_t* slider)
+{
+	return claim(BINDING_SLIDER, slider);
+}
+#endif
+
+#if LV_USE_GAUGE
+int DataBinder::bind_gauge(lv_obj_t* gauge, uint8_t needle)
+{
+	int id = claim(BINDING_GAUGE, gauge);
+	if(id >= 0) {
+		slots[id].needle = needle;
+	}
+	return id;
+}
+#endif
+
+#if LV_USE_CHART
+int DataBinder::bind_chart(lv_obj_t* chart, lv_chart_series_t* series)
+{
+	int id = claim(BINDING_CHART, chart);
+	if(id >= 0) {
+		slots[id].series = series;
+	}
+	return id;
+}
+#endif
+
+int DataBinder::bind(lv_obj_t* obj, apply_t apply)
+{
+	int id = claim(BINDING_CUSTOM, obj);
+	if(id >= 0) {
+		slots[id].apply = apply;
+	}
+	return id;
+}
+
+void DataBinder::unbind(int id)
+{
+	MBED_ASSERT(id >= 0 && id < MBED_CONF_MBED_LVGL_DATA_BINDING_SLOTS);
+	slots[id].type = BINDING_FREE;
+	slots[id].obj = NULL;
+}
+
+void DataBinder::publish(int id, int32_t value)
+{
+	MBED_ASSERT(id >= 0 && id < MBED_CONF_MBED_LVGL_DATA_BINDING_SLOTS);
+	slot_t* slot = &slots[id];
+
+	/* The value is stored before the sequence number is bumped (the atomic
+	 * increment is a barrier), so a frame that sees the new sequence number
+	 * reads this value or a later one. Last writer wins. */
+	slot->value = value;
+	core_util_atomic_incr_u32((uint32_t*) &slot->seq, 1);
+
+#if MBED_CONF_RTOS_PRESENT
+	LittlevGL& lvgl = LittlevGL::get_instance();
+	if(lvgl.get_idle_state() == LittlevGL::IDLE_PARKED) {
+		lvgl.wake();
+	}
+#endif
+}
+
+void DataBinder::before_refresh(lv_disp_t* disp)
+{
+	for(size_t i = 0; i < MBED_CONF_MBED_LVGL_DATA_BINDING_SLOTS; i++) {
+		slot_t* slot = &slots[i];
+		if(slot->type == BINDING_FREE || slot->disp != disp) {
+			continue;
+		}
+
+		uint32_t seq = slot->seq;
+		if(seq == slot->applied_seq) {
+			continue;
+		}
+		int32_t value = slot->value;
+
+		stats.published += seq - slot->applied_seq;
+		slot->applied_seq = seq;
+
+		if(slot->applied && value == slot->applied_value) {
+			stats.unchanged++;
+			continue;
+		}
+
+		apply(slot, value);
+		slot->applied_value = value;
+		slot->applied = true;
+		stats.applied++;
+	}
+}
+
+void DataBinder::apply(slot_t* slot, int32_t value)
+{
+	switch(slot->type) {
+#if LV_USE_LABEL
+		case BINDING_LABEL: {
+			char text[DATA_BINDER_LABEL_LEN];
+			snprintf(text, sizeof(text), slot->format, (int) value);
+			lv_label_set_text(slot->obj, text);
+			break;
+		}
+#endif
+#if LV_USE_BAR
+		case BINDING_BAR:
+			lv_bar_set_value(slot->obj, (int16_t) value, LV_ANIM_OFF);
+			break;
+#endif
+#if LV_USE_SLIDER
+		case BINDING_SLIDER:
+			lv_slider_set_value(slot->obj, (int16_t) value, LV_ANIM_OFF);
+			break;
+#endif
+#if LV_USE_GAUGE
+		case BINDING_GAUGE:
+			lv_gauge_set_value(slot->obj, slot->needle, (int16_t) value);
+			break;
+#endif
+#if LV_USE_CHART
+		case BINDING_CHART:
+			lv_chart_set_next(slot->obj, slot->series, (lv_coord_t) value);
+			break;
+#endif
+		case BINDING_CUSTOM:
+			slot->apply(slot->obj, value);
+			break;
+		default:
+			break;
+	}
+}
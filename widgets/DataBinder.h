@@ -0,0 +1,201 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_WIDGETS_DATABINDER_H_
+#define MBED_LVGL_WIDGETS_DATABINDER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lv_obj.h"
+#if LV_USE_CHART
+#include "lv_chart.h"
+#endif
+
+#include "LVGLFrameHook.h"
+
+#include "platform/Callback.h"
+#include "platform/NonCopyable.h"
+
+/**
+ * Frame-coherent binding of values produced by other threads to widgets
+ *
+ * Producers (threads or interrupts) publish values into lock-free slots at
+ * whatever rate they run. Right before a display is refreshed, only the
+ * latest value of each binding that changed since the previous frame is
+ * applied to its widget, from the GUI thread. A 1kHz source costs one
+ * widget update, and at most one invalidation, per frame. Values equal to
+ * the one last applied are not applied again.
+ *
+ * Publishing wakes the GUI if it is parked (see LittlevGL::set_idle_parking).
+ *
+ * @note Bindings must be created and removed from the GUI thread, and
+ * removed before their object is deleted
+ */
+class DataBinder : public LVGLFrameHook, private mbed::NonCopyable<DataBinder>
+{
+	public:
+
+		/** Applies a value to an object, called from the GUI thread */
+		typedef mbed::Callback<void(lv_obj_t* obj, int32_t value)> apply_t;
+
+		/** Binding statistics */
+		typedef struct {
+			uint32_t published;		/** Values published (counted when they are picked up) */
+			uint32_t applied;		/** Values applied to widgets */
+			uint32_t unchanged;		/** Values dropped because they were already applied */
+		} stats_t;
+
+		/**
+		 * Instantiate a DataBinder, it registers itself with LittlevGL
+		 */
+		DataBinder();
+
+		~DataBinder();
+
+#if LV_USE_LABEL
+		/**
+		 * Binds a label, its text is the value printed with a format
+		 *
+		 * @param[in] label Label to update
+		 * @param[in] format printf format with one int conversion (eg: "%d rpm"), must stay valid
+		 *
+		 * @retval id of the binding, -1 if all slots are used
+		 */
+		int bind_label(lv_obj_t* label, const char* format = "%d");
+#endif
+
+#if LV_USE_BAR
+		/**
+		 * Binds a bar, the value is its value
+		 */
+		int bind_bar(lv_obj_t* bar);
+#endif
+
+#if LV_USE_SLIDER
+		/**
+		 * Binds a slider, the value is its value
+		 */
+		int bind_slider(lv_obj_t* slider);
+#endif
+
+#if LV_USE_GAUGE
+		/**
+		 * Binds a needle of a gauge
+		 *
+		 * @param[in] gauge Gauge to update
+		 * @param[in] needle Index of the needle
+		 */
+		int bind_gauge(lv_obj_t* gauge, uint8_t needle = 0);
+#endif
+
+#if LV_USE_CHART
+		/**
+		 * Binds a chart series, each value applied is the series' next point
+		 *
+		 * @note Only the latest value per frame is added, samples published
+		 * in between are not plotted
+		 */
+		int bind_chart(lv_obj_t* chart, lv_chart_series_t* series);
+#endif
+
+		/**
+		 * Binds an object with a custom update
+		 *
+		 * @param[in] obj Object to update
+		 * @param[in] apply Function applying a value to the object
+		 *
+		 * @retval id of the binding, -1 if all slots are used
+		 */
+		int bind(lv_obj_t* obj, apply_t apply);
+
+		/**
+		 * Removes a binding
+		 *
+		 * @param[in] id Binding to remove
+		 */
+		void unbind(int id);
+
+		/**
+		 * Publishes a value, safe from any thread and from interrupts
+		 *
+		 * @param[in] id Binding the value is for
+		 * @param[in] value New value
+		 */
+		void publish(int id, int32_t value);
+
+		const stats_t& get_stats(void) const {
+			return stats;
+		}
+
+		void reset_stats(void);
+
+		/*
+		 * @brief Frame hook implementation, applies the latest values
+		 */
+		virtual void before_refresh(lv_disp_t* disp);
+
+	protected:
+
+		typedef enum {
+			BINDING_FREE,
+			BINDING_LABEL,
+			BINDING_BAR,
+			BINDING_SLIDER,
+			BINDING_GAUGE,
+			BINDING_CHART,
+			BINDING_CUSTOM,
+		} binding_type_t;
+
+		typedef struct {
+			binding_type_t type;
+			lv_obj_t* obj;
+			lv_disp_t* disp;
+			union {
+				const char* format;
+				uint8_t needle;
+#if LV_USE_CHART
+				lv_chart_series_t* series;
+#endif
+			};
+			apply_t apply;
+
+			/** Written by producers */
+			volatile int32_t value;
+			volatile uint32_t seq;
+
+			/** GUI thread only */
+			uint32_t applied_seq;
+			int32_t applied_value;
+			bool applied;
+		} slot_t;
+
+		/** Claims a free slot */
+		int claim(binding_type_t type, lv_obj_t* obj);
+
+		/** Applies a value to a slot's object */
+		void apply(slot_t* slot, int32_t value);
+
+	protected:
+
+		slot_t slots[MBED_CONF_MBED_LVGL_DATA_BINDING_SLOTS];
+
+		stats_t stats;
+
+};
+
+#endif /* MBED_LVGL_WIDGETS_DATABINDER_H_ */
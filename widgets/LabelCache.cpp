@@ -0,0 +1,363 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LabelCache.h"
+
+#if LV_USE_LABEL && LV_USE_IMG && LV_IMG_CF_ALPHA && (LV_COLOR_DEPTH > 1)
+
+#include <string.h>
+
+#include "lv_refr.h"
+#include "lv_draw_img.h"
+#include "lv_img_cache.h"
+
+#include "platform/mbed_assert.h"
+
+/** Number of temporary pixels used to rasterize a label (rendered in strips) */
+#define LABEL_CACHE_RENDER_PX	1024
+
+LabelCache* LabelCache::caches = NULL;
+
+LabelCache::LabelCache(uint32_t budget_bytes) :
+		entries(NULL), budget_bytes(budget_bytes), used_bytes(0),
+		use_counter(0), hits(0), misses(0), next_cache(caches)
+{
+	caches = this;
+}
+
+LabelCache::~LabelCache()
+{
+	while(entries != NULL) {
+		detach(entries->label);
+	}
+
+	// Unlink from the list of caches
+	LabelCache** link = &caches;
+	while(*link != this) {
+		link = &(*link)->next_cache;
+	}
+	*link = next_cache;
+}
+
+void LabelCache::attach(lv_obj_t* label)
+{
+	LabelCache* owner;
+	if(find(label, &owner) != NULL) {
+		return;
+	}
+
+	entry_t* entry = new entry_t;
+	memset(entry, 0, sizeof(entry_t));
+	entry->label = label;
+	entry->design_cb = lv_obj_get_design_cb(label);
+	entry->signal_cb = lv_obj_get_signal_cb(label);
+	entry->next = entries;
+	entries = entry;
+
+	lv_obj_set_design_cb(label, &LabelCache::design);
+	lv_obj_set_signal_cb(label, &LabelCache::signal);
+}
+
+void LabelCache::detach(lv_obj_t* label)
+{
+	entry_t** link = &entries;
+	while(*link != NULL) {
+		entry_t* entry = *link;
+		if(entry->label == label) {
+			drop(entry);
+			lv_obj_set_design_cb(label, entry->design_cb);
+			lv_obj_set_signal_cb(label, entry->signal_cb);
+			*link = entry->next;
+			delete entry;
+			return;
+		}
+		link = &entry->next;
+	}
+}
+
+void LabelCache::invalidate(lv_obj_t* label)
+{
+	LabelCache* owner;
+	entry_t* entry = find(label, &owner);
+	if(entry != NULL) {
+		owner->drop(entry);
+		lv_obj_invalidate(label);
+	}
+}
+
+void LabelCache::clear(void)
+{
+	for(entry_t* entry = entries; entry != NULL; entry = entry->next) {
+		drop(entry);
+	}
+}
+
+uint32_t LabelCache::compute_key(lv_obj_t* label)
+{
+	const lv_style_t* style = lv_obj_get_style(label);
+	const char* text = lv_label_get_text(label);
+
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+	for(const char* c = text; c != NULL && *c != '\0'; c++) {
+		hash = (hash ^ (uint8_t) *c) * 16777619u;
+	}
+
+	uint32_t params[] = {
+		(uint32_t) (uintptr_t) style->text.font,
+		(uint32_t) style->text.letter_space,
+		(uint32_t) style->text.line_space,
+		(uint32_t) lv_label_get_align(label),
+		(uint32_t) lv_obj_get_width(label),
+		(uint32_t) lv_obj_get_height(label),
+	};
+	for(size_t i = 0; i < sizeof(params)/sizeof(params[0]); i++) {
+		hash = (hash ^ params[i]) * 16777619u;
+	}
+
+	return hash;
+}
+
+bool LabelCache::is_current(const entry_t* entry, lv_obj_t* label, uint32_t key)
+{
+	if(entry->img.data == NULL || entry->key != key) {
+		return false;
+	}
+
+	// Hashes collide, the text itself decides
+	const char* text = lv_label_get_text(label);
+	size_t text_len = (text != NULL) ? strlen(text) : 0;
+	return text_len == entry->text_len && memcmp(text, entry->text, text_len) == 0;
+}
+
+bool LabelCache::is_cacheable(lv_obj_t* label)
+{
+	lv_label_long_mode_t mode = lv_label_get_long_mode(label);
+	if(mode == LV_LABEL_LONG_SROLL || mode == LV_LABEL_LONG_SROLL_CIRC) {
+		return false;
+	}
+
+	// Faded labels would have their opacity applied twice
+	if(lv_obj_get_opa_scale(label) != LV_OPA_COVER) {
+		return false;
+	}
+
+	// A single-tint mask loses inline colors and the selection's background
+	if(lv_label_get_recolor(label)) {
+		return false;
+	}
+#if LV_LABEL_TEXT_SEL
+	if(lv_label_get_text_sel_start(label) != LV_LABEL_TEXT_SEL_OFF &&
+			lv_label_get_text_sel_end(label) != LV_LABEL_TEXT_SEL_OFF) {
+		return false;
+	}
+#endif
+
+	// Only bare text can be reduced to an alpha mask
+	return !lv_label_get_body_draw(label);
+}
+
+bool LabelCache::render(entry_t* entry, uint32_t key)
+{
+	lv_obj_t* label = entry->label;
+	lv_coord_t w = lv_obj_get_width(label);
+	lv_coord_t h = lv_obj_get_height(label);
+	if(w <= 0 || h <= 0) {
+		return false;
+	}
+
+	const char* text = lv_label_get_text(label);
+	size_t text_len = (text != NULL) ? strlen(text) : 0;
+
+	uint32_t size = (uint32_t) w * h;
+	if(entry->img.data == NULL || entry->img.data_size != size || entry->text_len != text_len) {
+		drop(entry);
+		if(!make_room(size + text_len)) {
+			return false;
+		}
+		entry->img.data = new uint8_t[size];
+		entry->img.data_size = size;
+		entry->text = new char[text_len + 1];
+		entry->text_len = text_len;
+		used_bytes += size + text_len;
+	}
+	memcpy(entry->text, text != NULL ? text : "", text_len + 1);
+
+	entry->img.header.always_zero = 0;
+	entry->img.header.cf = LV_IMG_CF_ALPHA_8BIT;
+	entry->img.header.w = w;
+	entry->img.header.h = h;
+
+	// Draw the text in white on black so its brightness is its coverage
+	lv_style_t mask_style;
+	lv_style_copy(&mask_style, lv_obj_get_style(label));
+	mask_style.text.color = LV_COLOR_WHITE;
+	mask_style.text.opa = LV_OPA_COVER;
+	const lv_style_t* style_ori = label->style_p;
+	label->style_p = &mask_style;
+
+	lv_coord_t strip_h = LABEL_CACHE_RENDER_PX / w;
+	if(strip_h < 1) strip_h = 1;
+	if(strip_h > h) strip_h = h;
+	lv_color_t* strip = new lv_color_t[(uint32_t) w * strip_h];
+
+	/* Create a dummy display to fool the lv_draw functions.
+	 * They will think they draw to the real screen. */
+	lv_disp_t disp;
+	memset(&disp, 0, sizeof(lv_disp_t));
+	lv_disp_buf_t disp_buf;
+	lv_disp_buf_init(&disp_buf, strip, NULL, (uint32_t) w * strip_h);
+	lv_disp_drv_init(&disp.driver);
+	disp.driver.buffer = &disp_buf;
+	disp.driver.hor_res = lv_disp_get_hor_res(NULL);
+	disp.driver.ver_res = lv_disp_get_ver_res(NULL);
+
+	lv_disp_t* refr_ori = lv_refr_get_disp_refreshing();
+	lv_refr_set_disp_refreshing(&disp);
+
+	uint8_t* alpha = (uint8_t*) entry->img.data;
+	for(lv_coord_t y = 0; y < h; y += strip_h) {
+		lv_coord_t rows = (h - y < strip_h) ? (h - y) : strip_h;
+
+		disp_buf.area.x1 = label->coords.x1;
+		disp_buf.area.x2 = label->coords.x2;
+		disp_buf.area.y1 = label->coords.y1 + y;
+		disp_buf.area.y2 = disp_buf.area.y1 + rows - 1;
+
+		uint32_t px = (uint32_t) w * rows;
+		for(uint32_t i = 0; i < px; i++) {
+			strip[i] = LV_COLOR_BLACK;
+		}
+
+		entry->design_cb(label, &disp_buf.area, LV_DESIGN_DRAW_MAIN);
+
+		for(uint32_t i = 0; i < px; i++) {
+			*alpha++ = lv_color_brightness(strip[i]);
+		}
+	}
+
+	lv_refr_set_disp_refreshing(refr_ori);
+	label->style_p = style_ori;
+	delete[] strip;
+
+	// The image cache identifies sources by address, which is reused here
+	lv_img_cache_invalidate_src(&entry->img);
+
+	entry->key = key;
+	return true;
+}
+
+void LabelCache::drop(entry_t* entry)
+{
+	if(entry->img.data != NULL) {
+		lv_img_cache_invalidate_src(&entry->img);
+		used_bytes -= entry->img.data_size + entry->text_len;
+		delete[] entry->img.data;
+		entry->img.data = NULL;
+		entry->img.data_size = 0;
+		delete[] entry->text;
+		entry->text = NULL;
+		entry->text_len = 0;
+	}
+}
+
+bool LabelCache::make_room(uint32_t size)
+{
+	if(size > budget_bytes) {
+		return false;
+	}
+
+	while(used_bytes + size > budget_bytes) {
+		entry_t* lru = NULL;
+		for(entry_t* entry = entries; entry != NULL; entry = entry->next) {
+			if(entry->img.data != NULL &&
+					(lru == NULL || (int32_t)(entry->last_use - lru->last_use) < 0)) {
+				lru = entry;
+			}
+		}
+		MBED_ASSERT(lru != NULL);
+		drop(lru);
+	}
+
+	return true;
+}
+
+LabelCache::entry_t* LabelCache::find(lv_obj_t* label, LabelCache** owner)
+{
+	for(LabelCache* cache = caches; cache != NULL; cache = cache->next_cache) {
+		for(entry_t* entry = cache->entries; entry != NULL; entry = entry->next) {
+			if(entry->label == label) {
+				*owner = cache;
+				return entry;
+			}
+		}
+	}
+	return NULL;
+}
+
+bool LabelCache::design(lv_obj_t* label, const lv_area_t* mask, lv_design_mode_t mode)
+{
+	LabelCache* cache;
+	entry_t* entry = find(label, &cache);
+	MBED_ASSERT(entry != NULL);
+
+	if(mode != LV_DESIGN_DRAW_MAIN || !is_cacheable(label)) {
+		return entry->design_cb(label, mask, mode);
+	}
+
+	uint32_t key = compute_key(label);
+	if(is_current(entry, label, key)) {
+		cache->hits++;
+	} else {
+		cache->misses++;
+		if(!cache->render(entry, key)) {
+			return entry->design_cb(label, mask, mode);
+		}
+	}
+	entry->last_use = ++cache->use_counter;
+
+	// Tint the alpha mask with the label's real text color
+	const lv_style_t* style = lv_obj_get_style(label);
+	lv_style_t img_style;
+	lv_style_copy(&img_style, &lv_style_plain);
+	img_style.image.color = style->text.color;
+	img_style.image.opa = style->text.opa;
+
+	lv_draw_img(&label->coords, mask, &entry->img, &img_style, LV_OPA_COVER);
+
+	return true;
+}
+
+lv_res_t LabelCache::signal(lv_obj_t* label, lv_signal_t sign, void* param)
+{
+	LabelCache* cache;
+	entry_t* entry = find(label, &cache);
+	MBED_ASSERT(entry != NULL);
+
+	lv_res_t res = entry->signal_cb(label, sign, param);
+
+	if(sign == LV_SIGNAL_STYLE_CHG) {
+		cache->drop(entry);
+	} else if(sign == LV_SIGNAL_CLEANUP) {
+		// The label is being deleted
+		cache->detach(label);
+	}
+
+	return res;
+}
+
+#endif /* LV_USE_LABEL && LV_USE_IMG && LV_IMG_CF_ALPHA && (LV_COLOR_DEPTH > 1) */
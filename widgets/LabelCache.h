@@ -0,0 +1,160 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_WIDGETS_LABELCACHE_H_
+#define MBED_LVGL_WIDGETS_LABELCACHE_H_
+
+#if LV_USE_LABEL && LV_USE_IMG && LV_IMG_CF_ALPHA && (LV_COLOR_DEPTH > 1)
+
+#include <stdint.h>
+
+#include "lv_obj.h"
+#include "lv_label.h"
+#include "lv_img.h"
+
+#include "platform/NonCopyable.h"
+
+/**
+ * Opt-in cache of pre-rendered label text
+ *
+ * Attached labels are rasterized once into an 8-bit alpha bitmap and
+ * redrawn by blitting that bitmap (tinted with the label's text color)
+ * instead of rendering every glyph each time their area is invalidated.
+ *
+ * A bitmap is re-rendered automatically when the label's text, font,
+ * spacing, alignment or size change, and dropped when its style changes.
+ * Bitmaps are evicted least-recently-used first to stay within the budget.
+ *
+ * Labels with a drawn body, a scrolling long mode, recoloring or a text
+ * selection are drawn normally.
+ */
+class LabelCache : private mbed::NonCopyable<LabelCache>
+{
+	public:
+
+		/**
+		 * Instantiate a LabelCache
+		 *
+		 * @param[in] budget_bytes Maximum number of bytes of cached bitmaps and texts
+		 */
+		LabelCache(uint32_t budget_bytes = MBED_CONF_MBED_LVGL_LABEL_CACHE_SIZE);
+
+		~LabelCache();
+
+		/**
+		 * Enables caching for a label
+		 *
+		 * @param[in] label Label whose text rarely (or never) changes
+		 */
+		void attach(lv_obj_t* label);
+
+		/**
+		 * Disables caching for a label and frees its bitmap
+		 *
+		 * @param[in] label Label previously attached
+		 */
+		void detach(lv_obj_t* label);
+
+		/**
+		 * Drops the cached bitmap of a label, it will be re-rendered on next draw
+		 *
+		 * @param[in] label Label previously attached
+		 */
+		void invalidate(lv_obj_t* label);
+
+		/**
+		 * Drops all cached bitmaps
+		 */
+		void clear(void);
+
+		/** Number of bytes currently used by cached bitmaps and texts */
+		uint32_t get_used_bytes(void) const {
+			return used_bytes;
+		}
+
+		/** Number of draws served from a cached bitmap */
+		uint32_t get_hits(void) const {
+			return hits;
+		}
+
+		/** Number of draws that required rendering the label */
+		uint32_t get_misses(void) const {
+			return misses;
+		}
+
+	protected:
+
+		/** Attached label */
+		typedef struct entry {
+			lv_obj_t* label;
+			lv_design_cb_t design_cb;	/** Label's original design function */
+			lv_signal_cb_t signal_cb;	/** Label's original signal function */
+			uint32_t key;				/** Hash of what the bitmap was rendered from */
+			char* text;					/** Copy of the text the bitmap was rendered from */
+			size_t text_len;
+			lv_img_dsc_t img;			/** Cached bitmap (img.data is NULL if not cached) */
+			uint32_t last_use;
+			struct entry* next;
+		} entry_t;
+
+		/** Hash of everything that affects the rendered bitmap */
+		static uint32_t compute_key(lv_obj_t* label);
+
+		/** Whether the entry's bitmap was rendered from the label's current state */
+		static bool is_current(const entry_t* entry, lv_obj_t* label, uint32_t key);
+
+		/** Whether the label can be cached in its current state */
+		static bool is_cacheable(lv_obj_t* label);
+
+		/** Renders the label into the entry's bitmap */
+		bool render(entry_t* entry, uint32_t key);
+
+		/** Frees the entry's bitmap and text */
+		void drop(entry_t* entry);
+
+		/** Evicts least-recently-used bitmaps until size fits the budget */
+		bool make_room(uint32_t size);
+
+		/** Finds the entry (and owning cache) of a label */
+		static entry_t* find(lv_obj_t* label, LabelCache** owner);
+
+		/*
+		 * @brief Design and signal functions installed on attached labels
+		 */
+		static bool design(lv_obj_t* label, const lv_area_t* mask, lv_design_mode_t mode);
+		static lv_res_t signal(lv_obj_t* label, lv_signal_t sign, void* param);
+
+	protected:
+
+		entry_t* entries;
+
+		uint32_t budget_bytes;
+		uint32_t used_bytes;
+
+		uint32_t use_counter;
+		uint32_t hits;
+		uint32_t misses;
+
+		/** All LabelCache instances, used to route lvgl callbacks */
+		LabelCache* next_cache;
+		static LabelCache* caches;
+
+};
+
+#endif /* LV_USE_LABEL && LV_USE_IMG && LV_IMG_CF_ALPHA && (LV_COLOR_DEPTH > 1) */
+
+#endif /* MBED_LVGL_WIDGETS_LABELCACHE_H_ */
@@ -0,0 +1,263 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ScreenManager.h"
+
+#include <string.h>
+
+#include "lv_anim.h"
+#include "lv_disp.h"
+
+#include "LittlevGL.h"
+
+#include "platform/mbed_assert.h"
+#include "hal/us_ticker_api.h"
+
+#if MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING
+#include "platform/mem_accounting.h"
+#endif
+
+/** Period of the task building screens ahead of time */
+#define SCREEN_MANAGER_PREBUILD_PERIOD	50
+
+ScreenManager::ScreenManager(LVGLDisplayDriver& driver, size_t max_screens, uint32_t budget_bytes) :
+		driver(driver), entry_count(0), max_screens(max_screens), budget_bytes(budget_bytes),
+		used_bytes(0), active(-1), use_counter(0), prebuild_lv_task(NULL), show_time(0),
+		transition_pending(false), transition_drawn(false)
+{
+	MBED_ASSERT(max_screens >= 1);
+	memset(&stats, 0, sizeof(stats));
+	LittlevGL::get_instance().add_frame_hook(*this);
+}
+
+ScreenManager::~ScreenManager()
+{
+	LittlevGL::get_instance().remove_frame_hook(*this);
+
+	if(prebuild_lv_task != NULL) {
+		lv_task_del(prebuild_lv_task);
+	}
+
+	for(size_t i = 0; i < entry_count; i++) {
+		if((int) i != active && entries[i].screen != NULL) {
+			lv_obj_del(entries[i].screen);
+		}
+	}
+}
+
+int ScreenManager::add_screen(const char* name, builder_t builder)
+{
+	if(entry_count == MBED_CONF_MBED_LVGL_SCREEN_MANAGER_MAX_SCREENS) {
+		return -1;
+	}
+
+	entry_t* entry = &entries[entry_count];
+	entry->name = name;
+	entry->builder = builder;
+	entry->screen = NULL;
+	entry->cost_bytes = 0;
+	entry->last_use = 0;
+	entry->prebuild = false;
+	return (int) entry_count++;
+}
+
+lv_obj_t* ScreenManager::get_screen(int id) const
+{
+	MBED_ASSERT(id >= 0 && (size_t) id < entry_count);
+	return entries[id].screen;
+}
+
+void ScreenManager::show(int id)
+{
+	MBED_ASSERT(id >= 0 && (size_t) id < entry_count);
+	entry_t* entry = &entries[id];
+
+	show_time = (uint32_t) ticker_read_us(get_us_ticker_data());
+	stats.shows++;
+
+	if(entry->screen != NULL) {
+		stats.hits++;
+	} else {
+		build(id);
+	}
+	entry->prebuild = false;
+	entry->last_use = ++use_counter;
+
+	active = id;
+	lv_disp_load_scr(entry->screen);
+
+	transition_pending = true;
+	transition_drawn = false;
+
+	enforce_limits();
+}
+
+void ScreenManager::prebuild(int id)
+{
+	MBED_ASSERT(id >= 0 && (size_t) id < entry_count);
+	if(entries[id].screen != NULL) {
+		return;
+	}
+
+	entries[id].prebuild = true;
+	if(prebuild_lv_task == NULL) {
+		prebuild_lv_task = lv_task_create(&ScreenManager::prebuild_task,
+				SCREEN_MANAGER_PREBUILD_PERIOD, LV_TASK_PRIO_LOWEST, this);
+	}
+}
+
+void ScreenManager::evict(int id)
+{
+	MBED_ASSERT(id >= 0 && (size_t) id < entry_count);
+	entry_t* entry = &entries[id];
+	if(id == active || entry->screen == NULL) {
+		return;
+	}
+
+	lv_obj_del(entry->screen);
+	entry->screen = NULL;
+	used_bytes -= entry->cost_bytes;
+	entry->cost_bytes = 0;
+}
+
+void ScreenManager::build(int id)
+{
+	entry_t* entry = &entries[id];
+
+	// Screens are created on the default display
+	lv_disp_t* previous_default = lv_disp_get_default();
+	lv_disp_set_default(driver.get_lv_disp_obj());
+
+	uint32_t start = (uint32_t) ticker_read_us(get_us_ticker_data());
+#if MBED_CONF_MBED_LVGL_ENABLE_MEM_ACCOUNTING
+	mbed_lvgl_mem_stats_t before, after;
+	mbed_lvgl_mem_get_stats(&before);
+	{
+		LVGLMemTag tag(entry->name);
+		entry->screen = entry->builder();
+	}
+	mbed_lvgl_mem_get_stats(&after);
+	entry->cost_bytes = (after.live_bytes > before.live_bytes) ? (after.live_bytes - before.live_bytes) : 0;
+	used_bytes += entry->cost_bytes;
+#else
+	entry->screen = entry->builder();
+#endif
+	uint32_t build_time = (uint32_t) ticker_read_us(get_us_ticker_data()) - start;
+
+	lv_disp_set_default(previous_default);
+
+	MBED_ASSERT(entry->screen != NULL);
+	if(build_time > stats.max_build_us) {
+		stats.max_build_us = build_time;
+	}
+}
+
+void ScreenManager::enforce_limits(void)
+{
+	while(true) {
+		size_t cached = 0;
+		entry_t* lru = NULL;
+		for(size_t i = 0; i < entry_count; i++) {
+			entry_t* entry = &entries[i];
+			if(entry->screen == NULL) {
+				continue;
+			}
+			cached++;
+			if((int) i != active && (lru == NULL || (int32_t)(entry->last_use - lru->last_use) < 0)) {
+				lru = entry;
+			}
+		}
+
+		bool over_budget = (budget_bytes != 0 && used_bytes > budget_bytes);
+		if(lru == NULL || (cached <= max_screens && !over_budget)) {
+			return;
+		}
+
+		evict(lru - entries);
+		stats.evictions++;
+	}
+}
+
+bool ScreenManager::is_display_idle(void)
+{
+	lv_disp_t* disp = driver.get_lv_disp_obj();
+	if(disp == NULL || disp->inv_p != 0) {
+		return false;
+	}
+
+#if LV_USE_ANIMATION
+	if(lv_anim_count_running() != 0) {
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+void ScreenManager::prebuild_task(lv_task_t* task)
+{
+	ScreenManager* manager = (ScreenManager*) task->user_data;
+	if(!manager->is_display_idle()) {
+		return;
+	}
+
+	// With room for the screen shown only, a prebuilt screen would be evicted at once
+	bool room = (manager->active < 0 || manager->max_screens > 1);
+
+	// One screen per run, so input and refreshes are served in between
+	for(size_t i = 0; i < manager->entry_count; i++) {
+		entry_t* entry = &manager->entries[i];
+		if(!entry->prebuild) {
+			continue;
+		}
+
+		entry->prebuild = false;
+		if(entry->screen == NULL && room) {
+			manager->build(i);
+			entry->last_use = ++manager->use_counter;
+			manager->stats.prebuilt++;
+			manager->enforce_limits();
+			return;
+		}
+	}
+
+	// Nothing left to build, don't keep the GUI from parking
+	lv_task_del(task);
+	manager->prebuild_lv_task = NULL;
+}
+
+void ScreenManager::before_refresh(lv_disp_t* disp)
+{
+	if(transition_pending && disp == driver.get_lv_disp_obj() && disp->inv_p != 0) {
+		transition_drawn = true;
+	}
+}
+
+void ScreenManager::after_refresh(lv_disp_t* disp)
+{
+	if(!transition_drawn || disp != driver.get_lv_disp_obj()) {
+		return;
+	}
+
+	transition_pending = false;
+	transition_drawn = false;
+
+	stats.last_latency_us = (uint32_t) ticker_read_us(get_us_ticker_data()) - show_time;
+	if(stats.last_latency_us > stats.max_latency_us) {
+		stats.max_latency_us = stats.last_latency_us;
+	}
+}
@@ -0,0 +1,198 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_WIDGETS_SCREENMANAGER_H_
+#define MBED_LVGL_WIDGETS_SCREENMANAGER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lv_obj.h"
+#include "lv_task.h"
+
+#include "LVGLDisplayDriver.h"
+#include "LVGLFrameHook.h"
+
+#include "platform/Callback.h"
+#include "platform/NonCopyable.h"
+
+/**
+ * Switches between screens, keeping recently used ones alive
+ *
+ * Screens are registered with a function that builds them. Showing a
+ * screen that is still cached only loads it, so frequently toggled screens
+ * switch in one frame instead of paying for deleting and re-creating
+ * their object trees. Screens are built lazily when first shown, or ahead
+ * of time with prebuild(), in which case they are built one at a time
+ * when the display has nothing to redraw and no animation runs.
+ *
+ * Screens that are not shown are deleted least-recently-used first once
+ * more than the maximum number of screens are cached or, with
+ * enable_mem_accounting, once the heap used building them exceeds the budget.
+ *
+ * The latency of each transition (from show() to the end of the first
+ * refresh drawing the new screen) is measured.
+ *
+ * @note The manager owns the screens it builds, they must not be deleted
+ * by the application
+ */
+class ScreenManager : public LVGLFrameHook, private mbed::NonCopyable<ScreenManager>
+{
+	public:
+
+		/** Builds a screen (eg: lv_obj_create(NULL, NULL) and its children) and returns it */
+		typedef mbed::Callback<lv_obj_t*(void)> builder_t;
+
+		/** Transition statistics */
+		typedef struct {
+			uint32_t shows;				/** Screens shown */
+			uint32_t hits;				/** Screens shown from the cache */
+			uint32_t prebuilt;			/** Screens built ahead of time */
+			uint32_t evictions;			/** Screens deleted to stay within limits */
+			uint32_t last_latency_us;	/** Latency of the last transition */
+			uint32_t max_latency_us;	/** Longest transition */
+			uint32_t max_build_us;		/** Longest screen build */
+		} stats_t;
+
+		/**
+		 * Instantiate a ScreenManager
+		 *
+		 * @param[in] driver Display driver the screens are shown on
+		 * @param[in] max_screens (optional) Most screens kept alive, including the one shown
+		 * @param[in] budget_bytes (optional) Most heap used by screens kept alive, 0 for no limit (needs enable_mem_accounting)
+		 */
+		ScreenManager(LVGLDisplayDriver& driver,
+				size_t max_screens = MBED_CONF_MBED_LVGL_SCREEN_CACHE_SIZE,
+				uint32_t budget_bytes = MBED_CONF_MBED_LVGL_SCREEN_CACHE_BUDGET);
+
+		/**
+		 * Deletes the screens built by the manager, except the one shown
+		 */
+		~ScreenManager();
+
+		/**
+		 * Registers a screen
+		 *
+		 * @param[in] name Name of the screen, must stay valid
+		 * @param[in] builder Function building the screen
+		 *
+		 * @retval id of the screen, -1 if the maximum number of screens is registered
+		 */
+		int add_screen(const char* name, builder_t builder);
+
+		/**
+		 * Shows a screen, building it if it isn't cached
+		 *
+		 * @param[in] id Screen to show
+		 */
+		void show(int id);
+
+		/**
+		 * Builds a screen ahead of time, once the display is idle
+		 *
+		 * @note Skipped if only one screen is kept alive and one is shown,
+		 * the prebuilt screen would be evicted right away
+		 *
+		 * @param[in] id Screen to build
+		 */
+		void prebuild(int id);
+
+		/**
+		 * Deletes a screen from the cache (eg: its content is outdated), unless it is shown
+		 */
+		void evict(int id);
+
+		/**
+		 * Gets the screen shown, -1 if none
+		 */
+		int get_active(void) const {
+			return active;
+		}
+
+		/**
+		 * Gets a screen's object, NULL if it isn't built
+		 */
+		lv_obj_t* get_screen(int id) const;
+
+		/**
+		 * Gets the heap used by the cached screens (needs enable_mem_accounting)
+		 */
+		uint32_t get_used_bytes(void) const {
+			return used_bytes;
+		}
+
+		const stats_t& get_stats(void) const {
+			return stats;
+		}
+
+		/*
+		 * @brief Frame hook implementation
+		 */
+		virtual void before_refresh(lv_disp_t* disp);
+		virtual void after_refresh(lv_disp_t* disp);
+
+	protected:
+
+		typedef struct {
+			const char* name;
+			builder_t builder;
+			lv_obj_t* screen;
+			uint32_t cost_bytes;	/** Heap used to build the screen */
+			uint32_t last_use;
+			bool prebuild;			/** Queued for building ahead of time */
+		} entry_t;
+
+		/** Builds a screen */
+		void build(int id);
+
+		/** Deletes cached screens until the limits are met */
+		void enforce_limits(void);
+
+		/** Whether the display has anything to do */
+		bool is_display_idle(void);
+
+		/*
+		 * @brief lv_task building queued screens
+		 */
+		static void prebuild_task(lv_task_t* task);
+
+	protected:
+
+		LVGLDisplayDriver& driver;
+
+		entry_t entries[MBED_CONF_MBED_LVGL_SCREEN_MANAGER_MAX_SCREENS];
+		size_t entry_count;
+
+		size_t max_screens;
+		uint32_t budget_bytes;
+		uint32_t used_bytes;
+
+		int active;
+		uint32_t use_counter;
+
+		lv_task_t* prebuild_lv_task;
+
+		/** Transition being measured */
+		uint32_t show_time;
+		bool transition_pending;
+		bool transition_drawn;
+
+		stats_t stats;
+
+};
+
+#endif /* MBED_LVGL_WIDGETS_SCREENMANAGER_H_ */
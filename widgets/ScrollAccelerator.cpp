@@ -0,0 +1,293 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ScrollAccelerator.h"
+
+#if LV_USE_PAGE
+
+#include "lv_refr.h"
+
+#include "LittlevGL.h"
+
+#include "platform/mbed_assert.h"
+
+ScrollAccelerator* ScrollAccelerator::accelerators = NULL;
+
+ScrollAccelerator::ScrollAccelerator(LVGLDisplayDriver& driver) :
+		driver(driver), page(NULL), scrl(NULL), page_signal_cb(NULL), scrl_signal_cb(NULL),
+		region_valid(false), pending_dy(0), moved(false), fallback(false), area_count(0),
+		applying(false), accelerated_frames(0), fallback_frames(0),
+		next_accelerator(accelerators)
+{
+	accelerators = this;
+}
+
+ScrollAccelerator::~ScrollAccelerator()
+{
+	detach();
+
+	// Unlink from the list of accelerators
+	ScrollAccelerator** link = &accelerators;
+	while(*link != this) {
+		link = &(*link)->next_accelerator;
+	}
+	*link = next_accelerator;
+}
+
+bool ScrollAccelerator::attach(lv_obj_t* page)
+{
+	if(!driver.has_hw_scroll()) {
+		return false;
+	}
+
+	detach();
+
+	this->page = page;
+	scrl = lv_page_get_scrl(page);
+	page_signal_cb = lv_obj_get_signal_cb(page);
+	scrl_signal_cb = lv_obj_get_signal_cb(scrl);
+	lv_obj_set_signal_cb(page, &ScrollAccelerator::page_signal);
+	lv_obj_set_signal_cb(scrl, &ScrollAccelerator::scrl_signal);
+
+	// Nothing is known about what was invalidated so far
+	reset_frame();
+	fallback = true;
+
+	LittlevGL::get_instance().add_frame_hook(*this);
+	return true;
+}
+
+void ScrollAccelerator::detach(void)
+{
+	if(page == NULL) {
+		return;
+	}
+
+	LittlevGL::get_instance().remove_frame_hook(*this);
+
+	lv_obj_set_signal_cb(page, page_signal_cb);
+	lv_obj_set_signal_cb(scrl, scrl_signal_cb);
+	page = NULL;
+	scrl = NULL;
+
+	if(region_valid) {
+		// The display RAM no longer matches lvgl's rows, redraw everything
+		driver.set_scroll_region(0, -1);
+		region_valid = false;
+		if(driver.get_lv_disp_obj() != NULL) {
+			lv_obj_invalidate(lv_disp_get_scr_act(driver.get_lv_disp_obj()));
+		}
+	}
+}
+
+void ScrollAccelerator::before_refresh(lv_disp_t* disp)
+{
+	if(page == NULL || disp != driver.get_lv_disp_obj()) {
+		return;
+	}
+
+	if(update_region(disp) && moved) {
+		if(!fallback && apply(disp)) {
+			accelerated_frames++;
+		} else {
+			fallback_frames++;
+		}
+	}
+
+	reset_frame();
+}
+
+void ScrollAccelerator::on_invalidate(lv_disp_t* disp, const lv_area_t* area)
+{
+	if(page == NULL || applying || fallback || disp != driver.get_lv_disp_obj()) {
+		return;
+	}
+
+	if(!region_valid || !lv_area_is_on(area, &region)) {
+		return;
+	}
+
+	// The page's own invalidations are what the scroll replaces
+	if(area->x1 == region.x1 && area->y1 == region.y1 &&
+			area->x2 == region.x2 && area->y2 == region.y2) {
+		return;
+	}
+
+	if(!lv_area_is_in(area, &region) || area_count >= SCROLL_ACCELERATOR_MAX_AREAS) {
+		fallback = true;
+		return;
+	}
+
+	lv_area_copy(&areas[area_count++], area);
+}
+
+void ScrollAccelerator::reset_frame(void)
+{
+	pending_dy = 0;
+	moved = false;
+	fallback = false;
+	area_count = 0;
+}
+
+bool ScrollAccelerator::update_region(lv_disp_t* disp)
+{
+	lv_area_t screen;
+	screen.x1 = 0;
+	screen.y1 = 0;
+	screen.x2 = lv_disp_get_hor_res(disp) - 1;
+	screen.y2 = lv_disp_get_ver_res(disp) - 1;
+
+	lv_area_t visible;
+	bool eligible = lv_area_intersect(&visible, &page->coords, &screen) &&
+			visible.x1 == screen.x1 && visible.x2 == screen.x2 && !lv_obj_get_hidden(page);
+
+	if(eligible == region_valid && (!eligible ||
+			(visible.y1 == region.y1 && visible.y2 == region.y2))) {
+		return eligible;
+	}
+
+	// The band changed, display RAM has to be redrawn with the new row mapping
+	if(eligible) {
+		driver.set_scroll_region(visible.y1, visible.y2);
+		lv_area_copy(&region, &visible);
+	} else {
+		driver.set_scroll_region(0, -1);
+	}
+	region_valid = eligible;
+
+	applying = true;
+	lv_inv_area(disp, &screen);
+	applying = false;
+
+	return false;
+}
+
+bool ScrollAccelerator::apply(lv_disp_t* disp)
+{
+	lv_coord_t height = lv_area_get_height(&region);
+	lv_coord_t dy = pending_dy;
+
+	if(dy >= height || -dy >= height) {
+		return false;
+	}
+
+	// Keep the areas outside of the page, everything inside it is replaced
+	lv_area_t keep[LV_INV_BUF_SIZE];
+	uint32_t keep_count = 0;
+	for(uint32_t i = 0; i < disp->inv_p; i++) {
+		const lv_area_t* area = &disp->inv_areas[i];
+		if(!lv_area_is_on(area, &region)) {
+			lv_area_copy(&keep[keep_count++], area);
+		} else if(!lv_area_is_in(area, &region)) {
+			// Eg: the whole screen was invalidated
+			return false;
+		}
+	}
+
+	applying = true;
+
+	lv_inv_area(disp, NULL);
+	for(uint32_t i = 0; i < keep_count; i++) {
+		lv_inv_area(disp, &keep[i]);
+	}
+
+	// Rows scrolled into view
+	if(dy != 0) {
+		lv_area_t exposed;
+		lv_area_copy(&exposed, &region);
+		if(dy > 0) {
+			exposed.y2 = region.y1 + dy - 1;
+		} else {
+			exposed.y1 = region.y2 + dy + 1;
+		}
+		lv_inv_area(disp, &exposed);
+	}
+
+	// Other changes inside the page, where they were and where the scroll moved them
+	for(size_t i = 0; i < area_count; i++) {
+		lv_inv_area(disp, &areas[i]);
+
+		lv_area_t moved_area;
+		lv_area_copy(&moved_area, &areas[i]);
+		moved_area.y1 += dy;
+		moved_area.y2 += dy;
+		if(lv_area_intersect(&moved_area, &moved_area, &region)) {
+			lv_inv_area(disp, &moved_area);
+		}
+	}
+
+	applying = false;
+
+	if(dy != 0) {
+		driver.scroll(dy);
+	}
+
+	return true;
+}
+
+ScrollAccelerator* ScrollAccelerator::find(lv_obj_t* obj)
+{
+	for(ScrollAccelerator* accel = accelerators; accel != NULL; accel = accel->next_accelerator) {
+		if(accel->page == obj || accel->scrl == obj) {
+			return accel;
+		}
+	}
+	return NULL;
+}
+
+lv_res_t ScrollAccelerator::page_signal(lv_obj_t* page, lv_signal_t sign, void* param)
+{
+	ScrollAccelerator* accel = find(page);
+	MBED_ASSERT(accel != NULL);
+
+	lv_res_t res = accel->page_signal_cb(page, sign, param);
+
+	if(sign == LV_SIGNAL_STYLE_CHG) {
+		accel->fallback = true;
+	} else if(sign == LV_SIGNAL_CLEANUP) {
+		accel->detach();
+	}
+
+	return res;
+}
+
+lv_res_t ScrollAccelerator::scrl_signal(lv_obj_t* scrl, lv_signal_t sign, void* param)
+{
+	ScrollAccelerator* accel = find(scrl);
+	MBED_ASSERT(accel != NULL);
+
+	lv_res_t res = accel->scrl_signal_cb(scrl, sign, param);
+
+	if(sign == LV_SIGNAL_CORD_CHG) {
+		// Only pure vertical translations can be scrolled in hardware
+		const lv_area_t* ori = (const lv_area_t*) param;
+		if(ori->x1 == scrl->coords.x1 && ori->x2 == scrl->coords.x2 &&
+				lv_area_get_height(ori) == lv_obj_get_height(scrl)) {
+			accel->pending_dy += scrl->coords.y1 - ori->y1;
+		} else {
+			accel->fallback = true;
+		}
+		accel->moved = true;
+	} else if(sign == LV_SIGNAL_CLEANUP) {
+		// The page is being deleted, its scrollable goes first
+		accel->detach();
+	}
+
+	return res;
+}
+
+#endif /* LV_USE_PAGE */
@@ -0,0 +1,157 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_WIDGETS_SCROLLACCELERATOR_H_
+#define MBED_LVGL_WIDGETS_SCROLLACCELERATOR_H_
+
+#if LV_USE_PAGE
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lv_obj.h"
+#include "lv_page.h"
+
+#include "LVGLDisplayDriver.h"
+#include "LVGLFrameHook.h"
+
+#include "platform/NonCopyable.h"
+
+/** Number of invalidated areas inside the page tracked per frame */
+#define SCROLL_ACCELERATOR_MAX_AREAS	8
+
+/**
+ * Scrolls a page (or list) with the display's hardware vertical scrolling
+ *
+ * When the page's content moves vertically and nothing else about it
+ * changes, the rows already on the display are moved by the display
+ * controller and only the rows scrolled into view are rendered and sent,
+ * instead of the whole page.
+ *
+ * Other areas invalidated inside the page during the same frame are
+ * redrawn where they were invalidated and where the scroll moved them.
+ * Anything else (the page moving or resizing, its style changing, an
+ * invalidation straddling its edges) falls back to lvgl's normal redraw.
+ *
+ * Requirements:
+ * - the display driver supports hardware scrolling (has_hw_scroll)
+ * - the page spans the whole width of the display, since whole rows are scrolled
+ * - the page's background looks the same on every row (plain color, no
+ *   top or bottom border), since it is scrolled along with the content
+ */
+class ScrollAccelerator : public LVGLFrameHook, private mbed::NonCopyable<ScrollAccelerator>
+{
+	public:
+
+		/**
+		 * Instantiate a ScrollAccelerator
+		 *
+		 * @param[in] driver Display driver the page is shown on
+		 */
+		ScrollAccelerator(LVGLDisplayDriver& driver);
+
+		~ScrollAccelerator();
+
+		/**
+		 * Starts accelerating a page's vertical scrolling
+		 *
+		 * @param[in] page Page (or list) to accelerate
+		 *
+		 * @retval false if the display does not support hardware scrolling
+		 */
+		bool attach(lv_obj_t* page);
+
+		/**
+		 * Stops accelerating the page and disables hardware scrolling
+		 */
+		void detach(void);
+
+		/** Number of frames where the page was scrolled in hardware */
+		uint32_t get_accelerated_frames(void) const {
+			return accelerated_frames;
+		}
+
+		/** Number of frames where the page moved but had to be redrawn by lvgl */
+		uint32_t get_fallback_frames(void) const {
+			return fallback_frames;
+		}
+
+		/*
+		 * @brief Frame hook implementation
+		 */
+		virtual void before_refresh(lv_disp_t* disp);
+		virtual void on_invalidate(lv_disp_t* disp, const lv_area_t* area);
+
+	protected:
+
+		/** Forgets what happened to the page during the frame */
+		void reset_frame(void);
+
+		/** Updates the hardware scroll band from the page's coordinates */
+		bool update_region(lv_disp_t* disp);
+
+		/** Replaces the invalidated page with the rows scrolled into view */
+		bool apply(lv_disp_t* disp);
+
+		/** Finds the accelerator of a page or its scrollable */
+		static ScrollAccelerator* find(lv_obj_t* obj);
+
+		/*
+		 * @brief Signal functions installed on the page and its scrollable
+		 */
+		static lv_res_t page_signal(lv_obj_t* page, lv_signal_t sign, void* param);
+		static lv_res_t scrl_signal(lv_obj_t* scrl, lv_signal_t sign, void* param);
+
+	protected:
+
+		LVGLDisplayDriver& driver;
+
+		lv_obj_t* page;
+		lv_obj_t* scrl;
+		lv_signal_cb_t page_signal_cb;	/** Page's original signal function */
+		lv_signal_cb_t scrl_signal_cb;	/** Scrollable's original signal function */
+
+		/** Hardware scroll band, valid when the page spans the display's width */
+		lv_area_t region;
+		bool region_valid;
+
+		/** Rows the content moved by during the frame */
+		lv_coord_t pending_dy;
+		bool moved;
+
+		/** The frame can't be accelerated */
+		bool fallback;
+
+		/** Other areas invalidated inside the page during the frame */
+		lv_area_t areas[SCROLL_ACCELERATOR_MAX_AREAS];
+		size_t area_count;
+
+		/** Set while the accelerator invalidates areas itself */
+		bool applying;
+
+		uint32_t accelerated_frames;
+		uint32_t fallback_frames;
+
+		/** All ScrollAccelerator instances, used to route lvgl callbacks */
+		ScrollAccelerator* next_accelerator;
+		static ScrollAccelerator* accelerators;
+
+};
+
+#endif /* LV_USE_PAGE */
+
+#endif /* MBED_LVGL_WIDGETS_SCROLLACCELERATOR_H_ */
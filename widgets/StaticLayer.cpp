@@ -0,0 +1,406 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StaticLayer.h"
+
+#if (LV_COLOR_DEPTH > 1)
+
+#include <string.h>
+
+#include "lv_refr.h"
+#include "lv_img_cache.h"
+
+#include "platform/mbed_assert.h"
+
+StaticLayer* StaticLayer::layers = NULL;
+
+StaticLayer::StaticLayer(lv_obj_t* container, lv_color_t* buffer, size_t buffer_px) :
+		container(container), members(NULL), buffer(buffer), buffer_px(buffer_px),
+		own_buffer(buffer == NULL), dirty(true), renders(0), hits(0), fallbacks(0),
+		next_layer(layers)
+{
+	MBED_ASSERT(container != NULL);
+	memset(&img, 0, sizeof(img));
+	if(own_buffer) {
+		this->buffer_px = 0;
+	}
+
+	layers = this;
+
+	wrap(container, false);
+	lv_obj_invalidate(container);
+}
+
+StaticLayer::~StaticLayer()
+{
+	lv_obj_t* obj = container;
+	release();
+	if(obj != NULL) {
+		lv_obj_invalidate(obj);
+	}
+
+	// Unlink from the list of layers
+	StaticLayer** link = &layers;
+	while(*link != this) {
+		link = &(*link)->next_layer;
+	}
+	*link = next_layer;
+}
+
+void StaticLayer::add_static(lv_obj_t* child)
+{
+	MBED_ASSERT(container != NULL && lv_obj_get_parent(child) == container);
+	wrap_tree(child, true);
+	mark_dirty();
+}
+
+void StaticLayer::remove_static(lv_obj_t* child)
+{
+	StaticLayer* owner;
+	member_t* member = find(child, &owner);
+	if(member == NULL || owner != this || !member->root) {
+		return;
+	}
+
+	unwrap_tree(child);
+	mark_dirty();
+}
+
+void StaticLayer::invalidate(void)
+{
+	mark_dirty();
+}
+
+StaticLayer::member_t* StaticLayer::wrap(lv_obj_t* obj, bool root)
+{
+	member_t* member = new member_t;
+	member->obj = obj;
+	member->design_cb = lv_obj_get_design_cb(obj);
+	member->signal_cb = lv_obj_get_signal_cb(obj);
+	member->root = root;
+	member->next = members;
+	members = member;
+
+	lv_obj_set_design_cb(obj, &StaticLayer::design);
+	lv_obj_set_signal_cb(obj, &StaticLayer::signal);
+	return member;
+}
+
+void StaticLayer::unwrap(lv_obj_t* obj)
+{
+	member_t** link = &members;
+	while(*link != NULL) {
+		member_t* member = *link;
+		if(member->obj == obj) {
+			lv_obj_set_design_cb(obj, member->design_cb);
+			lv_obj_set_signal_cb(obj, member->signal_cb);
+			*link = member->next;
+			delete member;
+			return;
+		}
+		link = &member->next;
+	}
+}
+
+void StaticLayer::wrap_tree(lv_obj_t* obj, bool root)
+{
+	StaticLayer* owner;
+	if(find(obj, &owner) == NULL) {
+		wrap(obj, root);
+	}
+
+	lv_obj_t* child = lv_obj_get_child(obj, NULL);
+	while(child != NULL) {
+		wrap_tree(child, false);
+		child = lv_obj_get_child(obj, child);
+	}
+}
+
+void StaticLayer::unwrap_tree(lv_obj_t* obj)
+{
+	lv_obj_t* child = lv_obj_get_child(obj, NULL);
+	while(child != NULL) {
+		unwrap_tree(child);
+		child = lv_obj_get_child(obj, child);
+	}
+
+	unwrap(obj);
+}
+
+StaticLayer::member_t* StaticLayer::find(lv_obj_t* obj, StaticLayer** owner)
+{
+	for(StaticLayer* layer = layers; layer != NULL; layer = layer->next_layer) {
+		for(member_t* member = layer->members; member != NULL; member = member->next) {
+			if(member->obj == obj) {
+				*owner = layer;
+				return member;
+			}
+		}
+	}
+	return NULL;
+}
+
+void StaticLayer::release(void)
+{
+	while(members != NULL) {
+		unwrap(members->obj);
+	}
+	container = NULL;
+
+	if(img.data != NULL) {
+		lv_img_cache_invalidate_src(&img);
+		img.data = NULL;
+	}
+
+	if(own_buffer) {
+		delete[] buffer;
+		buffer = NULL;
+		buffer_px = 0;
+	}
+}
+
+void StaticLayer::get_layer_area(lv_area_t* area) const
+{
+	lv_area_copy(area, &container->coords);
+	area->x1 -= container->ext_draw_pad;
+	area->y1 -= container->ext_draw_pad;
+	area->x2 += container->ext_draw_pad;
+	area->y2 += container->ext_draw_pad;
+}
+
+bool StaticLayer::render(void)
+{
+	lv_area_t area;
+	get_layer_area(&area);
+	lv_coord_t w = lv_area_get_width(&area);
+	lv_coord_t h = lv_area_get_height(&area);
+	if(w <= 0 || h <= 0) {
+		return false;
+	}
+
+	uint32_t size = (uint32_t) w * h;
+	if(own_buffer && buffer_px != size) {
+		if(img.data != NULL) {
+			lv_img_cache_invalidate_src(&img);
+			img.data = NULL;
+		}
+		delete[] buffer;
+		buffer = new lv_color_t[size];
+		buffer_px = size;
+	} else if(size > buffer_px) {
+		return false;
+	}
+
+	// Pick up children created in static subtrees since they were flagged
+	for(member_t* member = members; member != NULL; member = member->next) {
+		if(member->root) {
+			wrap_tree(member->obj, true);
+		}
+	}
+
+	// Chroma key what the container doesn't cover so the background shows through
+	bool opaque = get_design_cb(container)(container, &area, LV_DESIGN_COVER_CHK);
+	if(!opaque) {
+		for(uint32_t i = 0; i < size; i++) {
+			buffer[i] = LV_COLOR_TRANSP;
+		}
+	}
+
+	/* Create a dummy display to fool the lv_draw functions.
+	 * They will think they draw to the real screen. */
+	lv_disp_t* real_disp = lv_obj_get_disp(container);
+	lv_disp_t disp;
+	memset(&disp, 0, sizeof(lv_disp_t));
+	lv_disp_buf_t disp_buf;
+	lv_disp_buf_init(&disp_buf, buffer, NULL, size);
+	lv_disp_drv_init(&disp.driver);
+	disp.driver.buffer = &disp_buf;
+	disp.driver.hor_res = lv_disp_get_hor_res(real_disp);
+	disp.driver.ver_res = lv_disp_get_ver_res(real_disp);
+	disp.driver.antialiasing = real_disp->driver.antialiasing;
+	lv_area_copy(&disp_buf.area, &area);
+
+	lv_disp_t* refr_ori = lv_refr_get_disp_refreshing();
+	lv_refr_set_disp_refreshing(&disp);
+	draw_content(&area);
+	lv_refr_set_disp_refreshing(refr_ori);
+
+	img.header.always_zero = 0;
+	img.header.cf = opaque ? LV_IMG_CF_TRUE_COLOR : LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED;
+	img.header.w = w;
+	img.header.h = h;
+	img.data = (const uint8_t*) buffer;
+	img.data_size = size * sizeof(lv_color_t);
+
+	// The image cache identifies sources by address, which is reused here
+	lv_img_cache_invalidate_src(&img);
+
+	dirty = false;
+	renders++;
+	return true;
+}
+
+void StaticLayer::draw_content(const lv_area_t* mask)
+{
+	lv_area_t area;
+	get_layer_area(&area);
+	if(!lv_area_intersect(&area, &area, mask)) {
+		return;
+	}
+
+	get_design_cb(container)(container, &area, LV_DESIGN_DRAW_MAIN);
+
+	lv_area_t child_mask;
+	if(!lv_area_intersect(&child_mask, &container->coords, mask)) {
+		return;
+	}
+
+	// Back to front, like lvgl's refresh
+	lv_obj_t* child = (lv_obj_t*) lv_ll_get_tail(&container->child_ll);
+	for(; child != NULL; child = (lv_obj_t*) lv_ll_get_prev(&container->child_ll, child)) {
+		StaticLayer* owner;
+		member_t* member = find(child, &owner);
+		if(member != NULL && member->root) {
+			draw_tree(child, &child_mask);
+		}
+	}
+}
+
+void StaticLayer::draw_tree(lv_obj_t* obj, const lv_area_t* mask)
+{
+	if(lv_obj_get_hidden(obj)) {
+		return;
+	}
+
+	lv_area_t ext_mask;
+	lv_area_copy(&ext_mask, &obj->coords);
+	ext_mask.x1 -= obj->ext_draw_pad;
+	ext_mask.y1 -= obj->ext_draw_pad;
+	ext_mask.x2 += obj->ext_draw_pad;
+	ext_mask.y2 += obj->ext_draw_pad;
+	if(!lv_area_intersect(&ext_mask, &ext_mask, mask)) {
+		return;
+	}
+
+	lv_design_cb_t design_cb = get_design_cb(obj);
+	design_cb(obj, &ext_mask, LV_DESIGN_DRAW_MAIN);
+
+	lv_area_t child_mask;
+	if(lv_area_intersect(&child_mask, &obj->coords, mask)) {
+		lv_obj_t* child = (lv_obj_t*) lv_ll_get_tail(&obj->child_ll);
+		for(; child != NULL; child = (lv_obj_t*) lv_ll_get_prev(&obj->child_ll, child)) {
+			draw_tree(child, &child_mask);
+		}
+	}
+
+	design_cb(obj, &ext_mask, LV_DESIGN_DRAW_POST);
+}
+
+lv_design_cb_t StaticLayer::get_design_cb(lv_obj_t* obj)
+{
+	StaticLayer* owner;
+	member_t* member = find(obj, &owner);
+	return (member != NULL) ? member->design_cb : lv_obj_get_design_cb(obj);
+}
+
+void StaticLayer::mark_dirty(void)
+{
+	dirty = true;
+	if(container != NULL) {
+		lv_obj_invalidate(container);
+	}
+}
+
+bool StaticLayer::design(lv_obj_t* obj, const lv_area_t* mask, lv_design_mode_t mode)
+{
+	StaticLayer* layer;
+	member_t* member = find(obj, &layer);
+	MBED_ASSERT(member != NULL);
+
+	if(obj != layer->container) {
+		// Static objects are part of the layer, drawn with the container
+		return (mode == LV_DESIGN_COVER_CHK) ? false : true;
+	}
+
+	if(mode != LV_DESIGN_DRAW_MAIN) {
+		return member->design_cb(obj, mask, mode);
+	}
+
+	if(layer->dirty || layer->img.data == NULL) {
+		if(!layer->render()) {
+			layer->fallbacks++;
+			layer->draw_content(mask);
+			return true;
+		}
+	} else {
+		layer->hits++;
+	}
+
+	lv_area_t area;
+	layer->get_layer_area(&area);
+	lv_draw_img(&area, mask, &layer->img, &lv_style_plain, LV_OPA_COVER);
+
+	return true;
+}
+
+lv_res_t StaticLayer::signal(lv_obj_t* obj, lv_signal_t sign, void* param)
+{
+	StaticLayer* layer;
+	member_t* member = find(obj, &layer);
+	MBED_ASSERT(member != NULL);
+
+	lv_res_t res = member->signal_cb(obj, sign, param);
+	if(res != LV_RES_OK) {
+		return res;
+	}
+
+	if(obj == layer->container) {
+		if(sign == LV_SIGNAL_CLEANUP) {
+			// The container is being deleted (its children already are)
+			layer->release();
+		} else if(sign == LV_SIGNAL_STYLE_CHG) {
+			layer->mark_dirty();
+		} else if(sign == LV_SIGNAL_CORD_CHG) {
+			// Moving the container doesn't change what it looks like
+			const lv_area_t* ori = (const lv_area_t*) param;
+			if(lv_area_get_width(ori) != lv_obj_get_width(obj) ||
+					lv_area_get_height(ori) != lv_obj_get_height(obj)) {
+				layer->mark_dirty();
+			}
+		} else if(sign == LV_SIGNAL_CHILD_CHG && param != NULL) {
+			// Only the container hears of some changes of its children (eg: hidden)
+			StaticLayer* owner;
+			member_t* child = find((lv_obj_t*) param, &owner);
+			if(child != NULL && owner == layer && child->root) {
+				layer->mark_dirty();
+			}
+		}
+		return res;
+	}
+
+	if(sign == LV_SIGNAL_CLEANUP) {
+		layer->unwrap(obj);
+		layer->mark_dirty();
+	} else if(sign == LV_SIGNAL_STYLE_CHG || sign == LV_SIGNAL_CORD_CHG ||
+			sign == LV_SIGNAL_CHILD_CHG) {
+		layer->mark_dirty();
+	}
+
+	return res;
+}
+
+#endif /* (LV_COLOR_DEPTH > 1) */
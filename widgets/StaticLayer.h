@@ -0,0 +1,185 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_WIDGETS_STATICLAYER_H_
+#define MBED_LVGL_WIDGETS_STATICLAYER_H_
+
+#if (LV_COLOR_DEPTH > 1)
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lv_obj.h"
+#include "lv_draw_img.h"
+
+#include "platform/NonCopyable.h"
+
+/**
+ * Opt-in off-screen layer caching a container's unchanging content
+ *
+ * The container's own drawing (eg: a gradient or shadowed background) and
+ * the children flagged static (eg: a gauge's scale, images) are rendered
+ * once into a buffer the size of the container. Each time the container
+ * is redrawn the buffer is blitted instead, and only the other (dynamic)
+ * children, eg: the gauge's needle, are rendered on top of it.
+ *
+ * The buffer is re-rendered automatically when the container's size or
+ * style changes, and when a static child (or any of its children) is
+ * moved, resized, restyled, hidden, created or deleted. Changes lvgl sends no
+ * signal for (eg: the text of a static label) need a call to invalidate().
+ *
+ * If the container does not cover its whole area, the buffer is chroma
+ * keyed (LV_COLOR_TRANSP) so what is behind it shows through. Anti-aliased
+ * edges over a transparent background are blended against the chroma
+ * color, so layers are best used on opaque containers.
+ *
+ * @note Static children are drawn as part of the layer, below all dynamic
+ * children, regardless of their order in the container
+ */
+class StaticLayer : private mbed::NonCopyable<StaticLayer>
+{
+	public:
+
+		/**
+		 * Instantiate a StaticLayer
+		 *
+		 * @param[in] container Object whose content is cached
+		 * @param[in] buffer (optional) Buffer to render into (eg: in external RAM), allocated from the heap if NULL
+		 * @param[in] buffer_px (optional) Size of the buffer in pixels, the layer is drawn uncached if the container doesn't fit
+		 */
+		StaticLayer(lv_obj_t* container, lv_color_t* buffer = NULL, size_t buffer_px = 0);
+
+		/**
+		 * Restores the container and its static children, frees the buffer
+		 */
+		~StaticLayer();
+
+		/**
+		 * Flags a child of the container as static, it and its children are drawn into the layer
+		 *
+		 * @param[in] child Direct child of the container
+		 */
+		void add_static(lv_obj_t* child);
+
+		/**
+		 * Makes a static child dynamic again
+		 *
+		 * @param[in] child Child previously flagged static
+		 */
+		void remove_static(lv_obj_t* child);
+
+		/**
+		 * Re-renders the layer on next draw
+		 */
+		void invalidate(void);
+
+		/** Number of times the layer was rendered */
+		uint32_t get_renders(void) const {
+			return renders;
+		}
+
+		/** Number of draws served from the buffer */
+		uint32_t get_hits(void) const {
+			return hits;
+		}
+
+		/** Number of draws done without the buffer (it was too small or could not be allocated) */
+		uint32_t get_fallbacks(void) const {
+			return fallbacks;
+		}
+
+	protected:
+
+		/** Object whose design and signal functions are wrapped */
+		typedef struct member {
+			lv_obj_t* obj;
+			lv_design_cb_t design_cb;	/** Object's original design function */
+			lv_signal_cb_t signal_cb;	/** Object's original signal function */
+			bool root;					/** Direct child flagged static */
+			struct member* next;
+		} member_t;
+
+		/** Wraps an object's design and signal functions */
+		member_t* wrap(lv_obj_t* obj, bool root);
+
+		/** Restores an object's design and signal functions */
+		void unwrap(lv_obj_t* obj);
+
+		/** Wraps an object and its children (those created since it was wrapped) */
+		void wrap_tree(lv_obj_t* obj, bool root);
+
+		/** Unwraps an object and its children */
+		void unwrap_tree(lv_obj_t* obj);
+
+		/** Finds the member (and owning layer) of an object */
+		static member_t* find(lv_obj_t* obj, StaticLayer** owner);
+
+		/** Unwraps all objects and frees the buffer */
+		void release(void);
+
+		/** Area covered by the layer, the container and its extra drawing area (eg: shadow) */
+		void get_layer_area(lv_area_t* area) const;
+
+		/** Renders the layer into the buffer */
+		bool render(void);
+
+		/** Draws the container and static children to the display being refreshed */
+		void draw_content(const lv_area_t* mask);
+
+		/** Draws an object and its children like lvgl's refresh does, with the original design functions */
+		void draw_tree(lv_obj_t* obj, const lv_area_t* mask);
+
+		/** Original design function of an object */
+		lv_design_cb_t get_design_cb(lv_obj_t* obj);
+
+		/** Marks the layer for re-rendering and redraws the container */
+		void mark_dirty(void);
+
+		/*
+		 * @brief Design and signal functions installed on the container and static objects
+		 */
+		static bool design(lv_obj_t* obj, const lv_area_t* mask, lv_design_mode_t mode);
+		static lv_res_t signal(lv_obj_t* obj, lv_signal_t sign, void* param);
+
+	protected:
+
+		lv_obj_t* container;
+
+		/** Container and static objects */
+		member_t* members;
+
+		lv_color_t* buffer;
+		size_t buffer_px;
+		bool own_buffer;
+
+		/** Rendered layer (img.data is NULL if not rendered) */
+		lv_img_dsc_t img;
+		bool dirty;
+
+		uint32_t renders;
+		uint32_t hits;
+		uint32_t fallbacks;
+
+		/** All StaticLayer instances, used to route lvgl callbacks */
+		StaticLayer* next_layer;
+		static StaticLayer* layers;
+
+};
+
+#endif /* (LV_COLOR_DEPTH > 1) */
+
+#endif /* MBED_LVGL_WIDGETS_STATICLAYER_H_ */
@@ -0,0 +1,290 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StreamChart.h"
+
+#if LV_USE_CANVAS
+
+#include <string.h>
+
+#include "LittlevGL.h"
+
+#include "platform/mbed_assert.h"
+#include "platform/mbed_critical.h"
+
+#define STREAM_CHART_RING_SIZE	MBED_CONF_MBED_LVGL_STREAM_CHART_RING_SIZE
+#define STREAM_CHART_RING_MASK	(STREAM_CHART_RING_SIZE - 1)
+
+StreamChart::StreamChart(lv_obj_t* parent, lv_coord_t width, lv_coord_t height, lv_color_t* buffer) :
+		buffer(buffer), own_buffer(buffer == NULL), width(width), height(height),
+		head(0), tail(0), series_count(0), range_min(0), range_max(100),
+		background(LV_COLOR_BLACK), grid(LV_COLOR_GRAY), hdiv(3),
+		samples_per_column(1), column_samples(0), pending_count(0), pending_start(0),
+		has_last(false)
+{
+	MBED_ASSERT(width > 0 && height > 0);
+	MBED_ASSERT((STREAM_CHART_RING_SIZE & STREAM_CHART_RING_MASK) == 0);
+
+	if(own_buffer) {
+		this->buffer = new lv_color_t[(uint32_t) width * height];
+	}
+
+	cells = new cell_t[STREAM_CHART_RING_SIZE];
+	for(uint32_t i = 0; i < STREAM_CHART_RING_SIZE; i++) {
+		cells[i].seq = i;
+	}
+
+	pending = new column_t[width];
+	memset(&stats, 0, sizeof(stats));
+
+	canvas = lv_canvas_create(parent, NULL);
+	lv_canvas_set_buffer(canvas, this->buffer, width, height, LV_IMG_CF_TRUE_COLOR);
+	clear();
+
+	LittlevGL::get_instance().add_frame_hook(*this);
+}
+
+StreamChart::~StreamChart()
+{
+	LittlevGL::get_instance().remove_frame_hook(*this);
+
+	lv_obj_del(canvas);
+
+	delete[] pending;
+	delete[] cells;
+	if(own_buffer) {
+		delete[] buffer;
+	}
+}
+
+int StreamChart::add_series(lv_color_t color)
+{
+	if(series_count == MAX_SERIES) {
+		return -1;
+	}
+
+	series_colors[series_count] = color;
+	return series_count++;
+}
+
+void StreamChart::set_range(int32_t min, int32_t max)
+{
+	MBED_ASSERT(max > min);
+	range_min = min;
+	range_max = max;
+}
+
+void StreamChart::set_samples_per_column(uint32_t samples)
+{
+	MBED_ASSERT(samples >= 1);
+	samples_per_column = samples;
+	column_samples = 0;
+}
+
+void StreamChart::set_background(lv_color_t background, lv_color_t grid, uint8_t hdiv)
+{
+	this->background = background;
+	this->grid = grid;
+	this->hdiv = hdiv;
+	clear();
+}
+
+void StreamChart::clear(void)
+{
+	column_samples = 0;
+	pending_count = 0;
+	pending_start = 0;
+	has_last = false;
+
+	for(lv_coord_t x = 0; x < width; x++) {
+		draw_column(x, NULL);
+	}
+	lv_obj_invalidate(canvas);
+}
+
+bool StreamChart::push(const int32_t* values)
+{
+	// Claim a cell (bounded multi-producer queue, one sequence number per cell)
+	uint32_t pos = head;
+	cell_t* cell;
+	while(true) {
+		cell = &cells[pos & STREAM_CHART_RING_MASK];
+		int32_t diff = (int32_t)(cell->seq - pos);
+		if(diff == 0) {
+			if(core_util_atomic_cas_u32(&head, &pos, pos + 1)) {
+				break;
+			}
+		} else if(diff < 0) {
+			// The GUI thread hasn't consumed this cell yet
+			core_util_atomic_incr_u32(&stats.dropped, 1);
+			return false;
+		} else {
+			pos = head;
+		}
+	}
+
+	memcpy(cell->values, values, series_count * sizeof(int32_t));
+
+	// Publish the cell (the atomic increment is a barrier)
+	core_util_atomic_incr_u32((uint32_t*) &cell->seq, 1);
+
+#if MBED_CONF_RTOS_PRESENT
+	LittlevGL& lvgl = LittlevGL::get_instance();
+	if(lvgl.get_idle_state() == LittlevGL::IDLE_PARKED) {
+		lvgl.wake();
+	}
+#endif
+
+	return true;
+}
+
+bool StreamChart::pop(int32_t* values)
+{
+	cell_t* cell = &cells[tail & STREAM_CHART_RING_MASK];
+	if((int32_t)(cell->seq - (tail + 1)) < 0) {
+		return false;
+	}
+
+	memcpy(values, cell->values, series_count * sizeof(int32_t));
+
+	// Hand the cell back to producers for the next lap
+	core_util_atomic_incr_u32((uint32_t*) &cell->seq, STREAM_CHART_RING_SIZE - 1);
+	tail++;
+	return true;
+}
+
+void StreamChart::accumulate(const int32_t* values)
+{
+	for(uint8_t s = 0; s < series_count; s++) {
+		if(column_samples == 0) {
+			current.min[s] = values[s];
+			current.max[s] = values[s];
+		} else if(values[s] < current.min[s]) {
+			current.min[s] = values[s];
+		} else if(values[s] > current.max[s]) {
+			current.max[s] = values[s];
+		}
+		current.end[s] = values[s];
+	}
+
+	stats.samples++;
+	if(++column_samples < samples_per_column) {
+		return;
+	}
+	column_samples = 0;
+
+	// Only the latest width columns can be seen
+	if(pending_count == width) {
+		pending_start = (pending_start + 1) % width;
+		pending_count--;
+	}
+	pending[(pending_start + pending_count) % width] = current;
+	pending_count++;
+}
+
+void StreamChart::draw_columns(void)
+{
+	lv_coord_t count = pending_count;
+	if(count == 0) {
+		return;
+	}
+
+	// Scroll what is already drawn instead of redrawing it
+	if(count < width) {
+		for(lv_coord_t y = 0; y < height; y++) {
+			lv_color_t* row = &buffer[(uint32_t) y * width];
+			memmove(row, row + count, (width - count) * sizeof(lv_color_t));
+		}
+	}
+
+	for(lv_coord_t i = 0; i < count; i++) {
+		draw_column(width - count + i, &pending[(pending_start + i) % width]);
+	}
+
+	stats.columns += count;
+	pending_count = 0;
+	pending_start = 0;
+
+	lv_obj_invalidate(canvas);
+}
+
+void StreamChart::draw_column(lv_coord_t x, const column_t* column)
+{
+	lv_color_t* px = &buffer[x];
+	for(lv_coord_t y = 0; y < height; y++) {
+		px[(uint32_t) y * width] = background;
+	}
+	for(uint8_t d = 1; d <= hdiv; d++) {
+		px[(uint32_t)(d * height / (hdiv + 1)) * width] = grid;
+	}
+
+	if(column == NULL) {
+		return;
+	}
+
+	for(uint8_t s = 0; s < series_count; s++) {
+		int32_t lo = column->min[s];
+		int32_t hi = column->max[s];
+
+		// Join the previous column so steep edges stay continuous
+		if(has_last) {
+			if(last[s] < lo) lo = last[s];
+			if(last[s] > hi) hi = last[s];
+		}
+		last[s] = column->end[s];
+
+		lv_coord_t y2 = value_to_y(lo);
+		for(lv_coord_t y = value_to_y(hi); y <= y2; y++) {
+			px[(uint32_t) y * width] = series_colors[s];
+		}
+	}
+	has_last = true;
+}
+
+lv_coord_t StreamChart::value_to_y(int32_t value) const
+{
+	if(value <= range_min) {
+		return height - 1;
+	}
+	if(value >= range_max) {
+		return 0;
+	}
+
+	int64_t offset = ((int64_t) value - range_min) * (height - 1) / ((int64_t) range_max - range_min);
+	return (height - 1) - (lv_coord_t) offset;
+}
+
+void StreamChart::before_refresh(lv_disp_t* disp)
+{
+	if(disp != lv_obj_get_disp(canvas)) {
+		return;
+	}
+
+	uint32_t backlog = head - tail;
+	if(backlog > stats.max_backlog) {
+		stats.max_backlog = backlog;
+	}
+
+	int32_t values[MAX_SERIES];
+	while(pop(values)) {
+		accumulate(values);
+	}
+
+	draw_columns();
+}
+
+#endif /* LV_USE_CANVAS */
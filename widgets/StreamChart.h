@@ -0,0 +1,213 @@
+/* LittlevGL for Mbed-OS library
+ * Copyright (c) 2018-2019 George "AGlass0fMilk" Beckstein
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_LVGL_WIDGETS_STREAMCHART_H_
+#define MBED_LVGL_WIDGETS_STREAMCHART_H_
+
+#if LV_USE_CANVAS
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lv_obj.h"
+#include "lv_canvas.h"
+
+#include "LVGLFrameHook.h"
+
+#include "platform/NonCopyable.h"
+
+/**
+ * Oscilloscope-like chart of high-rate samples
+ *
+ * Producers push samples (one value per series, sampled together) into a
+ * lock-free ring buffer from any thread or interrupt. Once per frame,
+ * right before the chart's display is refreshed, the samples received
+ * are reduced to pixel columns: every column covers a fixed number of
+ * samples and is drawn as the min/max envelope of each series. The canvas
+ * is scrolled left by the number of new columns and only those columns
+ * are drawn, instead of shifting arrays and redrawing the whole chart for
+ * each point.
+ *
+ * Samples pushed while the ring buffer is full are dropped and counted.
+ *
+ * @note The chart must be deleted before its parent
+ */
+class StreamChart : public LVGLFrameHook, private mbed::NonCopyable<StreamChart>
+{
+	public:
+
+		/** Most series a chart can have */
+		static const uint8_t MAX_SERIES = MBED_CONF_MBED_LVGL_STREAM_CHART_MAX_SERIES;
+
+		/** Chart statistics */
+		typedef struct {
+			uint32_t samples;		/** Samples reduced to columns */
+			uint32_t dropped;		/** Samples dropped because the ring buffer was full */
+			uint32_t columns;		/** Columns drawn */
+			uint32_t max_backlog;	/** Most samples waiting for a frame */
+		} stats_t;
+
+		/**
+		 * Instantiate a StreamChart
+		 *
+		 * @param[in] parent Parent of the chart's canvas
+		 * @param[in] width Width of the chart
+		 * @param[in] height Height of the chart
+		 * @param[in] buffer (optional) Canvas buffer of width * height pixels, allocated from the heap if NULL
+		 */
+		StreamChart(lv_obj_t* parent, lv_coord_t width, lv_coord_t height, lv_color_t* buffer = NULL);
+
+		/**
+		 * Deletes the canvas
+		 */
+		~StreamChart();
+
+		/**
+		 * Gets the chart's canvas, eg: to position it
+		 */
+		lv_obj_t* get_canvas(void) {
+			return canvas;
+		}
+
+		/**
+		 * Adds a series
+		 *
+		 * @param[in] color Color the series is drawn with
+		 *
+		 * @retval index of the series, -1 if the chart has MAX_SERIES series
+		 */
+		int add_series(lv_color_t color);
+
+		/**
+		 * Sets the range of values shown (defaults to 0 to 100)
+		 */
+		void set_range(int32_t min, int32_t max);
+
+		/**
+		 * Sets how many samples each pixel column covers (defaults to 1)
+		 */
+		void set_samples_per_column(uint32_t samples);
+
+		/**
+		 * Sets the background and grid colors and the number of horizontal division lines
+		 */
+		void set_background(lv_color_t background, lv_color_t grid, uint8_t hdiv);
+
+		/**
+		 * Clears the chart
+		 */
+		void clear(void);
+
+		/**
+		 * Pushes a sample, safe from any thread and from interrupts
+		 *
+		 * @param[in] values One value per series
+		 *
+		 * @retval false if the ring buffer is full and the sample was dropped
+		 */
+		bool push(const int32_t* values);
+
+		/**
+		 * Pushes a sample of a single series chart
+		 */
+		bool push(int32_t value) {
+			return push(&value);
+		}
+
+		const stats_t& get_stats(void) const {
+			return stats;
+		}
+
+		/*
+		 * @brief Frame hook implementation, draws the samples received
+		 */
+		virtual void before_refresh(lv_disp_t* disp);
+
+	protected:
+
+		/** Slot of the ring buffer */
+		typedef struct {
+			volatile uint32_t seq;		/** Position the slot is free (seq == pos) or full (seq == pos + 1) for */
+			int32_t values[MAX_SERIES];
+		} cell_t;
+
+		/** Envelope of the samples of a column */
+		typedef struct {
+			int32_t min[MAX_SERIES];
+			int32_t max[MAX_SERIES];
+			int32_t end[MAX_SERIES];	/** Last sample of the column */
+		} column_t;
+
+		/** Pops a sample, GUI thread only */
+		bool pop(int32_t* values);
+
+		/** Adds a sample to the column being built */
+		void accumulate(const int32_t* values);
+
+		/** Scrolls the canvas by the pending columns and draws them */
+		void draw_columns(void);
+
+		/** Draws a column at x */
+		void draw_column(lv_coord_t x, const column_t* column);
+
+		/** Maps a value to a row */
+		lv_coord_t value_to_y(int32_t value) const;
+
+	protected:
+
+		lv_obj_t* canvas;
+		lv_color_t* buffer;
+		bool own_buffer;
+		lv_coord_t width;
+		lv_coord_t height;
+
+		/** Ring buffer */
+		cell_t* cells;
+		volatile uint32_t head;
+		uint32_t tail;
+
+		uint8_t series_count;
+		lv_color_t series_colors[MAX_SERIES];
+
+		int32_t range_min;
+		int32_t range_max;
+
+		lv_color_t background;
+		lv_color_t grid;
+		uint8_t hdiv;
+
+		/** Column being built */
+		uint32_t samples_per_column;
+		uint32_t column_samples;
+		column_t current;
+
+		/** Columns completed since the last frame, the latest width of them are kept */
+		column_t* pending;
+		lv_coord_t pending_count;
+		lv_coord_t pending_start;
+
+		/** Last sample drawn per series, the next column is joined to it */
+		int32_t last[MAX_SERIES];
+		bool has_last;
+
+		stats_t stats;
+
+};
+
+#endif /* LV_USE_CANVAS */
+
+#endif /* MBED_LVGL_WIDGETS_STREAMCHART_H_ */